@@ -381,6 +381,9 @@ bool APPB::FCmdIdle(PCMD pcmd)
     }
 #endif // DEBUG
 
+    // build objects whose data has been read in the background
+    CRF::CompletePrefetches();
+
     if ((_cactIdle & 0x0F) == 1 && pvNil != (pgob = GOB::PgobScreen()))
     {
         // check to see if the mouse moved
@@ -562,6 +565,10 @@ bool APPB::_FInit(ulong grfapp, ulong grfgob, long ginDef)
     if (!vpcex->FAddCmh(vpappb, kcmhlAppb))
         return fFalse;
 
+    // the fast codec is for data the app writes and reads back itself
+    if (!vpcodmUtil->FRegisterCodec(&vkcdfUtil))
+        return fFalse;
+
     // do OS specific initialization
     if (!_FInitOS())
         return fFalse;
@@ -697,6 +704,10 @@ void APPB::_CleanUp(void)
 #ifdef WIN
     _ShutDownViewer();
 #endif // WIN
+
+    // the main thread's memory cache can't wait for its thread_local
+    // destructor, which runs during CRT teardown
+    ShutDownMem();
 }
 
 /***************************************************************************
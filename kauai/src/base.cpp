@@ -15,9 +15,9 @@
 ASSERTNAME
 
 #ifdef DEBUG
-long vcactSuspendAssertValid = 0;
-long vcactAVSave = 0;
-long vcactAV = kswMax;
+thread_local long vcactSuspendAssertValid = 0;
+thread_local long vcactAVSave = 0;
+thread_local long vcactAV = kswMax;
 
 /*****************************************************************************
     Debugging stuff to track leaked allocated objects.
@@ -97,9 +97,10 @@ const ulong fobjNotAllocated = 0x40000000L;
 const ulong fobjAllocated = 0x20000000L;
 const ulong fobjAssertFull = 0x10000000L;
 
-extern long vcactSuspendAssertValid;
-extern long vcactAVSave;
-extern long vcactAV;
+// these are per thread - helper threads turn off AssertValid (see DFR)
+extern thread_local long vcactSuspendAssertValid;
+extern thread_local long vcactAVSave;
+extern thread_local long vcactAV;
 inline void SuspendAssertValid(void)
 {
     if (0 == vcactSuspendAssertValid++)
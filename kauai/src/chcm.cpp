@@ -73,6 +73,7 @@ CHCM::CHCM(void)
     _pcfl = pvNil;
     _pchlx = pvNil;
     _pglckiLoner = pvNil;
+    _pglckiPack = pvNil;
     _pmsnkError = pvNil;
     _cactError = 0;
     AssertThis(0);
@@ -97,6 +98,7 @@ CHCM::~CHCM(void)
     ReleasePpo(&_pcfl);
     ReleasePpo(&_pchlx);
     ReleasePpo(&_pglckiLoner);
+    ReleasePpo(&_pglckiPack);
 }
 
 #ifdef DEBUG
@@ -110,6 +112,7 @@ void CHCM::AssertValid(ulong grf)
     AssertPo(&_bsf, 0);
     AssertNilOrPo(_pchlx, 0);
     AssertNilOrPo(_pglckiLoner, 0);
+    AssertNilOrPo(_pglckiPack, 0);
     AssertNilOrPo(_pmsnkError, 0);
 }
 
@@ -126,6 +129,7 @@ void CHCM::MarkMem(void)
     MarkMemObj(&_bsf);
     MarkMemObj(_pchlx);
     MarkMemObj(_pglckiLoner);
+    MarkMemObj(_pglckiPack);
 }
 #endif // DEBUG
 
@@ -675,7 +679,8 @@ bool CHCM::_FPrepWrite(bool fPack, long cb, CTG ctg, CNO cno, PBLCK pblck)
 }
 
 /***************************************************************************
-    Balances a call to _FPrepWrite.
+    Balances a call to _FPrepWrite. Data to be packed is put in the chunk
+    unpacked and compressed later by _PackChunks.
 ***************************************************************************/
 bool CHCM::_FEndWrite(bool fPack, CTG ctg, CNO cno, PBLCK pblck)
 {
@@ -683,16 +688,52 @@ bool CHCM::_FEndWrite(bool fPack, CTG ctg, CNO cno, PBLCK pblck)
     AssertPo(pblck, fblckUnpacked);
 
     if (fPack)
-    {
-        // we don't fail if we can't compress it
-        pblck->FPackData();
-        return _pcfl->FPutBlck(pblck, ctg, cno);
-    }
+        return _pcfl->FPutBlck(pblck, ctg, cno) && _FQueuePack(ctg, cno);
 
     AssertPo(pblck, fblckFile);
     return fTrue;
 }
 
+/***************************************************************************
+    Add a chunk of _pcfl to the list of chunks to pack.
+***************************************************************************/
+bool CHCM::_FQueuePack(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+    CKI cki;
+
+    cki.ctg = ctg;
+    cki.cno = cno;
+    if (pvNil == _pglckiPack && pvNil == (_pglckiPack = GL::PglNew(size(CKI))))
+        return fFalse;
+    return _pglckiPack->FAdd(&cki);
+}
+
+/***************************************************************************
+    Pack the queued chunks. They're compressed as a batch, so the work gets
+    spread across the available processors. This needs to be called before
+    _pcfl or the default packing format changes.
+***************************************************************************/
+void CHCM::_PackChunks(void)
+{
+    AssertThis(0);
+    bool fRet;
+
+    if (pvNil == _pglckiPack || 0 == _pglckiPack->IvMac())
+        return;
+
+    // we don't fail if the chunks can't be compressed, only if reading or
+    // writing them fails
+    if (!FError())
+    {
+        fRet = _pcfl->FPackDataRgcki((CKI *)_pglckiPack->PvLock(0), _pglckiPack->IvMac());
+        _pglckiPack->Unlock();
+        if (!fRet)
+            _Error(ertOom);
+    }
+    AssertDo(_pglckiPack->FSetIvMac(0), 0);
+}
+
 /***************************************************************************
     Parse a metafile import command from the source file.
 ***************************************************************************/
@@ -1659,6 +1700,7 @@ void CHCM::_StartSubFile(bool fPack, CTG ctg, CNO cno)
     AssertThis(0);
     CSFC csfc;
 
+    _PackChunks();
     if (pvNil == _pglcsfc && pvNil == (_pglcsfc = GL::PglNew(size(CSFC))))
         goto LFail;
 
@@ -1695,6 +1737,7 @@ void CHCM::_EndSubFile(void)
 
     AssertPo(csfc.pcfl, 0);
 
+    _PackChunks();
     if (!FError())
     {
         long icki;
@@ -1751,8 +1794,8 @@ void CHCM::_EndSubFile(void)
         {
             BLCK blck(pfilDst, 0, fpDst);
 
-            // pack the data and put it in the chunk.
-            blck.FPackData();
+            // put the data in the chunk - it gets packed along with the
+            // parent file's other chunks
             if (!csfc.pcfl->FPutBlck(&blck, csfc.ctg, csfc.cno))
                 goto LFail;
         }
@@ -1769,6 +1812,9 @@ void CHCM::_EndSubFile(void)
 
     ReleasePpo(&_pcfl);
     _pcfl = csfc.pcfl;
+
+    if (!FError() && csfc.fPack && !_FQueuePack(csfc.ctg, csfc.cno))
+        _Error(ertOom);
 }
 
 /***************************************************************************
@@ -1794,7 +1840,11 @@ void CHCM::_ParsePackFmt(void)
     if (!vpcodmUtil->FCanDo(cfmt, fTrue))
         _Error(ertBadPackFmt);
     else
+    {
+        // chunks already queued get the old format
+        _PackChunks();
         vpcodmUtil->SetCfmtDefault(cfmt);
+    }
 }
 
 /***************************************************************************
@@ -2098,6 +2148,7 @@ PCFL CHCM::PcflCompile(PBSF pbsfSrc, PSTN pstnFile, PFNI pfniDst, PMSNK pmsnk)
         CSFC csfc;
 
         _Error(ertNoEndSubFile);
+        _PackChunks();
         while (_pglcsfc->FPop(&csfc))
         {
             ReleasePpo(&_pcfl);
@@ -2117,6 +2168,7 @@ PCFL CHCM::PcflCompile(PBSF pbsfSrc, PSTN pstnFile, PFNI pfniDst, PMSNK pmsnk)
         }
     }
 
+    _PackChunks();
     if (!FError() && !_pcfl->FSave(kctgChkCmp, pvNil))
         _Error(ertOom);
 
@@ -2311,7 +2363,10 @@ bool CHLX::_FDoSet(PTOK ptok)
 
     lw = 0;
     istn = ivNil;
-    if (pvNil != _pgstVariables || pvNil != (_pgstVariables = GST::PgstNew(size(long))))
+    // variables are looked up on every use, so hash them
+    if (pvNil == _pgstVariables && pvNil != (_pgstVariables = GST::PgstNew(size(long))))
+        _pgstVariables->SetHashed(fTrue);
+    if (pvNil != _pgstVariables)
     {
         if (_pgstVariables->FFindStn(&ptok->stn, &istn, fgstSorted))
             _pgstVariables->GetExtra(istn, &lw);
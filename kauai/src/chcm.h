@@ -193,6 +193,7 @@ class CHCM : public CHCM_PAR
 
     PCFL _pcfl;       // current sub file
     PGL _pglckiLoner; // the chunks that must be loners
+    PGL _pglckiPack;  // chunks in _pcfl waiting to be packed
 
     BSF _bsf;     // temporary buffer for the chunk data
     PCHLX _pchlx; // lexer for compiling
@@ -244,6 +245,8 @@ class CHCM : public CHCM_PAR
 
     bool _FPrepWrite(bool fPack, long cb, CTG ctg, CNO cno, PBLCK pblck);
     bool _FEndWrite(bool fPack, CTG ctg, CNO cno, PBLCK pblck);
+    bool _FQueuePack(CTG ctg, CNO cno);
+    void _PackChunks(void);
 
   public:
     CHCM(void);
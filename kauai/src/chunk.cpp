@@ -33,15 +33,34 @@
 
     On disk, chunky files are organized as follows:
 
-        * A header (CFP struct defined below).
+        * A header (CFPF struct defined below).
         * The raw chunk data arranged in arbitrary order (a heap).
+        * An optional table of payload hashes (see below).
         * The index for the chunky file.
         * An optional free map indicating which portions of the heap
           are currently not being used to store chunk data.
+        * Optionally, more heap interleaved with journal records.
 
     The header stores signatures, version numbers, and pointers to the
     index and free map. The heap contains only the raw chunk data.
-    The index is not updated on disk until FSave is called.
+    The index is not updated on disk until FSave is called. The header
+    also has a checksum of the index. When the index read at open matches
+    it, the (slow) check for cycles and orphans in the chunk graph is
+    skipped.
+
+    When FSave writes the index in place, it normally appends a journal
+    record holding just the index entries that changed since the last save
+    (and the current free map) instead of rewriting the whole index. Each
+    record points at the previous one and the header points at the last
+    one. When the file is opened, the journal is applied to the index in
+    memory. Once the journal gets bigger than half the index, FSave writes
+    the whole index again and the space used by the old index and journal
+    goes back to the heap.
+
+    File positions are 64 bits. Files that fit in 2GB are normally saved
+    with 32-bit positions, so older versions can still read them. Bigger
+    files (and ones given fcflLarge) are saved in the large format, which
+    adds the high words of the positions.
 
     The index is implemented as a general group (GG). The fixed portion
     of each entry is a CRP (defined below). The variable portion contains
@@ -72,6 +91,15 @@
     happens within a single run-time session (from the files point of view).
     If the chunky files are closed and re-opened, no sharing will occur.
 
+    Separately from that, chunks with byte-identical data share a single
+    copy of the data in the heap. When chunk data (that isn't tiny) is
+    written from memory or from another block, it is hashed and compared
+    against existing data with the same hash. If there's a match, the new chunk just points at
+    the existing data. The payload index keeps a reference count for each
+    piece of shared data, so the heap space is only freed when the last
+    chunk using it goes away. The hashes are saved with the index, so
+    sharing also works against data written in earlier sessions.
+
 ***************************************************************************/
 #include "util.h"
 ASSERTNAME
@@ -83,12 +111,18 @@ ASSERTNAME
     3	ShonK: changed format of chunk names to be a saved STN, 3/30/95
     4	ShonK: implemented support for compact index (CRP is smaller). 8/21/95
     5	ShonK: added the fcrpForest flag. 9/4/95
+    6	added the index journal (only files that have a journal need
+        this version to be read)
+    7	chunks can share data and payload hashes are saved (only files
+        with shared data need this version to be read)
+    8	64-bit file positions (only large files need this version to be
+        read)
 
 */
 
 // A file written by this version of chunk.cpp receives this cvn.  Any
 // file with this cvn value has exactly the same file format
-const short kcvnCur = 5;
+const short kcvnCur = 8;
 
 // A file written by this version of chunk.cpp can be read by any version
 // of chunk.cpp whose kcvnCur is >= to this (this should be <= kcvnCur)
@@ -107,9 +141,62 @@ const auto kcvnMinStnNames = 3;
 const auto kcvnMinGrfcrp = 4;
 const auto kcvnMinSmallIndex = 4;
 const auto kcvnMinForest = 5;
+const auto kcvnMinJournal = 6;
+const auto kcvnMinShared = 7;
+const auto kcvnMinLarge = 8;
 
 const long klwMagicChunky = BigLittle('CHN2', '2NHC'); // chunky file signature
 
+// File positions in the structures saved in the file are split into a low
+// word and a high word. The high word comes after the other fields and is
+// only saved in large files, so small files can still be read by older
+// versions. The structures are read into zeroed memory, so the high word
+// from a small file is zero (before and after byte swapping).
+
+// chunky file prefix, as saved in the file (see _FReadCfp and _FWriteCfp)
+struct CFPF
+{
+    long lwMagic;   // identifies this as a chunky file
+    CTG ctgCreator; // program that created this file
+    DVER dver;      // chunky file version
+    short bo;       // byte order
+    short osk;      // which system wrote this
+
+    ulong luFpMac;   // logical end of file
+    ulong luFpIndex; // location of chunky index
+    long cbIndex;    // size of chunky index
+    ulong luFpMap;   // location of free space map
+    long cbMap;      // size of free space map (may be 0)
+
+    ulong luFpJournal; // location of the last journal record (0 if none)
+    long cbJournal;    // size of the last journal record
+    long cbBase;       // size of the index and free map the journal applies to
+
+    ulong luFpPayload; // location of the payload hashes (just before the index)
+    long cbPayload;    // size of the payload hashes (may be 0)
+
+    ulong luIndexSum; // checksum of the index (see _LuSumIndex), 0 if none
+    ulong grfcfp;     // fcfpLarge, fcfpDict
+
+    // high words of the file positions (zero unless fcfpLarge)
+    long lwFpMacHigh;
+    long lwFpIndexHigh;
+    long lwFpMapHigh;
+    long lwFpJournalHigh;
+    long lwFpPayloadHigh;
+
+    long rglwReserved[11]; // reserved for future use - should be zero
+};
+const BOM kbomCfp = 0xB55FFFFFL; // the fields after cbPayload are past the BOM, so swap them separately
+const long kclwCfpPastBom = 7;
+
+enum
+{
+    fcfpNil = 0,
+    fcfpLarge = 0x01, // the file uses 64-bit file positions
+    fcfpDict = 0x02,  // the file has compression dictionaries (kctgDict chunks)
+};
+
 // chunky file prefix
 struct CFP
 {
@@ -125,9 +212,95 @@ struct CFP
     FP fpMap;     // location of free space map
     long cbMap;   // size of free space map (may be 0)
 
-    long rglwReserved[23]; // reserved for future use - should be zero
+    FP fpJournal;   // location of the last journal record (0 if none)
+    long cbJournal; // size of the last journal record
+    long cbBase;    // size of the index and free map the journal applies to
+
+    FP fpPayload;   // location of the payload hashes (just before the index)
+    long cbPayload; // size of the payload hashes (may be 0)
+
+    ulong luIndexSum; // checksum of the index (see _LuSumIndex), 0 if none
+    bool fLarge;      // the file uses 64-bit file positions
+    bool fDict;       // the file has compression dictionaries
+};
+
+// journal record header. This is followed by a GG of changed CRPs, a GL
+// of the CKIs of deleted chunks and the free map (which may be empty).
+struct JRH
+{
+    short bo;          // byte order
+    short osk;         // which system wrote this
+    ulong luFpPrev;    // the previous journal record (0 if this is the first)
+    long cbPrev;       // size of the previous journal record
+    long cbCrp;        // size of the GG of changed CRPs
+    long cbCki;        // size of the GL of deleted CKIs
+    long cbMap;        // size of the free map
+    long lwFpPrevHigh; // large files only
+
+    FP FpPrev(void)
+    {
+        return (FP)lwFpPrevHigh << 32 | luFpPrev;
+    }
+    void SetFpPrev(FP fpT)
+    {
+        luFpPrev = (ulong)fpT;
+        lwFpPrevHigh = (long)(fpT >> 32);
+    }
+};
+const BOM kbomJrh = 0x5FFF0000L;
+const long kcbJrhSmallFile = size(JRH) - size(long);
+
+// the journal is folded into the index once it gets bigger than half the
+// index or this, whichever is bigger
+const long kcbMinJournalFold = 0x00004000;
+
+// payload index entry (see _pglpye)
+struct PYE
+{
+    FP fp;
+    long cb;
+    long ccrp;    // number of chunks using the data
+    ulong luHash; // hash of the data (if fHash)
+    FP fpNew;     // where FSave put the data
+    bool fOnExtra;
+    bool fHash;
+};
+
+// saved payload hash - the payload hashes are saved as a GL of these
+struct PYH
+{
+    ulong luFp;
+    long cb;
+    ulong luHash;
+    long lwFpHigh; // large files only
+
+    FP Fp(void)
+    {
+        return (FP)lwFpHigh << 32 | luFp;
+    }
+    void SetFp(FP fpT)
+    {
+        luFp = (ulong)fpT;
+        lwFpHigh = (long)(fpT >> 32);
+    }
+};
+const BOM kbomPyh = 0xFF000000L;
+const long kcbPyhSmallFile = size(PYH) - size(long);
+
+// a compression dictionary registered with vpcodmUtil (see _pgldcte)
+struct DCTE
+{
+    CTG ctg;      // the chunk type the dictionary is for
+    ulong luDict; // the id vpcodmUtil knows it by
 };
-const BOM kbomCfp = 0xB55FFC00L;
+
+// initial value for _LuHashRgb and the buffer size used when hashing or
+// comparing data that isn't in memory
+const ulong kluHashSeed = 0x811C9DC5;
+const long kcbPayloadBuf = 1024;
+
+// data smaller than this isn't worth a payload index entry
+const long kcbMinPayload = 64;
 
 // free space map entry
 struct FSM
@@ -135,7 +308,26 @@ struct FSM
     FP fp;
     long cb;
 };
-const BOM kbomFsm = 0xF0000000L;
+
+// free space map entry, as saved in the file
+struct FSMF
+{
+    ulong luFp;
+    long cb;
+    long lwFpHigh; // large files only
+
+    FP Fp(void)
+    {
+        return (FP)lwFpHigh << 32 | luFp;
+    }
+    void SetFp(FP fpT)
+    {
+        luFp = (ulong)fpT;
+        lwFpHigh = (long)(fpT >> 32);
+    }
+};
+const BOM kbomFsmf = 0xFC000000L;
+const long kcbFsmfSmallFile = size(FSMF) - size(long);
 
 enum
 {
@@ -153,7 +345,7 @@ const long kcbMaxCrpbg = klwMax;
 struct CRPBG
 {
     CKI cki;      // chunk id
-    FP fp;        // location on file
+    ulong luFp;   // location on file
     long cb;      // size of data on file
     long ckid;    // number of owned chunks
     long ccrpRef; // number of owners of this chunk
@@ -171,6 +363,17 @@ struct CRPBG
         // for cvn >= kcvnMinGrfcrp
         ulong grfcrp;
     };
+    long lwFpHigh; // high word of the location (saved in large files only)
+
+    FP Fp(void)
+    {
+        return (FP)lwFpHigh << 32 | luFp;
+    }
+    void SetFp(FP fpT)
+    {
+        luFp = (ulong)fpT;
+        lwFpHigh = (long)(fpT >> 32);
+    }
 
     long BvRgch(void)
     {
@@ -206,8 +409,8 @@ struct CRPBG
         cb = cbT;
     }
 };
-const BOM kbomCrpbgGrfcrp = 0xFFFF0000L;
-const BOM kbomCrpbgBytes = 0xFFFE0000L;
+const BOM kbomCrpbgGrfcrp = 0xFFFFC000L;
+const BOM kbomCrpbgBytes = 0xFFFEC000L;
 
 // Chunk Representation (small version) - fixed element in pggcrp
 // variable part of group element is an rgkid and stn data (the name)
@@ -217,10 +420,21 @@ const ulong kgrfcrpAll = (1 << kcbitGrfcrp) - 1;
 struct CRPSM
 {
     CKI cki;          // chunk id
-    FP fp;            // location on file
+    ulong luFp;       // location on file
     ulong luGrfcrpCb; // low byte is the grfcrp, high 3 bytes is cb
     ushort ckid;      // number of owned chunks
     ushort ccrpRef;   // number of owners of this chunk
+    long lwFpHigh;    // high word of the location (saved in large files only)
+
+    FP Fp(void)
+    {
+        return (FP)lwFpHigh << 32 | luFp;
+    }
+    void SetFp(FP fpT)
+    {
+        luFp = (ulong)fpT;
+        lwFpHigh = (long)(fpT >> 32);
+    }
 
     long BvRgch(void)
     {
@@ -256,7 +470,7 @@ struct CRPSM
         luGrfcrpCb = (cbT << kcbitGrfcrp) | luGrfcrpCb & kgrfcrpAll;
     }
 };
-const BOM kbomCrpsm = 0xFF500000L;
+const BOM kbomCrpsm = 0xFF5C0000L;
 
 #ifdef CHUNK_BIG_INDEX
 
@@ -278,10 +492,184 @@ const BOM kbomCrp = kbomCrpsm;
 
 #endif //! CHUNK_BIG_INDEX
 
+// small files don't save the high word of a CRP's location
+const long kcbCrpSmallFile = size(CRP) - size(long);
+
 #define _BvKid(ikid) LwMul(ikid, size(KID))
 
+// indices smaller than this are just binary searched
+const long kccrpMinHash = 64;
+
+// after the index changes, rebuild the hash table once there have been
+// (ccrp / kccrpPerFindRebuild) lookups
+const long kccrpPerFindRebuild = 8;
+
+/***************************************************************************
+    Hash a (ctg, cno) pair for the index hash table.
+***************************************************************************/
+priv long _LwHashCki(CTG ctg, CNO cno)
+{
+    ulong lu = (ulong)ctg * 0x9E3779B1 + (ulong)cno;
+
+    lu ^= lu >> 15;
+    lu *= 0x85EBCA6B;
+    lu ^= lu >> 13;
+    return (long)(lu & klwMax);
+}
+
+/***************************************************************************
+    Hash the bytes for the payload index (FNV-1a). To hash data in pieces,
+    pass the result for one piece as luHash for the next.
+***************************************************************************/
+priv ulong _LuHashRgb(void *pv, long cb, ulong luHash)
+{
+    AssertIn(cb, 0, kcbMax);
+    AssertPvCb(pv, cb);
+    byte *pb, *pbLim;
+
+    for (pb = (byte *)pv, pbLim = pb + cb; pb < pbLim; pb++)
+        luHash = (luHash ^ *pb) * 0x01000193;
+    return luHash;
+}
+
+/***************************************************************************
+    Hash the data that's about to be written to a chunk. The data comes
+    from pv if it's not nil, otherwise from pblckSrc.
+***************************************************************************/
+priv bool _FHashData(long cb, PBLCK pblckSrc, void *pv, ulong *pluHash)
+{
+    AssertIn(cb, 0, kcbMax);
+    AssertVarMem(pluHash);
+    byte rgb[kcbPayloadBuf];
+    long ib, cbT;
+
+    if (pvNil != pv)
+    {
+        AssertPvCb(pv, cb);
+        *pluHash = _LuHashRgb(pv, cb, kluHashSeed);
+        return fTrue;
+    }
+
+    AssertPo(pblckSrc, 0);
+    *pluHash = kluHashSeed;
+    for (ib = 0; ib < cb; ib += cbT)
+    {
+        cbT = LwMin(cb - ib, size(rgb));
+        if (!pblckSrc->FReadRgb(rgb, cbT, ib, fTrue))
+            return fFalse;
+        *pluHash = _LuHashRgb(rgb, cbT, *pluHash);
+    }
+    return fTrue;
+}
+
+/***************************************************************************
+    Return whether the data at *pflo matches the data in pv (if it's not
+    nil) or pblckSrc.
+***************************************************************************/
+priv bool _FEqualData(PFLO pflo, PBLCK pblckSrc, void *pv)
+{
+    AssertPo(pflo, 0);
+    byte rgb[kcbPayloadBuf];
+    byte rgbSrc[kcbPayloadBuf];
+    long ib, cbT;
+
+    for (ib = 0; ib < pflo->cb; ib += cbT)
+    {
+        cbT = LwMin(pflo->cb - ib, size(rgb));
+        if (!pflo->FReadRgb(rgb, cbT, ib))
+            return fFalse;
+        if (pvNil != pv)
+        {
+            if (!FEqualRgb(rgb, (byte *)pv + ib, cbT))
+                return fFalse;
+        }
+        else if (!pblckSrc->FReadRgb(rgbSrc, cbT, ib, fTrue) || !FEqualRgb(rgb, rgbSrc, cbT))
+            return fFalse;
+    }
+    return fTrue;
+}
+
+/***************************************************************************
+    Compare two payload entries, either by (fOnExtra, fp) or by
+    (luHash, fOnExtra, fp).
+***************************************************************************/
+priv bool _FPyeLess(PYE *ppye1, PYE *ppye2, bool fByHash)
+{
+    if (fByHash && ppye1->luHash != ppye2->luHash)
+        return ppye1->luHash < ppye2->luHash;
+    if (FPure(ppye1->fOnExtra) != FPure(ppye2->fOnExtra))
+        return !ppye1->fOnExtra;
+    return ppye1->fp < ppye2->fp;
+}
+
+/***************************************************************************
+    Find where *ppye goes in a GL of PYEs sorted by _FPyeLess.
+***************************************************************************/
+priv long _IpyeFind(PGL pglpye, PYE *ppye, bool fByHash)
+{
+    AssertPo(pglpye, 0);
+    long ipye, ipyeMin, ipyeLim;
+
+    for (ipyeMin = 0, ipyeLim = pglpye->IvMac(); ipyeMin < ipyeLim;)
+    {
+        ipye = (ipyeMin + ipyeLim) / 2;
+        if (_FPyeLess((PYE *)pglpye->QvGet(ipye), ppye, fByHash))
+            ipyeMin = ipye + 1;
+        else
+            ipyeLim = ipye;
+    }
+    return ipyeMin;
+}
+
+/***************************************************************************
+    Sift prgpye[ipye] down the heap prgpye[0, cpye).
+***************************************************************************/
+priv void _SiftPye(PYE *prgpye, long ipye, long cpye, bool fByHash)
+{
+    long ipyeChild;
+    PYE pye = prgpye[ipye];
+
+    for (;;)
+    {
+        ipyeChild = 2 * ipye + 1;
+        if (ipyeChild >= cpye)
+            break;
+        if (ipyeChild + 1 < cpye && _FPyeLess(&prgpye[ipyeChild], &prgpye[ipyeChild + 1], fByHash))
+            ipyeChild++;
+        if (!_FPyeLess(&pye, &prgpye[ipyeChild], fByHash))
+            break;
+        prgpye[ipye] = prgpye[ipyeChild];
+        ipye = ipyeChild;
+    }
+    prgpye[ipye] = pye;
+}
+
+/***************************************************************************
+    Heap sort a GL of PYEs using _FPyeLess.
+***************************************************************************/
+priv void _SortPglpye(PGL pglpye, bool fByHash)
+{
+    AssertPo(pglpye, 0);
+    long ipye, cpye;
+    PYE *prgpye;
+
+    if ((cpye = pglpye->IvMac()) < 2)
+        return;
+
+    prgpye = (PYE *)pglpye->PvLock(0);
+    for (ipye = cpye / 2; ipye-- > 0;)
+        _SiftPye(prgpye, ipye, cpye, fByHash);
+    while (--cpye > 0)
+    {
+        SwapVars(&prgpye[0], &prgpye[cpye]);
+        _SiftPye(prgpye, 0, cpye, fByHash);
+    }
+    pglpye->Unlock();
+}
+
 const long rtiNil = 0; // no rti assigned
 long CFL::_rtiLast = rtiNil;
+long CFL::_cactIndexAll;
 PCFL CFL::_pcflFirst;
 
 #ifdef CHUNK_STATS
@@ -322,6 +710,26 @@ void CFL::DumpStn(PSTN pstn, PFIL pfil)
 RTCLASS(CFL)
 RTCLASS(CGE)
 
+/***************************************************************************
+    Release the dictionaries in a DCTE list and free the list.
+***************************************************************************/
+priv void _ReleasePgldcte(PGL *ppgldcte)
+{
+    AssertVarMem(ppgldcte);
+
+    long idcte;
+    DCTE dcte;
+
+    if (pvNil == *ppgldcte)
+        return;
+    for (idcte = (*ppgldcte)->IvMac(); idcte-- > 0;)
+    {
+        (*ppgldcte)->Get(idcte, &dcte);
+        vpcodmUtil->ReleaseDict(dcte.luDict);
+    }
+    ReleasePpo(ppgldcte);
+}
+
 /***************************************************************************
     Constructor for CFL - private.
 ***************************************************************************/
@@ -340,9 +748,15 @@ CFL::~CFL(void)
     AssertBaseThis(0);
     ReleasePpo(&_csto.pfil);
     ReleasePpo(&_csto.pglfsm);
+    ReleasePpo(&_csto.pglfsmCb);
     ReleasePpo(&_cstoExtra.pfil);
     ReleasePpo(&_cstoExtra.pglfsm);
+    ReleasePpo(&_cstoExtra.pglfsmCb);
     ReleasePpo(&_pggcrp);
+    _ReleaseIndexHash();
+    _ReleaseJournal();
+    _ReleasePayloads();
+    _ReleasePgldcte(&_pgldcte);
 #ifndef CHUNK_BIG_INDEX
     ReleasePpo(&_pglrtie);
 #endif //! CHUNK_BIG_INDEX
@@ -357,6 +771,7 @@ PCFL CFL::PcflOpen(FNI *pfni, ulong grfcfl)
     AssertPo(pfni, ffniFile);
     PCFL pcfl;
     ulong grffil;
+    ulong tsStart;
 
     Assert(!(grfcfl & fcflTemp), "can't open a file as temp");
     if (pvNil != (pcfl = PcflFromFni(pfni)))
@@ -371,21 +786,38 @@ PCFL CFL::PcflOpen(FNI *pfni, ulong grfcfl)
     if ((pcfl = NewObj CFL()) == pvNil)
         goto LFail;
 
-    if ((pcfl->_csto.pfil = FIL::PfilOpen(pfni, grffil)) == pvNil || !pcfl->_FReadIndex())
-    {
+    if ((pcfl->_csto.pfil = FIL::PfilOpen(pfni, grffil)) == pvNil)
         goto LFail;
-    }
-    if (tYes != pcfl->_TValidIndex())
+
+    // map the file before reading the index so the index comes from the
+    // view too. Failing to map isn't fatal.
+    if ((grfcfl & (fcflMapped | fcflWriteEnable)) == fcflMapped)
+        pcfl->_csto.pfil->FMap();
+
+    tsStart = TsCurrentPrecise();
+    if (!pcfl->_FReadIndex())
+        goto LFail;
+    // only read-only content opens trust the index checksum
+    if (!pcfl->_FCheckIndex((grfcfl & fcflValidate) || (grfcfl & (fcflMapped | fcflWriteEnable)) != fcflMapped))
     {
     LFail:
         ReleasePpo(&pcfl);
         PushErc(ercCflOpen);
         return pvNil;
     }
+    pcfl->_dtsOpen = TsCurrentPrecise() - tsStart;
     AssertDo(pcfl->FSetGrfcfl(grfcfl), 0);
 
+    // without its dictionaries, some of the data can't be unpacked
+    if (pcfl->_fDict && !pcfl->_FLoadDicts())
+    {
+        ReleasePpo(&pcfl);
+        PushErc(ercCflOpen);
+        return pvNil;
+    }
+
     // We don't assert with fcflGraph, because we've already
-    // called _TValidIndex.
+    // called _TValidIndex (or the index checksum matched).
     AssertPo(pcfl, fcflFull);
     return pcfl;
 }
@@ -398,18 +830,22 @@ bool CFL::FReopen(void)
 {
     AssertThis(0);
     CSTO csto, cstoExtra;
+    JRNS jrns;
     PGG pggcrp;
+    PGL pglpye, pglpyeHash;
 #ifndef CHUNK_BIG_INDEX
     PGL pglrtie;
 #endif // CHUNK_BIG_INDEX
     bool fFreeMapNotRead;
     bool fRet;
+    ulong tsStart;
 
     if (_csto.pfil->GrffilCur() & ffilWriteEnable || _fInvalidMainFile)
         return fFalse;
 
     pggcrp = _pggcrp;
     _pggcrp = pvNil;
+    _ReleaseIndexHash();
 
 #ifndef CHUNK_BIG_INDEX
     pglrtie = _pglrtie;
@@ -427,7 +863,16 @@ bool CFL::FReopen(void)
     cstoExtra = _cstoExtra;
     ClearPb(&_cstoExtra, size(cstoExtra));
 
-    fRet = _FReadIndex() && tYes == _TValidIndex();
+    jrns = _jrns;
+    ClearPb(&_jrns, size(jrns));
+
+    pglpye = _pglpye;
+    pglpyeHash = _pglpyeHash;
+    _pglpye = _pglpyeHash = pvNil;
+
+    tsStart = TsCurrentPrecise();
+    fRet = _FReadIndex() && _FCheckIndex(!_csto.pfil->FMapped());
+    _dtsOpen = TsCurrentPrecise() - tsStart;
     if (!fRet)
     {
         SwapVars(&_pggcrp, &pggcrp);
@@ -436,16 +881,31 @@ bool CFL::FReopen(void)
 #endif // CHUNK_BIG_INDEX
         SwapVars(&_csto, &csto);
         SwapVars(&_cstoExtra, &cstoExtra);
+        SwapVars(&_jrns, &jrns);
+        SwapVars(&_pglpye, &pglpye);
+        SwapVars(&_pglpyeHash, &pglpyeHash);
         _fFreeMapNotRead = FPure(fFreeMapNotRead);
+        _ReleaseIndexHash();
     }
+    _NoteIndexChange();
     ReleasePpo(&pggcrp);
 #ifndef CHUNK_BIG_INDEX
     ReleasePpo(&pglrtie);
 #endif // CHUNK_BIG_INDEX
     ReleasePpo(&csto.pfil);
     ReleasePpo(&csto.pglfsm);
+    ReleasePpo(&csto.pglfsmCb);
     ReleasePpo(&cstoExtra.pfil);
     ReleasePpo(&cstoExtra.pglfsm);
+    ReleasePpo(&cstoExtra.pglfsmCb);
+    ReleasePpo(&jrns.pglckiDirty);
+    ReleasePpo(&jrns.pglfsmIndex);
+    ReleasePpo(&pglpye);
+    ReleasePpo(&pglpyeHash);
+
+    // the dictionaries may have changed along with the rest of the file
+    if (fRet && _fDict && !_FLoadDicts())
+        Warn("couldn't reload dictionaries");
 
     AssertThis(0);
     return fRet;
@@ -490,14 +950,15 @@ PCFL CFL::PcflCreate(FNI *pfni, ulong grfcfl)
         goto LFail;
 
     if ((pcfl->_pggcrp = GG::PggNew(size(CRP))) == pvNil ||
-        (pcfl->_csto.pfil = FIL::PfilCreate(pfni, grffil)) == pvNil || !pcfl->_csto.pfil->FSetFpMac(size(CFP)))
+        (pcfl->_csto.pfil = FIL::PfilCreate(pfni, grffil)) == pvNil || !pcfl->_csto.pfil->FSetFpMac(size(CFPF)))
     {
         ReleasePpo(&pcfl);
     LFail:
         PushErc(ercCflCreate);
         return pvNil;
     }
-    pcfl->_csto.fpMac = size(CFP);
+    pcfl->_pggcrp->SetGapped(fTrue);
+    pcfl->_csto.fpMac = size(CFPF);
     AssertDo(pcfl->FSetGrfcfl(grfcfl), 0);
 
     AssertPo(pcfl, fcflFull | fcflGraph);
@@ -647,11 +1108,75 @@ bool CFL::FWriteChunkTree(CTG ctg, CNO cno, PFIL pfilDst, FP fpDst, long *pcb)
     return fTrue;
 }
 
+// a packed chunk of a forest being copied (see PcflReadForestFromFlo)
+struct FPC
+{
+    CKI cki;
+    FP fpSrc;
+    long cbSrc;
+};
+
+// the packed chunks of a copied forest are decompressed this many at a time
+const long kcfpcBatch = 64;
+
+/***************************************************************************
+    Put the data of the packed chunks of a forest in pcfl, where they were
+    added empty. The chunks are decompressed a batch at a time by
+    vpcodmUtil->FDecompressRghq, which spreads the work across the
+    available processors. If a batch won't decompress, its chunks are put
+    in as they are (still packed).
+***************************************************************************/
+priv bool _FPutForestPacked(PCFL pcfl, PFIL pfilSrc, PGL pglfpc)
+{
+    AssertPo(pcfl, 0);
+    AssertPo(pfilSrc, 0);
+    AssertPo(pglfpc, 0);
+    long ifpcMin, ihq, chq;
+    bool fPacked;
+    FPC fpc;
+    FLO flo;
+    HQ rghq[kcfpcBatch];
+    bool fRet = fFalse;
+
+    ClearPb(rghq, size(rghq));
+    flo.pfil = pfilSrc;
+    for (ifpcMin = 0; ifpcMin < pglfpc->IvMac(); ifpcMin += chq)
+    {
+        chq = LwMin(kcfpcBatch, pglfpc->IvMac() - ifpcMin);
+        for (ihq = 0; ihq < chq; ihq++)
+        {
+            pglfpc->Get(ifpcMin + ihq, &fpc);
+            flo.fp = fpc.fpSrc;
+            flo.cb = fpc.cbSrc;
+            if (!flo.FReadHq(&rghq[ihq]))
+                goto LFail;
+        }
+
+        fPacked = !vpcodmUtil->FDecompressRghq(rghq, chq);
+        for (ihq = 0; ihq < chq; ihq++)
+        {
+            BLCK blck(&rghq[ihq], fPacked);
+
+            pglfpc->Get(ifpcMin + ihq, &fpc);
+            if (!pcfl->FPutBlck(&blck, fpc.cki.ctg, fpc.cki.cno))
+                goto LFail;
+        }
+    }
+    fRet = fTrue;
+
+LFail:
+    for (ihq = 0; ihq < kcfpcBatch; ihq++)
+        FreePhq(&rghq[ihq]);
+    return fRet;
+}
+
 /***************************************************************************
     Static method to read a serialized chunk stream (as written by a series
     of calls to FWriteChunkTree) and create a CFL around it. If fCopyData
     is false, we construct the CFL to use pointers to the data in the FLO.
-    Otherwise, we copy the data to a new file.
+    Otherwise, we copy the data to a new file. The copy is stored unpacked:
+    the packed chunks are decompressed together (see _FPutForestPacked)
+    instead of one at a time whenever they're read.
 ***************************************************************************/
 PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
 {
@@ -666,28 +1191,33 @@ PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
         long ckid;
     };
 
-    PCFL pcfl;
+    PCFL pcfl = pvNil;
     ECDF ecdf;
     ECSD ecsdT, ecsdCur;
     FP fpSrc, fpLimSrc;
+    FPC fpc;
     PGL pglecsd = pvNil;
+    PGL pglfpc = pvNil;
 
     if (pvNil == (pglecsd = GL::PglNew(size(ECSD))))
         goto LFail;
+    if (fCopyData && pvNil == (pglfpc = GL::PglNew(size(FPC))))
+        goto LFail;
 
     if ((pcfl = NewObj CFL()) == pvNil)
         goto LFail;
 
     if (pvNil == (pcfl->_pggcrp = GG::PggNew(size(CRP))))
         goto LFail;
+    pcfl->_pggcrp->SetGapped(fTrue);
 
     if (fCopyData)
     {
-        if (pvNil == (pcfl->_csto.pfil = FIL::PfilCreateTemp()) || !pcfl->_csto.pfil->FSetFpMac(size(CFP)))
+        if (pvNil == (pcfl->_csto.pfil = FIL::PfilCreateTemp()) || !pcfl->_csto.pfil->FSetFpMac(size(CFPF)))
         {
             goto LFail;
         }
-        pcfl->_csto.fpMac = size(CFP);
+        pcfl->_csto.fpMac = size(CFPF);
     }
     else
     {
@@ -719,10 +1249,22 @@ PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
         else if (kboCur != ecdf.bo)
             goto LFail;
 
-        if (!FIn(ecdf.cb, 0, fpLimSrc - fpSrc + 1))
+        if (!FInFp(ecdf.cb, 0, fpLimSrc - fpSrc + 1))
             goto LFail;
 
-        if (fCopyData)
+        if (fCopyData && (ecdf.grfcrp & fcrpPacked) && ecdf.cb > 0)
+        {
+            // add it empty - _FPutForestPacked fills it in
+            if (!pcfl->FAdd(0, ecdf.ctg, &ecsdT.cno))
+                goto LFail;
+            fpc.cki.ctg = ecdf.ctg;
+            fpc.cki.cno = ecsdT.cno;
+            fpc.fpSrc = fpSrc;
+            fpc.cbSrc = ecdf.cb;
+            if (!pglfpc->FAdd(&fpc))
+                goto LFail;
+        }
+        else if (fCopyData)
         {
             BLCK blck(pflo->pfil, fpSrc, ecdf.cb, ecdf.grfcrp & fcrpPacked);
 
@@ -739,7 +1281,7 @@ PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
                 goto LFail;
 
             qcrp = (CRP *)pcfl->_pggcrp->QvFixedGet(icrp);
-            qcrp->fp = ecdf.cb > 0 ? fpSrc : 0;
+            qcrp->SetFp(ecdf.cb > 0 ? fpSrc : 0);
             qcrp->SetCb(ecdf.cb);
             qcrp->AssignGrfcrp(ecdf.grfcrp, fcrpPacked | fcrpForest);
         }
@@ -778,7 +1320,8 @@ PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
         }
     }
 
-    if (pglecsd->IvMac() > 0 || ecsdCur.ckid != 0)
+    if (pglecsd->IvMac() > 0 || ecsdCur.ckid != 0 ||
+        pvNil != pglfpc && !_FPutForestPacked(pcfl, pflo->pfil, pglfpc))
     {
     LFail:
         // something failed or the data was bad
@@ -786,6 +1329,7 @@ PCFL CFL::PcflReadForestFromFlo(PFLO pflo, bool fCopyData)
     }
 
     ReleasePpo(&pglecsd);
+    ReleasePpo(&pglfpc);
     AssertNilOrPo(pcfl, fcflFull | fcflGraph);
 
     return pcfl;
@@ -833,6 +1377,7 @@ void CFL::SetForest(CTG ctg, CNO cno, bool fForest)
         else
             qcrp->ClearGrfcrp(fcrpForest);
         _FSetRti(ctg, cno, rtiNil);
+        _MarkDirty(icrp);
     }
 }
 
@@ -893,7 +1438,7 @@ void CFL::CloseUnmarked(void)
 
 /***************************************************************************
     Set the grfcfl options.  This sets or clears fcflTemp and only sets
-    (never clears) fcflMark, fcflWriteEnable and fcflAddToExtra.  This
+    (never clears) fcflMark, fcflWriteEnable, fcflAddToExtra and fcflLarge.  This
     can only fail if fcflWriteEnable is specified and we can't make
     the base file write enabled.
 ***************************************************************************/
@@ -929,6 +1474,15 @@ bool CFL::FSetGrfcfl(ulong grfcfl, ulong grfcflMask)
     if (grfcfl & fcflReadFromExtra)
         _fReadFromExtra = fTrue;
 
+    // once a file is large, it stays large
+    if (grfcfl & fcflLarge)
+        _fLarge = fTrue;
+
+    // map the file if asked to. This is a no-op if the file is write
+    // enabled (becoming write enabled drops the mapping).
+    if (grfcfl & fcflMapped)
+        _csto.pfil->FMap();
+
     return fTrue;
 }
 
@@ -999,7 +1553,7 @@ void CFL::AssertValid(ulong grfcfl)
     long cbVar, cbRgch;
     CRP crp;
     long ikid;
-    FP fpBase = _fInvalidMainFile ? 0 : size(CFP);
+    FP fpBase = _fInvalidMainFile ? 0 : size(CFPF);
 
     Assert(!_fInvalidMainFile || _fAddToExtra, 0);
 
@@ -1010,6 +1564,11 @@ void CFL::AssertValid(ulong grfcfl)
         AssertPo(_csto.pglfsm, 0);
         Assert(!_fFreeMapNotRead, "free map never read, but exists!");
     }
+    if (_csto.pglfsmCb != pvNil)
+    {
+        AssertPo(_csto.pglfsmCb, 0);
+        Assert(_csto.pglfsm != pvNil && _csto.pglfsmCb->IvMac() == _csto.pglfsm->IvMac(), "free maps out of sync");
+    }
     Assert(_csto.fpMac >= fpBase, "fpMac wrong");
 
     if (_cstoExtra.pfil != pvNil)
@@ -1017,13 +1576,28 @@ void CFL::AssertValid(ulong grfcfl)
         AssertPo(_cstoExtra.pfil, 0);
         if (_cstoExtra.pglfsm != pvNil)
             AssertPo(_cstoExtra.pglfsm, 0);
+        if (_cstoExtra.pglfsmCb != pvNil)
+        {
+            AssertPo(_cstoExtra.pglfsmCb, 0);
+            Assert(_cstoExtra.pglfsm != pvNil && _cstoExtra.pglfsmCb->IvMac() == _cstoExtra.pglfsm->IvMac(),
+                   "extra free maps out of sync");
+        }
     }
     else
-        Assert(_cstoExtra.pglfsm == pvNil, 0);
+        Assert(_cstoExtra.pglfsm == pvNil && _cstoExtra.pglfsmCb == pvNil, 0);
 
 #ifndef CHUNK_BIG_INDEX
     AssertNilOrPo(_pglrtie, 0);
 #endif //! CHUNK_BIG_INDEX
+    AssertNilOrPo(_pglicrpHash, 0);
+    AssertNilOrPo(_pglctgr, 0);
+    Assert((pvNil == _pglicrpHash) == (pvNil == _pglctgr), "half built index hash");
+    AssertNilOrPo(_jrns.pglckiDirty, 0);
+    AssertNilOrPo(_jrns.pglfsmIndex, 0);
+    Assert(pvNil == _jrns.pglckiDirty || pvNil != _jrns.pglfsmIndex, "journal without index space");
+    AssertNilOrPo(_pglpye, 0);
+    AssertNilOrPo(_pglpyeHash, 0);
+    AssertNilOrPo(_pgldcte, 0);
 
     if (!(grfcfl & (fcflFull | fcflGraph)))
         return;
@@ -1050,6 +1624,7 @@ void CFL::AssertValid(ulong grfcfl)
 
         ckiNew = crp.cki;
         ccrpRefTot += crp.ccrpRef;
+        Assert(_FFindCtgCno(ckiNew.ctg, ckiNew.cno, &icrpT) && icrpT == icrp, "index lookup failed");
         ckidTot += crp.ckid;
 
 #ifdef CHUNK_BIG_INDEX
@@ -1060,15 +1635,15 @@ void CFL::AssertValid(ulong grfcfl)
         if (crp.Grfcrp(fcrpOnExtra))
         {
             Assert(_cstoExtra.pfil != pvNil, "fcrpOnExtra wrong");
-            AssertIn(crp.fp, 0, _cstoExtra.fpMac);
-            AssertIn(crp.Cb(), 1, _cstoExtra.fpMac - crp.fp + 1);
+            Assert(FInFp(crp.Fp(), 0, _cstoExtra.fpMac), "bad fp");
+            Assert(FInFp(crp.Cb(), 1, _cstoExtra.fpMac - crp.Fp() + 1), "bad cb");
             cbTotExtra += crp.Cb();
         }
         else
         {
-            AssertVar(crp.Cb() > 0 && (crp.fp >= fpBase) || crp.Cb() == 0 && crp.fp == 0, "bad fp", &crp.fp);
-            AssertVar(crp.fp <= _csto.fpMac, "bad fp", &crp.fp);
-            AssertIn(crp.Cb(), 0, _csto.fpMac - crp.fp + 1);
+            Assert(crp.Cb() > 0 && (crp.Fp() >= fpBase) || crp.Cb() == 0 && crp.Fp() == 0, "bad fp");
+            Assert(crp.Fp() <= _csto.fpMac, "bad fp");
+            Assert(FInFp(crp.Cb(), 0, _csto.fpMac - crp.Fp() + 1), "bad cb");
             cbTot += crp.Cb();
         }
 
@@ -1093,6 +1668,32 @@ void CFL::AssertValid(ulong grfcfl)
         }
     }
     Assert(ccrpRefTot == ckidTot, "ref counts messed up");
+
+    // shared data is counted once for each chunk using it
+    if (pvNil != _pglpye)
+    {
+        long ipye;
+        long cpyeHash = 0;
+        PYE pye, pyeOld;
+
+        for (ipye = 0; ipye < _pglpye->IvMac(); ipye++)
+        {
+            _pglpye->Get(ipye, &pye);
+            Assert(pye.cb > 0 && pye.ccrp > 0 && (pye.ccrp > 1 || pye.fHash), "bad pye");
+            Assert(ipye == 0 || _FPyeLess(&pyeOld, &pye, fFalse), "pye's not sorted");
+            if (pye.fOnExtra)
+                cbTotExtra -= LwMul(pye.ccrp - 1, pye.cb);
+            else
+                cbTot -= LwMul(pye.ccrp - 1, pye.cb);
+            if (pye.fHash)
+                cpyeHash++;
+            pyeOld = pye;
+        }
+        Assert(cpyeHash == (pvNil == _pglpyeHash ? 0 : _pglpyeHash->IvMac()), "payload indices out of sync");
+    }
+    else
+        Assert(pvNil == _pglpyeHash || _pglpyeHash->IvMac() == 0, "payload indices out of sync");
+
     Assert(cbTotExtra <= _cstoExtra.fpMac, "overlapping chunks on extra");
     Assert(cbTot <= _csto.fpMac - fpBase, "overlapping chunks on file");
 
@@ -1168,7 +1769,16 @@ void CFL::MarkMem(void)
     CFL_PAR::MarkMem();
     MarkMemObj(_pggcrp);
     MarkMemObj(_csto.pglfsm);
+    MarkMemObj(_csto.pglfsmCb);
     MarkMemObj(_cstoExtra.pglfsm);
+    MarkMemObj(_cstoExtra.pglfsmCb);
+    MarkMemObj(_pglicrpHash);
+    MarkMemObj(_pglctgr);
+    MarkMemObj(_jrns.pglckiDirty);
+    MarkMemObj(_jrns.pglfsmIndex);
+    MarkMemObj(_pglpye);
+    MarkMemObj(_pglpyeHash);
+    MarkMemObj(_pgldcte);
 #ifndef CHUNK_BIG_INDEX
     MarkMemObj(_pglrtie);
 #endif //! CHUNK_BIG_INDEX
@@ -1313,86 +1923,149 @@ tribool CFL::_TValidIndex(void)
 }
 
 /***************************************************************************
-    Verifies that this is a chunky file and reads the index into memory.
-    Sets the _fpFreeMap and _cbFreeMap fields and sets the _fFreeMapNotRead
-    flag. The free map is read separately by _ReadFreeMap. This is to avoid
-    hogging memory for the free map when we may never need it.
+    Checksum the parts of the index that _TValidIndex looks at. This works
+    on native longs, so the byte order of the file doesn't matter. Each
+    step is invertible, so changing any one long always changes the sum.
 ***************************************************************************/
-bool CFL::_FReadIndex(void)
+priv ulong _LuSumIndex(PGG pggcrp)
 {
-    AssertBaseThis(0);
-    AssertPo(_csto.pfil, 0);
-    Assert(!_fInvalidMainFile, 0);
+    AssertPo(pggcrp, 0);
+    CRP *qcrp;
+    KID *qkid;
+    long icrp, ikid, cbVar;
+    ulong luSum = kluHashSeed;
+
+#define _SumLu(lu) (luSum = (luSum ^ (ulong)(lu)) * 0x01000193)
+    for (icrp = 0; icrp < pggcrp->IvMac(); icrp++)
+    {
+        qcrp = (CRP *)pggcrp->QvFixedGet(icrp, &cbVar);
+        _SumLu(qcrp->cki.ctg);
+        _SumLu(qcrp->cki.cno);
+        _SumLu(qcrp->ckid);
+        _SumLu(qcrp->ccrpRef);
+        _SumLu(cbVar);
+        if (qcrp->ckid == 0)
+            continue;
+        qkid = (KID *)pggcrp->QvGet(icrp);
+        for (ikid = 0; ikid < qcrp->ckid; ikid++, qkid++)
+        {
+            _SumLu(qkid->cki.ctg);
+            _SumLu(qkid->cki.cno);
+            _SumLu(qkid->chid);
+        }
+    }
+    _SumLu(pggcrp->IvMac());
+#undef _SumLu
 
-    CFP cfp;
-    FP fpMac;
-    short bo;
-    short osk;
-    long cbVar;
-    long cbRgch;
-    long icrp, ccrp;
-    long cbFixed;
-    BOM bom;
+    return luSum;
+}
 
-    // used for old name stuff
-    SZS szsName;
-    STN stn;
-    bool fOldNames;
+/***************************************************************************
+    Check the index just read from the file. Unless fFull is set, the full
+    check is skipped if the index matches the checksum saved with it. The
+    checksum only catches accidental damage (anyone can compute it), so
+    callers only skip the check for read-only content files. Documents,
+    which can come from anywhere, always get the full check.
+***************************************************************************/
+bool CFL::_FCheckIndex(bool fFull)
+{
+    AssertBaseThis(0);
+    AssertPo(_pggcrp, 0);
+    ulong tsStart;
+    tribool tRet;
 
-    // used for old index stuff
-    bool fOldIndex;
+    if (!fFull && 0 != _luIndexSum && _luIndexSum == _LuSumIndex(_pggcrp))
+    {
+        _fValidated = fFalse;
+        _dtsValidate = 0;
+        return fTrue;
+    }
 
-    Assert(_pggcrp == pvNil && _csto.pglfsm == pvNil && _cstoExtra.pfil == pvNil && _cstoExtra.pglfsm == pvNil,
-           "cfl has wrong non-nil entries");
+    tsStart = TsCurrentPrecise();
+    tRet = _TValidIndex();
+    _dtsValidate = TsCurrentPrecise() - tsStart;
+    _fValidated = fTrue;
+    return tYes == tRet;
+}
 
-    // verify that this is a chunky file
-    if ((fpMac = _csto.pfil->FpMac()) < size(CFP))
-        return fFalse;
+/***************************************************************************
+    Copy an index saved without the high words of the CRP locations (by a
+    small file or an older version) to one with full CRPs. The high words
+    are zero.
+***************************************************************************/
+priv bool _FWidenIndex(PGG *ppggcrp)
+{
+    AssertVarMem(ppggcrp);
+    AssertPo(*ppggcrp, 0);
+
+    PGG pggcrp = *ppggcrp;
+    PGG pggcrpNew;
+    long icrp;
+    long cbFixed = pggcrp->CbFixed();
+    byte rgb[size(CRPBG)];
 
-    if (!_csto.pfil->FReadRgb(&cfp, size(cfp), 0))
+    AssertIn(cbFixed, 0, size(rgb) - size(long) + 1);
+    if (pvNil == (pggcrpNew = GG::PggNew(cbFixed + size(long), pggcrp->IvMac())))
         return fFalse;
 
-    // check the magic number and byte order indicator
-    if (cfp.lwMagic != klwMagicChunky || cfp.bo != kboCur && cfp.bo != kboOther)
+    ClearPb(rgb, size(rgb));
+    pggcrp->Lock();
+    for (icrp = 0; icrp < pggcrp->IvMac(); icrp++)
     {
-        return fFalse;
+        CopyPb(pggcrp->QvFixedGet(icrp), rgb, cbFixed);
+        if (!pggcrpNew->FAdd(pggcrp->Cb(icrp), pvNil, pggcrp->QvGet(icrp), rgb))
+        {
+            pggcrp->Unlock();
+            ReleasePpo(&pggcrpNew);
+            return fFalse;
+        }
     }
+    pggcrp->Unlock();
 
-    if (cfp.bo == kboOther)
-        SwapBytesBom(&cfp, kbomCfp);
-
-    // check the version numbers
-    if (!cfp.dver.FReadable(kcvnCur, kcvnMin))
-        return fFalse;
+    ReleasePpo(ppggcrp);
+    *ppggcrp = pggcrpNew;
+    return fTrue;
+}
 
-    // if the file has old style chunk names, translate them
-    fOldNames = cfp.dver._swCur < kcvnMinStnNames;
+/***************************************************************************
+    Byte swap, validate and clean up an index (or journal of index changes)
+    just read from the file, converting it to the current CRP type if
+    needed. If this fails, the index is freed.
+***************************************************************************/
+priv bool _FCleanIndex(PGG *ppggcrp, short bo, bool fOldIndex, bool fOldNames)
+{
+    AssertVarMem(ppggcrp);
+    AssertPo(*ppggcrp, 0);
 
-    // whether the index needs converted
-    fOldIndex = cfp.dver._swCur < kcvnMinGrfcrp;
+    PGG pggcrp;
+    long cbVar;
+    long cbRgch;
+    long icrp, ccrp;
+    long cbFixed;
+    BOM bom;
 
-    // verify the fp's and cb's
-    // the index and map should be last
-    if (!FIn(cfp.fpMac, size(cfp), fpMac + 1) || !FIn(cfp.fpIndex, size(cfp), cfp.fpMac + 1) ||
-        !FIn(cfp.cbIndex, 1, cfp.fpMac - cfp.fpIndex + 1) || cfp.fpMap != cfp.fpIndex + cfp.cbIndex ||
-        cfp.fpMap + cfp.cbMap != cfp.fpMac)
-    {
-        return fFalse;
-    }
+    // used for old name stuff
+    SZS szsName;
+    STN stn;
 
-    // read and validate the index
-    if ((_pggcrp = GG::PggRead(_csto.pfil, cfp.fpIndex, cfp.cbIndex, &bo, &osk)) == pvNil)
+    cbFixed = (*ppggcrp)->CbFixed();
+    if (cbFixed == size(CRPBG) - size(long) || cbFixed == size(CRPSM) - size(long))
     {
-        return fFalse;
+        if (!_FWidenIndex(ppggcrp))
+        {
+            ReleasePpo(ppggcrp);
+            return fFalse;
+        }
+        cbFixed += size(long);
     }
+    pggcrp = *ppggcrp;
 
-    cbFixed = _pggcrp->CbFixed();
     if (cbFixed != size(CRPBG) && (fOldIndex || cbFixed != size(CRPSM)))
         return fFalse;
 
     // Clean the index
     AssertBomRglw(kbomKid, size(KID));
-    _pggcrp->Lock();
+    pggcrp->Lock();
 
     if (cbFixed == size(CRPBG))
     {
@@ -1401,9 +2074,9 @@ bool CFL::_FReadIndex(void)
 
         bom = (bo != kboCur) ? (fOldIndex ? kbomCrpbgBytes : kbomCrpbgGrfcrp) : bomNil;
 
-        for (icrp = _pggcrp->IvMac(); icrp-- != 0;)
+        for (icrp = pggcrp->IvMac(); icrp-- != 0;)
         {
-            pcrpbg = (CRPBG *)_pggcrp->QvFixedGet(icrp, &cbVar);
+            pcrpbg = (CRPBG *)pggcrp->QvFixedGet(icrp, &cbVar);
 #ifndef CHUNK_BIG_INDEX
             // make sure we can convert this CRP to a small index CRP
             if (pcrpbg->cb > kcbMaxCrpsm || pcrpbg->ckid > kckidMax || pcrpbg->ccrpRef > kckidMax)
@@ -1421,7 +2094,7 @@ bool CFL::_FReadIndex(void)
             }
             if (bomNil != bom && pcrpbg->ckid > 0)
             {
-                SwapBytesRglw(_pggcrp->QvGet(icrp), pcrpbg->ckid * (size(KID) / size(long)));
+                SwapBytesRglw(pggcrp->QvGet(icrp), pcrpbg->ckid * (size(KID) / size(long)));
             }
             pcrpbg->rti = rtiNil;
 
@@ -1452,33 +2125,33 @@ bool CFL::_FReadIndex(void)
                 {
                     long cbNew;
 
-                    CopyPb(PvAddBv(_pggcrp->QvGet(icrp), bvRgch), szsName, cbRgch);
+                    CopyPb(PvAddBv(pggcrp->QvGet(icrp), bvRgch), szsName, cbRgch);
                     szsName[cbRgch] = 0;
                     stn.SetSzs(szsName);
                     cbNew = stn.CbData();
                     if (cbRgch != cbNew)
                     {
-                        _pggcrp->Unlock();
+                        pggcrp->Unlock();
                         if (cbRgch < cbNew)
                         {
-                            if (!_pggcrp->FInsertRgb(icrp, bvRgch, cbNew - cbRgch, pvNil))
+                            if (!pggcrp->FInsertRgb(icrp, bvRgch, cbNew - cbRgch, pvNil))
                             {
                                 goto LNukeName;
                             }
                         }
                         else
-                            _pggcrp->DeleteRgb(icrp, bvRgch, cbRgch - cbNew);
-                        _pggcrp->Lock();
+                            pggcrp->DeleteRgb(icrp, bvRgch, cbRgch - cbNew);
+                        pggcrp->Lock();
                     }
-                    stn.GetData(PvAddBv(_pggcrp->QvGet(icrp), bvRgch));
+                    stn.GetData(PvAddBv(pggcrp->QvGet(icrp), bvRgch));
                 }
                 else
                 {
                     // just nuke the name
-                    _pggcrp->Unlock();
+                    pggcrp->Unlock();
                 LNukeName:
-                    _pggcrp->DeleteRgb(icrp, bvRgch, cbRgch);
-                    _pggcrp->Lock();
+                    pggcrp->DeleteRgb(icrp, bvRgch, cbRgch);
+                    pggcrp->Lock();
                 }
             }
         }
@@ -1490,9 +2163,9 @@ bool CFL::_FReadIndex(void)
         CRPSM *pcrpsm;
 
         bom = (bo != kboCur) ? kbomCrpsm : bomNil;
-        for (icrp = _pggcrp->IvMac(); icrp-- != 0;)
+        for (icrp = pggcrp->IvMac(); icrp-- != 0;)
         {
-            pcrpsm = (CRPSM *)_pggcrp->QvFixedGet(icrp, &cbVar);
+            pcrpsm = (CRPSM *)pggcrp->QvFixedGet(icrp, &cbVar);
             if (!FIn(cbVar, 0, kcbMax))
                 goto LBadFile;
             if (bomNil != bom)
@@ -1503,16 +2176,16 @@ bool CFL::_FReadIndex(void)
             }
             if (pcrpsm->ckid > 0 && bomNil != bom)
             {
-                SwapBytesRglw(_pggcrp->QvGet(icrp), pcrpsm->ckid * (size(KID) / size(long)));
+                SwapBytesRglw(pggcrp->QvGet(icrp), pcrpsm->ckid * (size(KID) / size(long)));
             }
 
             pcrpsm->ClearGrfcrp(fcrpOnExtra);
             if (pcrpsm->ccrpRef == 0 && !pcrpsm->Grfcrp(fcrpLoner))
             {
             LBadFile:
-                _pggcrp->Unlock();
+                pggcrp->Unlock();
                 Bug("corrupt crp");
-                ReleasePpo(&_pggcrp);
+                ReleasePpo(ppggcrp);
                 return fFalse;
             }
         }
@@ -1521,18 +2194,18 @@ bool CFL::_FReadIndex(void)
     if (size(CRP) != cbFixed)
     {
         // need to convert the index (from big to small or small to big)
-        PGG pggcrp;
+        PGG pggcrpNew;
         CRPOTH *pcrpOld;
         CRP crp;
 
-        if (pvNil == (pggcrp = GG::PggNew(size(CRP), _pggcrp->IvMac())))
+        if (pvNil == (pggcrpNew = GG::PggNew(size(CRP), pggcrp->IvMac())))
             goto LFail;
 
-        for (ccrp = _pggcrp->IvMac(), icrp = 0; icrp < ccrp; icrp++)
+        for (ccrp = pggcrp->IvMac(), icrp = 0; icrp < ccrp; icrp++)
         {
-            pcrpOld = (CRPOTH *)_pggcrp->QvFixedGet(icrp, &cbVar);
+            pcrpOld = (CRPOTH *)pggcrp->QvFixedGet(icrp, &cbVar);
             crp.cki = pcrpOld->cki;
-            crp.fp = pcrpOld->fp;
+            crp.SetFp(pcrpOld->Fp());
             crp.SetCb(pcrpOld->Cb());
             crp.ckid = (CKID)pcrpOld->ckid;
             crp.ccrpRef = (CKID)pcrpOld->ccrpRef;
@@ -1541,30 +2214,383 @@ bool CFL::_FReadIndex(void)
             crp.rti = rtiNil;
 #endif // CHUNK_BIG_INDEX
 
-            if (!pggcrp->FInsert(icrp, _pggcrp->Cb(icrp), _pggcrp->QvGet(icrp), &crp))
+            if (!pggcrpNew->FInsert(icrp, pggcrp->Cb(icrp), pggcrp->QvGet(icrp), &crp))
             {
-                ReleasePpo(&pggcrp);
+                ReleasePpo(&pggcrpNew);
             LFail:
-                _pggcrp->Unlock();
+                pggcrp->Unlock();
+                ReleasePpo(ppggcrp);
                 return fFalse;
             }
         }
-        _pggcrp->Unlock();
-        ReleasePpo(&_pggcrp);
+        pggcrp->Unlock();
+        ReleasePpo(ppggcrp);
 
-        _pggcrp = pggcrp;
+        *ppggcrp = pggcrpNew;
     }
     else
-        _pggcrp->Unlock();
+        pggcrp->Unlock();
+    return fTrue;
+}
+
+/***************************************************************************
+    Read the chunky file prefix, checking the signature and byte order and
+    putting the file positions back together.
+***************************************************************************/
+priv bool _FReadCfp(PFIL pfil, CFP *pcfp)
+{
+    AssertPo(pfil, 0);
+    AssertVarMem(pcfp);
+    CFPF cfpf;
+
+    if (!pfil->FReadRgb(&cfpf, size(cfpf), 0))
+        return fFalse;
+
+    // check the magic number and byte order indicator
+    if (cfpf.lwMagic != klwMagicChunky || cfpf.bo != kboCur && cfpf.bo != kboOther)
+    {
+        return fFalse;
+    }
+
+    if (cfpf.bo == kboOther)
+    {
+        SwapBytesBom(&cfpf, kbomCfp);
+        SwapBytesRglw(&cfpf.luIndexSum, kclwCfpPastBom);
+    }
+
+    // the high words are only used by large files
+    pcfp->fLarge = cfpf.dver._swCur >= kcvnMinLarge && (cfpf.grfcfp & fcfpLarge);
+    pcfp->fDict = FPure(cfpf.grfcfp & fcfpDict);
+    if (!pcfp->fLarge)
+    {
+        cfpf.lwFpMacHigh = cfpf.lwFpIndexHigh = cfpf.lwFpMapHigh = 0;
+        cfpf.lwFpJournalHigh = cfpf.lwFpPayloadHigh = 0;
+    }
+
+    pcfp->lwMagic = cfpf.lwMagic;
+    pcfp->ctgCreator = cfpf.ctgCreator;
+    pcfp->dver = cfpf.dver;
+    pcfp->bo = cfpf.bo;
+    pcfp->osk = cfpf.osk;
+    pcfp->fpMac = (FP)cfpf.lwFpMacHigh << 32 | cfpf.luFpMac;
+    pcfp->fpIndex = (FP)cfpf.lwFpIndexHigh << 32 | cfpf.luFpIndex;
+    pcfp->cbIndex = cfpf.cbIndex;
+    pcfp->fpMap = (FP)cfpf.lwFpMapHigh << 32 | cfpf.luFpMap;
+    pcfp->cbMap = cfpf.cbMap;
+    pcfp->fpJournal = (FP)cfpf.lwFpJournalHigh << 32 | cfpf.luFpJournal;
+    pcfp->cbJournal = cfpf.cbJournal;
+    pcfp->cbBase = cfpf.cbBase;
+    pcfp->fpPayload = (FP)cfpf.lwFpPayloadHigh << 32 | cfpf.luFpPayload;
+    pcfp->cbPayload = cfpf.cbPayload;
+    pcfp->luIndexSum = cfpf.luIndexSum;
+    return fTrue;
+}
+
+/***************************************************************************
+    Write the chunky file prefix. The high words of the file positions are
+    only written for large files.
+***************************************************************************/
+priv bool _FWriteCfp(PFIL pfil, CFP *pcfp)
+{
+    AssertPo(pfil, 0);
+    AssertVarMem(pcfp);
+    Assert(pcfp->fLarge || pcfp->fpMac <= klwMax, "small file is too big");
+    CFPF cfpf;
+
+    ClearPb(&cfpf, size(cfpf));
+    cfpf.lwMagic = pcfp->lwMagic;
+    cfpf.ctgCreator = pcfp->ctgCreator;
+    cfpf.dver = pcfp->dver;
+    cfpf.bo = pcfp->bo;
+    cfpf.osk = pcfp->osk;
+    cfpf.luFpMac = (ulong)pcfp->fpMac;
+    cfpf.luFpIndex = (ulong)pcfp->fpIndex;
+    cfpf.cbIndex = pcfp->cbIndex;
+    cfpf.luFpMap = (ulong)pcfp->fpMap;
+    cfpf.cbMap = pcfp->cbMap;
+    cfpf.luFpJournal = (ulong)pcfp->fpJournal;
+    cfpf.cbJournal = pcfp->cbJournal;
+    cfpf.cbBase = pcfp->cbBase;
+    cfpf.luFpPayload = (ulong)pcfp->fpPayload;
+    cfpf.cbPayload = pcfp->cbPayload;
+    cfpf.luIndexSum = pcfp->luIndexSum;
+    if (pcfp->fDict)
+        cfpf.grfcfp |= fcfpDict;
+    if (pcfp->fLarge)
+    {
+        cfpf.grfcfp |= fcfpLarge;
+        cfpf.lwFpMacHigh = (long)(pcfp->fpMac >> 32);
+        cfpf.lwFpIndexHigh = (long)(pcfp->fpIndex >> 32);
+        cfpf.lwFpMapHigh = (long)(pcfp->fpMap >> 32);
+        cfpf.lwFpJournalHigh = (long)(pcfp->fpJournal >> 32);
+        cfpf.lwFpPayloadHigh = (long)(pcfp->fpPayload >> 32);
+    }
+
+    return pfil->FWriteRgb(&cfpf, size(cfpf), 0);
+}
+
+/***************************************************************************
+    Verifies that this is a chunky file and reads the index into memory.
+    Sets the _fpFreeMap and _cbFreeMap fields and sets the _fFreeMapNotRead
+    flag. The free map is read separately by _ReadFreeMap. This is to avoid
+    hogging memory for the free map when we may never need it.
+***************************************************************************/
+bool CFL::_FReadIndex(void)
+{
+    AssertBaseThis(0);
+    AssertPo(_csto.pfil, 0);
+    Assert(!_fInvalidMainFile, 0);
+
+    CFP cfp;
+    FP fpMac;
+    short bo;
+    short osk;
+    FSM fsm;
+    bool fOldNames;
+
+    // used for old index stuff
+    bool fOldIndex;
+
+    Assert(_pggcrp == pvNil && _csto.pglfsm == pvNil && _cstoExtra.pfil == pvNil && _cstoExtra.pglfsm == pvNil,
+           "cfl has wrong non-nil entries");
+
+    // verify that this is a chunky file
+    if ((fpMac = _csto.pfil->FpMac()) < size(CFPF))
+        return fFalse;
+
+    if (!_FReadCfp(_csto.pfil, &cfp))
+        return fFalse;
+    _luIndexSum = cfp.luIndexSum;
+    _fDict = cfp.fDict;
+
+    // check the version numbers
+    if (!cfp.dver.FReadable(kcvnCur, kcvnMin))
+        return fFalse;
+
+    // if the file has old style chunk names, translate them
+    fOldNames = cfp.dver._swCur < kcvnMinStnNames;
+
+    // whether the index needs converted
+    fOldIndex = cfp.dver._swCur < kcvnMinGrfcrp;
+
+    if (cfp.dver._swCur < kcvnMinJournal || cfp.fpJournal == 0)
+    {
+        // no journal - the index and map should be last
+        cfp.fpJournal = 0;
+        cfp.cbJournal = 0;
+        cfp.cbBase = cfp.fpMac - cfp.fpIndex;
+        if (!FInFp(cfp.fpMac, size(CFPF), fpMac + 1) || !FInFp(cfp.fpIndex, size(CFPF), cfp.fpMac + 1) ||
+            !FInFp(cfp.cbIndex, 1, cfp.fpMac - cfp.fpIndex + 1) || cfp.fpMap != cfp.fpIndex + cfp.cbIndex ||
+            cfp.fpMap + cfp.cbMap != cfp.fpMac)
+        {
+            return fFalse;
+        }
+    }
+    else
+    {
+        // the last journal record should be last and should contain the map
+        if (!FInFp(cfp.fpMac, size(CFPF), fpMac + 1) || !FInFp(cfp.fpIndex, size(CFPF), cfp.fpMac + 1) ||
+            !FInFp(cfp.cbIndex, 1, cfp.fpMac - cfp.fpIndex + 1) ||
+            !FInFp(cfp.cbBase, cfp.cbIndex, cfp.fpMac - cfp.fpIndex + 1) ||
+            !FInFp(cfp.fpJournal, cfp.fpIndex + cfp.cbBase, cfp.fpMac) || cfp.fpJournal + cfp.cbJournal != cfp.fpMac ||
+            !FInFp(cfp.fpMap, cfp.fpJournal + (cfp.fLarge ? size(JRH) : kcbJrhSmallFile), cfp.fpMac + 1) ||
+            cfp.fpMap + cfp.cbMap != cfp.fpMac)
+        {
+            return fFalse;
+        }
+    }
+
+    // the payload hashes (if any) should be just before the index
+    if (cfp.dver._swCur < kcvnMinShared || cfp.cbPayload <= 0 || cfp.fpPayload < size(CFPF) ||
+        cfp.fpPayload + cfp.cbPayload != cfp.fpIndex)
+    {
+        cfp.fpPayload = cfp.fpIndex;
+        cfp.cbPayload = 0;
+    }
+
+    // read and validate the index
+    if ((_pggcrp = GG::PggRead(_csto.pfil, cfp.fpIndex, cfp.cbIndex, &bo, &osk)) == pvNil)
+    {
+        return fFalse;
+    }
+
+    if (!_FCleanIndex(&_pggcrp, bo, fOldIndex, fOldNames))
+        return fFalse;
+
+    // the index is kept sorted, so chunks get inserted all over it
+    _pggcrp->SetGapped(fTrue);
+
+    // Remember where the index is, so later saves can just append to the
+    // journal. The space used by the index and journal is kept out of the
+    // heap until the journal is folded back into the index.
+    Assert(_jrns.pglfsmIndex == pvNil && _jrns.pglckiDirty == pvNil, 0);
+    _jrns.fpIndex = cfp.fpIndex;
+    _jrns.cbIndex = cfp.cbIndex;
+    _jrns.cbBase = cfp.cbBase;
+    _jrns.fpPayload = cfp.fpPayload;
+    _jrns.cbPayload = cfp.cbPayload;
+    _jrns.fLarge = cfp.fLarge;
+    if (cfp.fLarge)
+        _fLarge = fTrue;
+    fsm.fp = cfp.fpPayload;
+    fsm.cb = cfp.cbPayload + cfp.cbBase;
+    if (pvNil == (_jrns.pglfsmIndex = GL::PglNew(size(FSM), 1)) || !_jrns.pglfsmIndex->FAdd(&fsm))
+        ReleasePpo(&_jrns.pglfsmIndex);
+
+    if (cfp.fpJournal != 0 && !_FReadJournal(cfp.fpJournal, cfp.cbJournal))
+        return fFalse;
+
+    // if chunks may share data, we need the reference counts
+    if (!_FReadPayloads(cfp.fpPayload, cfp.cbPayload, cfp.dver._swBack >= kcvnMinShared))
+        return fFalse;
 
     _cbFreeMap = cfp.cbMap;
     _fpFreeMap = cfp.fpMap;
     _fFreeMapNotRead = cfp.cbMap > 0;
 
-    _csto.fpMac = cfp.fpIndex;
+    if (pvNil != _jrns.pglfsmIndex)
+    {
+        _csto.fpMac = cfp.fpMac;
+        _jrns.pglckiDirty = GL::PglNew(size(CKI));
+    }
+    else if (cfp.fpJournal == 0)
+    {
+        // we can't keep track of the index space, so just reuse it
+        _csto.fpMac = cfp.fpPayload;
+    }
+    else
+    {
+        // we lose the index and journal space until the file is compacted
+        _csto.fpMac = cfp.fpMac;
+    }
+
     return fTrue;
 }
 
+/***************************************************************************
+    Read the journal records ending with the one at (fpLast, cbLast) and
+    apply them to the index (oldest first). Adds the space used by the
+    journal records to _jrns.pglfsmIndex.
+***************************************************************************/
+bool CFL::_FReadJournal(FP fpLast, long cbLast)
+{
+    AssertBaseThis(0);
+    AssertPo(_pggcrp, 0);
+
+    PGL pgljrh = pvNil;
+    PGL pglfsmJrn = pvNil;
+    PGG pggcrp = pvNil;
+    PGL pglcki = pvNil;
+    FSM fsm;
+    JRH jrh;
+    CKI cki;
+    CRP *qcrp;
+    short bo;
+    short osk;
+    long ijrh, icrp, icrpDst, icki, cbVar;
+    long cbJrh = _jrns.fLarge ? size(JRH) : kcbJrhSmallFile;
+    bool fRet = fFalse;
+
+    // walk the chain of journal records back to the first one
+    if (pvNil == (pgljrh = GL::PglNew(size(JRH))) || pvNil == (pglfsmJrn = GL::PglNew(size(FSM))))
+        goto LFail;
+
+    ClearPb(&jrh, size(jrh));
+    for (fsm.fp = fpLast, fsm.cb = cbLast; fsm.fp != 0; fsm.fp = jrh.FpPrev(), fsm.cb = jrh.cbPrev)
+    {
+        if (!FInFp(fsm.fp, _jrns.fpIndex + _jrns.cbBase, fpLast + 1) || fsm.cb < cbJrh ||
+            !_csto.pfil->FReadRgb(&jrh, cbJrh, fsm.fp))
+        {
+            goto LFail;
+        }
+        if (jrh.bo == kboOther)
+            SwapBytesBom(&jrh, kbomJrh);
+        else if (jrh.bo != kboCur)
+            goto LFail;
+
+        // records are written in increasing file order, so this terminates
+        if (cbJrh + jrh.cbCrp + jrh.cbCki + jrh.cbMap != fsm.cb || jrh.cbCrp <= 0 || jrh.cbCki <= 0 ||
+            jrh.cbMap < 0 || jrh.FpPrev() != 0 && (jrh.cbPrev < cbJrh || jrh.FpPrev() + jrh.cbPrev > fsm.fp))
+        {
+            goto LFail;
+        }
+        if (!pgljrh->FAdd(&jrh) || !pglfsmJrn->FAdd(&fsm))
+            goto LFail;
+    }
+
+    // apply the records
+    for (ijrh = pgljrh->IvMac(); ijrh-- > 0;)
+    {
+        pgljrh->Get(ijrh, &jrh);
+        pglfsmJrn->Get(ijrh, &fsm);
+        fsm.fp += cbJrh;
+
+        // deleted chunks
+        if (pvNil == (pglcki = GL::PglRead(_csto.pfil, fsm.fp + jrh.cbCrp, jrh.cbCki, &bo, &osk)))
+            goto LFail;
+        if (pglcki->CbEntry() != size(CKI))
+            goto LFail;
+        AssertBomRglw(kbomCki, size(CKI));
+        if (bo != kboCur && pglcki->IvMac() > 0)
+            SwapBytesRglw(pglcki->QvGet(0), LwMul(pglcki->IvMac(), size(CKI) / size(long)));
+        for (icki = 0; icki < pglcki->IvMac(); icki++)
+        {
+            pglcki->Get(icki, &cki);
+            if (_FFindCtgCno(cki.ctg, cki.cno, &icrp))
+            {
+                _InvalidateIndexHash();
+                _pggcrp->Delete(icrp);
+            }
+        }
+        ReleasePpo(&pglcki);
+
+        // new and changed chunks
+        if (pvNil == (pggcrp = GG::PggRead(_csto.pfil, fsm.fp, jrh.cbCrp, &bo, &osk)) ||
+            !_FCleanIndex(&pggcrp, bo, fFalse, fFalse))
+        {
+            goto LFail;
+        }
+        for (icrp = 0; icrp < pggcrp->IvMac(); icrp++)
+        {
+            qcrp = (CRP *)pggcrp->QvFixedGet(icrp, &cbVar);
+            if (_FFindCtgCno(qcrp->cki.ctg, qcrp->cki.cno, &icrpDst))
+            {
+                if (!_pggcrp->FPut(icrpDst, cbVar, pggcrp->QvGet(icrp)))
+                    goto LFail;
+                _pggcrp->PutFixed(icrpDst, pggcrp->QvFixedGet(icrp));
+            }
+            else
+            {
+                if (!_pggcrp->FInsert(icrpDst, cbVar, pggcrp->QvGet(icrp), qcrp))
+                    goto LFail;
+                _InvalidateIndexHash();
+            }
+        }
+        ReleasePpo(&pggcrp);
+    }
+
+    // keep track of the journal space
+    for (ijrh = pglfsmJrn->IvMac(); pvNil != _jrns.pglfsmIndex && ijrh-- > 0;)
+    {
+        pglfsmJrn->Get(ijrh, &fsm);
+        if (!_jrns.pglfsmIndex->FAdd(&fsm))
+            ReleasePpo(&_jrns.pglfsmIndex);
+        _jrns.cbTotal += fsm.cb;
+    }
+    _jrns.fpLast = fpLast;
+    _jrns.cbLast = cbLast;
+    fRet = fTrue;
+
+LFail:
+    if (!fRet)
+        Warn("bad index journal");
+    ReleasePpo(&pgljrh);
+    ReleasePpo(&pglfsmJrn);
+    ReleasePpo(&pggcrp);
+    ReleasePpo(&pglcki);
+    return fRet;
+}
+
 /***************************************************************************
     Assert that the free map hasn't been read (and doesn't exist).  Read
     the free map from the file.  This _cannot_ be called after chunk
@@ -1579,7 +2605,10 @@ void CFL::_ReadFreeMap(void)
 
     short bo;
     short osk;
-    long cfsm;
+    long ifsm;
+    PGL pglfsmf;
+    FSM fsm;
+    FSMF fsmf;
 
     // clear this even if reading the free map fails - so we don't try to
     // read again
@@ -1593,64 +2622,288 @@ void CFL::_ReadFreeMap(void)
 
     if (_cbFreeMap > 0)
     {
-        if ((_csto.pglfsm = GL::PglRead(_csto.pfil, _fpFreeMap, _cbFreeMap, &bo, &osk)) == pvNil ||
-            _csto.pglfsm->CbEntry() != size(FSM))
+        if ((pglfsmf = GL::PglRead(_csto.pfil, _fpFreeMap, _cbFreeMap, &bo, &osk)) == pvNil)
+            return;
+        if (pglfsmf->CbEntry() != size(FSMF) && pglfsmf->CbEntry() != kcbFsmfSmallFile ||
+            (_csto.pglfsm = GL::PglNew(size(FSM), pglfsmf->IvMac())) == pvNil)
         {
             // it failed, but so what
-            ReleasePpo(&_csto.pglfsm);
+            ReleasePpo(&pglfsmf);
             return;
         }
-        // swap bytes
-        AssertBomRglw(kbomFsm, size(FSM));
-        if (bo != kboCur && (cfsm = _csto.pglfsm->IvMac()) > 0)
+
+        // swap bytes and put the file positions back together
+        AssertBomRglw(kbomFsmf, size(FSMF));
+        ClearPb(&fsmf, size(fsmf));
+        for (ifsm = 0; ifsm < pglfsmf->IvMac(); ifsm++)
         {
-            SwapBytesRglw(_csto.pglfsm->QvGet(0), cfsm * (size(FSM) / size(long)));
+            pglfsmf->Get(ifsm, &fsmf);
+            if (bo != kboCur)
+                SwapBytesBom(&fsmf, kbomFsmf);
+            fsm.fp = fsmf.Fp();
+            fsm.cb = fsmf.cb;
+            if (!_csto.pglfsm->FAdd(&fsm))
+            {
+                ReleasePpo(&_csto.pglfsm);
+                break;
+            }
         }
+        ReleasePpo(&pglfsmf);
     }
 }
 
 /***************************************************************************
-    If we have don't have write permission or there's an extra file,
-    write out a new file and do the rename stuff.  If not, just write
-    the index and free map.
+    Make the saved form of a free map. Returns pvNil on failure.
 ***************************************************************************/
-bool CFL::FSave(CTG ctgCreator, FNI *pfni)
+priv PGL _PglfsmfFromPglfsm(PGL pglfsm, bool fLarge)
 {
-    AssertThis(fcflFull | fcflGraph);
-    AssertNilOrPo(pfni, ffniFile);
+    AssertPo(pglfsm, 0);
+    PGL pglfsmf;
+    FSM fsm;
+    FSMF fsmf;
+    long ifsm;
 
-    FNI fni;
-    FLO floSrc, floDst;
-    long ccrp, icrp;
-    CRP *qcrp;
-    PFIL pfilOld;
+    if (pvNil == (pglfsmf = GL::PglNew(fLarge ? size(FSMF) : kcbFsmfSmallFile, pglfsm->IvMac())))
+        return pvNil;
 
-    if (_fInvalidMainFile)
+    for (ifsm = 0; ifsm < pglfsm->IvMac(); ifsm++)
     {
-        if (pvNil == pfni)
+        pglfsm->Get(ifsm, &fsm);
+        Assert(fLarge || fsm.fp + fsm.cb <= klwMax, "free space past the end of a small file");
+        fsmf.SetFp(fsm.fp);
+        fsmf.cb = fsm.cb;
+        if (!pglfsmf->FAdd(&fsmf))
         {
-            Bug("can't save a CFL that has no file attached!");
-            return fFalse;
+            ReleasePpo(&pglfsmf);
+            break;
         }
-        fni = *pfni;
     }
-    else
+    return pglfsmf;
+}
+
+/***************************************************************************
+    Copy the index without the high words of the CRP locations, for saving
+    in a small file. Returns pvNil on failure.
+***************************************************************************/
+priv PGG _PggcrpSmallFile(PGG pggcrp)
+{
+    AssertPo(pggcrp, 0);
+    PGG pggcrpNew;
+    CRP *qcrp;
+    long icrp;
+
+    if (pvNil == (pggcrpNew = GG::PggNew(kcbCrpSmallFile, pggcrp->IvMac())))
+        return pvNil;
+
+    pggcrp->Lock();
+    for (icrp = 0; icrp < pggcrp->IvMac(); icrp++)
     {
-        GetFni(&fni);
-        if (pfni != pvNil)
+        qcrp = (CRP *)pggcrp->QvFixedGet(icrp);
+        Assert(qcrp->Fp() + qcrp->Cb() <= klwMax, "chunk past the end of a small file");
+        if (!pggcrpNew->FAdd(pggcrp->Cb(icrp), pvNil, pggcrp->QvGet(icrp), qcrp))
         {
-            if (pfni->FEqual(&fni))
-                pfni = pvNil;
-            else
-                fni = *pfni;
+            ReleasePpo(&pggcrpNew);
+            break;
         }
     }
+    pggcrp->Unlock();
+    return pggcrpNew;
+}
 
-    if (!_fAddToExtra && _cstoExtra.pfil == pvNil && pfni == pvNil)
+/***************************************************************************
+    Build the payload index from the chunk index and the saved payload
+    hashes at (fp, cb). If fShared, chunks may share data, so we need the
+    payload index to know when data is no longer used and failing to build
+    it is an error. Otherwise, failing just means new chunks won't share
+    data with the existing ones.
+***************************************************************************/
+bool CFL::_FReadPayloads(FP fp, long cb, bool fShared)
+{
+    AssertBaseThis(0);
+    AssertPo(_pggcrp, 0);
+    Assert(pvNil == _pglpye && pvNil == _pglpyeHash, "payload index already exists");
+
+    PGL pglpyh = pvNil;
+    PYE pye, pyeT;
+    PYH pyh;
+    PYE *qpye;
+    CRP *qcrp;
+    short bo;
+    short osk;
+    long icrp, ccrp, ipye, ipyeDst, ipyh;
+
+    if (!fShared && cb == 0)
+        return fTrue;
+
+    // get an entry for the data of each chunk
+    ccrp = _pggcrp->IvMac();
+    if (pvNil == (_pglpye = GL::PglNew(size(PYE), ccrp)))
+        goto LFail;
+    ClearPb(&pye, size(pye));
+    pye.ccrp = 1;
+    for (icrp = 0; icrp < ccrp; icrp++)
+    {
+        qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+        if (qcrp->Cb() == 0 || qcrp->Grfcrp(fcrpOnExtra))
+            continue;
+        pye.fp = qcrp->Fp();
+        pye.cb = qcrp->Cb();
+        if (!_pglpye->FAdd(&pye))
+            goto LFail;
+    }
+    _SortPglpye(_pglpye, fFalse);
+
+    // merge the entries for the same data
+    for (ipye = ipyeDst = 0; ipye < _pglpye->IvMac(); ipye++)
+    {
+        _pglpye->Get(ipye, &pye);
+        if (ipyeDst > 0)
+        {
+            _pglpye->Get(ipyeDst - 1, &pyeT);
+            if (pyeT.fp == pye.fp)
+            {
+                if (pyeT.cb != pye.cb)
+                    goto LFail;
+                pyeT.ccrp++;
+                _pglpye->Put(ipyeDst - 1, &pyeT);
+                continue;
+            }
+        }
+        _pglpye->Put(ipyeDst++, &pye);
+    }
+    AssertDo(_pglpye->FSetIvMac(ipyeDst), 0);
+
+    // attach the saved hashes - if they can't be read, we just don't know
+    // the hashes
+    if (cb > 0 && pvNil != (pglpyh = GL::PglRead(_csto.pfil, fp, cb, &bo, &osk)) &&
+        (pglpyh->CbEntry() == size(PYH) || pglpyh->CbEntry() == kcbPyhSmallFile))
+    {
+        AssertBomRglw(kbomPyh, size(PYH));
+        ClearPb(&pyh, size(pyh));
+        for (ipyh = 0; ipyh < pglpyh->IvMac(); ipyh++)
+        {
+            pglpyh->Get(ipyh, &pyh);
+            if (kboOther == bo)
+                SwapBytesBom(&pyh, kbomPyh);
+            if (_FFindPye(fFalse, pyh.Fp(), &ipye))
+            {
+                qpye = (PYE *)_pglpye->QvGet(ipye);
+                if (qpye->cb == pyh.cb)
+                {
+                    qpye->luHash = pyh.luHash;
+                    qpye->fHash = fTrue;
+                }
+            }
+        }
+    }
+    ReleasePpo(&pglpyh);
+
+    // only keep the shared and hashed entries
+    for (ipye = ipyeDst = 0; ipye < _pglpye->IvMac(); ipye++)
+    {
+        _pglpye->Get(ipye, &pye);
+        if (pye.ccrp > 1 || pye.fHash)
+            _pglpye->Put(ipyeDst++, &pye);
+    }
+    AssertDo(_pglpye->FSetIvMac(ipyeDst), 0);
+
+    // build the hash index
+    if (pvNil == (_pglpyeHash = GL::PglNew(size(PYE), ipyeDst)))
+        goto LFail;
+    for (ipye = 0; ipye < ipyeDst; ipye++)
+    {
+        _pglpye->Get(ipye, &pye);
+        if (pye.fHash && !_pglpyeHash->FAdd(&pye))
+            goto LFail;
+    }
+    _SortPglpye(_pglpyeHash, fTrue);
+    return fTrue;
+
+LFail:
+    ReleasePpo(&pglpyh);
+    _ReleasePayloads();
+    return !fShared;
+}
+
+/***************************************************************************
+    Return whether any chunks share data.
+***************************************************************************/
+bool CFL::_FShared(void)
+{
+    AssertBaseThis(0);
+    long ipye;
+
+    if (pvNil == _pglpye)
+        return fFalse;
+
+    for (ipye = _pglpye->IvMac(); ipye-- > 0;)
+    {
+        if (((PYE *)_pglpye->QvGet(ipye))->ccrp > 1)
+            return fTrue;
+    }
+    return fFalse;
+}
+
+/***************************************************************************
+    Free the payload index.
+***************************************************************************/
+void CFL::_ReleasePayloads(void)
+{
+    AssertBaseThis(0);
+
+    ReleasePpo(&_pglpye);
+    ReleasePpo(&_pglpyeHash);
+}
+
+/***************************************************************************
+    If we have don't have write permission or there's an extra file,
+    write out a new file and do the rename stuff.  If not, just write
+    the index and free map. Data packed with kcfmtKauaiFast is repacked
+    in the default format first, unless we're saving back to a temp file.
+***************************************************************************/
+bool CFL::FSave(CTG ctgCreator, FNI *pfni)
+{
+    AssertThis(fcflFull | fcflGraph);
+    AssertNilOrPo(pfni, ffniFile);
+
+    FNI fni;
+    FLO floSrc, floDst;
+    FP fp;
+    long ccrp, icrp, ipye, ipyeT;
+    CRP *qcrp;
+    PYE *qpye;
+    PFIL pfilOld;
+
+    if (_fInvalidMainFile)
+    {
+        if (pvNil == pfni)
+        {
+            Bug("can't save a CFL that has no file attached!");
+            return fFalse;
+        }
+        fni = *pfni;
+    }
+    else
     {
-        // just write the index
+        GetFni(&fni);
+        if (pfni != pvNil)
+        {
+            if (pfni->FEqual(&fni))
+                pfni = pvNil;
+            else
+                fni = *pfni;
+        }
+    }
+
+    // data packed with the fast codec stays in temp files
+    if ((pvNil != pfni || !FTemp()) && !_FRepackFast())
+        goto LError;
+
+    if (!_fAddToExtra && _cstoExtra.pfil == pvNil && pfni == pvNil)
+    {
+        // just write the index (or append the changes to the journal)
         Assert(!_fFreeMapNotRead, "why hasn't the free map been read?");
-        if (!_FWriteIndex(ctgCreator))
+        if (!_FWriteJournal(ctgCreator) && !_FWriteIndex(ctgCreator))
             goto LError;
         return fTrue;
     }
@@ -1658,19 +2911,36 @@ bool CFL::FSave(CTG ctgCreator, FNI *pfni)
     // get a temp name in the same directory as the target
     if ((floDst.pfil = FIL::PfilCreateTemp(&fni)) == pvNil)
         goto LError;
-    if (!floDst.pfil->FSetFpMac(size(CFP)))
+    if (!floDst.pfil->FSetFpMac(size(CFPF)))
         goto LFail;
 
-    floDst.fp = size(CFP);
+    if (pvNil != _pglpye)
+    {
+        for (ipye = _pglpye->IvMac(); ipye-- > 0;)
+            ((PYE *)_pglpye->QvGet(ipye))->fpNew = 0;
+    }
+
+    floDst.fp = size(CFPF);
     ccrp = _pggcrp->IvMac();
     for (icrp = 0; icrp < ccrp; icrp++)
     {
         qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
         floSrc.pfil = qcrp->Grfcrp(fcrpOnExtra) ? _cstoExtra.pfil : _csto.pfil;
-        floSrc.fp = qcrp->fp;
+        floSrc.fp = qcrp->Fp();
         floSrc.cb = floDst.cb = qcrp->Cb();
+        if (floSrc.cb == 0)
+            continue;
+
+        // shared data is only copied once
+        if (_FFindPye(FPure(qcrp->Grfcrp(fcrpOnExtra)), floSrc.fp, &ipye))
+        {
+            qpye = (PYE *)_pglpye->QvGet(ipye);
+            if (qpye->fpNew != 0)
+                continue;
+            qpye->fpNew = floDst.fp;
+        }
 
-        if (floSrc.cb > 0 && !floSrc.FCopy(&floDst))
+        if (!floSrc.FCopy(&floDst))
         {
         LFail:
             Assert(floDst.pfil->FTemp(), "file not a temp");
@@ -1681,19 +2951,53 @@ bool CFL::FSave(CTG ctgCreator, FNI *pfni)
     }
 
     // All the data has been copied.  Update the index to point to the new file.
-    floSrc.fp = size(CFP);
+    floSrc.fp = size(CFPF);
     for (icrp = 0; icrp < ccrp; icrp++)
     {
         qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+        if (qcrp->Cb() > 0 && _FFindPye(FPure(qcrp->Grfcrp(fcrpOnExtra)), qcrp->Fp(), &ipye) &&
+            (fp = ((PYE *)_pglpye->QvGet(ipye))->fpNew) != floSrc.fp)
+        {
+            // the data was copied for an earlier chunk
+            qcrp->ClearGrfcrp(fcrpOnExtra);
+            qcrp->SetFp(fp);
+            continue;
+        }
         qcrp->ClearGrfcrp(fcrpOnExtra);
-        qcrp->fp = qcrp->Cb() > 0 ? floSrc.fp : 0;
+        qcrp->SetFp(qcrp->Cb() > 0 ? floSrc.fp : 0);
         floSrc.fp += qcrp->Cb();
     }
     Assert(floSrc.fp == floDst.fp, "what happened? - file messed up");
 
+    // the payload index is keyed by location, so move it to the new file too
+    if (pvNil != _pglpye)
+    {
+        if (pvNil != _pglpyeHash)
+        {
+            for (ipye = _pglpyeHash->IvMac(); ipye-- > 0;)
+            {
+                qpye = (PYE *)_pglpyeHash->QvGet(ipye);
+                AssertDo(_FFindPye(qpye->fOnExtra, qpye->fp, &ipyeT), "payload indices out of sync");
+                qpye->fp = ((PYE *)_pglpye->QvGet(ipyeT))->fpNew;
+                qpye->fOnExtra = fFalse;
+            }
+            _SortPglpye(_pglpyeHash, fTrue);
+        }
+        for (ipye = _pglpye->IvMac(); ipye-- > 0;)
+        {
+            qpye = (PYE *)_pglpye->QvGet(ipye);
+            Assert(qpye->fpNew != 0, "shared data not copied");
+            qpye->fp = qpye->fpNew;
+            qpye->fOnExtra = fFalse;
+        }
+        _SortPglpye(_pglpye, fFalse);
+    }
+
     // update the csto's and write the index
     pfilOld = _csto.pfil;
     ReleasePpo(&_csto.pglfsm);
+    ReleasePpo(&_csto.pglfsmCb);
+    _ReleaseJournal();
     _fFreeMapNotRead = fFalse;
     _csto.pfil = floDst.pfil;
     _csto.fpMac = floDst.fp;
@@ -1704,6 +3008,7 @@ bool CFL::FSave(CTG ctgCreator, FNI *pfni)
         _cstoExtra.fpMac = 0;
         ReleasePpo(&_cstoExtra.pfil);
         ReleasePpo(&_cstoExtra.pglfsm);
+        ReleasePpo(&_cstoExtra.pglfsmCb);
     }
 
     // write the index
@@ -1732,13 +3037,24 @@ bool CFL::FSave(CTG ctgCreator, FNI *pfni)
         {
             // restore the original csto and make floDst.pfil the extra file
             _csto.pfil = pfilOld;
-            _csto.fpMac = size(CFP);
+            _csto.fpMac = size(CFPF);
+            _ReleaseJournal();
             for (icrp = 0; icrp < ccrp; icrp++)
             {
                 qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
                 if (qcrp->Cb() > 0)
                     qcrp->SetGrfcrp(fcrpOnExtra);
             }
+            if (pvNil != _pglpye)
+            {
+                for (ipye = _pglpye->IvMac(); ipye-- > 0;)
+                    ((PYE *)_pglpye->QvGet(ipye))->fOnExtra = fTrue;
+            }
+            if (pvNil != _pglpyeHash)
+            {
+                for (ipye = _pglpyeHash->IvMac(); ipye-- > 0;)
+                    ((PYE *)_pglpyeHash->QvGet(ipye))->fOnExtra = fTrue;
+            }
             _cstoExtra.pfil = floDst.pfil;
             floDst.pfil->SetTemp(fTrue);
             _cstoExtra.fpMac = floDst.fp;
@@ -1759,7 +3075,9 @@ bool CFL::FSave(CTG ctgCreator, FNI *pfni)
 }
 
 /***************************************************************************
-    Write the chunky index and free map to the end of the file.
+    Write the payload hashes, chunky index and free map to the end of the
+    file. The space used by the old index and journal (if any) is freed
+    first.
 ***************************************************************************/
 bool CFL::_FWriteIndex(CTG ctgCreator)
 {
@@ -1769,30 +3087,311 @@ bool CFL::_FWriteIndex(CTG ctgCreator)
 
     CFP cfp;
     BLCK blck;
+    FSM fsm;
+    PYE pye;
+    PYH pyh;
+    PGL pglpyh = pvNil;
+    PGL pglfsmf = pvNil;
+    PGG pggcrp;
+    PGG pggcrpSmall = pvNil;
+    FP fpLim;
+    long ifsm, ipye;
+    bool fRet = fFalse;
+
+    // fold the journal - free the highest space first so the end of the
+    // file is trimmed as much as possible
+    if (pvNil != _jrns.pglfsmIndex)
+    {
+        for (ifsm = _jrns.pglfsmIndex->IvMac(); ifsm-- > 0;)
+        {
+            _jrns.pglfsmIndex->Get(ifsm, &fsm);
+            _FreeFpCb(fFalse, fsm.fp, fsm.cb);
+        }
+    }
+    _ReleaseJournal();
+
+    // Small files can't go past 2GB, so switch to the large format if the
+    // index might end past that. The sizes in memory are at least the
+    // saved sizes.
+    if (!_fLarge)
+    {
+        fpLim = _csto.fpMac + _pggcrp->CbOnFile();
+        if (pvNil != _csto.pglfsm)
+            fpLim += _csto.pglfsm->CbOnFile();
+        if (pvNil != _pglpyeHash)
+            fpLim += _pglpyeHash->CbOnFile();
+        _fLarge = fpLim > klwMax;
+    }
 
     ClearPb(&cfp, size(cfp));
     cfp.lwMagic = klwMagicChunky;
     cfp.ctgCreator = ctgCreator;
-    cfp.dver.Set(kcvnCur, kcvnBack);
+    cfp.dver.Set(kcvnCur, _fLarge ? kcvnMinLarge : _FShared() ? kcvnMinShared : kcvnBack);
     cfp.bo = kboCur;
     cfp.osk = koskCur;
+    cfp.luIndexSum = _LuSumIndex(_pggcrp);
+    cfp.fLarge = _fLarge;
+    cfp.fDict = CckiCtg(kctgDict) > 0;
 
-    blck.Set(_csto.pfil, cfp.fpIndex = _csto.fpMac, cfp.cbIndex = _pggcrp->CbOnFile());
-    if (!_pggcrp->FWrite(&blck))
-        return fFalse;
+    // save the payload hashes, so data written later can share with the
+    // data that's already there
+    cfp.fpPayload = cfp.fpIndex = _csto.fpMac;
+    if (pvNil != _pglpyeHash && _pglpyeHash->IvMac() > 0 &&
+        pvNil != (pglpyh = GL::PglNew(_fLarge ? size(PYH) : kcbPyhSmallFile, _pglpyeHash->IvMac())))
+    {
+        for (ipye = 0; ipye < _pglpyeHash->IvMac(); ipye++)
+        {
+            _pglpyeHash->Get(ipye, &pye);
+            if (pye.fOnExtra)
+                continue;
+            pyh.SetFp(pye.fp);
+            pyh.cb = pye.cb;
+            pyh.luHash = pye.luHash;
+            if (!pglpyh->FAdd(&pyh))
+            {
+                ReleasePpo(&pglpyh);
+                break;
+            }
+        }
+    }
+    if (pvNil != pglpyh)
+    {
+        blck.Set(_csto.pfil, cfp.fpPayload, cfp.cbPayload = pglpyh->CbOnFile());
+        if (!pglpyh->FWrite(&blck))
+            goto LFail;
+        cfp.fpIndex += cfp.cbPayload;
+    }
+
+    // small files don't save the high words of the CRP locations
+    pggcrp = _pggcrp;
+    if (!_fLarge && pvNil == (pggcrp = pggcrpSmall = _PggcrpSmallFile(_pggcrp)))
+        goto LFail;
+    blck.Set(_csto.pfil, cfp.fpIndex, cfp.cbIndex = pggcrp->CbOnFile());
+    if (!pggcrp->FWrite(&blck))
+        goto LFail;
     cfp.fpMap = cfp.fpIndex + cfp.cbIndex;
     if (_csto.pglfsm != pvNil)
     {
+        if (pvNil == (pglfsmf = _PglfsmfFromPglfsm(_csto.pglfsm, _fLarge)))
+            goto LFail;
         AssertDo(blck.FMoveMin(cfp.cbIndex), 0);
-        AssertDo(blck.FMoveLim(cfp.cbMap = _csto.pglfsm->CbOnFile()), 0);
-        if (!_csto.pglfsm->FWrite(&blck))
-            return fFalse;
+        AssertDo(blck.FMoveLim(cfp.cbMap = pglfsmf->CbOnFile()), 0);
+        if (!pglfsmf->FWrite(&blck))
+            goto LFail;
     }
     else
         cfp.cbMap = 0;
 
     cfp.fpMac = cfp.fpMap + cfp.cbMap;
-    return _csto.pfil->FWriteRgb(&cfp, size(cfp), 0);
+    if (!_FWriteCfp(_csto.pfil, &cfp))
+        goto LFail;
+
+    // keep the index and map out of the heap so later saves can append
+    // to the journal
+    _fpFreeMap = cfp.fpMap;
+    _cbFreeMap = cfp.cbMap;
+    _jrns.fpIndex = cfp.fpIndex;
+    _jrns.cbIndex = cfp.cbIndex;
+    _jrns.cbBase = (long)(cfp.fpMac - cfp.fpIndex);
+    _jrns.fpPayload = cfp.fpPayload;
+    _jrns.cbPayload = cfp.cbPayload;
+    _jrns.fLarge = cfp.fLarge;
+    fsm.fp = cfp.fpPayload;
+    fsm.cb = cfp.cbPayload + _jrns.cbBase;
+    if (pvNil != (_jrns.pglfsmIndex = GL::PglNew(size(FSM), 1)) && _jrns.pglfsmIndex->FAdd(&fsm))
+    {
+        _csto.fpMac = cfp.fpMac;
+        _jrns.pglckiDirty = GL::PglNew(size(CKI));
+    }
+    else
+        ReleasePpo(&_jrns.pglfsmIndex);
+    fRet = fTrue;
+
+LFail:
+    ReleasePpo(&pglpyh);
+    ReleasePpo(&pggcrpSmall);
+    ReleasePpo(&pglfsmf);
+    return fRet;
+}
+
+/***************************************************************************
+    Append the index entries that changed since the last save (and the
+    free map) to the journal. Returns false without changing anything on
+    disk that matters if the whole index should be written instead.
+***************************************************************************/
+bool CFL::_FWriteJournal(CTG ctgCreator)
+{
+    AssertBaseThis(0);
+    AssertPo(_pggcrp, 0);
+    AssertPo(_csto.pfil, 0);
+
+    PGG pggcrp = pvNil;
+    PGL pglcki = pvNil;
+    PGL pglfsmf = pvNil;
+    CFP cfp;
+    JRH jrh;
+    BLCK blck;
+    FSM fsm;
+    CKI cki;
+    long icki, icrp;
+    long cbJrh = _fLarge ? size(JRH) : kcbJrhSmallFile;
+    FP fp;
+    bool fRet = fFalse;
+
+    // the journal has to use the same format as the index it applies to
+    if (pvNil == _jrns.pglckiDirty || pvNil == _jrns.pglfsmIndex || FPure(_jrns.fLarge) != FPure(_fLarge))
+        return fFalse;
+
+    // collect the changes - the fixed part of the CRPs in small files is
+    // just a prefix of the CRP
+    if (pvNil == (pggcrp = GG::PggNew(_fLarge ? size(CRP) : kcbCrpSmallFile)) ||
+        pvNil == (pglcki = GL::PglNew(size(CKI))))
+    {
+        goto LFail;
+    }
+    for (icki = 0; icki < _jrns.pglckiDirty->IvMac(); icki++)
+    {
+        _jrns.pglckiDirty->Get(icki, &cki);
+        if (!_FFindCtgCno(cki.ctg, cki.cno, &icrp))
+        {
+            if (!pglcki->FAdd(&cki))
+                goto LFail;
+        }
+        else if (!pggcrp->FAdd(_pggcrp->Cb(icrp), pvNil, _pggcrp->QvGet(icrp), _pggcrp->QvFixedGet(icrp)))
+            goto LFail;
+    }
+
+    if (pvNil != _csto.pglfsm && pvNil == (pglfsmf = _PglfsmfFromPglfsm(_csto.pglfsm, _fLarge)))
+        goto LFail;
+
+    ClearPb(&jrh, size(jrh));
+    jrh.bo = kboCur;
+    jrh.osk = koskCur;
+    jrh.SetFpPrev(_jrns.fpLast);
+    jrh.cbPrev = _jrns.cbLast;
+    jrh.cbCrp = pggcrp->CbOnFile();
+    jrh.cbCki = pglcki->CbOnFile();
+    jrh.cbMap = pvNil != pglfsmf ? pglfsmf->CbOnFile() : 0;
+    fsm.fp = fp = _csto.fpMac;
+    fsm.cb = cbJrh + jrh.cbCrp + jrh.cbCki + jrh.cbMap;
+
+    // if the journal is getting big, write the whole index instead
+    if (_jrns.cbTotal + fsm.cb > LwMax(kcbMinJournalFold, _jrns.cbBase / 2))
+        goto LFail;
+
+    // a small file that would grow past 2GB has to switch to the large
+    // format, which means writing the whole index
+    if (!_fLarge && fsm.fp + fsm.cb > klwMax)
+        goto LFail;
+
+    // make sure we can remember where the record is
+    if (!_jrns.pglfsmIndex->FEnsureSpace(1))
+        goto LFail;
+
+    if (!_csto.pfil->FWriteRgb(&jrh, cbJrh, fp))
+        goto LFail;
+    fp += cbJrh;
+    blck.Set(_csto.pfil, fp, jrh.cbCrp);
+    if (!pggcrp->FWrite(&blck))
+        goto LFail;
+    fp += jrh.cbCrp;
+    blck.Set(_csto.pfil, fp, jrh.cbCki);
+    if (!pglcki->FWrite(&blck))
+        goto LFail;
+    fp += jrh.cbCki;
+    if (jrh.cbMap > 0)
+    {
+        blck.Set(_csto.pfil, fp, jrh.cbMap);
+        if (!pglfsmf->FWrite(&blck))
+            goto LFail;
+    }
+
+    // point the header at the new record
+    ClearPb(&cfp, size(cfp));
+    cfp.lwMagic = klwMagicChunky;
+    cfp.ctgCreator = ctgCreator;
+    cfp.dver.Set(kcvnCur, _fLarge ? kcvnMinLarge : _FShared() ? kcvnMinShared : kcvnMinJournal);
+    cfp.bo = kboCur;
+    cfp.osk = koskCur;
+    cfp.luIndexSum = _LuSumIndex(_pggcrp);
+    cfp.fLarge = _fLarge;
+    cfp.fDict = CckiCtg(kctgDict) > 0;
+    cfp.fpIndex = _jrns.fpIndex;
+    cfp.cbIndex = _jrns.cbIndex;
+    cfp.fpMap = fp;
+    cfp.cbMap = jrh.cbMap;
+    cfp.fpJournal = fsm.fp;
+    cfp.cbJournal = fsm.cb;
+    cfp.cbBase = _jrns.cbBase;
+    cfp.fpPayload = _jrns.fpPayload;
+    cfp.cbPayload = _jrns.cbPayload;
+    cfp.fpMac = fsm.fp + fsm.cb;
+    if (!_FWriteCfp(_csto.pfil, &cfp))
+        goto LFail;
+
+    AssertDo(_jrns.pglfsmIndex->FAdd(&fsm), 0);
+    _csto.fpMac = cfp.fpMac;
+    _fpFreeMap = cfp.fpMap;
+    _cbFreeMap = cfp.cbMap;
+    _jrns.fpLast = fsm.fp;
+    _jrns.cbLast = fsm.cb;
+    _jrns.cbTotal += fsm.cb;
+    AssertDo(_jrns.pglckiDirty->FSetIvMac(0), 0);
+    fRet = fTrue;
+
+LFail:
+    ReleasePpo(&pggcrp);
+    ReleasePpo(&pglcki);
+    ReleasePpo(&pglfsmf);
+    return fRet;
+}
+
+/***************************************************************************
+    Forget about the saved index and journal.
+***************************************************************************/
+void CFL::_ReleaseJournal(void)
+{
+    AssertBaseThis(0);
+
+    ReleasePpo(&_jrns.pglckiDirty);
+    ReleasePpo(&_jrns.pglfsmIndex);
+    ClearPb(&_jrns, size(_jrns));
+}
+
+/***************************************************************************
+    Note that the index entry for icrp has changed (or is about to be
+    deleted), so the next save puts it in the journal.
+***************************************************************************/
+void CFL::_MarkDirty(long icrp)
+{
+    AssertBaseThis(0);
+    AssertIn(icrp, 0, _pggcrp->IvMac());
+    long icki, ickiMin, ickiLim;
+    CKI cki, *qcki;
+
+    if (pvNil == _jrns.pglckiDirty)
+        return;
+
+    cki = ((CRP *)_pggcrp->QvFixedGet(icrp))->cki;
+    for (ickiMin = 0, ickiLim = _jrns.pglckiDirty->IvMac(); ickiMin < ickiLim;)
+    {
+        icki = (ickiMin + ickiLim) / 2;
+        qcki = (CKI *)_jrns.pglckiDirty->QvGet(icki);
+        if (qcki->ctg < cki.ctg || qcki->ctg == cki.ctg && qcki->cno < cki.cno)
+            ickiMin = icki + 1;
+        else
+            ickiLim = icki;
+    }
+    if (ickiMin < _jrns.pglckiDirty->IvMac())
+    {
+        qcki = (CKI *)_jrns.pglckiDirty->QvGet(ickiMin);
+        if (qcki->ctg == cki.ctg && qcki->cno == cki.cno)
+            return;
+    }
+
+    // if this fails, the next save writes the whole index
+    if (!_jrns.pglckiDirty->FInsert(ickiMin, &cki))
+        ReleasePpo(&_jrns.pglckiDirty);
 }
 
 /***************************************************************************
@@ -1814,7 +3413,7 @@ bool CFL::FSaveACopy(CTG ctgCreator, FNI *pfni)
 
     // initialize the destination FLO.
     floDst.pfil = pcflDst->_csto.pfil;
-    floDst.fp = size(CFP);
+    floDst.fp = size(CFPF);
 
     // need to lock the _pggcrp for the FInsert operations below
     ccrp = _pggcrp->IvMac();
@@ -1827,7 +3426,7 @@ bool CFL::FSaveACopy(CTG ctgCreator, FNI *pfni)
 
         // get the source and destination FLOs
         floSrc.pfil = pcrp->Grfcrp(fcrpOnExtra) ? _cstoExtra.pfil : _csto.pfil;
-        floSrc.fp = pcrp->fp;
+        floSrc.fp = pcrp->Fp();
         floDst.cb = floSrc.cb = pcrp->Cb();
 
         // copy the data
@@ -1839,7 +3438,7 @@ bool CFL::FSaveACopy(CTG ctgCreator, FNI *pfni)
 
         // create the index entry - the only things that change are the
         // (fp, cb) and the fcrpOnExtra flag.
-        crp.fp = floDst.fp;
+        crp.SetFp(floDst.fp);
         crp.SetCb(floDst.cb);
         crp.ClearGrfcrp(fcrpOnExtra);
         if (!pcflDst->_pggcrp->FInsert(icrp, _pggcrp->Cb(icrp), _pggcrp->QvGet(icrp), &crp))
@@ -1849,6 +3448,8 @@ bool CFL::FSaveACopy(CTG ctgCreator, FNI *pfni)
         }
     }
     _pggcrp->Unlock();
+    pcflDst->_ReleaseIndexHash();
+    pcflDst->_fFast = _fFast || FTemp();
 
     // set the fpMac of the destination CFL
     pcflDst->_csto.fpMac = floDst.fp;
@@ -1915,7 +3516,7 @@ bool CFL::_FEnsureOnExtra(long icrp, FLO *pflo)
         if (pvNil != pflo)
         {
             pflo->pfil = _cstoExtra.pfil;
-            pflo->fp = qcrp->fp;
+            pflo->fp = qcrp->Fp();
             pflo->cb = qcrp->Cb();
         }
     }
@@ -1930,13 +3531,13 @@ bool CFL::_FEnsureOnExtra(long icrp, FLO *pflo)
 
             qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
             stn.FFormatSz(PszLit("Cache: '%f', 0x%08x, fp = 0x%08x, cb = 0x%08x"), qcrp->cki.ctg, qcrp->cki.cno,
-                          qcrp->fp, qcrp->Cb());
+                          (long)qcrp->Fp(), qcrp->Cb());
             DumpStn(&stn, _csto.pfil);
         }
 #endif // CHUNK_STATS
 
         floSrc.pfil = _csto.pfil;
-        floSrc.fp = qcrp->fp;
+        floSrc.fp = qcrp->Fp();
         floSrc.cb = qcrp->Cb();
 
         if (!_FAllocFlo(floSrc.cb, &floDst, fTrue))
@@ -1947,9 +3548,14 @@ bool CFL::_FEnsureOnExtra(long icrp, FLO *pflo)
             return fFalse;
         }
 
+        // the data stays on the main file, but this chunk isn't using it
+        // any more
+        _FReleasePayload(fFalse, floSrc.fp, floSrc.cb);
+
         qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
         qcrp->SetGrfcrp(fcrpOnExtra);
-        qcrp->fp = floDst.fp;
+        qcrp->SetFp(floDst.fp);
+        _MarkDirty(icrp);
         if (pvNil != pflo)
             *pflo = floDst;
     }
@@ -1961,7 +3567,7 @@ bool CFL::_FEnsureOnExtra(long icrp, FLO *pflo)
 
         qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
         stn.FFormatSz(PszLit("Fetch from extra: '%f', 0x%08x, fp = 0x%08x, cb = 0x%08x"), qcrp->cki.ctg, qcrp->cki.cno,
-                      qcrp->fp, qcrp->Cb());
+                      (long)qcrp->Fp(), qcrp->Cb());
         DumpStn(&stn, _csto.pfil);
     }
 #endif // CHUNK_STATS
@@ -1983,7 +3589,7 @@ void CFL::_GetFlo(long icrp, PFLO pflo)
 
         qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
         pflo->pfil = qcrp->Grfcrp(fcrpOnExtra) ? _cstoExtra.pfil : _csto.pfil;
-        pflo->fp = qcrp->fp;
+        pflo->fp = qcrp->Fp();
         pflo->cb = qcrp->Cb();
 
 #ifdef CHUNK_STATS
@@ -1994,7 +3600,7 @@ void CFL::_GetFlo(long icrp, PFLO pflo)
             qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
             stn.FFormatSz(PszLit("Fetch from %z: '%f', 0x%08x, fp = 0x%08x, cb = 0x%08x"),
                           qcrp->Grfcrp(fcrpOnExtra) ? PszLit("extra") : PszLit("main"), qcrp->cki.ctg, qcrp->cki.cno,
-                          qcrp->fp, qcrp->Cb());
+                          (long)qcrp->Fp(), qcrp->Cb());
             DumpStn(&stn, _csto.pfil);
         }
 #endif // CHUNK_STATS
@@ -2035,155 +3641,799 @@ bool CFL::FFind(CTG ctg, CNO cno, BLCK *pblck)
         return fFalse;
     }
 
-    if (pvNil != pblck)
-        _GetBlck(icrp, pblck);
+    if (pvNil != pblck)
+        _GetBlck(icrp, pblck);
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Map the (ctg, cno) to a pflo.
+***************************************************************************/
+bool CFL::FFindFlo(CTG ctg, CNO cno, PFLO pflo)
+{
+    AssertThis(0);
+    AssertVarMem(pflo);
+
+    long icrp;
+
+    if (!_FFindCtgCno(ctg, cno, &icrp))
+    {
+        TrashVar(pflo);
+        return fFalse;
+    }
+
+    _GetFlo(icrp, pflo);
+    return fTrue;
+}
+
+/***************************************************************************
+    Reads the chunk (if it exists) into an hq.  Returns false if the
+    chunk doesn't exist or something failed, in which case *phq is set
+    to hqNil.  Doesn't unpack the data if it's packed.
+***************************************************************************/
+bool CFL::FReadHq(CTG ctg, CNO cno, HQ *phq)
+{
+    AssertThis(0);
+    AssertVarMem(phq);
+    BLCK blck;
+
+    *phq = hqNil; // in case FFind fails
+    return FFind(ctg, cno, &blck) && blck.FReadHq(phq, fTrue);
+}
+
+/***************************************************************************
+    An entry in the FReadRghq read list.  The list is kept sorted by file
+    and offset.
+***************************************************************************/
+struct BRE
+{
+    FLO flo;
+    long icki;
+    bool fPacked;
+};
+
+/***************************************************************************
+    Reads a batch of chunks into hq's.  prghq[icki] gets the data for
+    prgcki[icki].  The file reads are done in file offset order rather than
+    request order, and unless fPackedOk is set, the packed chunks are
+    decompressed together by vpcodmUtil->FDecompressRghq, which spreads the
+    work across the available processors.  Returns false if any of the
+    chunks doesn't exist or something failed, in which case all the hq's
+    are set to hqNil.
+***************************************************************************/
+bool CFL::FReadRghq(CKI *prgcki, long ccki, HQ *prghq, bool fPackedOk)
+{
+    AssertThis(0);
+    AssertIn(ccki, 0, kcbMax);
+    AssertPvCb(prgcki, LwMul(ccki, size(CKI)));
+    AssertPvCb(prghq, LwMul(ccki, size(HQ)));
+
+    long icki, icrp, ibre, ibreMin, ibreLim;
+    BRE bre, breT;
+    CRP *qcrp;
+    PGL pglbre = pvNil;
+    HQ *prghqPacked = pvNil;
+    bool fRet = fFalse;
+
+    for (icki = 0; icki < ccki; icki++)
+        prghq[icki] = hqNil;
+
+    if (pvNil == (pglbre = GL::PglNew(size(BRE), ccki)))
+        goto LFail;
+
+    // build the read list in file order
+    for (icki = 0; icki < ccki; icki++)
+    {
+        if (!_FFindCtgCno(prgcki[icki].ctg, prgcki[icki].cno, &icrp))
+            goto LFail;
+
+        _GetFlo(icrp, &bre.flo);
+        qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+        bre.fPacked = FPure(qcrp->Grfcrp(fcrpPacked));
+        bre.icki = icki;
+
+        for (ibreMin = 0, ibreLim = pglbre->IvMac(); ibreMin < ibreLim;)
+        {
+            ibre = (ibreMin + ibreLim) / 2;
+            pglbre->Get(ibre, &breT);
+            if (breT.flo.pfil < bre.flo.pfil || breT.flo.pfil == bre.flo.pfil && breT.flo.fp <= bre.flo.fp)
+                ibreMin = ibre + 1;
+            else
+                ibreLim = ibre;
+        }
+        if (!pglbre->FInsert(ibreMin, &bre))
+            goto LFail;
+    }
+
+    for (ibre = 0; ibre < ccki; ibre++)
+    {
+        pglbre->Get(ibre, &bre);
+        if (!bre.flo.FReadHq(&prghq[bre.icki]))
+            goto LFail;
+    }
+
+    if (!fPackedOk)
+    {
+        // decompress all the packed chunks as one batch
+        if (!FAllocPv((void **)&prghqPacked, LwMul(LwMax(ccki, 1), size(HQ)), fmemClear, mprNormal))
+            goto LFail;
+        for (ibre = 0; ibre < ccki; ibre++)
+        {
+            pglbre->Get(ibre, &bre);
+            prghqPacked[ibre] = bre.fPacked ? prghq[bre.icki] : hqNil;
+        }
+        if (!vpcodmUtil->FDecompressRghq(prghqPacked, ccki))
+            goto LFail;
+        for (ibre = 0; ibre < ccki; ibre++)
+        {
+            pglbre->Get(ibre, &bre);
+            if (bre.fPacked)
+                prghq[bre.icki] = prghqPacked[ibre];
+        }
+    }
+
+    fRet = fTrue;
+
+LFail:
+    if (!fRet)
+    {
+        for (icki = 0; icki < ccki; icki++)
+            FreePhq(&prghq[icki]);
+    }
+    FreePpv((void **)&prghqPacked);
+    ReleasePpo(&pglbre);
+
+    return fRet;
+}
+
+/***************************************************************************
+    Find a batch of chunks.  prgblck[icki] gets the data for prgcki[icki],
+    as if by FFind followed by BLCK::FUnpackData, except that the packed
+    chunks are read and decompressed together (see FReadRghq).  Unpacked
+    chunks are left on the file, so readers can still use the mapping.
+    Returns false if any of the chunks doesn't exist or something failed,
+    in which case all the blocks are freed.
+***************************************************************************/
+bool CFL::FFindRgblck(CKI *prgcki, long ccki, BLCK *prgblck)
+{
+    AssertThis(0);
+    AssertIn(ccki, 0, kcbMax);
+    AssertPvCb(prgcki, LwMul(ccki, size(CKI)));
+    AssertPvCb(prgblck, LwMul(ccki, size(BLCK)));
+
+    long icki, ickiPacked, cckiPacked;
+    CKI *prgckiPacked = pvNil;
+    HQ *prghqPacked = pvNil;
+    bool fRet = fFalse;
+
+    if (!FAllocPv((void **)&prgckiPacked, LwMul(LwMax(ccki, 1), size(CKI)), fmemNil, mprNormal) ||
+        !FAllocPv((void **)&prghqPacked, LwMul(LwMax(ccki, 1), size(HQ)), fmemClear, mprNormal))
+    {
+        goto LFail;
+    }
+
+    cckiPacked = 0;
+    for (icki = 0; icki < ccki; icki++)
+    {
+        if (!FFind(prgcki[icki].ctg, prgcki[icki].cno, &prgblck[icki]))
+            goto LFail;
+        if (prgblck[icki].FPacked())
+            prgckiPacked[cckiPacked++] = prgcki[icki];
+    }
+
+    if (cckiPacked > 0)
+    {
+        if (!FReadRghq(prgckiPacked, cckiPacked, prghqPacked))
+            goto LFail;
+        for (icki = ickiPacked = 0; icki < ccki; icki++)
+        {
+            if (prgblck[icki].FPacked())
+                prgblck[icki].SetHq(&prghqPacked[ickiPacked++]);
+        }
+        Assert(ickiPacked == cckiPacked, "lost track of the packed chunks");
+    }
+    fRet = fTrue;
+
+LFail:
+    if (!fRet)
+    {
+        for (icki = 0; icki < ccki; icki++)
+            prgblck[icki].Free();
+    }
+    FreePpv((void **)&prgckiPacked);
+    FreePpv((void **)&prghqPacked);
+
+    return fRet;
+}
+
+/***************************************************************************
+    If the chunky file is memory mapped (see fcflMapped), return a pointer
+    to the chunk's data in the view, without reading or copying it.
+    Returns pvNil if the chunk doesn't exist, is packed, lives on the extra
+    file or the file isn't mapped - in which case the caller should use
+    FFind or FReadHq. The pointer is valid until the file is closed or
+    write enabled, so callers must hold a reference to the CFL while
+    using it and must not write through it.
+***************************************************************************/
+void *CFL::PvFindMap(CTG ctg, CNO cno, long *pcb)
+{
+    AssertThis(0);
+    AssertNilOrVarMem(pcb);
+    long icrp;
+    CRP *qcrp;
+    FLO flo;
+    void *pv;
+
+    if (pvNil != pcb)
+        *pcb = 0;
+
+    if (!_csto.pfil->FMapped() || !_FFindCtgCno(ctg, cno, &icrp))
+        return pvNil;
+
+    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+    if (qcrp->Grfcrp(fcrpPacked))
+        return pvNil;
+
+    _GetFlo(icrp, &flo);
+    if (pvNil != (pv = flo.PvMap()) && pvNil != pcb)
+        *pcb = flo.cb;
+    return pv;
+}
+
+/***************************************************************************
+    Make sure the packed flag is set or clear according to fPacked.
+    This doesn't affect the data at all.
+***************************************************************************/
+void CFL::SetPacked(CTG ctg, CNO cno, bool fPacked)
+{
+    AssertThis(0);
+    long icrp;
+    CRP *qcrp;
+
+    if (!_FFindCtgCno(ctg, cno, &icrp))
+    {
+        Bug("chunk not there");
+        return;
+    }
+    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+    Assert(qcrp->cki.ctg == ctg && qcrp->cki.cno == cno, 0);
+    if (FPure(qcrp->Grfcrp(fcrpPacked)) != FPure(fPacked))
+    {
+        if (fPacked)
+            qcrp->SetGrfcrp(fcrpPacked);
+        else
+            qcrp->ClearGrfcrp(fcrpPacked);
+        _FSetRti(ctg, cno, rtiNil);
+        _MarkDirty(icrp);
+    }
+}
+
+/***************************************************************************
+    Return the value of the packed flag.
+***************************************************************************/
+bool CFL::FPacked(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+    long icrp;
+    CRP *qcrp;
+
+    if (!_FFindCtgCno(ctg, cno, &icrp))
+    {
+        Bug("chunk not there");
+        return fFalse;
+    }
+    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+    Assert(qcrp->cki.ctg == ctg && qcrp->cki.cno == cno, 0);
+    return FPure(qcrp->Grfcrp(fcrpPacked));
+}
+
+/***************************************************************************
+    If the data for the chunk is packed, unpack it.
+***************************************************************************/
+bool CFL::FUnpackData(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+    BLCK blck;
+
+    if (!FPacked(ctg, cno))
+        return fTrue;
+
+    AssertDo(FFind(ctg, cno, &blck), 0);
+    if (!blck.FUnpackData())
+        return fFalse;
+    return FPutBlck(&blck, ctg, cno);
+}
+
+/***************************************************************************
+    If the data isn't already packed, pack it. If cfmt is cfmtNil, this
+    uses CfmtPack(). KCD2 data is packed with the ctg's dictionary,
+    if it has one.
+***************************************************************************/
+bool CFL::FPackData(CTG ctg, CNO cno, long cfmt)
+{
+    AssertThis(0);
+    BLCK blck;
+    ulong luDict;
+
+    if (FPacked(ctg, cno))
+        return fTrue;
+
+    cfmt = _CfmtPackCtg(ctg, cfmt, &luDict);
+    AssertDo(FFind(ctg, cno, &blck), 0);
+    if (!blck.FPackData(cfmt, luDict))
+        return fFalse;
+    return FPutBlck(&blck, ctg, cno);
+}
+
+// most unpacked data FPackDataRgcki reads in before compressing it
+const long kcbPackBatchMax = 0x01000000;
+
+/***************************************************************************
+    Pack the data of a set of chunks. The chunks are read in batches and
+    each batch is compressed by vpcodmUtil->FCompressRghq, which spreads
+    the work across the available processors. As with FPackData, chunks
+    that are already packed are skipped and chunks that don't compress are
+    left unpacked. If cfmt is cfmtNil, this uses CfmtPack(). As
+    with FPackData, KCD2 data is packed with the ctg's dictionary, so a
+    batch ends where the dictionary changes. Returns false if reading or
+    writing the data fails.
+***************************************************************************/
+bool CFL::FPackDataRgcki(CKI *prgcki, long ccki, long cfmt)
+{
+    AssertThis(0);
+    AssertIn(ccki, 0, kcbMax);
+    AssertPvCb(prgcki, LwMul(ccki, size(CKI)));
+
+    long icki, ickiMin, ickiLim, cbBatch;
+    long cfmtBatch;
+    ulong luDict, luDictT;
+    BLCK blck;
+    HQ *prghq = pvNil;
+    bool *prgfPacked = pvNil;
+    bool fRet = fFalse;
+
+    if (0 == ccki)
+        return fTrue;
+
+    if (cfmtNil == cfmt)
+        cfmt = CfmtPack();
+    if (!FAllocPv((void **)&prghq, LwMul(ccki, size(HQ)), fmemClear, mprNormal) ||
+        !FAllocPv((void **)&prgfPacked, LwMul(ccki, size(bool)), fmemClear, mprNormal))
+    {
+        goto LFail;
+    }
+
+    for (ickiMin = 0; ickiMin < ccki; ickiMin = ickiLim)
+    {
+        // read the next batch
+        cfmtBatch = _CfmtPackCtg(prgcki[ickiMin].ctg, cfmt, &luDict);
+        for (ickiLim = ickiMin, cbBatch = 0; ickiLim < ccki && cbBatch < kcbPackBatchMax; ickiLim++)
+        {
+            if (ickiLim > ickiMin && prgcki[ickiLim].ctg != prgcki[ickiLim - 1].ctg &&
+                (_CfmtPackCtg(prgcki[ickiLim].ctg, cfmt, &luDictT) != cfmtBatch || luDictT != luDict))
+            {
+                break;
+            }
+            if (!FFind(prgcki[ickiLim].ctg, prgcki[ickiLim].cno, &blck))
+            {
+                Bug("chunk not there");
+                goto LFail;
+            }
+            if (blck.FPacked() || 0 == blck.Cb())
+                continue;
+            if (!blck.FReadHq(&prghq[ickiLim]))
+                goto LFail;
+            cbBatch += blck.Cb();
+        }
+
+        if (!vpcodmUtil->FCompressRghq(prghq + ickiMin, prgfPacked + ickiMin, ickiLim - ickiMin, cfmtBatch, luDict))
+            goto LFail;
+
+        for (icki = ickiMin; icki < ickiLim; icki++)
+        {
+            if (!prgfPacked[icki])
+            {
+                FreePhq(&prghq[icki]);
+                continue;
+            }
+            blck.SetHq(&prghq[icki], fTrue);
+            if (!FPutBlck(&blck, prgcki[icki].ctg, prgcki[icki].cno))
+                goto LFail;
+        }
+    }
+    fRet = fTrue;
+
+LFail:
+    if (pvNil != prghq)
+    {
+        for (icki = 0; icki < ccki; icki++)
+            FreePhq(&prghq[icki]);
+    }
+    FreePpv((void **)&prghq);
+    FreePpv((void **)&prgfPacked);
+
+    return fRet;
+}
+
+/***************************************************************************
+    Return the format to pack chunks of type ctg in, given the format asked
+    for (cfmtNil for CfmtPack()). KCD2 data of a type with a
+    dictionary is packed with the dictionary. Fills *pluDict with the
+    dictionary to pack with, or 0 if there isn't one.
+***************************************************************************/
+long CFL::_CfmtPackCtg(CTG ctg, long cfmt, ulong *pluDict)
+{
+    AssertThis(0);
+    AssertVarMem(pluDict);
+
+    *pluDict = 0;
+    if (cfmtNil == cfmt)
+        cfmt = CfmtPack();
+    if (kcfmtKauai2 != cfmt && kcfmtKauai2Dict != cfmt)
+        return cfmt;
+
+    if (0 == (*pluDict = LuDict(ctg)) || !vpcodmUtil->FCanDo(kcfmtKauai2Dict, fTrue))
+    {
+        *pluDict = 0;
+        return kcfmtKauai2;
+    }
+    return kcfmtKauai2Dict;
+}
+
+/***************************************************************************
+    Return the format FPackData uses by default. Data that is only going to
+    a temp file or the extra file gets the fast codec, since we're the only
+    ones that will read it; FSave repacks it before it goes anywhere else.
+***************************************************************************/
+long CFL::CfmtPack(void)
+{
+    AssertThis(0);
+
+    if ((_fAddToExtra || FTemp()) && vpcodmUtil->FCanDo(kcfmtKauaiFast, fTrue))
+        return kcfmtKauaiFast;
+    return vpcodmUtil->CfmtDefault();
+}
+
+/***************************************************************************
+    Repack any chunks packed with kcfmtKauaiFast in the default format.
+    Chunks that don't compress in the default format are left unpacked.
+***************************************************************************/
+bool CFL::_FRepackFast(void)
+{
+    AssertThis(0);
+    long icrp, cfmt;
+    ulong luDict;
+    CKI cki;
+    CRP *qcrp;
+    BLCK blck;
+
+    if (!_fFast && !FTemp())
+        return fTrue;
+    if (kcfmtKauaiFast == vpcodmUtil->CfmtDefault())
+        return fTrue;
+
+    for (icrp = 0; icrp < _pggcrp->IvMac(); icrp++)
+    {
+        qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+        if (!qcrp->Grfcrp(fcrpPacked))
+            continue;
+        cki = qcrp->cki;
+        _GetBlck(icrp, &blck);
+        if (!blck.FPacked(&cfmt) || kcfmtKauaiFast != cfmt)
+            continue;
+        cfmt = _CfmtPackCtg(cki.ctg, vpcodmUtil->CfmtDefault(), &luDict);
+        if (!blck.FUnpackData() || !blck.FPackData(cfmt, luDict) || !FPutBlck(&blck, cki.ctg, cki.cno))
+            return fFalse;
+    }
+    _fFast = fFalse;
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Return the id of the dictionary chunks of type ctg are packed with, or
+    0 if there isn't one.
+***************************************************************************/
+ulong CFL::LuDict(CTG ctg)
+{
+    AssertThis(0);
+    long idcte;
+    DCTE dcte;
+
+    if (pvNil == _pgldcte)
+        return 0;
+    for (idcte = _pgldcte->IvMac(); idcte-- > 0;)
+    {
+        _pgldcte->Get(idcte, &dcte);
+        if (dcte.ctg == ctg)
+            return dcte.luDict;
+    }
+    return 0;
+}
+
+/***************************************************************************
+    Set the compression dictionary for chunks of type ctg. The dictionary
+    is saved as the (kctgDict, ctg) chunk. A dictionary should be a sample
+    of the byte strings that turn up in many of the chunks (see the
+    chdict tool). KCD2 data packed from then on starts out with the
+    dictionary in its window, which helps small chunks a lot. Chunks of
+    the type that are packed with the old dictionary are unpacked first.
+    If cb is zero, this removes the dictionary.
+***************************************************************************/
+bool CFL::FSetDict(CTG ctg, void *pv, long cb)
+{
+    AssertThis(0);
+    AssertIn(cb, 0, kcbDictMax + 1);
+    AssertPvCb(pv, cb);
+    Assert(kctgDict != ctg, "dictionaries can't have dictionaries");
+
+    long icki, cfmt;
+    CKI cki;
+    BLCK blck;
+
+    if (0 != LuDict(ctg))
+    {
+        for (icki = CckiCtg(ctg); icki-- > 0;)
+        {
+            AssertDo(FGetCkiCtg(ctg, icki, &cki, pvNil, &blck), 0);
+            if (blck.FPacked(&cfmt) && kcfmtKauai2Dict == cfmt && !FUnpackData(cki.ctg, cki.cno))
+                return fFalse;
+        }
+    }
+
+    if (0 == cb)
+    {
+        if (FFind(kctgDict, ctg))
+            Delete(kctgDict, ctg);
+    }
+    else if (!FPutPv(pv, cb, kctgDict, ctg))
+        return fFalse;
+
+    return _FLoadDicts();
+}
+
+/***************************************************************************
+    Register the dictionaries in the kctgDict chunks with vpcodmUtil,
+    replacing the ones registered before.
+***************************************************************************/
+bool CFL::_FLoadDicts(void)
+{
+    AssertThis(0);
+
+    long icki, ccki;
+    CKI cki;
+    BLCK blck;
+    DCTE dcte;
+    HQ hq = hqNil;
+    PGL pgldcte = pvNil;
+    bool fRet = fFalse;
+
+    _fDict = (ccki = CckiCtg(kctgDict)) > 0;
+    if (0 == ccki)
+    {
+        _ReleasePgldcte(&_pgldcte);
+        return fTrue;
+    }
+
+    if (pvNil == (pgldcte = GL::PglNew(size(DCTE), ccki)))
+        return fFalse;
+    for (icki = 0; icki < ccki; icki++)
+    {
+        AssertDo(FGetCkiCtg(kctgDict, icki, &cki, pvNil, &blck), 0);
+        if (!blck.FUnpackData() || !blck.FReadHq(&hq))
+            goto LFail;
+        if (!FIn(CbOfHq(hq), 1, kcbDictMax + 1))
+        {
+            Warn("bad dictionary chunk");
+            FreePhq(&hq);
+            continue;
+        }
+
+        dcte.ctg = cki.cno;
+        if (!vpcodmUtil->FAddDict(QvFromHq(hq), CbOfHq(hq), &dcte.luDict))
+            goto LFail;
+        FreePhq(&hq);
+        if (!pgldcte->FAdd(&dcte))
+        {
+            vpcodmUtil->ReleaseDict(dcte.luDict);
+            goto LFail;
+        }
+    }
+
+    SwapVars(&_pgldcte, &pgldcte);
+    fRet = fTrue;
 
-    return fTrue;
+LFail:
+    FreePhq(&hq);
+    _ReleasePgldcte(&pgldcte);
+    return fRet;
 }
 
 /***************************************************************************
-    Map the (ctg, cno) to a pflo.
+    Create the extra file.  Note: the extra file doesn't have a CFP -
+    just raw data.
 ***************************************************************************/
-bool CFL::FFindFlo(CTG ctg, CNO cno, PFLO pflo)
+bool CFL::_FCreateExtra(void)
 {
-    AssertThis(0);
-    AssertVarMem(pflo);
-
-    long icrp;
+    AssertBaseThis(0);
+    Assert(_cstoExtra.pfil == pvNil, 0);
+    Assert(_cstoExtra.pglfsm == pvNil, 0);
 
-    if (!_FFindCtgCno(ctg, cno, &icrp))
-    {
-        TrashVar(pflo);
+    if (pvNil == (_cstoExtra.pfil = FIL::PfilCreateTemp()))
         return fFalse;
-    }
 
-    _GetFlo(icrp, pflo);
+    _cstoExtra.fpMac = 0;
     return fTrue;
 }
 
 /***************************************************************************
-    Reads the chunk (if it exists) into an hq.  Returns false if the
-    chunk doesn't exist or something failed, in which case *phq is set
-    to hqNil.  Doesn't unpack the data if it's packed.
+    Look for the free block starting at fp in the (fp sorted) free map.
+    Fills *pifsm with where it is or would be.
 ***************************************************************************/
-bool CFL::FReadHq(CTG ctg, CNO cno, HQ *phq)
+priv bool _FFindFsm(PGL pglfsm, FP fp, long *pifsm)
 {
-    AssertThis(0);
-    AssertVarMem(phq);
-    BLCK blck;
+    AssertPo(pglfsm, 0);
+    AssertVarMem(pifsm);
+    long ifsm, ifsmMin, ifsmLim;
+    FSM *qrgfsm;
 
-    *phq = hqNil; // in case FFind fails
-    return FFind(ctg, cno, &blck) && blck.FReadHq(phq, fTrue);
+    if ((ifsmLim = pglfsm->IvMac()) == 0)
+    {
+        *pifsm = 0;
+        return fFalse;
+    }
+
+    qrgfsm = (FSM *)pglfsm->QvGet(0);
+    for (ifsmMin = 0; ifsmMin < ifsmLim;)
+    {
+        ifsm = (ifsmMin + ifsmLim) / 2;
+        if (qrgfsm[ifsm].fp < fp)
+            ifsmMin = ifsm + 1;
+        else
+            ifsmLim = ifsm;
+    }
+
+    *pifsm = ifsmMin;
+    return ifsmMin < pglfsm->IvMac() && qrgfsm[ifsmMin].fp == fp;
 }
 
 /***************************************************************************
-    Make sure the packed flag is set or clear according to fPacked.
-    This doesn't affect the data at all.
+    Look for the free block (cb, fp) in the size sorted free map. Fills
+    *pifsm with where it is or would be. Passing fp == 0 finds the first
+    block that is at least cb bytes long.
 ***************************************************************************/
-void CFL::SetPacked(CTG ctg, CNO cno, bool fPacked)
+priv bool _FFindFsmCb(PGL pglfsmCb, long cb, FP fp, long *pifsm)
 {
-    AssertThis(0);
-    long icrp;
-    CRP *qcrp;
+    AssertPo(pglfsmCb, 0);
+    AssertVarMem(pifsm);
+    long ifsm, ifsmMin, ifsmLim;
+    FSM *qrgfsm;
 
-    if (!_FFindCtgCno(ctg, cno, &icrp))
+    if ((ifsmLim = pglfsmCb->IvMac()) == 0)
     {
-        Bug("chunk not there");
-        return;
+        *pifsm = 0;
+        return fFalse;
     }
-    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
-    Assert(qcrp->cki.ctg == ctg && qcrp->cki.cno == cno, 0);
-    if (FPure(qcrp->Grfcrp(fcrpPacked)) != FPure(fPacked))
+
+    qrgfsm = (FSM *)pglfsmCb->QvGet(0);
+    for (ifsmMin = 0; ifsmMin < ifsmLim;)
     {
-        if (fPacked)
-            qcrp->SetGrfcrp(fcrpPacked);
+        ifsm = (ifsmMin + ifsmLim) / 2;
+        if (qrgfsm[ifsm].cb < cb || qrgfsm[ifsm].cb == cb && qrgfsm[ifsm].fp < fp)
+            ifsmMin = ifsm + 1;
         else
-            qcrp->ClearGrfcrp(fcrpPacked);
-        _FSetRti(ctg, cno, rtiNil);
+            ifsmLim = ifsm;
     }
+
+    *pifsm = ifsmMin;
+    return ifsmMin < pglfsmCb->IvMac() && qrgfsm[ifsmMin].cb == cb && qrgfsm[ifsmMin].fp == fp;
 }
 
 /***************************************************************************
-    Return the value of the packed flag.
+    Add a free block to the size sorted free map. If this fails, the size
+    sorted map is freed (it will be rebuilt when next needed).
 ***************************************************************************/
-bool CFL::FPacked(CTG ctg, CNO cno)
+priv void _AddFsmCb(PGL *ppglfsmCb, FSM *pfsm)
 {
-    AssertThis(0);
-    long icrp;
-    CRP *qcrp;
+    AssertVarMem(ppglfsmCb);
+    AssertVarMem(pfsm);
+    long ifsm;
 
-    if (!_FFindCtgCno(ctg, cno, &icrp))
+    if (pvNil == *ppglfsmCb)
+        return;
+
+    if (_FFindFsmCb(*ppglfsmCb, pfsm->cb, pfsm->fp, &ifsm))
     {
-        Bug("chunk not there");
-        return fFalse;
+        Bug("free block already in size map");
+        return;
     }
-    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
-    Assert(qcrp->cki.ctg == ctg && qcrp->cki.cno == cno, 0);
-    return FPure(qcrp->Grfcrp(fcrpPacked));
+    if (!(*ppglfsmCb)->FInsert(ifsm, pfsm))
+        ReleasePpo(ppglfsmCb);
 }
 
 /***************************************************************************
-    If the data for the chunk is packed, unpack it.
+    Remove a free block from the size sorted free map.
 ***************************************************************************/
-bool CFL::FUnpackData(CTG ctg, CNO cno)
+priv void _RemoveFsmCb(PGL *ppglfsmCb, FSM *pfsm)
 {
-    AssertThis(0);
-    BLCK blck;
+    AssertVarMem(ppglfsmCb);
+    AssertVarMem(pfsm);
+    long ifsm;
 
-    if (!FPacked(ctg, cno))
-        return fTrue;
+    if (pvNil == *ppglfsmCb)
+        return;
 
-    AssertDo(FFind(ctg, cno, &blck), 0);
-    if (!blck.FUnpackData())
-        return fFalse;
-    return FPutBlck(&blck, ctg, cno);
+    if (!_FFindFsmCb(*ppglfsmCb, pfsm->cb, pfsm->fp, &ifsm))
+    {
+        Bug("free block not in size map");
+        ReleasePpo(ppglfsmCb);
+        return;
+    }
+    (*ppglfsmCb)->Delete(ifsm);
 }
 
 /***************************************************************************
-    If the data isn't already packed, pack it.
+    Make sure the size sorted copy of the free map exists. Returns false
+    if there is no free map or we couldn't build the copy.
 ***************************************************************************/
-bool CFL::FPackData(CTG ctg, CNO cno)
+bool CFL::_FEnsureFsmCb(CSTO *pcsto)
 {
-    AssertThis(0);
-    BLCK blck;
+    AssertBaseThis(0);
+    AssertVarMem(pcsto);
+    long ifsm, cfsm;
+    FSM fsm;
 
-    if (FPacked(ctg, cno))
+    if (pvNil != pcsto->pglfsmCb)
         return fTrue;
+    if (pvNil == pcsto->pglfsm)
+        return fFalse;
 
-    AssertDo(FFind(ctg, cno, &blck), 0);
-    if (!blck.FPackData())
+    cfsm = pcsto->pglfsm->IvMac();
+    if (pvNil == (pcsto->pglfsmCb = GL::PglNew(size(FSM), cfsm)))
         return fFalse;
-    return FPutBlck(&blck, ctg, cno);
+
+    for (ifsm = 0; ifsm < cfsm && pvNil != pcsto->pglfsmCb; ifsm++)
+    {
+        pcsto->pglfsm->Get(ifsm, &fsm);
+        _AddFsmCb(&pcsto->pglfsmCb, &fsm);
+    }
+
+    return pvNil != pcsto->pglfsmCb;
 }
 
 /***************************************************************************
-    Create the extra file.  Note: the extra file doesn't have a CFP -
-    just raw data.
+    Find a place to put a block the given size. Keeps the allocation
+    statistics.
 ***************************************************************************/
-bool CFL::_FCreateExtra(void)
+bool CFL::_FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra)
 {
     AssertBaseThis(0);
-    Assert(_cstoExtra.pfil == pvNil, 0);
-    Assert(_cstoExtra.pglfsm == pvNil, 0);
+    ulong tsStart = TsCurrentPrecise();
+    bool fRet;
 
-    if (pvNil == (_cstoExtra.pfil = FIL::PfilCreateTemp()))
-        return fFalse;
+    fRet = _FAllocFloCore(cb, pflo, fForceOnExtra);
+    _dtsAlloc += TsCurrentPrecise() - tsStart;
+    if (fRet && cb > 0)
+        _calloc++;
 
-    _cstoExtra.fpMac = 0;
-    return fTrue;
+    return fRet;
 }
 
 /***************************************************************************
-    Find a place to put a block the given size.
+    Find a place to put a block the given size. This uses the smallest
+    free block that's big enough. If no free block is big enough, the
+    space is added to the end of the file.
 ***************************************************************************/
-bool CFL::_FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra)
+bool CFL::_FAllocFloCore(long cb, PFLO pflo, bool fForceOnExtra)
 {
     AssertBaseThis(0);
     AssertIn(cb, 0, kcbMax);
     AssertVarMem(pflo);
 
     CSTO *pcsto;
-    long cfsm, ifsm;
+    long cfsm, ifsm, ifsmCb;
+    FSM fsm;
     FSM *qfsm;
 
     if (cb > kcbMaxCrp)
@@ -2222,6 +4472,36 @@ bool CFL::_FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra)
     // look for a free spot in the free space map
     if (pcsto->pglfsm != pvNil && (cfsm = pcsto->pglfsm->IvMac()) > 0)
     {
+        if (_FEnsureFsmCb(pcsto))
+        {
+            // use the smallest free block that's big enough
+            _FFindFsmCb(pcsto->pglfsmCb, cb, 0, &ifsmCb);
+            if (ifsmCb >= pcsto->pglfsmCb->IvMac())
+                goto LAppend;
+
+            pcsto->pglfsmCb->Get(ifsmCb, &fsm);
+            if (_FFindFsm(pcsto->pglfsm, fsm.fp, &ifsm))
+            {
+                pcsto->pglfsmCb->Delete(ifsmCb);
+                pflo->fp = fsm.fp;
+                if (fsm.cb == cb)
+                    pcsto->pglfsm->Delete(ifsm);
+                else
+                {
+                    fsm.cb -= cb;
+                    fsm.fp += cb;
+                    pcsto->pglfsm->Put(ifsm, &fsm);
+                    _AddFsmCb(&pcsto->pglfsmCb, &fsm);
+                }
+                _callocReuse++;
+                return fTrue;
+            }
+
+            Bug("free maps out of sync");
+            ReleasePpo(&pcsto->pglfsmCb);
+        }
+
+        // no size map, so take the first free block that's big enough
         qfsm = (FSM *)pcsto->pglfsm->QvGet(0);
         for (ifsm = 0; ifsm < cfsm; ifsm++, qfsm++)
         {
@@ -2236,11 +4516,13 @@ bool CFL::_FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra)
                     qfsm->cb -= cb;
                     qfsm->fp += cb;
                 }
+                _callocReuse++;
                 return fTrue;
             }
         }
     }
 
+LAppend:
     // put it at the end of the file
     if (pcsto->fpMac + cb > pcsto->pfil->FpMac() && !pcsto->pfil->FSetFpMac(pcsto->fpMac + cb))
     {
@@ -2256,7 +4538,10 @@ bool CFL::_FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra)
 /***************************************************************************
     Look for the (ctg, cno) pair.  Fills *picrp with where it should be.
     Returns whether or not it was found.  Assumes the _pggcrp is sorted
-    by (ctg, cno).  Does a binary search.
+    by (ctg, cno).  If the index hash table is built, probes it and only
+    binary searches the ctg's range when the chunk isn't there.  Otherwise
+    (a small index, or one that changed recently - see _FEnsureIndexHash)
+    binary searches the whole index.
 ***************************************************************************/
 bool CFL::_FFindCtgCno(CTG ctg, CNO cno, long *picrp)
 {
@@ -2275,7 +4560,35 @@ bool CFL::_FFindCtgCno(CTG ctg, CNO cno, long *picrp)
         return fFalse;
     }
 
-    for (icrpMin = 0, icrpLim = ccrp; icrpMin < icrpLim;)
+    if (_FEnsureIndexHash())
+    {
+        long islot, islotMask;
+        long *qrgicrp;
+
+        qrgicrp = (long *)_pglicrpHash->QvGet(0);
+        islotMask = _pglicrpHash->IvMac() - 1;
+        for (islot = _LwHashCki(ctg, cno) & islotMask; ivNil != (icrp = qrgicrp[islot]);
+             islot = (islot + 1) & islotMask)
+        {
+            cki = ((CRP *)_pggcrp->QvFixedGet(icrp))->cki;
+            if (cki.ctg == ctg && cki.cno == cno)
+            {
+                *picrp = icrp;
+                return fTrue;
+            }
+        }
+
+        // it's not there - we only need to search the ctg's range for
+        // where it would go
+        _GetCtgRange(ctg, &icrpMin, &icrpLim);
+    }
+    else
+    {
+        icrpMin = 0;
+        icrpLim = ccrp;
+    }
+
+    while (icrpMin < icrpLim)
     {
         icrp = (icrpMin + icrpLim) / 2;
         cki = ((CRP *)_pggcrp->QvFixedGet(icrp))->cki;
@@ -2299,6 +4612,196 @@ bool CFL::_FFindCtgCno(CTG ctg, CNO cno, long *picrp)
     return fFalse;
 }
 
+/***************************************************************************
+    Make sure the hash table and ctg range table for the index exist.
+    Returns false if the index is too small to bother with them, it
+    changed too recently or we couldn't allocate them, in which case the
+    caller should just binary search the index.
+***************************************************************************/
+bool CFL::_FEnsureIndexHash(void)
+{
+    // WARNING:  this is called by CFL::AssertValid (via _FFindCtgCno), so
+    // be careful about asserting stuff in here
+    AssertBaseThis(0);
+    long ccrp, cslot, icrp, islot, islotMask;
+    long *qrgicrp;
+    CTGR ctgr;
+    CKI cki;
+
+    if (pvNil != _pglicrpHash)
+        return fTrue;
+
+    ccrp = _pggcrp->IvMac();
+    if (ccrp < kccrpMinHash)
+        return fFalse;
+
+    // If the index has been changing, wait until there have been enough
+    // lookups since the last change to make the rebuild worth it. Until
+    // then, callers binary search.
+    if (_fIndexHashStale)
+    {
+        if (++_cactFindStale < ccrp / kccrpPerFindRebuild)
+            return fFalse;
+        _fIndexHashStale = fFalse;
+    }
+
+    // keep the table at most half full
+    for (cslot = 2 * kccrpMinHash; cslot < 2 * ccrp; cslot <<= 1)
+        ;
+
+    if (pvNil == (_pglctgr = GL::PglNew(size(CTGR))) || pvNil == (_pglicrpHash = GL::PglNew(size(long), cslot)) ||
+        !_pglicrpHash->FSetIvMac(cslot))
+    {
+        goto LFail;
+    }
+
+    // build the ctg ranges
+    for (icrp = 0; icrp < ccrp; icrp++)
+    {
+        cki = ((CRP *)_pggcrp->QvFixedGet(icrp))->cki;
+        if (icrp == 0 || cki.ctg != ctgr.ctg)
+        {
+            ctgr.ctg = cki.ctg;
+            ctgr.icrpMin = icrp;
+            if (!_pglctgr->FAdd(&ctgr))
+                goto LFail;
+        }
+    }
+
+    // build the hash table
+    qrgicrp = (long *)_pglicrpHash->QvGet(0);
+    FillPb(qrgicrp, LwMul(cslot, size(long)), 0xFF);
+    Assert(ivNil == qrgicrp[0], "FillPb didn't give ivNil");
+    islotMask = cslot - 1;
+    for (icrp = 0; icrp < ccrp; icrp++)
+    {
+        cki = ((CRP *)_pggcrp->QvFixedGet(icrp))->cki;
+        for (islot = _LwHashCki(cki.ctg, cki.cno) & islotMask; ivNil != qrgicrp[islot]; islot = (islot + 1) & islotMask)
+        {
+        }
+        qrgicrp[islot] = icrp;
+    }
+
+    return fTrue;
+
+LFail:
+    _ReleaseIndexHash();
+    return fFalse;
+}
+
+/***************************************************************************
+    Free the hash table and ctg ranges. They'll get rebuilt when they're
+    next needed.
+***************************************************************************/
+void CFL::_ReleaseIndexHash(void)
+{
+    AssertBaseThis(0);
+
+    ReleasePpo(&_pglicrpHash);
+    ReleasePpo(&_pglctgr);
+    _ictgrLast = 0;
+}
+
+/***************************************************************************
+    The index was just changed. Throw away the hash table and ctg ranges,
+    since the icrps in them are stale. Fixing them up in place costs as
+    much as rebuilding them, so we leave them alone until enough lookups
+    have gone by to pay for a rebuild (see _FEnsureIndexHash).
+***************************************************************************/
+void CFL::_InvalidateIndexHash(void)
+{
+    AssertBaseThis(0);
+
+    _ReleaseIndexHash();
+    _fIndexHashStale = fTrue;
+    _cactFindStale = 0;
+}
+
+/***************************************************************************
+    Look for the ctg in the range table. Fills in *pictgr with where it is
+    or should be. Assumes the range table exists.
+***************************************************************************/
+bool CFL::_FFindCtgr(CTG ctg, long *pictgr)
+{
+    AssertBaseThis(0);
+    AssertVarMem(pictgr);
+    AssertPo(_pglctgr, 0);
+    long ictgr, ictgrMin, ictgrLim;
+    CTGR *qrgctgr;
+
+    // enumerations tend to ask about the same ctg over and over
+    ictgrLim = _pglctgr->IvMac();
+    if (FIn(_ictgrLast, 0, ictgrLim) && ((CTGR *)_pglctgr->QvGet(_ictgrLast))->ctg == ctg)
+    {
+        *pictgr = _ictgrLast;
+        return fTrue;
+    }
+
+    if (ictgrLim == 0)
+    {
+        *pictgr = 0;
+        return fFalse;
+    }
+
+    qrgctgr = (CTGR *)_pglctgr->QvGet(0);
+    for (ictgrMin = 0; ictgrMin < ictgrLim;)
+    {
+        ictgr = (ictgrMin + ictgrLim) / 2;
+        if (qrgctgr[ictgr].ctg < ctg)
+            ictgrMin = ictgr + 1;
+        else if (qrgctgr[ictgr].ctg > ctg)
+            ictgrLim = ictgr;
+        else
+        {
+            *pictgr = _ictgrLast = ictgr;
+            return fTrue;
+        }
+    }
+
+    *pictgr = ictgrMin;
+    return fFalse;
+}
+
+/***************************************************************************
+    Get the range of icrps that have the given ctg. If there are none,
+    *picrpMin and *picrpLim are both set to where such a chunk would go.
+***************************************************************************/
+void CFL::_GetCtgRange(CTG ctg, long *picrpMin, long *picrpLim)
+{
+    // WARNING:  this is called by CFL::AssertValid (via _FFindCtgCno), so
+    // be careful about asserting stuff in here
+    AssertBaseThis(0);
+    AssertVarMem(picrpMin);
+    AssertVarMem(picrpLim);
+    long ictgr, cctgr, ccrp;
+    CTGR *qrgctgr;
+
+    ccrp = _pggcrp->IvMac();
+    if (!_FEnsureIndexHash())
+    {
+        // just binary search the index
+        _FFindCtgCno(ctg, 0, picrpMin);
+        if (ctg + 1 < ctg)
+        {
+            // ctg is the largest possible ctg!
+            *picrpLim = ccrp;
+        }
+        else
+            _FFindCtgCno(ctg + 1, 0, picrpLim);
+        return;
+    }
+
+    cctgr = _pglctgr->IvMac();
+    qrgctgr = (CTGR *)_pglctgr->QvGet(0);
+    if (_FFindCtgr(ctg, &ictgr))
+    {
+        *picrpMin = qrgctgr[ictgr].icrpMin;
+        *picrpLim = ictgr + 1 < cctgr ? qrgctgr[ictgr + 1].icrpMin : ccrp;
+    }
+    else
+        *picrpMin = *picrpLim = ictgr < cctgr ? qrgctgr[ictgr].icrpMin : ccrp;
+}
+
 /***************************************************************************
     Find an unused cno for the given ctg.  Fill in *picrp and *pcno.
 ***************************************************************************/
@@ -2361,16 +4864,16 @@ bool CFL::FAddPv(void *pv, long cb, CTG ctg, CNO *pcno)
     AssertVarMem(pcno);
     AssertIn(cb, 0, kcbMax);
     AssertPvCb(pv, cb);
-    BLCK blck;
+    long icrp;
 
-    if (!FAdd(cb, ctg, pcno, &blck))
-        return fFalse;
-    if (!blck.FWrite(pv))
+    _GetUniqueCno(ctg, &icrp, pcno);
+    if (!_FAdd(cb, ctg, *pcno, icrp, pvNil, pvNil, pv))
     {
-        Delete(ctg, *pcno);
         TrashVar(pcno);
+        AssertThis(0);
         return fFalse;
     }
+    AssertThis(0);
     return fTrue;
 }
 
@@ -2383,18 +4886,19 @@ bool CFL::FAddHq(HQ hq, CTG ctg, CNO *pcno)
     AssertVarMem(pcno);
     AssertHq(hq);
 
-    BLCK blck;
-    long cb = CbOfHq(hq);
+    long icrp;
+    bool fRet;
+    HQ hqT = hq;
+    BLCK blckSrc(&hq);
 
-    if (!FAdd(cb, ctg, pcno, &blck))
-        return fFalse;
-    if (!blck.FWriteHq(hq, 0))
-    {
-        Delete(ctg, *pcno);
+    _GetUniqueCno(ctg, &icrp, pcno);
+    fRet = _FAdd(blckSrc.Cb(), ctg, *pcno, icrp, pvNil, &blckSrc);
+    AssertDo(hqT == blckSrc.HqFree(), "blckSrc.HqFree() returned a differnt hq!");
+    if (!fRet)
         TrashVar(pcno);
-        return fFalse;
-    }
-    return fTrue;
+
+    AssertThis(0);
+    return fRet;
 }
 
 /***************************************************************************
@@ -2406,15 +4910,13 @@ bool CFL::FAddBlck(PBLCK pblckSrc, CTG ctg, CNO *pcno)
     AssertPo(pblckSrc, 0);
     AssertVarMem(pcno);
 
-    BLCK blck;
-    long cb = pblckSrc->Cb(fTrue);
+    long icrp;
 
-    if (!FAdd(cb, ctg, pcno, &blck))
-        return fFalse;
-    if (!pblckSrc->FWriteToBlck(&blck, fTrue))
+    _GetUniqueCno(ctg, &icrp, pcno);
+    if (!_FAdd(pblckSrc->Cb(fTrue), ctg, *pcno, icrp, pvNil, pblckSrc))
     {
-        Delete(ctg, *pcno);
         TrashVar(pcno);
+        AssertThis(0);
         return fFalse;
     }
     if (pblckSrc->FPacked())
@@ -2481,13 +4983,15 @@ bool CFL::FAddChildHq(CTG ctgPar, CNO cnoPar, CHID chid, HQ hq, CTG ctg, CNO *pc
 }
 
 /***************************************************************************
-    Low level add.  Sets the loner flag.
+    Low level add.  Sets the loner flag.  If pv or pblckSrc isn't nil, the
+    data is written from it (and may be shared with an existing chunk).
 ***************************************************************************/
-bool CFL::_FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck)
+bool CFL::_FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck, PBLCK pblckSrc, void *pv)
 {
     AssertBaseThis(0);
     AssertIn(cb, 0, kcbMax);
     AssertNilOrPo(pblck, 0);
+    AssertNilOrPo(pblckSrc, 0);
 
     CRP *qcrp;
     FLO flo;
@@ -2499,7 +5003,7 @@ bool CFL::_FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck)
         return fFalse;
     }
 
-    if (!_FAllocFlo(cb, &flo))
+    if (pvNil != pv || pvNil != pblckSrc ? !_FWriteData(cb, pblckSrc, pv, &flo) : !_FAllocFlo(cb, &flo))
     {
         _pggcrp->Delete(icrp);
         AssertThis(0);
@@ -2513,11 +5017,14 @@ bool CFL::_FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck)
     ClearPb(qcrp, size(CRP));
     qcrp->cki.ctg = ctg;
     qcrp->cki.cno = cno;
-    qcrp->fp = flo.fp;
+    qcrp->SetFp(flo.fp);
     qcrp->SetCb(flo.cb);
     if (flo.pfil == _cstoExtra.pfil)
         qcrp->SetGrfcrp(fcrpOnExtra);
     qcrp->SetGrfcrp(fcrpLoner);
+    _InvalidateIndexHash();
+    _NoteIndexChange();
+    _MarkDirty(icrp);
 
     if (pvNil != pblck)
         pblck->Set(&flo);
@@ -2574,10 +5081,13 @@ bool CFL::FPutBlck(PBLCK pblckSrc, CTG ctg, CNO cno)
 {
     AssertThis(0);
     AssertPo(pblckSrc, 0);
+    long cfmt;
 
     if (!_FPut(pblckSrc->Cb(fTrue), ctg, cno, pvNil, pblckSrc, pvNil))
         return pvNil;
-    SetPacked(ctg, cno, pblckSrc->FPacked());
+    SetPacked(ctg, cno, pblckSrc->FPacked(&cfmt));
+    if (kcfmtKauaiFast == cfmt)
+        _fFast = fTrue;
     return fTrue;
 }
 
@@ -2599,36 +5109,11 @@ bool CFL::_FPut(long cb, CTG ctg, CNO cno, PBLCK pblck, PBLCK pblckSrc, void *pv
     CRP *qcrp;
     FLO flo;
 
+    Assert(pvNil == pv || pvNil == pblckSrc, 0);
     if (!_FFindCtgCno(ctg, cno, &icrp))
-    {
-        BLCK blck;
-
-        if (pvNil == pblck)
-            pblck = &blck;
-
-        if (!_FAdd(cb, ctg, cno, icrp, pblck))
-            return fFalse;
-
-        if (pv != pvNil)
-        {
-            Assert(pvNil == pblckSrc, 0);
-            if (!pblck->FWrite(pv))
-                goto LFailNew;
-        }
-        else if (pvNil != pblckSrc && !pblckSrc->FWriteToBlck(pblck, fTrue))
-        {
-        LFailNew:
-            Delete(ctg, cno);
-            pblck->Free();
-            AssertThis(0);
-            return fFalse;
-        }
+        return _FAdd(cb, ctg, cno, icrp, pblck, pblckSrc, pv);
 
-        AssertThis(0);
-        return fTrue;
-    }
-
-    if (!_FAllocFlo(cb, &flo))
+    if (pvNil != pv || pvNil != pblckSrc ? !_FWriteData(cb, pblckSrc, pv, &flo) : !_FAllocFlo(cb, &flo))
     {
         AssertThis(0);
         return fFalse;
@@ -2637,40 +5122,212 @@ bool CFL::_FPut(long cb, CTG ctg, CNO cno, PBLCK pblck, PBLCK pblckSrc, void *pv
     if (pvNil != pblck)
         pblck->Set(&flo);
 
-    if (pv != pvNil)
-    {
-        Assert(pvNil == pblckSrc, 0);
-        if (!flo.FWrite(pv))
-            goto LFailOld;
-    }
-    else if (pvNil != pblckSrc && !pblckSrc->FWriteToFlo(&flo, fTrue))
-    {
-    LFailOld:
-        _FreeFpCb(_fAddToExtra, flo.fp, flo.cb);
-        if (pvNil != pblck)
-            pblck->Free();
-        AssertThis(0);
-        return fFalse;
-    }
-
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
     Assert(qcrp->cki.ctg == ctg, 0);
     Assert(qcrp->cki.cno == cno, 0);
-    _FreeFpCb(qcrp->Grfcrp(fcrpOnExtra), qcrp->fp, qcrp->Cb());
+    _ReleaseData(qcrp->Grfcrp(fcrpOnExtra), qcrp->Fp(), qcrp->Cb());
 
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
-    qcrp->fp = flo.fp;
+    qcrp->SetFp(flo.fp);
     qcrp->SetCb(flo.cb);
     if (flo.pfil == _cstoExtra.pfil)
         qcrp->SetGrfcrp(fcrpOnExtra);
     else
         qcrp->ClearGrfcrp(fcrpOnExtra);
     _FSetRti(ctg, cno, rtiNil);
+    _MarkDirty(icrp);
 
     AssertThis(0);
     return fTrue;
 }
 
+/***************************************************************************
+    Allocate space for cb bytes of chunk data and write the data from pv
+    (if it's not nil) or pblckSrc. If identical data is already in the
+    file, this just adds a reference to it instead.
+***************************************************************************/
+bool CFL::_FWriteData(long cb, PBLCK pblckSrc, void *pv, PFLO pflo)
+{
+    AssertBaseThis(0);
+    AssertIn(cb, 0, kcbMax);
+    AssertNilOrPo(pblckSrc, 0);
+    Assert(pvNil != pv || pvNil != pblckSrc, "no data");
+    AssertVarMem(pflo);
+
+    ulong luHash;
+    bool fHash;
+
+    fHash = cb >= kcbMinPayload && _FHashData(cb, pblckSrc, pv, &luHash);
+    if (fHash && _FFindPayload(luHash, cb, pblckSrc, pv, pflo))
+        return fTrue;
+
+    if (!_FAllocFlo(cb, pflo))
+        return fFalse;
+    Assert(pflo->pfil == _csto.pfil || pflo->pfil == _cstoExtra.pfil, 0);
+
+    if (pvNil != pv ? !pflo->FWrite(pv) : !pblckSrc->FWriteToFlo(pflo, fTrue))
+    {
+        _FreeFpCb(pflo->pfil == _cstoExtra.pfil, pflo->fp, pflo->cb);
+        return fFalse;
+    }
+
+    if (fHash)
+        _AddPayload(pflo, luHash);
+    return fTrue;
+}
+
+/***************************************************************************
+    Find the payload index entry for the data at (fOnExtra, fp). If it's
+    not there, *pipye is where it would go.
+***************************************************************************/
+bool CFL::_FFindPye(bool fOnExtra, FP fp, long *pipye)
+{
+    AssertBaseThis(0);
+    AssertVarMem(pipye);
+
+    PYE pye;
+    PYE *qpye;
+
+    if (pvNil == _pglpye)
+    {
+        *pipye = 0;
+        return fFalse;
+    }
+
+    ClearPb(&pye, size(pye));
+    pye.fOnExtra = FPure(fOnExtra);
+    pye.fp = fp;
+    *pipye = _IpyeFind(_pglpye, &pye, fFalse);
+    if (*pipye >= _pglpye->IvMac())
+        return fFalse;
+    qpye = (PYE *)_pglpye->QvGet(*pipye);
+    return qpye->fp == fp && FPure(qpye->fOnExtra) == FPure(fOnExtra);
+}
+
+/***************************************************************************
+    Look for existing data that matches the data in pv (if it's not nil)
+    or pblckSrc. If there is some, add a reference to it and put its
+    location in *pflo.
+***************************************************************************/
+bool CFL::_FFindPayload(ulong luHash, long cb, PBLCK pblckSrc, void *pv, PFLO pflo)
+{
+    AssertBaseThis(0);
+    AssertVarMem(pflo);
+
+    PYE pye;
+    long ipye, ipyeMaster;
+
+    if (pvNil == _pglpyeHash)
+        return fFalse;
+
+    ClearPb(&pye, size(pye));
+    pye.luHash = luHash;
+    for (ipye = _IpyeFind(_pglpyeHash, &pye, fTrue); ipye < _pglpyeHash->IvMac(); ipye++)
+    {
+        _pglpyeHash->Get(ipye, &pye);
+        if (pye.luHash != luHash)
+            break;
+        if (pye.cb != cb)
+            continue;
+
+        pflo->pfil = pye.fOnExtra ? _cstoExtra.pfil : _csto.pfil;
+        pflo->fp = pye.fp;
+        pflo->cb = cb;
+        if (!_FEqualData(pflo, pblckSrc, pv))
+            continue;
+
+        if (!_FFindPye(pye.fOnExtra, pye.fp, &ipyeMaster))
+        {
+            Bug("payload indices out of sync");
+            return fFalse;
+        }
+        ((PYE *)_pglpye->QvGet(ipyeMaster))->ccrp++;
+        return fTrue;
+    }
+    return fFalse;
+}
+
+/***************************************************************************
+    Add newly written data to the payload index. If this fails, the data
+    just won't be shared.
+***************************************************************************/
+void CFL::_AddPayload(PFLO pflo, ulong luHash)
+{
+    AssertBaseThis(0);
+    AssertPo(pflo, 0);
+
+    PYE pye;
+    long ipye;
+
+    if (pvNil == _pglpye && pvNil == (_pglpye = GL::PglNew(size(PYE), 1)))
+        return;
+    if (pvNil == _pglpyeHash && pvNil == (_pglpyeHash = GL::PglNew(size(PYE), 1)))
+        return;
+    if (!_pglpyeHash->FEnsureSpace(1))
+        return;
+
+    ClearPb(&pye, size(pye));
+    pye.fp = pflo->fp;
+    pye.cb = pflo->cb;
+    pye.ccrp = 1;
+    pye.luHash = luHash;
+    pye.fOnExtra = pflo->pfil == _cstoExtra.pfil;
+    pye.fHash = fTrue;
+    if (_FFindPye(pye.fOnExtra, pye.fp, &ipye))
+    {
+        Bug("data is already in the payload index");
+        return;
+    }
+    if (!_pglpye->FInsert(ipye, &pye))
+        return;
+    AssertDo(_pglpyeHash->FInsert(_IpyeFind(_pglpyeHash, &pye, fTrue), &pye), 0);
+}
+
+/***************************************************************************
+    A chunk has stopped using the data at (fOnExtra, fp, cb). Returns true
+    iff no other chunk uses it.
+***************************************************************************/
+bool CFL::_FReleasePayload(bool fOnExtra, FP fp, long cb)
+{
+    AssertBaseThis(0);
+
+    PYE pye;
+    long ipye;
+
+    if (cb == 0 || !_FFindPye(fOnExtra, fp, &ipye))
+        return fTrue;
+
+    _pglpye->Get(ipye, &pye);
+    Assert(pye.cb == cb, "payload size wrong");
+    if (--pye.ccrp > 1 || pye.ccrp == 1 && pye.fHash)
+    {
+        _pglpye->Put(ipye, &pye);
+        return fFalse;
+    }
+
+    _pglpye->Delete(ipye);
+    if (pye.fHash)
+    {
+        ipye = _IpyeFind(_pglpyeHash, &pye, fTrue);
+        Assert(ipye < _pglpyeHash->IvMac() && ((PYE *)_pglpyeHash->QvGet(ipye))->fp == fp,
+               "payload indices out of sync");
+        _pglpyeHash->Delete(ipye);
+    }
+    return pye.ccrp == 0;
+}
+
+/***************************************************************************
+    A chunk has stopped using the data at (fOnExtra, fp, cb). Free the
+    space if no other chunk uses it.
+***************************************************************************/
+void CFL::_ReleaseData(bool fOnExtra, FP fp, long cb)
+{
+    AssertBaseThis(0);
+
+    if (_FReleasePayload(fOnExtra, fp, cb))
+        _FreeFpCb(fOnExtra, fp, cb);
+}
+
 /***************************************************************************
     Swaps the data for the two chunks.  This allows a "safe save" of
     individual chunks (create a temp chunk, write the data, swap the data,
@@ -2695,9 +5352,9 @@ void CFL::SwapData(CTG ctg1, CNO cno1, CTG ctg2, CNO cno2)
     qcrp1 = (CRP *)_pggcrp->QvFixedGet(icrp1);
     qcrp2 = (CRP *)_pggcrp->QvFixedGet(icrp2);
 
-    fp = qcrp1->fp;
-    qcrp1->fp = qcrp2->fp;
-    qcrp2->fp = fp;
+    fp = qcrp1->Fp();
+    qcrp1->SetFp(qcrp2->Fp());
+    qcrp2->SetFp(fp);
     cb = qcrp1->Cb();
     qcrp1->SetCb(qcrp2->Cb());
     qcrp2->SetCb(cb);
@@ -2709,6 +5366,8 @@ void CFL::SwapData(CTG ctg1, CNO cno1, CTG ctg2, CNO cno2)
 
     _FSetRti(ctg1, cno1, rtiNil);
     _FSetRti(ctg2, cno2, rtiNil);
+    _MarkDirty(icrp1);
+    _MarkDirty(icrp2);
 
     AssertThis(fcflFull);
 }
@@ -2746,6 +5405,8 @@ void CFL::SwapChildren(CTG ctg1, CNO cno1, CTG ctg2, CNO cno2)
         AssertDo(_pggcrp->FMoveRgb(icrp1, 0, icrp2, cb2, cb1), 0);
     if (0 < cb2)
         AssertDo(_pggcrp->FMoveRgb(icrp2, 0, icrp1, 0, cb2), 0);
+    _MarkDirty(icrp1);
+    _MarkDirty(icrp2);
 
     AssertThis(fcflFull);
 }
@@ -2777,11 +5438,16 @@ void CFL::Move(CTG ctg, CNO cno, CTG ctgNew, CNO cnoNew)
     if (rtiNil != rti)
         _FSetRti(ctg, cno, rtiNil);
 
+    // the old cki goes in the journal as a delete, the new one as an add
+    _MarkDirty(icrpCur);
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrpCur);
     ccrpRef = qcrp->ccrpRef;
     qcrp->cki.ctg = ctgNew;
     qcrp->cki.cno = cnoNew;
+    _MarkDirty(icrpCur);
     _pggcrp->Move(icrpCur, icrpTarget);
+    _ReleaseIndexHash();
+    _NoteIndexChange();
 
     if (ccrpRef > 0)
     {
@@ -2814,6 +5480,7 @@ void CFL::Move(CTG ctg, CNO cno, CTG ctgNew, CNO cnoNew)
                 qkid->cki.cno = cnoNew;
 
                 MoveElement(qrgkid, size(KID), ikid, ikidNew);
+                _MarkDirty(icrp);
                 ccrpRef--;
             }
         }
@@ -2851,7 +5518,10 @@ void CFL::Delete(CTG ctg, CNO cno)
     Assert(qcrp->Grfcrp(fcrpLoner) || qcrp->ccrpRef == 0, "can't directly delete a child chunk");
     qcrp->ClearGrfcrp(fcrpLoner);
     if (qcrp->ccrpRef > 0)
+    {
+        _MarkDirty(icrp);
         return;
+    }
 
     cge.Init(this, ctg, cno);
     for (grfcgeIn = fcgeNil; cge.FNextKid(&kid, pvNil, &grfcge, grfcgeIn);)
@@ -2916,7 +5586,10 @@ void CFL::SetLoner(CTG ctg, CNO cno, bool fLoner)
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
 
     if (fLoner)
+    {
         qcrp->SetGrfcrp(fcrpLoner);
+        _MarkDirty(icrp);
+    }
     else if (qcrp->Grfcrp(fcrpLoner))
         Delete(ctg, cno);
 }
@@ -3007,6 +5680,7 @@ void CFL::DeleteChild(CTG ctgPar, CNO cnoPar, CTG ctgChild, CNO cnoChild, CHID c
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrpPar);
     qcrp->ckid--;
     _pggcrp->DeleteRgb(icrpPar, _BvKid(ikid), size(KID));
+    _MarkDirty(icrpPar);
 
     // now decrement the ref count and nuke it if the ref count is zero
     if (_FDecRefCount(icrpChild))
@@ -3032,6 +5706,7 @@ bool CFL::_FDecRefCount(long icrp)
         Bug("ref count wrong");
         return fFalse;
     }
+    _MarkDirty(icrp);
     return --(qcrp->ccrpRef) == 0 && !qcrp->Grfcrp(fcrpLoner);
 }
 
@@ -3046,19 +5721,35 @@ void CFL::_DeleteCore(long icrp)
 
     qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
     cki = qcrp->cki;
-    _FreeFpCb(qcrp->Grfcrp(fcrpOnExtra), qcrp->fp, qcrp->Cb());
+    _ReleaseData(qcrp->Grfcrp(fcrpOnExtra), qcrp->Fp(), qcrp->Cb());
     _FSetRti(cki.ctg, cki.cno, rtiNil);
+    _MarkDirty(icrp);
+    _InvalidateIndexHash();
     _pggcrp->Delete(icrp);
+    _NoteIndexChange();
 }
 
 /***************************************************************************
     Add the (fp, cb) to the free map.
 ***************************************************************************/
 void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
+{
+    AssertBaseThis(0);
+    ulong tsStart = TsCurrentPrecise();
+
+    _FreeFpCbCore(fOnExtra, fp, cb);
+    _dtsAlloc += TsCurrentPrecise() - tsStart;
+}
+
+/***************************************************************************
+    Add the given space to the free map, merging with adjacent free blocks.
+    The size sorted free map (if there is one) is kept in sync.
+***************************************************************************/
+void CFL::_FreeFpCbCore(bool fOnExtra, FP fp, long cb)
 {
     AssertBaseThis(0);
     Assert(cb > 0 || cb == 0 && fp == 0, "bad cb");
-    Assert(fp >= 0 && (fOnExtra || fp >= size(CFP) || cb == 0 || _fInvalidMainFile), "bad fp");
+    Assert(fp >= 0 && (fOnExtra || fp >= size(CFPF) || cb == 0 || _fInvalidMainFile), "bad fp");
 
     PGL pglfsm;
     long ifsm, ifsmMin, ifsmLim;
@@ -3092,6 +5783,7 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
             // fsm extends to the new end of the file, so delete the fsm
             // and adjust fpMac
             Assert(fsm.fp + fsm.cb == pcsto->fpMac, "bad fsm?");
+            _RemoveFsmCb(&pcsto->pglfsmCb, &fsm);
             pglfsm->Delete(ifsm);
             pcsto->fpMac = fsm.fp;
         }
@@ -3106,15 +5798,10 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
         return;
     }
 
-    for (ifsmMin = 0, ifsmLim = pglfsm->IvMac(); ifsmMin < ifsmLim;)
+    if (_FFindFsm(pglfsm, fp, &ifsmMin))
     {
-        ifsm = (ifsmMin + ifsmLim) / 2;
-        pglfsm->Get(ifsm, &fsm);
-        Assert(fp + cb <= fsm.fp || fp >= fsm.fp + fsm.cb, "freeing space that overlaps free space");
-        if (fsm.fp < fp)
-            ifsmMin = ifsm + 1;
-        else
-            ifsmLim = ifsm;
+        Bug("freeing space that overlaps free space");
+        return;
     }
 
     ifsmLim = pglfsm->IvMac();
@@ -3127,6 +5814,7 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
         {
             // extend the previous free block
             Assert(fsm.fp + fsm.cb == fp, "overlap");
+            _RemoveFsmCb(&pcsto->pglfsmCb, &fsm);
             fsm.cb = fp + cb - fsm.fp;
             if (ifsmMin < ifsmLim)
             {
@@ -3137,10 +5825,12 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
                     // merge the two
                     Assert(fsmT.fp == fsm.fp + fsm.cb, "overlap");
                     fsm.cb = fsmT.fp + fsmT.cb - fsm.fp;
+                    _RemoveFsmCb(&pcsto->pglfsmCb, &fsmT);
                     pglfsm->Delete(ifsmMin);
                 }
             }
             pglfsm->Put(ifsmMin - 1, &fsm);
+            _AddFsmCb(&pcsto->pglfsmCb, &fsm);
             return;
         }
     }
@@ -3152,9 +5842,11 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
         if (fsm.fp <= fp + cb)
         {
             Assert(fsm.fp == fp + cb, "overlap");
+            _RemoveFsmCb(&pcsto->pglfsmCb, &fsm);
             fsm.cb = fsm.fp + fsm.cb - fp;
             fsm.fp = fp;
             pglfsm->Put(ifsmMin, &fsm);
+            _AddFsmCb(&pcsto->pglfsmCb, &fsm);
             return;
         }
     }
@@ -3163,7 +5855,57 @@ void CFL::_FreeFpCb(bool fOnExtra, FP fp, long cb)
     fsm.cb = cb;
 
     // if it fails, we lose some space - so what
-    pglfsm->FInsert(ifsmMin, &fsm);
+    if (pglfsm->FInsert(ifsmMin, &fsm))
+        _AddFsmCb(&pcsto->pglfsmCb, &fsm);
+}
+
+/***************************************************************************
+    Get the heap allocation statistics for the main file.
+***************************************************************************/
+void CFL::GetAlst(ALST *palst)
+{
+    AssertThis(0);
+    AssertVarMem(palst);
+    long ifsm;
+    FSM fsm;
+
+    ClearPb(palst, size(ALST));
+    if (_fFreeMapNotRead)
+        _ReadFreeMap();
+
+    if (pvNil != _csto.pglfsm)
+    {
+        palst->cfsm = _csto.pglfsm->IvMac();
+        for (ifsm = 0; ifsm < palst->cfsm; ifsm++)
+        {
+            _csto.pglfsm->Get(ifsm, &fsm);
+            palst->cbFree += fsm.cb;
+            if (fsm.cb > palst->cbFreeMax)
+                palst->cbFreeMax = fsm.cb;
+        }
+    }
+    if (palst->cbFree > 0)
+        palst->pctFragment = LwMulDiv(palst->cbFree - palst->cbFreeMax, 100, palst->cbFree);
+
+    if (pvNil != _pglpye)
+    {
+        PYE pye;
+        long ipye;
+
+        for (ipye = 0; ipye < _pglpye->IvMac(); ipye++)
+        {
+            _pglpye->Get(ipye, &pye);
+            if (!pye.fOnExtra)
+                palst->cbShared += LwMul(pye.ccrp - 1, pye.cb);
+        }
+    }
+
+    palst->calloc = _calloc;
+    palst->callocReuse = _callocReuse;
+    palst->dtsAlloc = _dtsAlloc;
+    palst->dtsOpen = _dtsOpen;
+    palst->dtsValidate = _dtsValidate;
+    palst->fValidated = _fValidated;
 }
 
 /***************************************************************************
@@ -3224,6 +5966,7 @@ bool CFL::_FSetName(long icrp, PSTN pstn)
         pstn->GetData(PvAddBv(_pggcrp->PvLock(icrp), bvRgch));
         _pggcrp->Unlock();
     }
+    _MarkDirty(icrp);
 
     return fTrue;
 }
@@ -3359,6 +6102,8 @@ bool CFL::_FAdoptChild(long icrpPar, long ikid, CTG ctgChild, CNO cnoChild, CHID
 
     if (fClearLoner)
         qcrp->ClearGrfcrp(fcrpLoner);
+    _MarkDirty(icrpPar);
+    _MarkDirty(icrp);
     AssertThis(0);
     return fTrue;
 }
@@ -3393,6 +6138,7 @@ void CFL::ChangeChid(CTG ctgPar, CNO cnoPar, CTG ctgChild, CNO cnoChild, CHID ch
     qkid->chid = chidNew;
 
     MoveElement(qrgkid, size(KID), ikidOld, ikidNew);
+    _MarkDirty(icrp);
 
     AssertThis(0);
 }
@@ -3455,21 +6201,13 @@ bool CFL::FGetIcki(CTG ctg, CNO cno, long *picki)
 long CFL::CckiCtg(CTG ctg)
 {
     AssertThis(0);
-    long icrpMac;
     long icrpMin;
     long icrpLim;
 
-    if ((icrpMac = _pggcrp->IvMac()) == 0)
+    if (_pggcrp->IvMac() == 0)
         return 0;
 
-    _FFindCtgCno(ctg, 0, &icrpMin);
-    if (ctg + 1 < ctg)
-    {
-        // ctg is the largest possible ctg!
-        return icrpMac - icrpMin;
-    }
-
-    _FFindCtgCno(ctg + 1, 0, &icrpLim);
+    _GetCtgRange(ctg, &icrpMin, &icrpLim);
     return icrpLim - icrpMin;
 }
 
@@ -3485,19 +6223,14 @@ bool CFL::FGetCkiCtg(CTG ctg, long icki, CKI *pcki, long *pckid, PBLCK pblck)
     AssertNilOrVarMem(pckid);
     AssertNilOrPo(pblck, 0);
     CRP *qcrp;
-    long icrpMac;
+    long icrpMin, icrpLim;
     long icrp;
 
-    if (!FIn(icki, 0, (icrpMac = _pggcrp->IvMac())))
-        goto LFail;
-
-    _FFindCtgCno(ctg, 0, &icrp);
-    icrp += icki;
-    if (!FIn(icrp, 0, icrpMac))
+    if (!FIn(icki, 0, _pggcrp->IvMac()))
         goto LFail;
 
-    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
-    if (qcrp->cki.ctg != ctg)
+    _GetCtgRange(ctg, &icrpMin, &icrpLim);
+    if ((icrp = icrpMin + icki) >= icrpLim)
     {
     LFail:
         TrashVar(pcki);
@@ -3506,12 +6239,15 @@ bool CFL::FGetCkiCtg(CTG ctg, long icki, CKI *pcki, long *pckid, PBLCK pblck)
             pblck->Free();
         return fFalse;
     }
+
+    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
+    Assert(qcrp->cki.ctg == ctg, "bad ctg range");
     if (pvNil != pcki)
         *pcki = qcrp->cki;
     if (pvNil != pckid)
         *pckid = qcrp->ckid;
     if (pvNil != pblck)
-        _GetBlck(icki, pblck);
+        _GetBlck(icrp, pblck);
 
     return fTrue;
 }
@@ -3606,10 +6342,7 @@ bool CFL::_FFindChidCtg(CTG ctgPar, CNO cnoPar, CHID chid, CTG ctg, KID *pkid)
 {
     AssertThis(0);
     AssertVarMem(pkid);
-    long ikidMin, ikidLim, ikid;
-    CRP *qcrp;
-    KID *qrgkid, *qkid;
-    long ckid, icrp;
+    long ikid, icrp;
 
     if (!_FFindCtgCno(ctgPar, cnoPar, &icrp))
     {
@@ -3617,14 +6350,37 @@ bool CFL::_FFindChidCtg(CTG ctgPar, CNO cnoPar, CHID chid, CTG ctg, KID *pkid)
         goto LFail;
     }
 
-    qcrp = (CRP *)_pggcrp->QvFixedGet(icrp);
-    if ((ckid = qcrp->ckid) <= 0)
+    ikid = _IkidFindChidCtg(icrp, chid, ctg);
+    if (ikid < ((CRP *)_pggcrp->QvFixedGet(icrp))->ckid)
+    {
+        _pggcrp->GetRgb(icrp, _BvKid(ikid), size(KID), pkid);
+        if (pkid->chid == chid && pkid->cki.ctg >= ctg)
+            return fTrue;
+    }
+LFail:
+    TrashVar(pkid);
+    return fFalse;
+}
+
+/***************************************************************************
+    Return the index of the first child of icrpPar that sorts at or after
+    (chid, ctg).  Returns the number of children if there isn't one.  Kids
+    are sorted by (chid, ctg, cno).
+***************************************************************************/
+long CFL::_IkidFindChidCtg(long icrpPar, CHID chid, CTG ctg)
+{
+    AssertBaseThis(0);
+    AssertIn(icrpPar, 0, _pggcrp->IvMac());
+    long ikidMin, ikidLim, ikid, ckid;
+    KID *qrgkid, *qkid;
+
+    if ((ckid = ((CRP *)_pggcrp->QvFixedGet(icrpPar))->ckid) <= 0)
     {
         Assert(0 == ckid, "bad crp");
-        goto LFail;
+        return 0;
     }
 
-    qrgkid = (KID *)_pggcrp->QvGet(icrp);
+    qrgkid = (KID *)_pggcrp->QvGet(icrpPar);
     for (ikidMin = 0, ikidLim = ckid; ikidMin < ikidLim;)
     {
         ikid = (ikidMin + ikidLim) / 2;
@@ -3640,18 +6396,93 @@ bool CFL::_FFindChidCtg(CTG ctgPar, CNO cnoPar, CHID chid, CTG ctg, KID *pkid)
             ikidLim = ikid;
     }
 
-    if (ikidMin < qcrp->ckid)
+    return ikidMin;
+}
+
+/***************************************************************************
+    Initialize *pkde to enumerate all the children of (ctgPar, cnoPar).
+    Call FNextKid to get each child in turn.  Unlike calling FGetKid with
+    increasing ikid values, this only looks up the parent once.
+***************************************************************************/
+void CFL::InitKde(CTG ctgPar, CNO cnoPar, KDE *pkde)
+{
+    AssertThis(0);
+    AssertVarMem(pkde);
+
+    pkde->ckiPar.ctg = ctgPar;
+    pkde->ckiPar.cno = cnoPar;
+    pkde->ikid = 0;
+    if (!_FFindCtgCno(ctgPar, cnoPar, &pkde->icrpPar))
+    {
+        Bug("chunk not found");
+        pkde->icrpPar = ivNil;
+        pkde->ikidLim = 0;
+        return;
+    }
+    pkde->ikidLim = ((CRP *)_pggcrp->QvFixedGet(pkde->icrpPar))->ckid;
+}
+
+/***************************************************************************
+    Initialize *pkde to enumerate the children of (ctgPar, cnoPar) that
+    have the given chid.  The range is found by binary search, so this is
+    cheap even when the parent has many children.
+***************************************************************************/
+void CFL::InitKdeChid(CTG ctgPar, CNO cnoPar, CHID chid, KDE *pkde)
+{
+    AssertThis(0);
+    AssertVarMem(pkde);
+
+    InitKde(ctgPar, cnoPar, pkde);
+    if (ivNil == pkde->icrpPar)
+        return;
+
+    pkde->ikid = _IkidFindChidCtg(pkde->icrpPar, chid, (CTG)0);
+    if (chid + 1 != 0)
+        pkde->ikidLim = _IkidFindChidCtg(pkde->icrpPar, chid + 1, (CTG)0);
+}
+
+/***************************************************************************
+    Get the next child in the enumeration.  Returns false when there are
+    no more.  If pikid is not nil, fills it with the child's index.  Other
+    chunks may be created or deleted during the enumeration, but the
+    parent's list of children must not change.
+***************************************************************************/
+bool CFL::FNextKid(KDE *pkde, KID *pkid, long *pikid)
+{
+    AssertThis(0);
+    AssertVarMem(pkde);
+    AssertVarMem(pkid);
+    AssertNilOrVarMem(pikid);
+    CRP *qcrp;
+
+    if (pkde->ikid >= pkde->ikidLim)
+    {
+        TrashVar(pkid);
+        TrashVar(pikid);
+        return fFalse;
+    }
+
+    // the parent moves in the index when other chunks are added or removed
+    if (!FIn(pkde->icrpPar, 0, _pggcrp->IvMac()) ||
+        !FEqualRgb(&((CRP *)_pggcrp->QvFixedGet(pkde->icrpPar))->cki, &pkde->ckiPar, size(CKI)))
     {
-        qkid = &qrgkid[ikidMin];
-        if (qkid->chid == chid && qkid->cki.ctg >= ctg)
+        if (!_FFindCtgCno(pkde->ckiPar.ctg, pkde->ckiPar.cno, &pkde->icrpPar))
         {
-            *pkid = *qkid;
-            return fTrue;
+            Bug("parent went away");
+            pkde->ikid = pkde->ikidLim = 0;
+            TrashVar(pkid);
+            TrashVar(pikid);
+            return fFalse;
         }
     }
-LFail:
-    TrashVar(pkid);
-    return fFalse;
+
+    qcrp = (CRP *)_pggcrp->QvFixedGet(pkde->icrpPar);
+    AssertIn(pkde->ikidLim, 0, qcrp->ckid + 1);
+    if (pvNil != pikid)
+        *pikid = pkde->ikid;
+    _pggcrp->GetRgb(pkde->icrpPar, _BvKid(pkde->ikid), size(KID), pkid);
+    pkde->ikid++;
+    return fTrue;
 }
 
 /***************************************************************************
@@ -3818,6 +6649,7 @@ bool CFL::_FCopy(CTG ctgSrc, CNO cnoSrc, PCFL pcflDst, CNO *pcnoDst, bool fClone
 
     long icrpSrc, icrpDst;
     long rtiSrc;
+    long cfmt;
     CGE cge;
     KID kid;
     CKI ckiPar;
@@ -3888,8 +6720,14 @@ bool CFL::_FCopy(CTG ctgSrc, CNO cnoSrc, PCFL pcflDst, CNO *pcnoDst, bool fClone
             // find the source icrp
             AssertDo(_FFindCtgCno(kid.cki.ctg, kid.cki.cno, &icrpSrc), 0);
 
-            // get the source blck
+            // get the source blck - data packed with our dictionary has to
+            // be unpacked unless the destination has the same one
             _GetBlck(icrpSrc, &blckSrc);
+            if (blckSrc.FPacked(&cfmt) && kcfmtKauai2Dict == cfmt &&
+                pcflDst->LuDict(kid.cki.ctg) != LuDict(kid.cki.ctg) && !blckSrc.FUnpackData())
+            {
+                goto LFail;
+            }
 
             // allocate the dst chunk and copy the data - use the source cno
             // if possible
@@ -3918,6 +6756,7 @@ bool CFL::_FCopy(CTG ctgSrc, CNO cnoSrc, PCFL pcflDst, CNO *pcnoDst, bool fClone
             {
                 qcrp = (CRP *)pcflDst->_pggcrp->QvFixedGet(icrpDst);
                 qcrp->SetGrfcrp(fcrpForest);
+                pcflDst->_MarkDirty(icrpDst);
             }
 
             // set the dst name and rti to the src name and rti
@@ -38,6 +38,25 @@ enum
     // to the hard drive.
     fcflReadFromExtra = 0x0010,
 
+    // This flag indicates that the file should be mapped into memory
+    // while it is read only. Reads are then satisfied from the view
+    // instead of going through the file system, and PvFindMap can get
+    // at unpacked chunk data without copying it. If the platform can't
+    // map the file, it is read normally.
+    fcflMapped = 0x0020,
+
+    // This flag forces the full consistency check of the index when the
+    // file is opened. Without it, the check is skipped for read-only
+    // content files (fcflMapped without fcflWriteEnable) whose index
+    // matches the checksum saved with it. Other files always get it.
+    fcflValidate = 0x0040,
+
+    // This flag makes the file use the large format (64-bit file positions)
+    // from the next save on, even if it's smaller than 2GB. Files that get
+    // bigger than that switch to the large format by themselves. Only
+    // versions that know the large format can read such files.
+    fcflLarge = 0x0080,
+
 #ifdef DEBUG
     // for AssertValid
     fcflGraph = 0x4000, // check the graph structure for cycles
@@ -45,6 +64,10 @@ enum
 #endif // DEBUG
 };
 
+// A chunk of this type holds the compression dictionary for the chunks
+// of the type given by its cno (see CFL::FSetDict).
+const CTG kctgDict = 'DICT';
+
 // chunk identification
 struct CKI
 {
@@ -61,6 +84,31 @@ struct KID
 };
 const BOM kbomKid = 0xFC000000;
 
+// kid enumeration state - see CFL::InitKde and CFL::FNextKid
+struct KDE
+{
+    CKI ckiPar;   // the parent chunk
+    long icrpPar; // where the parent was in the index last time we looked
+    long ikid;    // next kid to return
+    long ikidLim; // stop before this kid
+};
+
+// heap allocation and open statistics for a chunky file - see CFL::GetAlst
+struct ALST
+{
+    long cfsm;         // number of free blocks in the main file
+    long cbFree;       // total size of the free blocks
+    long cbFreeMax;    // size of the largest free block
+    long pctFragment;  // 100 * (1 - cbFreeMax / cbFree)
+    long calloc;       // number of heap allocations since the file was opened
+    long callocReuse;  // number of those that reused free space
+    ulong dtsAlloc;    // time spent allocating and freeing (kdtsPreciseSecond)
+    long cbShared;     // chunk data bytes saved by sharing identical data
+    ulong dtsOpen;     // time spent opening the file (kdtsPreciseSecond)
+    ulong dtsValidate; // part of dtsOpen spent in the full index check
+    bool fValidated;   // whether the full index check was done at open
+};
+
 /***************************************************************************
     Chunky file class.
 ***************************************************************************/
@@ -81,6 +129,7 @@ class CFL : public CFL_PAR
         PFIL pfil;  // the file
         FP fpMac;   // logical end of file (for writing new chunks)
         PGL pglfsm; // free space map
+        PGL pglfsmCb; // free space map sorted by (cb, fp) for best fit
     };
 
     PGG _pggcrp;     // the index
@@ -92,11 +141,79 @@ class CFL : public CFL_PAR
     bool _fFreeMapNotRead : 1;
     bool _fReadFromExtra : 1;
     bool _fInvalidMainFile : 1;
+    bool _fValidated : 1;
+    bool _fLarge : 1; // save with 64-bit file positions
+    bool _fDict : 1;  // the header says there are kctgDict chunks
+    bool _fFast : 1;  // some chunks may be packed with kcfmtKauaiFast
 
     // for deferred reading of the free map
     FP _fpFreeMap;
     long _cbFreeMap;
 
+    // allocation statistics
+    long _calloc;
+    long _callocReuse;
+    ulong _dtsAlloc;
+
+    // open statistics
+    ulong _luIndexSum; // the index checksum saved in the file (0 if none)
+    ulong _dtsOpen;
+    ulong _dtsValidate;
+
+    // The index journal. pglckiDirty is nil when the next save must write
+    // the whole index.
+    struct JRNS
+    {
+        PGL pglckiDirty; // chunks changed since the index was last written
+        PGL pglfsmIndex; // file space holding the saved index and journal
+        FP fpIndex;      // the saved index
+        long cbIndex;
+        long cbBase;     // size of the saved index and free map
+        FP fpLast;       // the last journal record (0 if none)
+        long cbLast;
+        long cbTotal;    // total size of the journal records
+        FP fpPayload;    // the saved payload hashes (written with the index)
+        long cbPayload;
+        bool fLarge;     // the saved index uses 64-bit file positions
+    };
+    JRNS _jrns;
+
+    // Payload index for sharing identical chunk data. _pglpye has an entry
+    // for each piece of chunk data that is used by more than one chunk or
+    // whose hash is known, sorted by (fOnExtra, fp). _pglpyeHash has
+    // copies of the hashed entries sorted by hash.
+    PGL _pglpye;
+    PGL _pglpyeHash;
+
+    // Auxiliary lookup structures for the index. These are built lazily
+    // (for large enough indices) and are thrown away whenever the index
+    // changes.
+    struct CTGR
+    {
+        CTG ctg;
+        long icrpMin;
+    };
+
+    PGL _pglicrpHash;      // open addressing hash table of icrps, ivNil is empty
+    PGL _pglctgr;          // the first icrp of each ctg, sorted by ctg
+    long _ictgrLast;       // the last ctgr we found
+    bool _fIndexHashStale; // the index changed since the hash was last built
+    long _cactFindStale;   // lookups since then
+
+    bool _FEnsureIndexHash(void);
+    void _ReleaseIndexHash(void);
+    void _InvalidateIndexHash(void);
+    bool _FFindCtgr(CTG ctg, long *pictgr);
+    void _GetCtgRange(CTG ctg, long *picrpMin, long *picrpLim);
+
+    // the compression dictionaries of the kctgDict chunks, as registered
+    // with vpcodmUtil (see DCTE in chunk.cpp)
+    PGL _pgldcte;
+
+    bool _FLoadDicts(void);
+    long _CfmtPackCtg(CTG ctg, long cfmt, ulong *pluDict);
+    bool _FRepackFast(void);
+
 #ifndef CHUNK_BIG_INDEX
     struct RTIE
     {
@@ -110,6 +227,18 @@ class CFL : public CFL_PAR
     bool _FFindRtie(CTG ctg, CNO cno, RTIE *prtie = pvNil, long *pirtie = pvNil);
 #endif //! CHUNK_BIG_INDEX
 
+    // Change counts for clients that cache which chunks a file has (CRM).
+    // These go up whenever chunks are added, deleted or renumbered, or the
+    // index is reread.
+    long _cactIndex;
+    static long _cactIndexAll; // summed over all CFLs
+
+    void _NoteIndexChange(void)
+    {
+        _cactIndex++;
+        _cactIndexAll++;
+    }
+
     // static member variables
     static long _rtiLast;
     static PCFL _pcflFirst;
@@ -123,13 +252,30 @@ class CFL : public CFL_PAR
 
     bool _FReadIndex(void);
     tribool _TValidIndex(void);
+    bool _FCheckIndex(bool fFull);
     bool _FWriteIndex(CTG ctgCreator);
+    bool _FReadJournal(FP fpLast, long cbLast);
+    bool _FWriteJournal(CTG ctgCreator);
+    void _ReleaseJournal(void);
+    void _MarkDirty(long icrp);
     bool _FCreateExtra(void);
     bool _FAllocFlo(long cb, PFLO pflo, bool fForceOnExtra = fFalse);
+    bool _FAllocFloCore(long cb, PFLO pflo, bool fForceOnExtra);
+    bool _FEnsureFsmCb(CSTO *pcsto);
     bool _FFindCtgCno(CTG ctg, CNO cno, long *picrp);
     void _GetUniqueCno(CTG ctg, long *picrp, CNO *pcno);
     void _FreeFpCb(bool fOnExtra, FP fp, long cb);
-    bool _FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck);
+    void _FreeFpCbCore(bool fOnExtra, FP fp, long cb);
+    bool _FAdd(long cb, CTG ctg, CNO cno, long icrp, PBLCK pblck, PBLCK pblckSrc = pvNil, void *pv = pvNil);
+    bool _FWriteData(long cb, PBLCK pblckSrc, void *pv, PFLO pflo);
+    bool _FFindPye(bool fOnExtra, FP fp, long *pipye);
+    bool _FFindPayload(ulong luHash, long cb, PBLCK pblckSrc, void *pv, PFLO pflo);
+    void _AddPayload(PFLO pflo, ulong luHash);
+    bool _FReleasePayload(bool fOnExtra, FP fp, long cb);
+    void _ReleaseData(bool fOnExtra, FP fp, long cb);
+    bool _FReadPayloads(FP fp, long cb, bool fShared);
+    bool _FShared(void);
+    void _ReleasePayloads(void);
     bool _FPut(long cb, CTG ctg, CNO cno, PBLCK pblck, PBLCK pblckSrc, void *pv);
     bool _FCopy(CTG ctgSrc, CNO cnoSrc, PCFL pcflDst, CNO *pcnoDst, bool fClone);
     bool _FFindMatch(CTG ctgSrc, CNO cnoSrc, PCFL pcflDst, CNO *pcnoDst);
@@ -140,6 +286,7 @@ class CFL : public CFL_PAR
     bool _FAdoptChild(long icrpPar, long ikid, CTG ctgChild, CNO cnoChild, CHID chid, bool fClearLoner);
     void _ReadFreeMap(void);
     bool _FFindChidCtg(CTG ctgPar, CNO cnoPar, CHID chid, CTG ctg, KID *pkid);
+    long _IkidFindChidCtg(long icrpPar, CHID chid, CTG ctg);
     bool _FSetName(long icrp, PSTN pstn);
     bool _FGetName(long icrp, PSTN pstn);
     void _GetFlo(long icrp, PFLO pflo);
@@ -162,6 +309,10 @@ class CFL : public CFL_PAR
 
     static void ClearMarks(void);
     static void CloseUnmarked(void);
+    static long CactIndexAll(void)
+    {
+        return _cactIndexAll;
+    }
 #ifdef CHUNK_STATS
     static void DumpStn(PSTN pstn, PFIL pfil = pvNil);
 #endif // CHUNK_STATS
@@ -190,6 +341,7 @@ class CFL : public CFL_PAR
     }
     long ElError(void);
     void ResetEl(long el = elNil);
+    void GetAlst(ALST *palst);
     bool FReopen(void);
 
     // finding and reading chunks
@@ -198,10 +350,19 @@ class CFL : public CFL_PAR
     bool FFind(CTG ctg, CNO cno, BLCK *pblck = pvNil);
     bool FFindFlo(CTG ctg, CNO cno, PFLO pflo);
     bool FReadHq(CTG ctg, CNO cno, HQ *phq);
+    bool FReadRghq(CKI *prgcki, long ccki, HQ *prghq, bool fPackedOk = fFalse);
+    bool FFindRgblck(CKI *prgcki, long ccki, BLCK *prgblck);
+    void *PvFindMap(CTG ctg, CNO cno, long *pcb = pvNil);
     void SetPacked(CTG ctg, CNO cno, bool fPacked);
     bool FPacked(CTG ctg, CNO cno);
     bool FUnpackData(CTG ctg, CNO cno);
-    bool FPackData(CTG ctg, CNO cno);
+    bool FPackData(CTG ctg, CNO cno, long cfmt = cfmtNil);
+    bool FPackDataRgcki(CKI *prgcki, long ccki, long cfmt = cfmtNil);
+    long CfmtPack(void);
+
+    // shared compression dictionaries
+    bool FSetDict(CTG ctg, void *pv, long cb);
+    ulong LuDict(CTG ctg);
 
     // creating and replacing chunks
     bool FAdd(long cb, CTG ctg, CNO *pcno, PBLCK pblck = pvNil);
@@ -240,6 +401,10 @@ class CFL : public CFL_PAR
     void ChangeChid(CTG ctgPar, CNO cnoPar, CTG ctgChild, CNO cnoChild, CHID chidOld, CHID chidNew);
 
     // enumerating chunks
+    long CactIndex(void)
+    {
+        return _cactIndex;
+    }
     long Ccki(void);
     bool FGetCki(long icki, CKI *pcki, long *pckid = pvNil, PBLCK pblck = pvNil);
     bool FGetIcki(CTG ctg, CNO cno, long *picki);
@@ -252,6 +417,9 @@ class CFL : public CFL_PAR
     bool FGetKidChid(CTG ctgPar, CNO cnoPar, CHID chid, KID *pkid);
     bool FGetKidChidCtg(CTG ctgPar, CNO cnoPar, CHID chid, CTG ctg, KID *pkid);
     bool FGetIkid(CTG ctgPar, CNO cnoPar, CTG ctg, CNO cno, CHID chid, long *pikid);
+    void InitKde(CTG ctgPar, CNO cnoPar, KDE *pkde);
+    void InitKdeChid(CTG ctgPar, CNO cnoPar, CHID chid, KDE *pkde);
+    bool FNextKid(KDE *pkde, KID *pkid, long *pikid = pvNil);
 
     // Serialized chunk forests
     bool FWriteChunkTree(CTG ctg, CNO cno, PFIL pfilDst, FP fpDst, long *pcb);
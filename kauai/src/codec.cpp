@@ -22,6 +22,72 @@ RTCLASS(CODC)
 ***************************************************************************/
 const long kcbCodecHeader = 2 * size(long);
 
+/***************************************************************************
+    kcfmtBlocked data splits the decompressed data into kcbCodecBlock sized
+    pieces that are compressed independently, so they can be decompressed
+    in parallel or one at a time. After the header comes a table with a
+    long (in big endian order) for each piece, giving where the piece's
+    data ends, measured from the end of the table. Each piece is a
+    complete compressed block (with its own header) in the default format
+    or, if it didn't compress, the raw bytes. The two are told apart by
+    size - compressed data is always smaller than its source.
+***************************************************************************/
+
+/***************************************************************************
+    kcfmtKauai2Dict data has the id of its dictionary (a ulong in big
+    endian order) after the header, then a KCD2 stream compressed as if
+    the dictionary came just before the data. The dictionary must be
+    registered with FAddDict to decompress the data.
+***************************************************************************/
+const long kcbDictId = size(ulong);
+
+// a registered dictionary
+struct DICT
+{
+    ulong luDict; // hash of the contents
+    byte *prgb;   // the contents (from FAllocPv, so it doesn't move)
+    long cb;
+    long cactRef; // number of FAddDict calls less ReleaseDict calls
+};
+
+/***************************************************************************
+    Return the end of the iblk'th piece's data from a kcfmtBlocked table.
+***************************************************************************/
+inline long _IbLimBlock(byte *prgbTable, long iblk)
+{
+    byte *pb = prgbTable + LwMul(iblk, size(long));
+    return LwFromBytes(pb[0], pb[1], pb[2], pb[3]);
+}
+
+/***************************************************************************
+    A single job for FDecompressRghq or FCompressRghq and the batch of jobs
+    shared by the threads doing the work.
+***************************************************************************/
+struct DCJ
+{
+    long ihq;
+    HQ hqDst;
+    void *pvSrc;
+    long cbSrc;
+    void *pvDst;
+    long cbDst;
+    bool fOk;
+    DFR dfr; // failures to report on the calling thread
+};
+
+struct DCB
+{
+    PCODM pcodm;
+    long cfmt;    // cfmtNil to decompress
+    ulong luDict; // dictionary to compress with
+    DCJ *prgdcj;
+    long cdcj;
+    long idcjNext; // the next job to hand out
+};
+
+// maximum number of threads working on a batch
+const long kcthrCodeMax = 8;
+
 /***************************************************************************
     Constructor for the compression manager. pcodc is an optional default
     codec. cfmt is the default compression format.
@@ -32,10 +98,12 @@ CODM::CODM(PCODC pcodc, long cfmt)
     Assert(cfmtNil != cfmt, "nil default compression format");
 
     _cfmtDef = cfmt;
+    _cmlDef = kcmlNormal;
     _pcodcDef = pcodc;
     if (pvNil != _pcodcDef)
         _pcodcDef->AddRef();
     _pglpcodc = pvNil;
+    _pgldict = pvNil;
 
     AssertThis(0);
 }
@@ -60,6 +128,18 @@ CODM::~CODM(void)
         }
         ReleasePpo(&_pglpcodc);
     }
+    if (pvNil != _pgldict)
+    {
+        long idict;
+        DICT dict;
+
+        for (idict = _pgldict->IvMac(); idict-- > 0;)
+        {
+            _pgldict->Get(idict, &dict);
+            FreePpv((void **)&dict.prgb);
+        }
+        ReleasePpo(&_pgldict);
+    }
 }
 
 #ifdef DEBUG
@@ -70,8 +150,10 @@ void CODM::AssertValid(ulong grf)
 {
     CODM_PAR::AssertValid(0);
     Assert(cfmtNil != _cfmtDef, "nil default compression");
+    AssertIn(_cmlDef, 0, kcmlLim);
     AssertNilOrPo(_pcodcDef, 0);
     AssertNilOrPo(_pglpcodc, 0);
+    AssertNilOrPo(_pgldict, 0);
 }
 
 /***************************************************************************
@@ -95,6 +177,18 @@ void CODM::MarkMem(void)
         }
         MarkMemObj(_pglpcodc);
     }
+    if (pvNil != _pgldict)
+    {
+        long idict;
+        DICT dict;
+
+        for (idict = _pgldict->IvMac(); idict-- > 0;)
+        {
+            _pgldict->Get(idict, &dict);
+            MarkPv(dict.prgb);
+        }
+        MarkMemObj(_pgldict);
+    }
 }
 #endif // DEBUG
 
@@ -114,6 +208,35 @@ void CODM::SetCfmtDefault(long cfmt)
     _cfmtDef = cfmt;
 }
 
+/***************************************************************************
+    Set the default compression level and pass it on to the codecs.
+***************************************************************************/
+void CODM::SetCmlDefault(long cml)
+{
+    AssertThis(0);
+
+    if (!FIn(cml, 0, kcmlLim))
+    {
+        Bug("bad compression level");
+        return;
+    }
+
+    _cmlDef = cml;
+    if (pvNil != _pcodcDef)
+        _pcodcDef->SetCml(cml);
+    if (pvNil != _pglpcodc)
+    {
+        long ipcodc;
+        PCODC pcodc;
+
+        for (ipcodc = _pglpcodc->IvMac(); ipcodc-- > 0;)
+        {
+            _pglpcodc->Get(ipcodc, &pcodc);
+            pcodc->SetCml(cml);
+        }
+    }
+}
+
 /***************************************************************************
     Add a codec to the compression manager.
 ***************************************************************************/
@@ -129,9 +252,183 @@ bool CODM::FRegisterCodec(PCODC pcodc)
         return fFalse;
 
     pcodc->AddRef();
+    pcodc->SetCml(_cmlDef);
     return fTrue;
 }
 
+/***************************************************************************
+    Look for the dictionary with the given id. Fills *pidict with where it
+    is or would be. Dictionaries are used by the threads decoding a batch
+    and by the CRF prefetch thread, so the caller must be in _mutxDict.
+***************************************************************************/
+bool CODM::_FFindDict(ulong luDict, long *pidict)
+{
+    AssertVarMem(pidict);
+
+    long idict, idictMin, idictLim;
+    DICT *qrgdict;
+
+    if (pvNil == _pgldict)
+    {
+        *pidict = 0;
+        return fFalse;
+    }
+
+    qrgdict = (DICT *)_pgldict->QvGet(0);
+    for (idictMin = 0, idictLim = _pgldict->IvMac(); idictMin < idictLim;)
+    {
+        idict = (idictMin + idictLim) / 2;
+        if (qrgdict[idict].luDict < luDict)
+            idictMin = idict + 1;
+        else
+            idictLim = idict;
+    }
+
+    *pidict = idictMin;
+    return idictMin < _pgldict->IvMac() && qrgdict[idictMin].luDict == luDict;
+}
+
+/***************************************************************************
+    Register a dictionary for kcfmtKauai2Dict. The contents are copied.
+    Fills *pluDict with the dictionary's id, which is never zero. If the
+    dictionary is already registered, this just adds a reference to it.
+***************************************************************************/
+bool CODM::FAddDict(void *pv, long cb, ulong *pluDict)
+{
+    AssertThis(0);
+    AssertIn(cb, 1, kcbDictMax + 1);
+    AssertPvCb(pv, cb);
+    AssertVarMem(pluDict);
+
+    long idict, ib;
+    DICT dict;
+    byte *prgb = (byte *)pv;
+    bool fRet = fFalse;
+
+    TrashVar(pluDict);
+
+    // FNV-1a hash of the contents and size
+    dict.luDict = 0x811C9DC5;
+    for (ib = 0; ib < cb; ib++)
+        dict.luDict = (dict.luDict ^ prgb[ib]) * 0x01000193;
+    dict.luDict = (dict.luDict ^ (ulong)cb) * 0x01000193;
+    if (0 == dict.luDict)
+        dict.luDict = 1;
+
+    _mutxDict.Enter();
+
+    if (_FFindDict(dict.luDict, &idict))
+    {
+        DICT *qdict = (DICT *)_pgldict->QvGet(idict);
+
+        if (qdict->cb != cb || !FEqualRgb(qdict->prgb, pv, cb))
+        {
+            Warn("dictionary hash collision");
+            goto LFail;
+        }
+        qdict->cactRef++;
+    }
+    else
+    {
+        if (pvNil == _pgldict && pvNil == (_pgldict = GL::PglNew(size(DICT))))
+            goto LFail;
+        if (!FAllocPv((void **)&dict.prgb, cb, fmemNil, mprNormal))
+            goto LFail;
+        CopyPb(pv, dict.prgb, cb);
+        dict.cb = cb;
+        dict.cactRef = 1;
+        if (!_pgldict->FInsert(idict, &dict))
+        {
+            FreePpv((void **)&dict.prgb);
+            goto LFail;
+        }
+    }
+
+    *pluDict = dict.luDict;
+    fRet = fTrue;
+
+LFail:
+    _mutxDict.Leave();
+    return fRet;
+}
+
+/***************************************************************************
+    Release a reference to a dictionary added with FAddDict (or taken by
+    _FRefDict).
+***************************************************************************/
+void CODM::ReleaseDict(ulong luDict)
+{
+    AssertThis(0);
+
+    long idict;
+    DICT dict;
+
+    _mutxDict.Enter();
+
+    if (!_FFindDict(luDict, &idict))
+    {
+        Bug("releasing a dictionary that isn't registered");
+        goto LDone;
+    }
+
+    _pgldict->Get(idict, &dict);
+    if (--dict.cactRef > 0)
+        _pgldict->Put(idict, &dict);
+    else
+    {
+        FreePpv((void **)&dict.prgb);
+        _pgldict->Delete(idict);
+    }
+
+LDone:
+    _mutxDict.Leave();
+}
+
+/***************************************************************************
+    Add a reference to the dictionary with the given id and get its
+    contents. The contents don't move and stay valid until the matching
+    ReleaseDict, even if the dictionary's owner releases it in the
+    meantime. Returns false if the dictionary isn't registered.
+***************************************************************************/
+bool CODM::_FRefDict(ulong luDict, byte **pprgb, long *pcb)
+{
+    AssertVarMem(pprgb);
+    AssertVarMem(pcb);
+
+    long idict;
+    DICT *qdict;
+    bool fRet;
+
+    _mutxDict.Enter();
+
+    if ((fRet = _FFindDict(luDict, &idict)))
+    {
+        qdict = (DICT *)_pgldict->QvGet(idict);
+        qdict->cactRef++;
+        *pprgb = qdict->prgb;
+        *pcb = qdict->cb;
+    }
+
+    _mutxDict.Leave();
+    return fRet;
+}
+
+/***************************************************************************
+    Return whether the dictionary with the given id is registered.
+***************************************************************************/
+bool CODM::FHasDict(ulong luDict)
+{
+    AssertThis(0);
+
+    long idict;
+    bool fRet;
+
+    _mutxDict.Enter();
+    fRet = _FFindDict(luDict, &idict);
+    _mutxDict.Leave();
+    return fRet;
+}
+
 /***************************************************************************
     Return whether we can encode or decode the given format.
 ***************************************************************************/
@@ -142,6 +439,8 @@ bool CODM::FCanDo(long cfmt, bool fEncode)
 
     if (cfmtNil == cfmt)
         return fFalse;
+    if (kcfmtBlocked == cfmt)
+        return !fEncode || _FFindCodec(fTrue, _CfmtBlock(), &pcodc);
 
     return _FFindCodec(fEncode, cfmt, &pcodc);
 }
@@ -169,6 +468,28 @@ bool CODM::FGetCfmtFromBlck(PBLCK pblck, long *pcfmt)
     return fTrue;
 }
 
+/***************************************************************************
+    Gets the decompressed size of the block (assuming it is compressed).
+***************************************************************************/
+bool CODM::FGetCbFromBlck(PBLCK pblck, long *pcb)
+{
+    AssertThis(0);
+    AssertPo(pblck, 0);
+    AssertVarMem(pcb);
+
+    byte rgb[kcbCodecHeader];
+
+    TrashVar(pcb);
+    if (pblck->Cb(fTrue) <= size(rgb))
+        return fFalse;
+
+    if (!pblck->FReadRgb(rgb, size(rgb), 0, fTrue))
+        return fFalse;
+
+    *pcb = LwFromBytes(rgb[4], rgb[5], rgb[6], rgb[7]);
+    return FIn(*pcb, 1, kcbMax);
+}
+
 /***************************************************************************
     Look for a codec that can handle the given format.
 ***************************************************************************/
@@ -207,7 +528,7 @@ bool CODM::_FFindCodec(bool fEncode, long cfmt, PCODC *ppcodc)
     Compress or decompress an hq of data. Note that the value of *phq
     may change. cfmt should be cfmtNil to decompress.
 ***************************************************************************/
-bool CODM::_FCodePhq(long cfmt, HQ *phq)
+bool CODM::_FCodePhq(long cfmt, HQ *phq, ulong luDict)
 {
     AssertThis(0);
     AssertVarMem(phq);
@@ -221,7 +542,7 @@ bool CODM::_FCodePhq(long cfmt, HQ *phq)
 
     pvSrc = PvLockHq(*phq);
     cbSrc = CbOfHq(*phq);
-    fRet = _FCode(cfmt, pvSrc, cbSrc, pvNil, 0, &cbDst);
+    fRet = _FCode(cfmt, pvSrc, cbSrc, pvNil, 0, &cbDst, luDict);
     UnlockHq(*phq);
     if (!fRet)
         return fFalse;
@@ -230,7 +551,7 @@ bool CODM::_FCodePhq(long cfmt, HQ *phq)
         return fFalse;
 
     pvSrc = PvLockHq(*phq);
-    fRet = _FCode(cfmt, pvSrc, cbSrc, PvLockHq(hqDst), cbDst, &cbDst);
+    fRet = _FCode(cfmt, pvSrc, cbSrc, PvLockHq(hqDst), cbDst, &cbDst, luDict);
     UnlockHq(hqDst);
     UnlockHq(*phq);
     if (!fRet)
@@ -247,12 +568,275 @@ bool CODM::_FCodePhq(long cfmt, HQ *phq)
     return fTrue;
 }
 
+/***************************************************************************
+    Do jobs from the batch until there are none left. This is run by the
+    calling thread and by each helper thread.
+***************************************************************************/
+priv void _CodeJobs(DCB *pdcb)
+{
+    long idcj;
+    long cbDst;
+    DCJ *pdcj;
+    DFR *pdfrOld = vpdfrCur;
+
+#ifdef WIN
+    while ((idcj = InterlockedIncrement(&pdcb->idcjNext) - 1) < pdcb->cdcj)
+#else  //! WIN
+    while ((idcj = pdcb->idcjNext++) < pdcb->cdcj)
+#endif //! WIN
+    {
+        pdcj = &pdcb->prgdcj[idcj];
+        vpdfrCur = &pdcj->dfr;
+        if (cfmtNil == pdcb->cfmt)
+        {
+            pdcj->fOk = pdcb->pcodm->FDecompress(pdcj->pvSrc, pdcj->cbSrc, pdcj->pvDst, pdcj->cbDst, &cbDst) &&
+                        cbDst == pdcj->cbDst;
+        }
+        else
+        {
+            pdcj->fOk = pdcb->pcodm->FCompress(pdcj->pvSrc, pdcj->cbSrc, pdcj->pvDst, pdcj->cbDst, &cbDst, pdcb->cfmt,
+                                               pdcb->luDict);
+            if (pdcj->fOk)
+                pdcj->cbDst = cbDst;
+        }
+    }
+    vpdfrCur = pdfrOld;
+}
+
+#ifdef WIN
+/***************************************************************************
+    Thread proc for the batch helper threads.
+***************************************************************************/
+priv ulong __stdcall _LuCodeThread(void *pv)
+{
+    // the calling thread owns the objects we use, so don't validate them
+    Debug(vcactAV = 0;)
+    _CodeJobs((DCB *)pv);
+    return 0;
+}
+#endif // WIN
+
+/***************************************************************************
+    Run all the jobs in the batch, spreading them across the available
+    processors. The source and destination memory must be locked. Errors
+    and failed asserts in the jobs are reported on this thread once all
+    the jobs are done.
+***************************************************************************/
+priv void _RunJobs(DCB *pdcb)
+{
+    long idcj;
+#ifdef WIN
+    SYSTEM_INFO si;
+    HANDLE rghth[kcthrCodeMax];
+    ulong luThread;
+    long ithr, cthr;
+
+    // start helper threads - this thread does its share of the work too
+    GetSystemInfo(&si);
+    cthr = LwMin(LwMin((long)si.dwNumberOfProcessors, kcthrCodeMax), pdcb->cdcj) - 1;
+    for (ithr = 0; ithr < cthr; ithr++)
+    {
+        if (hNil == (rghth[ithr] = CreateThread(pvNil, 0, _LuCodeThread, pdcb, 0, &luThread)))
+            break;
+    }
+    cthr = ithr;
+#endif // WIN
+
+    _CodeJobs(pdcb);
+
+#ifdef WIN
+    if (cthr > 0)
+    {
+        WaitForMultipleObjects(cthr, rghth, fTrue, INFINITE);
+        for (ithr = 0; ithr < cthr; ithr++)
+            CloseHandle(rghth[ithr]);
+    }
+#endif // WIN
+
+    for (idcj = 0; idcj < pdcb->cdcj; idcj++)
+        ReportDfr(&pdcb->prgdcj[idcj].dfr);
+}
+
+/***************************************************************************
+    Decompress a batch of hq's. Nil entries are skipped. The sizes are
+    determined and all the memory is allocated and locked up front, so the
+    worker threads don't touch the memory manager. On failure, the hq's
+    are left as they were.
+***************************************************************************/
+bool CODM::FDecompressRghq(HQ *prghq, long chq)
+{
+    AssertThis(0);
+    AssertIn(chq, 0, kcbMax);
+    AssertPvCb(prghq, LwMul(chq, size(HQ)));
+
+    long ihq, idcj;
+    DCB dcb;
+    DCJ *pdcj;
+    HQ hq;
+    bool fRet = fFalse;
+
+    if (0 == chq)
+        return fTrue;
+
+    ClearPb(&dcb, size(dcb));
+    dcb.pcodm = this;
+    dcb.cfmt = cfmtNil;
+    if (!FAllocPv((void **)&dcb.prgdcj, LwMul(chq, size(DCJ)), fmemClear, mprNormal))
+        return fFalse;
+
+    // get the decompressed sizes and allocate the destinations
+    for (ihq = 0; ihq < chq; ihq++)
+    {
+        if (hqNil == (hq = prghq[ihq]))
+            continue;
+        AssertHq(hq);
+
+        pdcj = &dcb.prgdcj[dcb.cdcj++];
+        pdcj->ihq = ihq;
+        pdcj->cbSrc = CbOfHq(hq);
+        if (pdcj->cbSrc <= 0)
+            goto LFail;
+        fRet = FDecompress(PvLockHq(hq), pdcj->cbSrc, pvNil, 0, &pdcj->cbDst);
+        UnlockHq(hq);
+        if (!fRet || !FAllocHq(&pdcj->hqDst, pdcj->cbDst, fmemNil, mprNormal))
+        {
+            fRet = fFalse;
+            goto LFail;
+        }
+    }
+
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+    {
+        pdcj = &dcb.prgdcj[idcj];
+        pdcj->pvSrc = PvLockHq(prghq[pdcj->ihq]);
+        pdcj->pvDst = PvLockHq(pdcj->hqDst);
+    }
+
+    _RunJobs(&dcb);
+
+    fRet = fTrue;
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+    {
+        pdcj = &dcb.prgdcj[idcj];
+        UnlockHq(pdcj->hqDst);
+        UnlockHq(prghq[pdcj->ihq]);
+        if (!pdcj->fOk)
+            fRet = fFalse;
+    }
+
+    if (fRet)
+    {
+        for (idcj = 0; idcj < dcb.cdcj; idcj++)
+        {
+            pdcj = &dcb.prgdcj[idcj];
+            FreePhq(&prghq[pdcj->ihq]);
+            prghq[pdcj->ihq] = pdcj->hqDst;
+            pdcj->hqDst = hqNil;
+        }
+    }
+
+LFail:
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+        FreePhq(&dcb.prgdcj[idcj].hqDst);
+    FreePpv((void **)&dcb.prgdcj);
+
+    return fRet;
+}
+
+/***************************************************************************
+    Compress a batch of hq's, spreading the work across the available
+    processors. Nil entries are skipped. Each hq that compresses is
+    replaced by its compressed version and gets its prgfPacked entry set;
+    the others are left alone. Returns false only if we run out of memory,
+    in which case none of the hq's are changed. As with FDecompressRghq,
+    the hq's are allocated up front; the only memory the worker threads
+    touch is the encoder's scratch space, which comes from FAllocPv.
+***************************************************************************/
+bool CODM::FCompressRghq(HQ *prghq, bool *prgfPacked, long chq, long cfmt, ulong luDict)
+{
+    AssertThis(0);
+    AssertIn(chq, 0, kcbMax);
+    AssertPvCb(prghq, LwMul(chq, size(HQ)));
+    AssertPvCb(prgfPacked, LwMul(chq, size(bool)));
+
+    long ihq, idcj;
+    DCB dcb;
+    DCJ *pdcj;
+    HQ hq;
+    bool fRet = fFalse;
+
+    if (0 == chq)
+        return fTrue;
+    ClearPb(prgfPacked, LwMul(chq, size(bool)));
+
+    ClearPb(&dcb, size(dcb));
+    dcb.pcodm = this;
+    dcb.cfmt = cfmtNil == cfmt ? _cfmtDef : cfmt;
+    dcb.luDict = luDict;
+    if (!FAllocPv((void **)&dcb.prgdcj, LwMul(chq, size(DCJ)), fmemClear, mprNormal))
+        return fFalse;
+
+    // allocate the destinations - anything that isn't smaller than the
+    // source isn't worth keeping
+    for (ihq = 0; ihq < chq; ihq++)
+    {
+        if (hqNil == (hq = prghq[ihq]))
+            continue;
+        AssertHq(hq);
+
+        pdcj = &dcb.prgdcj[dcb.cdcj];
+        pdcj->ihq = ihq;
+        pdcj->cbSrc = CbOfHq(hq);
+        if (pdcj->cbSrc <= 0 || !FCompress(QvFromHq(hq), pdcj->cbSrc, pvNil, 0, &pdcj->cbDst, dcb.cfmt, luDict))
+            continue;
+        if (!FAllocHq(&pdcj->hqDst, pdcj->cbDst, fmemNil, mprNormal))
+            goto LFail;
+        dcb.cdcj++;
+    }
+
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+    {
+        pdcj = &dcb.prgdcj[idcj];
+        pdcj->pvSrc = PvLockHq(prghq[pdcj->ihq]);
+        pdcj->pvDst = PvLockHq(pdcj->hqDst);
+    }
+
+    _RunJobs(&dcb);
+
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+    {
+        pdcj = &dcb.prgdcj[idcj];
+        UnlockHq(pdcj->hqDst);
+        UnlockHq(prghq[pdcj->ihq]);
+        if (!pdcj->fOk)
+            continue;
+
+        if (pdcj->cbDst < CbOfHq(pdcj->hqDst))
+            AssertDo(FResizePhq(&pdcj->hqDst, pdcj->cbDst, fmemNil, mprNormal), 0);
+        FreePhq(&prghq[pdcj->ihq]);
+        prghq[pdcj->ihq] = pdcj->hqDst;
+        pdcj->hqDst = hqNil;
+        prgfPacked[pdcj->ihq] = fTrue;
+    }
+    fRet = fTrue;
+
+LFail:
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+        FreePhq(&dcb.prgdcj[idcj].hqDst);
+    FreePpv((void **)&dcb.prgdcj);
+
+    return fRet;
+}
+
 /***************************************************************************
     Compress or decompress a block of data. If pvDst is nil, just fill
     *pcbDst with the required destination buffer size. This is just an
-    estimate in the compress case.
+    estimate in the compress case. luDict is the dictionary to compress
+    kcfmtKauai2Dict data with. A dictionary is referenced for as long as
+    it's being used, so another thread releasing it can't free it out from
+    under us.
 ***************************************************************************/
-bool CODM::_FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+bool CODM::_FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, ulong luDict)
 {
     AssertIn(cbSrc, 1, kcbMax);
     AssertPvCb(pvSrc, cbSrc);
@@ -262,6 +846,10 @@ bool CODM::_FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, l
 
     byte *prgb;
     PCODC pcodc;
+    byte *prgbDict;
+    long cbDict;
+    long cbId = 0;
+    bool fRet = fFalse;
 
     if (cfmtNil != cfmt)
     {
@@ -269,32 +857,60 @@ bool CODM::_FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, l
         if (pvNil == pvDst || cbDst >= cbSrc)
             cbDst = cbSrc - 1;
 
-        if (cbDst <= kcbCodecHeader)
+        if (kcfmtKauai2Dict == cfmt)
+        {
+            if (!_FRefDict(luDict, &prgbDict, &cbDict))
+            {
+                Bug("compressing with a dictionary that isn't registered");
+                return fFalse;
+            }
+            cbId = kcbDictId;
+        }
+
+        if (cbDst <= kcbCodecHeader + cbId)
         {
             // destination is smaller than the minimum compressed size, so
             // no sense trying.
-            return fFalse;
+            goto LFail;
         }
 
         // make sure we have a codec for this format
-        if (!_FFindCodec(fTrue, cfmt, &pcodc))
-            return fFalse;
+        if (kcfmtBlocked == cfmt ? !FCanDo(cfmt, fTrue) : !_FFindCodec(fTrue, cfmt, &pcodc))
+            goto LFail;
 
         if (pvNil == pvDst)
         {
             // this is our best guess at the compressed size
             *pcbDst = cbDst;
-            return fTrue;
+            fRet = fTrue;
+            goto LFail;
         }
 
         prgb = (byte *)pvDst;
-        if (!pcodc->FConvert(fTrue, cfmt, pvSrc, cbSrc, prgb + kcbCodecHeader, cbDst - kcbCodecHeader, pcbDst))
+        if (kcfmtBlocked == cfmt)
         {
-            return fFalse;
+            if (!_FEncodeBlocked(pvSrc, cbSrc, prgb + kcbCodecHeader, cbDst - kcbCodecHeader, pcbDst))
+                goto LFail;
+        }
+        else if (kcfmtKauai2Dict == cfmt)
+        {
+            if (!pcodc->FConvertDict(fTrue, cfmt, prgbDict, cbDict, pvSrc, cbSrc, prgb + kcbCodecHeader + cbId,
+                                     cbDst - kcbCodecHeader - cbId, pcbDst))
+            {
+                goto LFail;
+            }
+            prgb[8] = B3Lw(luDict);
+            prgb[9] = B2Lw(luDict);
+            prgb[10] = B1Lw(luDict);
+            prgb[11] = B0Lw(luDict);
+        }
+        else if (!pcodc->FConvert(fTrue, cfmt, pvSrc, cbSrc, prgb + kcbCodecHeader, cbDst - kcbCodecHeader, pcbDst))
+        {
+            goto LFail;
         }
 
-        AssertIn(*pcbDst, 1, cbDst - kcbCodecHeader + 1);
-        *pcbDst += kcbCodecHeader;
+        AssertIn(*pcbDst, 1, cbDst - kcbCodecHeader - cbId + 1);
+        *pcbDst += kcbCodecHeader + cbId;
 
         prgb[0] = B3Lw(cfmt);
         prgb[1] = B2Lw(cfmt);
@@ -319,24 +935,306 @@ bool CODM::_FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, l
             return fFalse;
 
         // make sure we have a codec for this format
-        if (!_FFindCodec(fFalse, cfmt, &pcodc))
+        if (kcfmtBlocked != cfmt && !_FFindCodec(fFalse, cfmt, &pcodc))
             return fFalse;
 
+        // make sure we have the dictionary
+        if (kcfmtKauai2Dict == cfmt)
+        {
+            if (0 >= (cbSrc -= kcbDictId))
+                return fFalse;
+            luDict = LwFromBytes(prgb[8], prgb[9], prgb[10], prgb[11]);
+            if (!_FRefDict(luDict, &prgbDict, &cbDict))
+            {
+                Warn("data needs a dictionary that isn't registered");
+                return fFalse;
+            }
+            cbId = kcbDictId;
+        }
+
         if (pvNil == pvDst)
-            return fTrue;
+        {
+            fRet = fTrue;
+            goto LFail;
+        }
 
         cbDst = *pcbDst;
-        if (!pcodc->FConvert(fFalse, cfmt, prgb + kcbCodecHeader, cbSrc, pvDst, cbDst, pcbDst))
+        if (kcfmtBlocked == cfmt)
         {
-            return fFalse;
+            if (!_FDecodeBlocked(prgb + kcbCodecHeader, cbSrc, pvDst, cbDst))
+                goto LFail;
+        }
+        else if (kcfmtKauai2Dict == cfmt)
+        {
+            if (!pcodc->FConvertDict(fFalse, cfmt, prgbDict, cbDict, prgb + kcbCodecHeader + cbId, cbSrc, pvDst, cbDst,
+                                     pcbDst))
+            {
+                goto LFail;
+            }
+        }
+        else if (!pcodc->FConvert(fFalse, cfmt, prgb + kcbCodecHeader, cbSrc, pvDst, cbDst, pcbDst))
+        {
+            goto LFail;
         }
 
         if (cbDst != *pcbDst)
         {
             Bug("decompressed to wrong size");
-            return fFalse;
+            goto LFail;
+        }
+    }
+    fRet = fTrue;
+
+LFail:
+    if (kcfmtKauai2Dict == cfmt)
+        ReleaseDict(luDict);
+    return fRet;
+}
+
+/***************************************************************************
+    Compress pvSrc into kcfmtBlocked data (without the header). The pieces
+    are compressed one after another - FCompressRghq already spreads the
+    work across chunks.
+***************************************************************************/
+bool CODM::_FEncodeBlocked(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    long cblk = LwDivAway(cbSrc, kcbCodecBlock);
+    long cbTable = LwMul(cblk, size(long));
+    long cfmt = _CfmtBlock();
+    long iblk, ibSrc, cbBlk, cbOut, ibLim;
+    byte *prgbSrc = (byte *)pvSrc;
+    byte *prgbTable = (byte *)pvDst;
+    byte *pb, *pbLim;
+
+    TrashVar(pcbDst);
+    if (cbDst <= cbTable)
+        return fFalse;
+
+    pb = prgbTable + cbTable;
+    pbLim = prgbTable + cbDst;
+    for (iblk = 0; iblk < cblk; iblk++)
+    {
+        ibSrc = LwMul(iblk, kcbCodecBlock);
+        cbBlk = LwMin(kcbCodecBlock, cbSrc - ibSrc);
+        if (!_FCode(cfmt, prgbSrc + ibSrc, cbBlk, pb, pbLim - pb, &cbOut))
+        {
+            // store it as is
+            if (pbLim - pb < cbBlk)
+                return fFalse;
+            CopyPb(prgbSrc + ibSrc, pb, cbBlk);
+            cbOut = cbBlk;
         }
+        pb += cbOut;
+
+        ibLim = pb - prgbTable - cbTable;
+        prgbTable[iblk * size(long)] = B3Lw(ibLim);
+        prgbTable[iblk * size(long) + 1] = B2Lw(ibLim);
+        prgbTable[iblk * size(long) + 2] = B1Lw(ibLim);
+        prgbTable[iblk * size(long) + 3] = B0Lw(ibLim);
     }
 
+    *pcbDst = pb - prgbTable;
     return fTrue;
 }
+
+/***************************************************************************
+    Decompress kcfmtBlocked data (without the header) into pvDst, which
+    must be exactly the decompressed size. The compressed pieces are
+    spread across the available processors.
+***************************************************************************/
+bool CODM::_FDecodeBlocked(void *pvSrc, long cbSrc, void *pvDst, long cbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+
+    long cblk = LwDivAway(cbDst, kcbCodecBlock);
+    long cbTable = LwMul(cblk, size(long));
+    long iblk, idcj, ibDst, cbBlk, ibMin, ibLim;
+    byte *prgbSrc = (byte *)pvSrc;
+    byte *prgbDst = (byte *)pvDst;
+    DCB dcb;
+    DCJ *pdcj;
+    bool fRet = fFalse;
+
+    if (cbSrc < cbTable)
+        return fFalse;
+
+    ClearPb(&dcb, size(dcb));
+    dcb.pcodm = this;
+    dcb.cfmt = cfmtNil;
+    if (!FAllocPv((void **)&dcb.prgdcj, LwMul(cblk, size(DCJ)), fmemClear, mprNormal))
+        return fFalse;
+
+    for (iblk = 0, ibMin = 0; iblk < cblk; iblk++, ibMin = ibLim)
+    {
+        ibLim = _IbLimBlock(prgbSrc, iblk);
+        ibDst = LwMul(iblk, kcbCodecBlock);
+        cbBlk = LwMin(kcbCodecBlock, cbDst - ibDst);
+        if (!FIn(ibLim - ibMin, 1, cbBlk + 1) || ibLim > cbSrc - cbTable)
+            goto LFail;
+
+        if (ibLim - ibMin == cbBlk)
+        {
+            // this piece wasn't compressed
+            CopyPb(prgbSrc + cbTable + ibMin, prgbDst + ibDst, cbBlk);
+            continue;
+        }
+
+        pdcj = &dcb.prgdcj[dcb.cdcj++];
+        pdcj->pvSrc = prgbSrc + cbTable + ibMin;
+        pdcj->cbSrc = ibLim - ibMin;
+        pdcj->pvDst = prgbDst + ibDst;
+        pdcj->cbDst = cbBlk;
+    }
+
+    _RunJobs(&dcb);
+
+    fRet = fTrue;
+    for (idcj = 0; idcj < dcb.cdcj; idcj++)
+    {
+        if (!dcb.prgdcj[idcj].fOk)
+            fRet = fFalse;
+    }
+
+LFail:
+    FreePpv((void **)&dcb.prgdcj);
+    return fRet;
+}
+
+/***************************************************************************
+    Decompress cb bytes at offset ib of the decompressed data of the packed
+    block pblck into pv. If the data is in the kcfmtBlocked format, only
+    the pieces that overlap the range are read and decompressed, in
+    parallel. Otherwise the whole block is decompressed.
+***************************************************************************/
+bool CODM::FDecompressRgbFromBlck(PBLCK pblck, void *pv, long cb, long ib)
+{
+    AssertThis(0);
+    AssertPo(pblck, 0);
+    AssertIn(cb, 0, kcbMax);
+    AssertPvCb(pv, cb);
+
+    byte rgb[kcbCodecHeader];
+    long cfmt, cbTotal, cblkTotal, ibTable, ibData, cbData;
+    long iblkMin, cblk, iblk, ibMin, ibLim, ibBlk, cbBlk, ibCopyMin, ibCopyLim;
+    byte *prgbTable = pvNil;
+    HQ *prghq = pvNil;
+    HQ hq;
+    bool fRet = fFalse;
+
+    if (pblck->Cb(fTrue) <= size(rgb) || !pblck->FReadRgb(rgb, size(rgb), 0, fTrue))
+        return fFalse;
+    cfmt = LwFromBytes(rgb[0], rgb[1], rgb[2], rgb[3]);
+    cbTotal = LwFromBytes(rgb[4], rgb[5], rgb[6], rgb[7]);
+    if (!FIn(ib, 0, cbTotal + 1) || !FIn(cb, 0, cbTotal - ib + 1))
+    {
+        Bug("reading outside blck");
+        return fFalse;
+    }
+    if (0 == cb)
+        return fTrue;
+
+    if (kcfmtBlocked != cfmt)
+    {
+        // no way to get at part of it - decompress the whole thing
+        if (!pblck->FReadHq(&hq, fTrue))
+            return fFalse;
+        if (!FDecompressPhq(&hq) || CbOfHq(hq) != cbTotal)
+        {
+            FreePhq(&hq);
+            return fFalse;
+        }
+        CopyPb((byte *)QvFromHq(hq) + ib, pv, cb);
+        FreePhq(&hq);
+        return fTrue;
+    }
+
+    cblkTotal = LwDivAway(cbTotal, kcbCodecBlock);
+    ibData = kcbCodecHeader + LwMul(cblkTotal, size(long));
+    cbData = pblck->Cb(fTrue) - ibData;
+    if (cbData <= 0)
+        return fFalse;
+
+    // read the table entries for the pieces we need, plus the one before
+    // them, which tells where the first one starts
+    iblkMin = ib / kcbCodecBlock;
+    cblk = LwDivAway(ib + cb, kcbCodecBlock) - iblkMin;
+    ibTable = kcbCodecHeader + LwMul(iblkMin - 1, size(long));
+    if (!FAllocPv((void **)&prgbTable, LwMul(cblk + 1, size(long)), fmemClear, mprNormal) ||
+        !FAllocPv((void **)&prghq, LwMul(cblk, size(HQ)), fmemClear, mprNormal))
+    {
+        goto LFail;
+    }
+    if (0 == iblkMin)
+    {
+        // the first piece starts at zero - prgbTable is already cleared
+        if (!pblck->FReadRgb(prgbTable + size(long), LwMul(cblk, size(long)), kcbCodecHeader, fTrue))
+            goto LFail;
+    }
+    else if (!pblck->FReadRgb(prgbTable, LwMul(cblk + 1, size(long)), ibTable, fTrue))
+        goto LFail;
+
+    // read the pieces, copying the ones that aren't compressed straight
+    // to the destination
+    for (iblk = 0; iblk < cblk; iblk++)
+    {
+        ibMin = _IbLimBlock(prgbTable, iblk);
+        ibLim = _IbLimBlock(prgbTable, iblk + 1);
+        ibBlk = LwMul(iblkMin + iblk, kcbCodecBlock);
+        cbBlk = LwMin(kcbCodecBlock, cbTotal - ibBlk);
+        if (!FIn(ibMin, 0, ibLim) || ibLim > cbData || ibLim - ibMin > cbBlk)
+            goto LFail;
+
+        if (ibLim - ibMin == cbBlk)
+        {
+            ibCopyMin = LwMax(ib, ibBlk);
+            ibCopyLim = LwMin(ib + cb, ibBlk + cbBlk);
+            if (!pblck->FReadRgb((byte *)pv + ibCopyMin - ib, ibCopyLim - ibCopyMin,
+                                 ibData + ibMin + ibCopyMin - ibBlk, fTrue))
+            {
+                goto LFail;
+            }
+        }
+        else if (!pblck->FReadHq(&prghq[iblk], ibLim - ibMin, ibData + ibMin, fTrue))
+            goto LFail;
+    }
+
+    if (!FDecompressRghq(prghq, cblk))
+        goto LFail;
+
+    for (iblk = 0; iblk < cblk; iblk++)
+    {
+        if (hqNil == (hq = prghq[iblk]))
+            continue;
+
+        ibBlk = LwMul(iblkMin + iblk, kcbCodecBlock);
+        cbBlk = LwMin(kcbCodecBlock, cbTotal - ibBlk);
+        if (CbOfHq(hq) != cbBlk)
+            goto LFail;
+        ibCopyMin = LwMax(ib, ibBlk);
+        ibCopyLim = LwMin(ib + cb, ibBlk + cbBlk);
+        CopyPb((byte *)QvFromHq(hq) + ibCopyMin - ibBlk, (byte *)pv + ibCopyMin - ib, ibCopyLim - ibCopyMin);
+    }
+    fRet = fTrue;
+
+LFail:
+    if (pvNil != prghq)
+    {
+        for (iblk = 0; iblk < cblk; iblk++)
+            FreePhq(&prghq[iblk]);
+    }
+    FreePpv((void **)&prghq);
+    FreePpv((void **)&prgbTable);
+
+    return fRet;
+}
@@ -15,6 +15,23 @@
 #ifndef CODEC_H
 #define CODEC_H
 
+/***************************************************************************
+    Compression levels. These trade compression time for compressed size.
+***************************************************************************/
+enum
+{
+    kcmlFast,   // bounded match search - for quick rebuilds
+    kcmlNormal, // full match search
+    kcmlMax,    // full match search plus lazy matching
+    kcmlLim
+};
+
+// the size of the pieces kcfmtBlocked data is split into
+const long kcbCodecBlock = 0x00010000;
+
+// the largest dictionary kcfmtKauai2Dict data can be primed with
+const long kcbDictMax = 0x00010000;
+
 /***************************************************************************
     Codec object.
 ***************************************************************************/
@@ -32,6 +49,21 @@ class CODC : public CODC_PAR
     // Decompression should be extremely fast. Compression may be
     // (painfully) slow.
     virtual bool FConvert(bool fEncode, long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst) = 0;
+
+    // Like FConvert, but for formats that prime the compressor with a
+    // dictionary of data like what's being compressed. The same dictionary
+    // must be used to decompress the data.
+    virtual bool FConvertDict(bool fEncode, long cfmt, void *pvDict, long cbDict, void *pvSrc, long cbSrc, void *pvDst,
+                              long cbDst, long *pcbDst)
+    {
+        return fFalse;
+    }
+
+    // set how hard the encoder should work. Codecs with only one way of
+    // compressing ignore this.
+    virtual void SetCml(long cml)
+    {
+    }
 };
 
 /***************************************************************************
@@ -48,12 +80,23 @@ class CODM : public CODM_PAR
 
   protected:
     long _cfmtDef;
+    long _cmlDef;
     PCODC _pcodcDef;
     PGL _pglpcodc;
+    PGL _pgldict;   // the registered dictionaries, sorted by luDict
+    MUTX _mutxDict; // guards _pgldict, since other threads decode with them
 
     virtual bool _FFindCodec(bool fEncode, long cfmt, PCODC *ppcodc);
-    virtual bool _FCodePhq(long cfmt, HQ *phq);
-    virtual bool _FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
+    virtual bool _FCodePhq(long cfmt, HQ *phq, ulong luDict = 0);
+    virtual bool _FCode(long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, ulong luDict = 0);
+    bool _FFindDict(ulong luDict, long *pidict);
+    bool _FRefDict(ulong luDict, byte **pprgb, long *pcb);
+    bool _FEncodeBlocked(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
+    bool _FDecodeBlocked(void *pvSrc, long cbSrc, void *pvDst, long cbDst);
+    long _CfmtBlock(void)
+    {
+        return kcfmtBlocked == _cfmtDef ? kcfmtKauai2 : _cfmtDef;
+    }
 
   public:
     CODM(PCODC pcodc, long cfmt);
@@ -64,6 +107,11 @@ class CODM : public CODM_PAR
         return _cfmtDef;
     }
     void SetCfmtDefault(long cfmt);
+    long CmlDefault(void)
+    {
+        return _cmlDef;
+    }
+    void SetCmlDefault(long cml);
     virtual bool FRegisterCodec(PCODC pcodc);
     virtual bool FCanDo(long cfmt, bool fEncode);
 
@@ -71,6 +119,9 @@ class CODM : public CODM_PAR
     // compressed).
     virtual bool FGetCfmtFromBlck(PBLCK pblck, long *pcfmt);
 
+    // Gets the decompressed size of the block (assuming it is compressed).
+    bool FGetCbFromBlck(PBLCK pblck, long *pcb);
+
     // FDecompress allows pvDst to be nil (in which case *pcbDst is filled
     // in with the buffer size required).
     // FCompress also allows pvDst to be nil, but the value returned in
@@ -79,19 +130,43 @@ class CODM : public CODM_PAR
     {
         return _FCodePhq(cfmtNil, phq);
     }
-    bool FCompressPhq(HQ *phq, long cfmt = cfmtNil)
+    bool FCompressPhq(HQ *phq, long cfmt = cfmtNil, ulong luDict = 0)
     {
-        return _FCodePhq(cfmtNil == cfmt ? _cfmtDef : cfmt, phq);
+        return _FCodePhq(cfmtNil == cfmt ? _cfmtDef : cfmt, phq, luDict);
     }
 
     bool FDecompress(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
     {
         return _FCode(cfmtNil, pvSrc, cbSrc, pvDst, cbDst, pcbDst);
     }
-    bool FCompress(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, long cfmt = cfmtNil)
+    bool FCompress(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, long cfmt = cfmtNil,
+                   ulong luDict = 0)
     {
-        return _FCode(cfmtNil == cfmt ? _cfmtDef : cfmt, pvSrc, cbSrc, pvDst, cbDst, pcbDst);
+        return _FCode(cfmtNil == cfmt ? _cfmtDef : cfmt, pvSrc, cbSrc, pvDst, cbDst, pcbDst, luDict);
     }
+
+    // Dictionaries for kcfmtKauai2Dict. A dictionary is identified by a
+    // hash of its contents, which is saved with the compressed data.
+    // Adding the same dictionary again just adds a reference to it.
+    // luDict is the dictionary to use when compressing to kcfmtKauai2Dict.
+    bool FAddDict(void *pv, long cb, ulong *pluDict);
+    void ReleaseDict(ulong luDict);
+    bool FHasDict(ulong luDict);
+
+    // Decompresses a batch of hq's, spreading the work across the available
+    // processors. Nil entries are skipped. Either all the hq's are replaced
+    // with their decompressed versions or none are.
+    bool FDecompressRghq(HQ *prghq, long chq);
+
+    // Decompresses cb bytes at offset ib of the unpacked data of a packed
+    // block. For kcfmtBlocked data only the blocks covering the range are
+    // read and decompressed.
+    bool FDecompressRgbFromBlck(PBLCK pblck, void *pv, long cb, long ib);
+
+    // Compresses a batch of hq's in parallel. The hq's that compress are
+    // replaced with their compressed versions and get their prgfPacked
+    // entry set. Nil and incompressible entries are left alone.
+    bool FCompressRghq(HQ *prghq, bool *prgfPacked, long chq, long cfmt = cfmtNil, ulong luDict = 0);
 };
 
 /***************************************************************************
@@ -101,19 +176,53 @@ typedef class KCDC *PKCDC;
 #define KCDC_PAR CODC
 #define kclsKCDC 'KCDC'
 class KCDC : public KCDC_PAR
+{
+    RTCLASS_DEC
+
+  protected:
+    long _cml;
+
+    bool _FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
+    bool _FDecode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
+    bool _FEncode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, long cbDict = 0);
+    bool _FDecode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, void *pvDict = pvNil,
+                   long cbDict = 0);
+
+  public:
+    KCDC(void)
+    {
+        _cml = kcmlNormal;
+    }
+
+    virtual bool FCanDo(bool fEncode, long cfmt)
+    {
+        return kcfmtKauai2 == cfmt || kcfmtKauai == cfmt || kcfmtKauai2Dict == cfmt;
+    }
+    virtual bool FConvert(bool fEncode, long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
+    virtual bool FConvertDict(bool fEncode, long cfmt, void *pvDict, long cbDict, void *pvSrc, long cbSrc, void *pvDst,
+                              long cbDst, long *pcbDst);
+    virtual void SetCml(long cml);
+};
+
+/***************************************************************************
+    The fast Kauai codec. Compresses much less than KCDC, but several times
+    faster. Meant for temporary data rather than shipped content.
+***************************************************************************/
+typedef class KCDF *PKCDF;
+#define KCDF_PAR CODC
+#define kclsKCDF 'KCDF'
+class KCDF : public KCDF_PAR
 {
     RTCLASS_DEC
 
   protected:
     bool _FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
     bool _FDecode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
-    bool _FEncode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
-    bool _FDecode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
 
   public:
     virtual bool FCanDo(bool fEncode, long cfmt)
     {
-        return kcfmtKauai2 == cfmt || kcfmtKauai == cfmt;
+        return kcfmtKauaiFast == cfmt;
     }
     virtual bool FConvert(bool fEncode, long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst);
 };
@@ -107,12 +107,14 @@
 ***************************************************************************/
 #include "util.h"
 #include "codkpri.h"
+#include <string.h>
 ASSERTNAME
 
 // REVIEW shonk: should we turn on _Safety?
 #define SAFETY
 
 RTCLASS(KCDC)
+RTCLASS(KCDF)
 
 /***************************************************************************
     Encode or decode a block.
@@ -143,6 +145,55 @@ bool KCDC::FConvert(bool fEncode, long cfmt, void *pvSrc, long cbSrc, void *pvDs
     }
 }
 
+/***************************************************************************
+    Encode or decode a block primed with a dictionary. Matches can reach
+    back into the dictionary. The encoder needs the dictionary in front of
+    the data, so it copies them both to one buffer. The decoder reads the
+    dictionary where it is and decodes straight into pvDst.
+***************************************************************************/
+bool KCDC::FConvertDict(bool fEncode, long cfmt, void *pvDict, long cbDict, void *pvSrc, long cbSrc, void *pvDst,
+                        long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbDict, 1, kcbDictMax + 1);
+    AssertPvCb(pvDict, cbDict);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    byte *prgb;
+    bool fRet;
+
+    TrashVar(pcbDst);
+    if (kcfmtKauai2Dict != cfmt)
+        return fFalse;
+
+    if (!fEncode)
+        return _FDecode2(pvSrc, cbSrc, pvDst, cbDst, pcbDst, pvDict, cbDict);
+
+    if (!FAllocPv((void **)&prgb, cbDict + cbSrc, fmemNil, mprNormal))
+        return fFalse;
+    CopyPb(pvDict, prgb, cbDict);
+    CopyPb(pvSrc, prgb + cbDict, cbSrc);
+    fRet = _FEncode2(prgb, cbDict + cbSrc, pvDst, cbDst, pcbDst, cbDict);
+    FreePpv((void **)&prgb);
+
+    return fRet;
+}
+
+/***************************************************************************
+    Set the compression level used by the encoders.
+***************************************************************************/
+void KCDC::SetCml(long cml)
+{
+    AssertThis(0);
+    AssertIn(cml, 0, kcmlLim);
+
+    _cml = cml;
+}
+
 /***************************************************************************
     Bit array class - for writing the compressed data.
 ***************************************************************************/
@@ -245,37 +296,216 @@ bool BITA::FWriteLogEncoded(ulong lu)
     return FWriteBits(lu << 1, cbit + 1);
 }
 
+// 64 bit window onto the compressed bit stream and unit of match copies
+typedef unsigned long long LUW;
+
 /***************************************************************************
-    Compress the data in pvSrc using the KCDC encoding.  Returns false if
-    the data can't be compressed. This is not optimized (ie, it's slow).
+    Load the 64 bits of the compressed stream starting at pb, least
+    significant byte first. Bytes at or past pbLim read as 0xFF, which is
+    what the stream's tail contains anyway.
 ***************************************************************************/
-bool KCDC::_FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+inline LUW _LuwLoad(byte *pb, byte *pbLim)
 {
-    AssertThis(0);
+    LUW luw;
+    long ib;
+
+#ifdef LITTLE_ENDIAN
+    if (pb + size(LUW) <= pbLim)
+    {
+        memcpy(&luw, pb, size(LUW));
+        return luw;
+    }
+#endif // LITTLE_ENDIAN
+
+    for (luw = 0, ib = size(LUW); ib-- > 0;)
+        luw = (luw << 8) | (pb + ib < pbLim ? pb[ib] : 0xFF);
+    return luw;
+}
+
+/***************************************************************************
+    Top up the bit buffer luw so it holds at least 56 unread bits. pbSrc
+    is where the next byte to go into the buffer comes from.
+***************************************************************************/
+inline void _Refill(LUW &luw, long &cbitAvail, byte *&pbSrc, byte *pbLimSrc)
+{
+    luw |= _LuwLoad(pbSrc, pbLimSrc) << cbitAvail;
+    pbSrc += (63 - cbitAvail) >> 3;
+    cbitAvail |= 56;
+}
+
+// bit index of (lu * 0x077CB531) >> 27 for each power of two lu
+static const byte _mpiluibit[32] = {0,  1,  28, 2,  29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4,  8,
+                                    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6,  11, 5,  10, 9};
+
+/***************************************************************************
+    Return the number of consecutive 1 bits at the bottom of luw. Stops
+    counting at 13, which is more than any valid length prefix.
+***************************************************************************/
+inline long _CbitLowOnes(LUW luw)
+{
+    // most length prefixes are short, so try the low nibble first - this
+    // constant holds the answer for each nibble in 3 bit fields
+    long cbit = (long)((0x808408608408ULL >> (3 * (luw & 0x0F))) & 0x07);
+
+    if (cbit < 4)
+        return cbit;
+
+    ulong lu = (ulong)luw & 0x1FFF;
+
+    // isolate the lowest 0 bit and look up its index
+    lu = ~lu & (lu + 1);
+    return _mpiluibit[((lu * 0x077CB531) & 0xFFFFFFFF) >> 27];
+}
+
+// how to decode an offset, indexed by the three bits after the leading 1
+// of the offset code
+struct OFC
+{
+    long cbitCode; // bits in the class code, including the leading 1
+    long cbit;     // bits in the offset
+    long dibMin;   // added to the offset
+    long cbMin;    // added to the length
+};
+
+static const OFC _rgofcKcdc[8] = {
+    {2, kcbitKcdc0, kdibMinKcdc0, 0}, {3, kcbitKcdc1, kdibMinKcdc1, 0}, {2, kcbitKcdc0, kdibMinKcdc0, 0},
+    {4, kcbitKcdc2, kdibMinKcdc2, 0}, {2, kcbitKcdc0, kdibMinKcdc0, 0}, {3, kcbitKcdc1, kdibMinKcdc1, 0},
+    {2, kcbitKcdc0, kdibMinKcdc0, 0}, {4, kcbitKcdc3, kdibMinKcdc3, 1},
+};
+static const OFC _rgofcKcd2[8] = {
+    {2, kcbitKcd2_0, kdibMinKcd2_0, 0}, {3, kcbitKcd2_1, kdibMinKcd2_1, 0}, {2, kcbitKcd2_0, kdibMinKcd2_0, 0},
+    {4, kcbitKcd2_2, kdibMinKcd2_2, 0}, {2, kcbitKcd2_0, kdibMinKcd2_0, 0}, {3, kcbitKcd2_1, kdibMinKcd2_1, 0},
+    {2, kcbitKcd2_0, kdibMinKcd2_0, 0}, {4, kcbitKcd2_3, kdibMinKcd2_3, 1},
+};
+
+/***************************************************************************
+    Copy a match of cb bytes from dib bytes back in the destination. The
+    source and destination overlap when dib < cb, in which case the bytes
+    written must repeat with period dib, so we can't just use CopyPb or
+    BltPb.
+***************************************************************************/
+inline void _CopyMatch(byte *pbDst, long dib, long cb, byte *pbLimDst)
+{
+    byte *pbSrc = pbDst - dib;
+
+    if (dib >= size(LUW) && pbLimDst - pbDst >= cb + size(LUW))
+    {
+        // there's room to run past the end of the match, so copy whole
+        // words - any overshoot lands in the destination beyond the match
+        // and is either overwritten by later codes or ignored
+        do
+        {
+            memcpy(pbDst, pbSrc, size(LUW));
+            pbDst += size(LUW);
+            pbSrc += size(LUW);
+        } while ((cb -= size(LUW)) > 0);
+        return;
+    }
+
+    if (dib < size(LUW))
+    {
+        long dibWord, cbT;
+
+        if (cb <= 2 * size(LUW))
+        {
+            // short overlapping runs aren't worth anything fancy
+            while (cb-- > 0)
+                *pbDst++ = *pbSrc++;
+            return;
+        }
+        if (dib == 1)
+        {
+            memset(pbDst, pbSrc[0], cb);
+            return;
+        }
+
+        // Copy bytes until the repeating pattern is at least a word long.
+        // From then on any multiple of dib is as good a distance as dib.
+        for (dibWord = dib; dibWord < size(LUW); dibWord += dib)
+            ;
+        for (cbT = dibWord - dib, cb -= cbT; cbT-- > 0;)
+            *pbDst++ = *pbSrc++;
+        pbSrc = pbDst - dibWord;
+    }
+
+    // the distance is now at least a word, so each word we read has
+    // already been written
+    for (; cb >= 2 * size(LUW); cb -= 2 * size(LUW))
+    {
+        if (dib >= 2 * size(LUW))
+            memcpy(pbDst, pbSrc, 2 * size(LUW));
+        else
+        {
+            memcpy(pbDst, pbSrc, size(LUW));
+            memcpy(pbDst + size(LUW), pbSrc + size(LUW), size(LUW));
+        }
+        pbDst += 2 * size(LUW);
+        pbSrc += 2 * size(LUW);
+    }
+    if (cb >= size(LUW))
+    {
+        memcpy(pbDst, pbSrc, size(LUW));
+        pbDst += size(LUW);
+        pbSrc += size(LUW);
+        cb -= size(LUW);
+    }
+    while (cb-- > 0)
+        *pbDst++ = *pbSrc++;
+}
+
+// number of links the fast level follows when looking for a match
+const long kcprobeFastKcdc = 16;
+
+// cost of a literal, used to weigh lazy matches
+const long kcbitLiteralKcdc = 9;
+
+/***************************************************************************
+    Match finder shared by the encoders. Each position is linked to the
+    previous position starting with the same byte pair.
+***************************************************************************/
+struct MFND
+{
+    byte *prgbSrc;
+    long cbSrc;
+    long *pmpibibNext; // previous position with the same byte pair
+    long cprobeMax;    // number of links to follow looking for a match
+    bool fLazy;        // whether to look one byte ahead for a better match
+
+    // the last look ahead, so it doesn't get searched for twice
+    long ibSrcNext;
+    long cbMatchNext;
+    long ibMatchNext;
+};
+
+/***************************************************************************
+    Build the links for the match finder. The search effort depends on
+    the compression level.
+***************************************************************************/
+priv bool _FInitMfnd(MFND *pmfnd, void *pvSrc, long cbSrc, long cml)
+{
+    AssertVarMem(pmfnd);
     AssertIn(cbSrc, 1, kcbMax);
     AssertPvCb(pvSrc, cbSrc);
-    AssertIn(cbDst, 1, kcbMax);
-    AssertPvCb(pvDst, cbDst);
-    AssertVarMem(pcbDst);
+    AssertIn(cml, 0, kcmlLim);
 
-    long ibSrc;
-    long ibMatch, ibTest, cbMatch, ibMin, cbT;
-    byte bMatchNew, bMatchLast;
-    BITA bita;
+    long ibSrc, ibTest;
     long *pmpsuibStart = pvNil;
     byte *prgbSrc = (byte *)pvSrc;
-    long *pmpibibNext = pvNil;
 
-    TrashVar(pcbDst);
-    if (cbDst - kcbTailKcdc <= 1)
-        return fFalse;
+    ClearPb(pmfnd, size(MFND));
+    pmfnd->prgbSrc = prgbSrc;
+    pmfnd->cbSrc = cbSrc;
+    pmfnd->cprobeMax = kcmlFast == cml ? kcprobeFastKcdc : klwMax;
+    pmfnd->fLazy = kcmlMax == cml;
+    pmfnd->ibSrcNext = -1;
 
     // allocate the links
-    if (!FAllocPv((void **)&pmpibibNext, LwMul(size(long), cbSrc), fmemNil, mprNormal) ||
+    if (!FAllocPv((void **)&pmfnd->pmpibibNext, LwMul(size(long), cbSrc), fmemNil, mprNormal) ||
         !FAllocPv((void **)&pmpsuibStart, LwMul(size(long), 0x10000), fmemNil, mprNormal))
     {
         Warn("failed to allocate memory for links");
-        goto LFail;
+        FreePpv((void **)&pmfnd->pmpibibNext);
+        return fFalse;
     }
 
     // write the links
@@ -287,65 +517,189 @@ bool KCDC::_FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbD
         ushort suCur = ((ushort)prgbSrc[ibSrc]) << 8 | (ushort)prgbSrc[ibSrc + 1];
         ibTest = pmpsuibStart[suCur];
         pmpsuibStart[suCur] = ibSrc;
-        pmpibibNext[ibSrc] = ibTest;
+        pmfnd->pmpibibNext[ibSrc] = ibTest;
     }
-    pmpibibNext[cbSrc - 1] = 0xCCCCCCCCL;
+    pmfnd->pmpibibNext[cbSrc - 1] = 0xCCCCCCCCL;
     FreePpv((void **)&pmpsuibStart);
 
-    // write flags byte
-    bita.Set(pvDst, cbDst);
-    AssertDo(bita.FWriteBits(0, 8), 0);
+    return fTrue;
+}
 
-    for (ibSrc = 0; ibSrc < cbSrc; ibSrc += cbMatch)
-    {
-        byte *pbMatch;
-        long cbMaxMatch;
+/***************************************************************************
+    Free the match finder's links.
+***************************************************************************/
+priv void _FreeMfnd(MFND *pmfnd)
+{
+    AssertVarMem(pmfnd);
+    FreePpv((void **)&pmfnd->pmpibibNext);
+}
 
-        // get the new byte and the link
-        ibTest = pmpibibNext[ibSrc];
-        Assert(ibTest < ibSrc, 0);
+/***************************************************************************
+    Look for the longest earlier match for the bytes at ibSrc. Returns the
+    length of the match (1 if there isn't one) and fills in *pibMatch.
+***************************************************************************/
+priv long _CbFindMatch(MFND *pmfnd, long ibSrc, long *pibMatch)
+{
+    AssertVarMem(pmfnd);
+    AssertIn(ibSrc, 0, pmfnd->cbSrc);
+    AssertVarMem(pibMatch);
 
-        // assume we'll store a literal
-        cbMatch = 1;
-        ibMatch = ibSrc;
+    long ibMatch, ibTest, cbMatch, ibMin, cbT, cbMaxMatch, cprobe;
+    byte bMatchNew, bMatchLast;
+    byte *pbMatch;
+    byte *prgbSrc = pmfnd->prgbSrc;
+    long *pmpibibNext = pmfnd->pmpibibNext;
+
+    // get the link
+    ibTest = pmpibibNext[ibSrc];
+    Assert(ibTest < ibSrc, 0);
+
+    // assume we'll store a literal
+    cbMatch = 1;
+    ibMatch = ibSrc;
+
+    if (ibTest <= (ibMin = ibSrc - kdibMinKcdc4))
+        goto LDone;
+
+    // we've seen this byte pair before - look for the longest match
+    cbMaxMatch = LwMin(kcbMaxLenKcdc, pmfnd->cbSrc - ibSrc);
+    pbMatch = prgbSrc + ibSrc;
+    bMatchNew = prgbSrc[ibSrc + 1];
+    bMatchLast = prgbSrc[ibSrc];
+    for (cprobe = pmfnd->cprobeMax; ibTest > ibMin && cprobe-- > 0; ibTest = pmpibibNext[ibTest])
+    {
+        Assert(prgbSrc[ibTest + 1] == prgbSrc[ibSrc + 1], "links are wrong");
+        if (prgbSrc[ibTest + cbMatch] != bMatchNew || prgbSrc[ibTest + cbMatch - 1] != bMatchLast ||
+            cbMatch >= (cbT = CbEqualRgb(prgbSrc + ibTest, pbMatch, cbMaxMatch)))
+        {
+            Assert(pmpibibNext[ibTest] < ibTest, 0);
+            continue;
+        }
 
-        if (ibTest <= (ibMin = ibSrc - kdibMinKcdc4))
-            goto LStore;
+        AssertIn(cbT, cbMatch + 1, kcbMaxLenKcdc + 1);
 
-        // we've seen this byte pair before - look for the longest match
-        cbMaxMatch = LwMin(kcbMaxLenKcdc, cbSrc - ibSrc);
-        pbMatch = prgbSrc + ibSrc;
-        bMatchNew = prgbSrc[ibSrc + 1];
-        bMatchLast = prgbSrc[ibSrc];
-        for (; ibTest > ibMin; ibTest = pmpibibNext[ibTest])
+        // if this run requires a 20 bit offset, we need to beat a
+        // 9 or 6 bit offset by 2 bytes
+        if (ibSrc - ibTest < kdibMinKcdc3 || cbT - cbMatch > 1 || ibSrc - ibMatch >= kdibMinKcdc2)
         {
-            Assert(prgbSrc[ibTest + 1] == prgbSrc[ibSrc + 1], "links are wrong");
-            if (prgbSrc[ibTest + cbMatch] != bMatchNew || prgbSrc[ibTest + cbMatch - 1] != bMatchLast ||
-                cbMatch >= (cbT = CbEqualRgb(prgbSrc + ibTest, pbMatch, cbMaxMatch)))
-            {
-                Assert(pmpibibNext[ibTest] < ibTest, 0);
-                continue;
-            }
+            cbMatch = cbT;
+            ibMatch = ibTest;
+            if (cbMatch == cbMaxMatch)
+                break;
+            bMatchNew = prgbSrc[ibSrc + cbMatch];
+            bMatchLast = prgbSrc[ibSrc + cbMatch - 1];
+        }
 
-            AssertIn(cbT, cbMatch + 1, kcbMaxLenKcdc + 1);
+        Assert(pmpibibNext[ibTest] < ibTest, 0);
+    }
 
-            // if this run requires a 20 bit offset, we need to beat a
-            // 9 or 6 bit offset by 2 bytes
-            if (ibSrc - ibTest < kdibMinKcdc3 || cbT - cbMatch > 1 || ibSrc - ibMatch >= kdibMinKcdc2)
-            {
-                cbMatch = cbT;
-                ibMatch = ibTest;
-                if (cbMatch == cbMaxMatch)
-                    break;
-                bMatchNew = prgbSrc[ibSrc + cbMatch];
-                bMatchLast = prgbSrc[ibSrc + cbMatch - 1];
-            }
+LDone:
+    *pibMatch = ibMatch;
+    return cbMatch;
+}
 
-            Assert(pmpibibNext[ibTest] < ibTest, 0);
-        }
+/***************************************************************************
+    Return the number of bits it takes to encode a match of cb bytes at
+    offset dib.
+***************************************************************************/
+priv long _CbitMatch(long dib, long cb)
+{
+    long cbit, lu;
+
+    if (dib < kdibMinKcdc1)
+        cbit = 2 + kcbitKcdc0;
+    else if (dib < kdibMinKcdc2)
+        cbit = 3 + kcbitKcdc1;
+    else if (dib < kdibMinKcdc3)
+        cbit = 4 + kcbitKcdc2;
+    else
+    {
+        cbit = 4 + kcbitKcdc3;
+        cb--;
+    }
+
+    // the length is log encoded - 2n + 1 bits for values in [2^n, 2^(n+1))
+    for (lu = cb - 1; lu > 1; lu >>= 1)
+        cbit += 2;
+    return cbit + 1;
+}
+
+/***************************************************************************
+    Find the match to store at ibSrc. Returns the length of the match (1
+    for a literal) and fills in *pibMatch. At the max level, a match is
+    passed over if starting one byte later gives a better one.
+***************************************************************************/
+priv long _CbNextMatch(MFND *pmfnd, long ibSrc, long *pibMatch)
+{
+    AssertVarMem(pmfnd);
+    AssertIn(ibSrc, 0, pmfnd->cbSrc);
+    AssertVarMem(pibMatch);
+
+    long cbMatch, cbNext, ibNext;
+
+    if (ibSrc == pmfnd->ibSrcNext)
+    {
+        cbMatch = pmfnd->cbMatchNext;
+        *pibMatch = pmfnd->ibMatchNext;
+    }
+    else
+        cbMatch = _CbFindMatch(pmfnd, ibSrc, pibMatch);
+
+    if (!pmfnd->fLazy || cbMatch == 1 || cbMatch == kcbMaxLenKcdc || ibSrc + cbMatch >= pmfnd->cbSrc)
+        return cbMatch;
+
+    cbNext = _CbFindMatch(pmfnd, ibSrc + 1, &ibNext);
+    pmfnd->ibSrcNext = ibSrc + 1;
+    pmfnd->cbMatchNext = cbNext;
+    pmfnd->ibMatchNext = ibNext;
+
+    // a literal followed by the next match has to cover more bytes for
+    // fewer bits per byte
+    if (cbNext > cbMatch && LwMul(kcbitLiteralKcdc + _CbitMatch(ibSrc + 1 - ibNext, cbNext), cbMatch) <
+                                LwMul(_CbitMatch(ibSrc - *pibMatch, cbMatch), cbNext + 1))
+    {
+        *pibMatch = ibSrc;
+        return 1;
+    }
+
+    return cbMatch;
+}
+
+/***************************************************************************
+    Compress the data in pvSrc using the KCDC encoding.  Returns false if
+    the data can't be compressed. This is not optimized (ie, it's slow).
+***************************************************************************/
+bool KCDC::_FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    long ibSrc;
+    long ibMatch, cbMatch, cbT;
+    BITA bita;
+    MFND mfnd;
+    byte *prgbSrc = (byte *)pvSrc;
+
+    TrashVar(pcbDst);
+    if (cbDst - kcbTailKcdc <= 1)
+        return fFalse;
+
+    if (!_FInitMfnd(&mfnd, pvSrc, cbSrc, _cml))
+        return fFalse;
+
+    // write flags byte
+    bita.Set(pvDst, cbDst);
+    AssertDo(bita.FWriteBits(0, 8), 0);
+
+    for (ibSrc = 0; ibSrc < cbSrc; ibSrc += cbMatch)
+    {
+        cbMatch = _CbNextMatch(&mfnd, ibSrc, &ibMatch);
 
         // write out the bits
-    LStore:
         AssertIn(ibMatch, 0, ibSrc + (cbMatch == 1));
         AssertIn(cbMatch, 1 + (ibMatch < ibSrc) + (ibSrc - ibMatch >= kdibMinKcdc3), kcbMaxLenKcdc + 1);
 
@@ -415,12 +769,12 @@ bool KCDC::_FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbD
 
     *pcbDst = bita.Ib();
 
-    FreePpv((void **)&pmpibibNext);
+    _FreeMfnd(&mfnd);
     return fTrue;
 
 LFail:
     // can't compress the source
-    FreePpv((void **)&pmpibibNext);
+    _FreeMfnd(&mfnd);
     return fFalse;
 }
 
@@ -473,101 +827,66 @@ bool KCDC::_FDecode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbD
 
 #else //! IN_80386
 
-#include "kcdc_c.h"
-
-    *pcbDst = cbTot;
-    return fTrue;
-
-#if 0 // BROKEN; KEPT FOR REFERENCE
-    long cb, dib, ibit, cbit;
-    register ulong luCur;
-    byte *pbT;
-    register byte *pbDst = (byte *)pvDst;
+    long cb, dib, cbit, cbitLen;
+    const OFC *pofc;
+    LUW luw = 0;
+    long cbitAvail = 0;
+    byte *pbDst = (byte *)pvDst;
     byte *pbLimDst = (byte *)pvDst + cbDst;
-    register byte *pbSrc = (byte *)pvSrc + 1;
-
-#define _FTest(ibit) (luCur & (1L << (ibit)))
-#ifdef LITTLE_ENDIAN
-#define _Advance(cb) ((pbSrc += (cb)), (luCur = *(ulong *)(pbSrc - 4)))
-#else //! LITTLE_ENDIAN
-#define _Advance(cb) ((pbSrc += (cb)), (luCur = LwFromBytes(pbSrc[-1], pbSrc[-2], pbSrc[-3], pbSrc[-4])))
-#endif //! LITTLE_ENDIAN
+    byte *pbSrc = (byte *)pvSrc + 1;
+    byte *pbLimSrc = (byte *)pvSrc + cbSrc;
 
-    _Advance(4);
-
-    for (ibit = 0;;)
+    // A literal is 9 bits and a match at most 4 + kcbitKcdc3 +
+    // 2 * kcbitMaxLenKcdc + 1 = 47 bits, so after _Refill luw always holds
+    // a whole code.
+    for (;;)
     {
-        if (!_FTest(ibit))
+        _Refill(luw, cbitAvail, pbSrc, pbLimSrc);
+        if (!(luw & 1))
         {
-            // literal
+            // literals - there are several in each refill
+            do
+            {
 #ifdef SAFETY
-            if (pbDst >= pbLimDst)
-                goto LFail;
+                if (pbDst >= pbLimDst)
+                    goto LFail;
 #endif // SAFETY
-            *pbDst++ = (byte)(luCur >> ibit + 1);
-            ibit += 9;
+                *pbDst++ = (byte)(luw >> 1);
+                luw >>= 9;
+                cbitAvail -= 9;
+            } while (cbitAvail >= 9 && !(luw & 1));
+            continue;
         }
-        else
-        {
-            // get the offset
-            cb = 1;
-            if (!_FTest(ibit + 1))
-            {
-                dib = ((luCur >> (ibit + 2)) & ((1 << kcbitKcdc0) - 1)) + kdibMinKcdc0;
-                ibit += 2 + kcbitKcdc0;
-            }
-            else if (!_FTest(ibit + 2))
-            {
-                dib = ((luCur >> (ibit + 3)) & ((1 << kcbitKcdc1) - 1)) + kdibMinKcdc1;
-                ibit += 3 + kcbitKcdc1;
-            }
-            else if (!_FTest(ibit + 3))
-            {
-                dib = ((luCur >> (ibit + 4)) & ((1 << kcbitKcdc2) - 1)) + kdibMinKcdc2;
-                ibit += 4 + kcbitKcdc2;
-            }
-            else
-            {
-                dib = (luCur >> (ibit + 4)) & ((1 << kcbitKcdc3) - 1);
-                if (dib == ((1 << kcbitKcdc3) - 1))
-                    break;
-                dib += kdibMinKcdc3;
-                ibit += 4 + kcbitKcdc3;
-                cb++;
-            }
-            _Advance(ibit >> 3);
-            ibit &= 0x07;
 
-            // get the length
-            for (cbit = 0;;)
-            {
-                if (!_FTest(ibit + cbit))
-                    break;
-                if (++cbit > kcbitMaxLenKcdc)
-                    goto LFail;
-            }
+        // get the offset
+        pofc = &_rgofcKcdc[(luw >> 1) & 0x07];
+        dib = (long)((luw >> pofc->cbitCode) & ((1 << pofc->cbit) - 1));
+        if (dib == ((1 << kcbitKcdc3) - 1))
+            break;
+        dib += pofc->dibMin;
+        cb = 1 + pofc->cbMin;
+        cbit = pofc->cbitCode + pofc->cbit;
 
-            cb += (1 << cbit) + ((luCur >> (cbit + 1)) & ((1 << cbit) - 1));
-            ibit += cbit + cbit + 1;
+        // get the length
+        luw >>= cbit;
+        if ((cbitLen = _CbitLowOnes(luw)) > kcbitMaxLenKcdc)
+            goto LFail;
+        luw >>= cbitLen + 1;
+        cb += (1 << cbitLen) + (long)(luw & ((1 << cbitLen) - 1));
+        luw >>= cbitLen;
+        cbitAvail -= cbit + cbitLen + cbitLen + 1;
 
 #ifdef SAFETY
-            if (pbLimDst - pbDst < cb || pbDst - (byte *)pvDst < dib)
-                goto LFail;
+        if (pbLimDst - pbDst < cb || pbDst - (byte *)pvDst < dib)
+            goto LFail;
 #endif // SAFETY
-            for (pbT = pbDst - dib; cb-- > 0;)
-                *pbDst++ = *pbT++;
-        }
-        _Advance(ibit >> 3);
-        ibit &= 0x07;
+        _CopyMatch(pbDst, dib, cb, pbLimDst);
+        pbDst += cb;
     }
 
     *pcbDst = pbDst - (byte *)pvDst;
     return fTrue;
 
-#undef _FTest
-#undef _Advance
-#endif // 0
-
 #endif //! IN_80386
 
 LFail:
@@ -578,112 +897,46 @@ LFail:
 /***************************************************************************
     Compress the data in pvSrc using the KCD2 encoding.  Returns false if
     the data can't be compressed. This is not optimized (ie, it's slow).
+    If cbDict is non-zero, the first cbDict bytes of pvSrc are a dictionary
+    that matches can refer to, but that isn't itself encoded.
 ***************************************************************************/
-bool KCDC::_FEncode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+bool KCDC::_FEncode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, long cbDict)
 {
     AssertThis(0);
     AssertIn(cbSrc, 1, kcbMax);
     AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDict, 0, cbSrc);
     AssertIn(cbDst, 1, kcbMax);
     AssertPvCb(pvDst, cbDst);
     AssertVarMem(pcbDst);
 
     long ibSrc;
-    long ibMatch, ibTest, cbMatch, ibMin, cbT;
-    byte bMatchNew, bMatchLast;
+    long ibMatch, cbMatch, cbT;
     BITA bita;
     long cbRun;
-    long *pmpsuibStart = pvNil;
+    MFND mfnd;
     byte *prgbSrc = (byte *)pvSrc;
-    long *pmpibibNext = pvNil;
 
     TrashVar(pcbDst);
     if (cbDst - kcbTailKcdc <= 1)
         return fFalse;
 
-    // allocate the links
-    if (!FAllocPv((void **)&pmpibibNext, LwMul(size(long), cbSrc), fmemNil, mprNormal) ||
-        !FAllocPv((void **)&pmpsuibStart, LwMul(size(long), 0x10000), fmemNil, mprNormal))
-    {
-        Warn("failed to allocate memory for links");
-        goto LFail;
-    }
-
-    // write the links
-    // we need to set each entry of pmpsuibStart to a big negative number,
-    // but not too big, or we risk overflow below.
-    FillPb(pmpsuibStart, LwMul(size(long), 0x10000), 0xCC);
-    for (ibSrc = 0; ibSrc < cbSrc - 1; ibSrc++)
-    {
-        ushort suCur = ((ushort)prgbSrc[ibSrc]) << 8 | (ushort)prgbSrc[ibSrc + 1];
-        ibTest = pmpsuibStart[suCur];
-        pmpsuibStart[suCur] = ibSrc;
-        pmpibibNext[ibSrc] = ibTest;
-    }
-    pmpibibNext[cbSrc - 1] = 0xCCCCCCCCL;
-    FreePpv((void **)&pmpsuibStart);
+    if (!_FInitMfnd(&mfnd, pvSrc, cbSrc, _cml))
+        return fFalse;
 
     // write flags byte
     bita.Set(pvDst, cbDst);
     AssertDo(bita.FWriteBits(0, 8), 0);
 
     cbRun = 0;
-    for (ibSrc = 0;; ibSrc += cbMatch)
+    for (ibSrc = cbDict;; ibSrc += cbMatch)
     {
-        byte *pbMatch;
-        long cbMaxMatch;
-
         if (ibSrc >= cbSrc)
-        {
             cbMatch = 0;
-            goto LStore;
-        }
-
-        // get the new byte and the link
-        ibTest = pmpibibNext[ibSrc];
-        Assert(ibTest < ibSrc, 0);
-
-        // assume we'll store a literal
-        cbMatch = 1;
-        ibMatch = ibSrc;
-
-        if (ibTest <= (ibMin = ibSrc - kdibMinKcdc4))
-            goto LStore;
-
-        // we've seen this byte pair before - look for the longest match
-        cbMaxMatch = LwMin(kcbMaxLenKcdc, cbSrc - ibSrc);
-        pbMatch = prgbSrc + ibSrc;
-        bMatchNew = prgbSrc[ibSrc + 1];
-        bMatchLast = prgbSrc[ibSrc];
-        for (; ibTest > ibMin; ibTest = pmpibibNext[ibTest])
-        {
-            Assert(prgbSrc[ibTest + 1] == prgbSrc[ibSrc + 1], "links are wrong");
-            if (prgbSrc[ibTest + cbMatch] != bMatchNew || prgbSrc[ibTest + cbMatch - 1] != bMatchLast ||
-                cbMatch >= (cbT = CbEqualRgb(prgbSrc + ibTest, pbMatch, cbMaxMatch)))
-            {
-                Assert(pmpibibNext[ibTest] < ibTest, 0);
-                continue;
-            }
-
-            AssertIn(cbT, cbMatch + 1, kcbMaxLenKcdc + 1);
-
-            // if this run requires a 20 bit offset, we need to beat a
-            // 9 or 6 bit offset by 2 bytes
-            if (ibSrc - ibTest < kdibMinKcdc3 || cbT - cbMatch > 1 || ibSrc - ibMatch >= kdibMinKcdc2)
-            {
-                cbMatch = cbT;
-                ibMatch = ibTest;
-                if (cbMatch == cbMaxMatch)
-                    break;
-                bMatchNew = prgbSrc[ibSrc + cbMatch];
-                bMatchLast = prgbSrc[ibSrc + cbMatch - 1];
-            }
-
-            Assert(pmpibibNext[ibTest] < ibTest, 0);
-        }
+        else
+            cbMatch = _CbNextMatch(&mfnd, ibSrc, &ibMatch);
 
         // write out the bits
-    LStore:
         if (cbMatch != 1 && cbRun > 0)
         {
             // write the previous literal run
@@ -784,25 +1037,29 @@ bool KCDC::_FEncode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcb
 
     *pcbDst = bita.Ib();
 
-    FreePpv((void **)&pmpibibNext);
+    _FreeMfnd(&mfnd);
     return fTrue;
 
 LFail:
     // can't compress the source
-    FreePpv((void **)&pmpibibNext);
+    _FreeMfnd(&mfnd);
     return fFalse;
 }
 
 /***************************************************************************
-    Decompress a compressed KCD2 stream.
+    Decompress a compressed KCD2 stream. If cbDict is non-zero, the stream
+    was compressed with the dictionary at pvDict, and matches that reach
+    back before pvDst are copied from the end of it.
 ***************************************************************************/
-bool KCDC::_FDecode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+bool KCDC::_FDecode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst, void *pvDict, long cbDict)
 {
     AssertThis(0);
     AssertIn(cbSrc, 1, kcbMax);
     AssertPvCb(pvSrc, cbSrc);
     AssertIn(cbDst, 1, kcbMax);
     AssertPvCb(pvDst, cbDst);
+    AssertIn(cbDict, 0, kcbDictMax + 1);
+    AssertPvCb(pvDict, cbDict);
     AssertVarMem(pcbDst);
 
     long ib;
@@ -834,124 +1091,428 @@ bool KCDC::_FDecode2(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcb
     }
 
 #ifdef IN_80386
-
+    // the assembly decoder doesn't know about dictionaries
+    if (0 == cbDict)
+    {
 #include "kcd2_386.h"
 
-    *pcbDst = cbTot;
-    return fTrue;
-
-#else //! IN_80386
-
-#include "kcd2_c.h"
-
-    *pcbDst = cbTot;
-    return fTrue;
-
-#if 0 // BROKEN; KEPT FOR REFERENCE
-    long cb, dib, ibit, cbit;
-    register ulong luCur;
-    byte bT;
-    byte *pbT;
-    register byte *pbDst = (byte *)pvDst;
+        *pcbDst = cbTot;
+        return fTrue;
+    }
+#endif // IN_80386
+
+    long cb, dib, cbit, cbitLen, ibit, cbT;
+    const OFC *pofc;
+    LUW luw = 0;
+    long cbitAvail = 0;
+    byte *pbLimDict = (byte *)pvDict + cbDict;
+    byte *pbDst = (byte *)pvDst;
     byte *pbLimDst = (byte *)pvDst + cbDst;
-    register byte *pbSrc = (byte *)pvSrc + 1;
-    byte *pbLimSrc = (byte *)pvSrc + cbSrc - kcbTailKcd2;
-
-#define _FTest(ibit) (luCur & (1L << (ibit)))
-#ifdef LITTLE_ENDIAN
-#define _Advance(cb) ((pbSrc += (cb)), (luCur = *(ulong *)(pbSrc - 4)))
-#else //! LITTLE_ENDIAN
-#define _Advance(cb) ((pbSrc += (cb)), (luCur = LwFromBytes(pbSrc[-1], pbSrc[-2], pbSrc[-3], pbSrc[-4])))
-#endif //! LITTLE_ENDIAN
+    byte *pbSrc = (byte *)pvSrc + 1;
+    byte *pbLimSrc = (byte *)pvSrc + cbSrc;
 
-    _Advance(4);
-
-    for (ibit = 0;;)
+    // A code is at most 2 * kcbitMaxLenKcd2 + 1 + 4 + kcbitKcd2_3 = 48 bits,
+    // so after _Refill luw always holds a whole code.
+    for (;;)
     {
+        _Refill(luw, cbitAvail, pbSrc, pbLimSrc);
+
         // get the length
-        for (cbit = 0;;)
+        if ((cbitLen = _CbitLowOnes(luw)) > kcbitMaxLenKcd2)
+            break;
+        luw >>= cbitLen + 1;
+        cb = (1 << cbitLen) + (long)(luw & ((1 << cbitLen) - 1));
+        luw >>= cbitLen;
+        cbit = cbitLen + cbitLen + 1;
+
+        if (!(luw & 1) && cb == 1)
         {
-            if (!_FTest(ibit + cbit))
-                break;
-            if (++cbit > kcbitMaxLenKcd2)
-                goto LDone;
+            // a single literal byte is just the next 8 bits
+#ifdef SAFETY
+            if (pbDst >= pbLimDst)
+                goto LFail;
+#endif // SAFETY
+            *pbDst++ = (byte)(luw >> 1);
+            luw >>= 9;
+            cbitAvail -= cbit + 9;
+            continue;
         }
 
-        cb = (1 << cbit) + ((luCur >> (cbit + 1)) & ((1 << cbit) - 1));
-        ibit += cbit + cbit + 1;
-        _Advance(ibit >> 3);
-        ibit &= 0x07;
-
-        if (!_FTest(ibit))
+        if (!(luw & 1))
         {
-            // literal
+            // literal run - the last byte of the run is split around the
+            // other bytes, which are byte aligned, so go back to reading
+            // bytes from where the bit buffer has got to
+            cbitAvail -= cbit + 1;
+            ibit = -cbitAvail & 0x07;
+            pbSrc -= (cbitAvail + 7) >> 3;
 #ifdef SAFETY
-            if (pbDst + cb > pbLimDst)
-                goto LFail;
-            if (pbSrc - 3 + cb > pbLimSrc)
+            if (pbLimDst - pbDst < cb || pbLimSrc - kcbTailKcd2 - pbSrc < cb)
                 goto LFail;
 #endif // SAFETY
-            ibit++;
-            bT = (byte) ~(luCur & ((1 << ibit) - 1));
-            if (cb > 1)
+            if (ibit == 0)
+                memcpy(pbDst, pbSrc, cb);
+            else
             {
-                CopyPb(pbSrc - 3, pbDst, cb - 1);
-                pbDst += cb - 1;
-                _Advance(cb);
+                memcpy(pbDst, pbSrc + 1, cb - 1);
+                pbDst[cb - 1] = (byte)((pbSrc[0] >> ibit) | (pbSrc[cb] << (8 - ibit)));
             }
-            else
-                _Advance(1);
-            bT |= luCur & ((1 << ibit) - 1);
-            *pbDst++ = bT;
+            pbDst += cb;
+            pbSrc += cb;
+
+            luw = 0;
+            cbitAvail = 0;
+            _Refill(luw, cbitAvail, pbSrc, pbLimSrc);
+            luw >>= ibit;
+            cbitAvail -= ibit;
+            continue;
         }
-        else
+
+        // get the offset
+        pofc = &_rgofcKcd2[(luw >> 1) & 0x07];
+        dib = (long)((luw >> pofc->cbitCode) & ((1 << pofc->cbit) - 1)) + pofc->dibMin;
+        cb += 1 + pofc->cbMin;
+        luw >>= pofc->cbitCode + pofc->cbit;
+        cbitAvail -= cbit + pofc->cbitCode + pofc->cbit;
+
+#ifdef SAFETY
+        if (pbLimDst - pbDst < cb || pbDst - (byte *)pvDst + cbDict < dib)
+            goto LFail;
+#endif // SAFETY
+        if ((cbT = dib - (long)(pbDst - (byte *)pvDst)) > 0)
         {
-            // get the offset
-            cb++;
-            if (!_FTest(ibit + 1))
+            // the match starts cbT bytes from the end of the dictionary
+            if (cbT >= cb)
             {
-                dib = ((luCur >> (ibit + 2)) & ((1 << kcbitKcd2_0) - 1)) + kdibMinKcd2_0;
-                ibit += 2 + kcbitKcd2_0;
+                memcpy(pbDst, pbLimDict - cbT, cb);
+                pbDst += cb;
+                continue;
             }
-            else if (!_FTest(ibit + 2))
+
+            // the rest of it starts at pvDst, which is still dib back
+            memcpy(pbDst, pbLimDict - cbT, cbT);
+            pbDst += cbT;
+            cb -= cbT;
+        }
+        _CopyMatch(pbDst, dib, cb, pbLimDst);
+        pbDst += cb;
+    }
+
+    *pcbDst = pbDst - (byte *)pvDst;
+    return fTrue;
+
+LFail:
+    Bug("bad compressed data");
+    return fFalse;
+}
+
+/***************************************************************************
+    Fast Kauai codec. This is a byte aligned LZ77 variant meant for data
+    that is compressed and decompressed by the same running copy of the
+    app, where speed matters more than size.
+
+    The stream is a sequence of tokens. Each token is a byte holding a
+    literal count in its high nibble and a match length (less
+    kcbMinMatchKcdf) in its low nibble. A nibble of 15 is followed by more
+    length bytes, which are added on until one of them is less than 255.
+    Then come the literal bytes and then the match offset as two bytes,
+    low byte first. The last token has no match - the stream ends right
+    after its literals.
+***************************************************************************/
+
+/***************************************************************************
+    Encode or decode a block.
+***************************************************************************/
+bool KCDF::FConvert(bool fEncode, long cfmt, void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    if (kcfmtKauaiFast != cfmt)
+        return fFalse;
+    if (fEncode)
+        return _FEncode(pvSrc, cbSrc, pvDst, cbDst, pcbDst);
+    return _FDecode(pvSrc, cbSrc, pvDst, cbDst, pcbDst);
+}
+
+/***************************************************************************
+    Read 4 bytes of the source as a ulong, in memory order. This is only
+    used to compare bytes, so the byte order doesn't matter.
+***************************************************************************/
+inline ulong _LuRead4(byte *pb)
+{
+    ulong lu;
+
+    memcpy(&lu, pb, size(ulong));
+    return lu;
+}
+
+/***************************************************************************
+    Hash kcbHashKcdf bytes of source into the KCDF encoder's table, which
+    has (1 << cbitHash) entries. There must be size(LUW) bytes at pb.
+    Hashing more bytes than the shortest match means fewer probes turn up
+    short matches that cost more to code than they save.
+***************************************************************************/
+inline long _IhashKcdf(byte *pb, long cbitHash)
+{
+    LUW luw;
+
+    memcpy(&luw, pb, size(LUW));
+    return (long)(((luw << (8 * (size(LUW) - kcbHashKcdf))) * 0xCF1BBCDCB7A56463ULL) >> (64 - cbitHash));
+}
+
+/***************************************************************************
+    Return how many of the bytes at pb1 and pb2 match, up to cbMax.
+***************************************************************************/
+inline long _CbCommon(byte *pb1, byte *pb2, long cbMax)
+{
+    LUW luw1, luw2;
+    long cb;
+
+    for (cb = 0; cb + size(LUW) <= cbMax; cb += size(LUW))
+    {
+        memcpy(&luw1, pb1 + cb, size(LUW));
+        memcpy(&luw2, pb2 + cb, size(LUW));
+        if (luw1 != luw2)
+        {
+#ifdef LITTLE_ENDIAN
+            // find the first differing byte without going back to memory
+            luw1 ^= luw2;
+            if (0 == (luw1 & 0xFFFFFFFF))
             {
-                dib = ((luCur >> (ibit + 3)) & ((1 << kcbitKcd2_1) - 1)) + kdibMinKcd2_1;
-                ibit += 3 + kcbitKcd2_1;
+                cb += 4;
+                luw1 >>= 32;
             }
-            else if (!_FTest(ibit + 3))
+            if (0 == (luw1 & 0xFFFF))
             {
-                dib = ((luCur >> (ibit + 4)) & ((1 << kcbitKcd2_2) - 1)) + kdibMinKcd2_2;
-                ibit += 4 + kcbitKcd2_2;
+                cb += 2;
+                luw1 >>= 16;
             }
-            else
-            {
-                dib = (luCur >> (ibit + 4)) & ((1 << kcbitKcd2_3) - 1) + kdibMinKcd2_3;
-                ibit += 4 + kcbitKcd2_3;
+            if (0 == (luw1 & 0xFF))
                 cb++;
-            }
+            return cb;
+#else  //! LITTLE_ENDIAN
+            break;
+#endif //! LITTLE_ENDIAN
+        }
+    }
+    while (cb < cbMax && pb1[cb] == pb2[cb])
+        cb++;
+    return cb;
+}
 
-#ifdef SAFETY
-            if (pbLimDst - pbDst < cb || pbDst - (byte *)pvDst < dib)
-                goto LFail;
-#endif // SAFETY
-            for (pbT = pbDst - dib; cb-- > 0;)
-                *pbDst++ = *pbT++;
+/***************************************************************************
+    Write a length that didn't fit in its token nibble.
+***************************************************************************/
+inline byte *_PbWriteLenKcdf(byte *pbDst, long cb)
+{
+    for (cb -= 15; cb >= 255; cb -= 255)
+        *pbDst++ = 255;
+    *pbDst++ = (byte)cb;
+    return pbDst;
+}
+
+/***************************************************************************
+    Write a KCDF token with its literals and match. cbMatch is zero for the
+    final token. pbLimSrc is the end of the source the literals are in.
+    Returns pvNil if it doesn't fit in the destination.
+***************************************************************************/
+priv byte *_PbWriteTokenKcdf(byte *pbDst, byte *pbLimDst, byte *pbLit, byte *pbLimSrc, long cbLit, long dib,
+                             long cbMatch)
+{
+    long cbCode = cbMatch > 0 ? cbMatch - kcbMinMatchKcdf : 0;
+
+    // make sure the worst case fits
+    if (pbLimDst - pbDst < cbLit + cbLit / 255 + cbCode / 255 + 5)
+        return pvNil;
+
+    *pbDst++ = (byte)((LwMin(cbLit, 15) << 4) | LwMin(cbCode, 15));
+    if (cbLit >= 15)
+        pbDst = _PbWriteLenKcdf(pbDst, cbLit);
+    if (cbLit <= 2 * size(LUW) && pbLimSrc - pbLit >= 2 * size(LUW) && pbLimDst - pbDst >= 2 * size(LUW) + 5)
+    {
+        // short run with room to spare - copy a fixed amount
+        memcpy(pbDst, pbLit, 2 * size(LUW));
+    }
+    else
+        CopyPb(pbLit, pbDst, cbLit);
+    pbDst += cbLit;
+
+    if (cbMatch > 0)
+    {
+        AssertIn(dib, 1, kdibMaxKcdf + 1);
+        *pbDst++ = (byte)dib;
+        *pbDst++ = (byte)(dib >> 8);
+        if (cbCode >= 15)
+            pbDst = _PbWriteLenKcdf(pbDst, cbCode);
+    }
+
+    return pbDst;
+}
+
+/***************************************************************************
+    Compress the data in pvSrc using the KCDF encoding. Returns false if
+    the data can't be compressed. This looks for matches through a single
+    hash table probe and skips ahead faster the longer it goes without
+    finding one, so it is quick rather than thorough. Most chunks are
+    small, so the hash table is sized to the source to keep clearing it
+    from costing more than the encoding.
+***************************************************************************/
+bool KCDF::_FEncode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    long rgibHash[1 << kcbitHashKcdf];
+    long ibSrc, ibAnchor, ibMatch, ibLimMatch, cbMatch, ihash, cbitHash;
+    ulong lu;
+    byte *prgbSrc = (byte *)pvSrc;
+    byte *pbDst = (byte *)pvDst;
+    byte *pbLimDst = pbDst + cbDst;
+
+    TrashVar(pcbDst);
+    for (cbitHash = kcbitHashMinKcdf; cbitHash < kcbitHashKcdf && (1L << cbitHash) < cbSrc; cbitHash++)
+        ;
+    ClearPb(rgibHash, LwMul(size(long), 1L << cbitHash));
+
+    // matches have to start far enough from the end to hash them
+    ibLimMatch = cbSrc - size(LUW) + 1;
+    for (ibSrc = ibAnchor = 0; ibSrc < ibLimMatch;)
+    {
+        lu = _LuRead4(prgbSrc + ibSrc);
+        ihash = _IhashKcdf(prgbSrc + ibSrc, cbitHash);
+        ibMatch = rgibHash[ihash];
+        rgibHash[ihash] = ibSrc;
+
+        if (ibMatch >= ibSrc || ibSrc - ibMatch > kdibMaxKcdf || _LuRead4(prgbSrc + ibMatch) != lu)
+        {
+            // no match - the longer it's been since the last one, the
+            // bigger the steps we take
+            ibSrc += 1 + ((ibSrc - ibAnchor) >> kcbitSkipKcdf);
+            continue;
+        }
+
+        // extend the match back over the pending literals and forward
+        while (ibSrc > ibAnchor && ibMatch > 0 && prgbSrc[ibSrc - 1] == prgbSrc[ibMatch - 1])
+        {
+            ibSrc--;
+            ibMatch--;
         }
+        cbMatch = kcbMinMatchKcdf + _CbCommon(prgbSrc + ibSrc + kcbMinMatchKcdf, prgbSrc + ibMatch + kcbMinMatchKcdf,
+                                              cbSrc - ibSrc - kcbMinMatchKcdf);
+
+        pbDst = _PbWriteTokenKcdf(pbDst, pbLimDst, prgbSrc + ibAnchor, prgbSrc + cbSrc, ibSrc - ibAnchor, ibSrc - ibMatch,
+                                  cbMatch);
+        if (pvNil == pbDst)
+            return fFalse;
 
-        _Advance(ibit >> 3);
-        ibit &= 0x07;
+        ibSrc += cbMatch;
+        ibAnchor = ibSrc;
+
+        // remember a position inside the match, so a repeat of the end of
+        // it can be found
+        if (ibSrc - 2 < ibLimMatch)
+            rgibHash[_IhashKcdf(prgbSrc + ibSrc - 2, cbitHash)] = ibSrc - 2;
     }
 
-LDone:
+    // write the final literals
+    pbDst = _PbWriteTokenKcdf(pbDst, pbLimDst, prgbSrc + ibAnchor, prgbSrc + cbSrc, cbSrc - ibAnchor, 0, 0);
+    if (pvNil == pbDst)
+        return fFalse;
+
     *pcbDst = pbDst - (byte *)pvDst;
     return fTrue;
+}
 
-#undef _FTest
-#undef _Advance
+/***************************************************************************
+    Read the extra bytes of a length that didn't fit in its token nibble.
+***************************************************************************/
+inline bool _FReadLenKcdf(byte **ppbSrc, byte *pbLimSrc, long *pcb)
+{
+    byte b;
+
+    do
+    {
+        if (*ppbSrc >= pbLimSrc || *pcb > kcbMax)
+            return fFalse;
+        b = *(*ppbSrc)++;
+        *pcb += b;
+    } while (b == 255);
 
-#endif // 0
+    return fTrue;
+}
 
-#endif //! IN_80386
+/***************************************************************************
+    Decompress a compressed KCDF stream.
+***************************************************************************/
+bool KCDF::_FDecode(void *pvSrc, long cbSrc, void *pvDst, long cbDst, long *pcbDst)
+{
+    AssertThis(0);
+    AssertIn(cbSrc, 1, kcbMax);
+    AssertPvCb(pvSrc, cbSrc);
+    AssertIn(cbDst, 1, kcbMax);
+    AssertPvCb(pvDst, cbDst);
+    AssertVarMem(pcbDst);
+
+    long cb, dib;
+    byte bToken;
+    byte *pbSrc = (byte *)pvSrc;
+    byte *pbLimSrc = pbSrc + cbSrc;
+    byte *pbDst = (byte *)pvDst;
+    byte *pbLimDst = pbDst + cbDst;
+
+    TrashVar(pcbDst);
+    for (;;)
+    {
+        if (pbSrc >= pbLimSrc)
+            goto LFail;
+        bToken = *pbSrc++;
+
+        // copy the literals
+        cb = bToken >> 4;
+        if (cb == 15 && !_FReadLenKcdf(&pbSrc, pbLimSrc, &cb))
+            goto LFail;
+        if (pbLimSrc - pbSrc < cb || pbLimDst - pbDst < cb)
+            goto LFail;
+        if (cb <= 2 * size(LUW) && pbLimSrc - pbSrc >= 2 * size(LUW) && pbLimDst - pbDst >= 2 * size(LUW))
+        {
+            // short run with room to spare - copy a fixed amount
+            memcpy(pbDst, pbSrc, 2 * size(LUW));
+        }
+        else
+            memcpy(pbDst, pbSrc, cb);
+        pbSrc += cb;
+        pbDst += cb;
+
+        // the last token has no match
+        if (pbSrc == pbLimSrc)
+            break;
+
+        // get the offset and length and copy the match
+        if (pbLimSrc - pbSrc < 2)
+            goto LFail;
+        dib = (long)pbSrc[0] | ((long)pbSrc[1] << 8);
+        pbSrc += 2;
+        cb = bToken & 0x0F;
+        if (cb == 15 && !_FReadLenKcdf(&pbSrc, pbLimSrc, &cb))
+            goto LFail;
+        cb += kcbMinMatchKcdf;
+        if (dib == 0 || pbDst - (byte *)pvDst < dib || pbLimDst - pbDst < cb)
+            goto LFail;
+        _CopyMatch(pbDst, dib, cb, pbLimDst);
+        pbDst += cb;
+    }
+
+    *pcbDst = pbDst - (byte *)pvDst;
+    return fTrue;
 
 LFail:
     Bug("bad compressed data");
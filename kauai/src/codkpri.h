@@ -50,4 +50,14 @@
 #define kdibMinKcd2_3 0x1241
 #define kdibMinKcd2_4 0x101240 // used as a lim for 20 bit offsets
 
+/***************************************************************************
+    Constants for the KCDF encoding.
+***************************************************************************/
+#define kcbMinMatchKcdf 4   // shortest match
+#define kdibMaxKcdf 0xFFFF  // largest match offset
+#define kcbHashKcdf 6       // bytes the encoder hashes to find matches
+#define kcbitHashKcdf 12    // log of the encoder's largest hash table size
+#define kcbitHashMinKcdf 6  // log of its smallest (for tiny sources)
+#define kcbitSkipKcdf 5     // log of how many misses before the encoder step grows
+
 #endif //! CODKPRI_H
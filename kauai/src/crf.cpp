@@ -25,6 +25,51 @@ RTCLASS(CRF)
 RTCLASS(CRM)
 RTCLASS(CABO)
 
+// prefetch entry states
+enum
+{
+    pfsQueued, // waiting to be read
+    pfsBusy,   // being read by the prefetch thread
+    pfsDone,   // read successfully, hq is the data
+    pfsFailed, // couldn't be read
+};
+
+// the most prefetched objects CompletePrefetches builds per call
+const long kcpfeIdle = 4;
+
+PGL CRF::_pglpfe;
+MUTX CRF::_mutxPfe;
+bool CRF::_fPrefetchThread;
+#ifdef WIN
+HANDLE CRF::_hevtPfe;
+#endif // WIN
+
+/***************************************************************************
+    Start prefetching a list of chunks (see TPrefetch).  Returns tNo if
+    any of the chunks isn't there, otherwise tMaybe if any couldn't be
+    queued, otherwise tYes.
+***************************************************************************/
+tribool RCA::TPrefetchRgcki(CKI *prgcki, long ccki, PFNRPO pfnrpo, long crep)
+{
+    AssertThis(0);
+    AssertIn(ccki, 0, kcbMax);
+    AssertPvCb(prgcki, LwMul(ccki, size(CKI)));
+    Assert(pvNil != pfnrpo, "nil object reader");
+    long icki;
+    tribool t;
+    tribool tRet = tYes;
+
+    for (icki = 0; icki < ccki; icki++)
+    {
+        t = TPrefetch(prgcki[icki].ctg, prgcki[icki].cno, pfnrpo, crep);
+        if (tNo == t)
+            tRet = tNo;
+        else if (tMaybe == t && tYes == tRet)
+            tRet = tMaybe;
+    }
+    return tRet;
+}
+
 /***************************************************************************
     Constructor for base cacheable object.
 ***************************************************************************/
@@ -34,6 +79,7 @@ BACO::BACO(void)
     _pcrf = pvNil;
     _crep = crepToss;
     _fAttached = fFalse;
+    _ievc = ivNil;
 }
 
 /***************************************************************************
@@ -178,6 +224,36 @@ CRF::~CRF(void)
 {
     AssertBaseThis(fobjAllocated);
     CRE cre;
+    PFE pfe;
+    long ipfe;
+
+    if (_cpfe > 0)
+    {
+        // cancel our prefetches
+        _mutxPfe.Enter();
+        for (ipfe = _pglpfe->IvMac(); ipfe-- > 0;)
+        {
+            _pglpfe->Get(ipfe, &pfe);
+            if (pfe.pcrf != this)
+                continue;
+            if (pfsBusy == pfe.pfs)
+            {
+                // the prefetch thread is reading it, CompletePrefetches
+                // will free it
+                pfe.pcrf = pvNil;
+                _pglpfe->Put(ipfe, &pfe);
+            }
+            else
+            {
+                _pglpfe->Delete(ipfe);
+                ReportDfr(&pfe.dfr);
+                _ReleasePfe(&pfe);
+            }
+            _cpfe--;
+        }
+        _mutxPfe.Leave();
+        Assert(_cpfe == 0, "prefetch count is wrong");
+    }
 
     _cactRef++; // so we don't get "deleted" while detaching the BACOs
     if (pvNil != _pglcre)
@@ -192,6 +268,9 @@ CRF::~CRF(void)
         }
         ReleasePpo(&_pglcre);
     }
+    ReleasePpo(&_pglevc);
+    ReleasePpo(&_pggpke);
+    ReleasePpo(&_pglpkq);
     Assert(_cactRef == 1, "someone still refers to this CRF");
     ReleasePpo(&_pcfl);
 }
@@ -205,7 +284,8 @@ PCRF CRF::PcrfNew(PCFL pcfl, long cbMax)
     AssertIn(cbMax, 0, kcbMax);
     PCRF pcrf;
 
-    if (pvNil != (pcrf = NewObj CRF(pcfl, cbMax)) && pvNil == (pcrf->_pglcre = GL::PglNew(size(CRE), 5)))
+    if (pvNil != (pcrf = NewObj CRF(pcfl, cbMax)) &&
+        (pvNil == (pcrf->_pglcre = GL::PglNew(size(CRE), 5)) || pvNil == (pcrf->_pglevc = GL::PglNew(size(EVC), 5))))
     {
         ReleasePpo(&pcrf);
     }
@@ -249,6 +329,23 @@ void CRF::SetCbMax(long cbMax)
     _cbMax = cbMax;
 }
 
+/***************************************************************************
+    Set the size of the second tier cache.  The chunk data of the objects
+    we load is kept here (compressed), so that reading an object again after
+    it's been tossed doesn't have to go to the file.  The data is copied
+    when the object is loaded and compressed in the background, like a
+    prefetch.  This is off (zero) by default.
+***************************************************************************/
+void CRF::SetCbMaxPacked(long cbMax)
+{
+    AssertThis(0);
+    AssertIn(cbMax, 0, kcbMax);
+
+    _cbMaxPacked = cbMax;
+    if (_cbPacked > cbMax)
+        _PurgePackedCb(_cbPacked - cbMax);
+}
+
 /***************************************************************************
     Pre-fetch the object.  Returns tYes if the chunk is successfully cached,
     tNo if the chunk isn't in the CRF and tMaybe if there wasn't room
@@ -271,18 +368,38 @@ tribool CRF::TLoad(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc, long crep)
     if (_FFindCre(ctg, cno, pfnrpo, &icre))
     {
         _pglcre->Get(icre, &cre);
-        cre.pbaco->SetCrep(LwMax(cre.pbaco->_crep, crep));
         cre.cactRelease = _cactRelease++;
         _pglcre->Put(icre, &cre);
+
+        // if nothing refers to it, this goes through BacoReleased, which
+        // moves it in the eviction heap (or tosses it)
+        cre.pbaco->SetCrep(LwMax(cre.pbaco->_crep, crep));
         return tYes;
     }
 
     // see if it's in the chunky file
-    if (!_pcfl->FFind(ctg, cno, &blck))
+    if (!_FFindBlck(ctg, cno, pfnrpo, &blck))
         return tNo;
 
+    return _TLoadBlck(ctg, cno, pfnrpo, &blck, crep);
+}
+
+/***************************************************************************
+    Read the object from the block and cache it.  The object must not be
+    cached already.  Returns tYes on success and tMaybe if there wasn't
+    room or it couldn't be read.
+***************************************************************************/
+tribool CRF::_TLoadBlck(CTG ctg, CNO cno, PFNRPO pfnrpo, PBLCK pblck, long crep)
+{
+    AssertThis(0);
+    Assert(pvNil != pfnrpo, "bad pfnrpo");
+    AssertPo(pblck, 0);
+    Assert(crep > crepToss, "crep too small");
+    CRE cre;
+    long icre;
+
     // get the approximate size of the object
-    if (!(*pfnrpo)(this, ctg, cno, &blck, pvNil, &cre.cb))
+    if (!(*pfnrpo)(this, ctg, cno, pblck, pvNil, &cre.cb))
         return tMaybe;
 
     if (_cbCur + cre.cb > _cbMax)
@@ -291,7 +408,8 @@ tribool CRF::TLoad(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc, long crep)
             return tMaybe;
     }
 
-    if (!(*pfnrpo)(this, ctg, cno, &blck, &cre.pbaco, &cre.cb))
+    _CaptureData(ctg, cno, pblck);
+    if (!(*pfnrpo)(this, ctg, cno, pblck, &cre.pbaco, &cre.cb))
         return tMaybe;
 
     AssertPo(cre.pbaco, 0);
@@ -316,7 +434,8 @@ tribool CRF::TLoad(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc, long crep)
     // indexes may have changed, get the location to insert again
     AssertDo(!_FFindCre(ctg, cno, pfnrpo, &icre), "how did this happen?");
 
-    if (!_pglcre->FInsert(icre, &cre))
+    // make sure the eviction heap will have room for it too
+    if (!_pglevc->FEnsureSpace(_pglcre->IvMac() + 1 - _pglevc->IvMac()) || !_pglcre->FInsert(icre, &cre))
     {
         // can't keep it loaded
         ReleasePpo(&cre.pbaco);
@@ -357,14 +476,16 @@ PBACO CRF::PbacoFetch(CTG ctg, CNO cno, PFNRPO pfnrpo, bool *pfError, RSC rsc)
         _pglcre->Get(icre, &cre);
         AssertPo(cre.pbaco, 0);
         cre.pbaco->AddRef();
+        _RemoveEvc(cre.pbaco);
         return cre.pbaco;
     }
 
     // see if it's in the chunky file
-    if (!_pcfl->FFind(ctg, cno, &blck))
+    if (!_FFindBlck(ctg, cno, pfnrpo, &blck))
         return pvNil;
 
     // get the object and its size
+    _CaptureData(ctg, cno, &blck);
     if (!(*pfnrpo)(this, ctg, cno, &blck, &cre.pbaco, &cre.cb))
     {
         if (pvNil != pfError)
@@ -388,7 +509,8 @@ PBACO CRF::PbacoFetch(CTG ctg, CNO cno, PFNRPO pfnrpo, bool *pfError, RSC rsc)
     // indexes may have changed, get the location to insert again
     AssertDo(!_FFindCre(ctg, cno, pfnrpo, &icre), "how did this happen?");
 
-    if (!_pglcre->FInsert(icre, &cre))
+    // make sure the eviction heap will have room for it too
+    if (!_pglevc->FEnsureSpace(_pglcre->IvMac() + 1 - _pglevc->IvMac()) || !_pglcre->FInsert(icre, &cre))
     {
         // return the pbaco anyway.  when it's released it will go away
         if (pvNil != pfError)
@@ -430,6 +552,7 @@ PBACO CRF::PbacoFind(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc)
     _pglcre->Get(icre, &cre);
     AssertPo(cre.pbaco, 0);
     cre.pbaco->AddRef();
+    _RemoveEvc(cre.pbaco);
     return cre.pbaco;
 }
 
@@ -473,6 +596,368 @@ PCRF CRF::PcrfFindChunk(CTG ctg, CNO cno, RSC rsc)
     return this;
 }
 
+/***************************************************************************
+    Start reading the object in the background.  The data is read (and
+    decompressed) by the prefetch thread.  The object is built from it on
+    this thread, by CompletePrefetches or by the first TLoad or PbacoFetch
+    of it, and cached with the given crep.  Returns tYes if the object is
+    cached or queued, tNo if the chunk isn't in the CRF and tMaybe if it
+    couldn't be queued.
+***************************************************************************/
+tribool CRF::TPrefetch(CTG ctg, CNO cno, PFNRPO pfnrpo, long crep)
+{
+    AssertThis(0);
+    Assert(pvNil != pfnrpo, "bad pfnrpo");
+    Assert(crep > crepToss, "crep too small");
+    PFE pfe;
+    long icre, ipfe;
+    BLCK blck;
+
+    // if it's cached, TLoad just updates its crep
+    if (_FFindCre(ctg, cno, pfnrpo, &icre))
+        return TLoad(ctg, cno, pfnrpo, rscNil, crep);
+
+    if (!_pcfl->FFind(ctg, cno, &blck))
+        return tNo;
+
+    // there's nothing to read for an empty chunk
+    if (0 == blck.Cb(fTrue))
+        return TLoad(ctg, cno, pfnrpo, rscNil, crep);
+
+    if (_cpfe > 0)
+    {
+        _mutxPfe.Enter();
+        if (_FFindPfe(ctg, cno, pfnrpo, &ipfe))
+        {
+            // already queued
+            _pglpfe->Get(ipfe, &pfe);
+            pfe.crep = LwMax(pfe.crep, crep);
+            _pglpfe->Put(ipfe, &pfe);
+            _mutxPfe.Leave();
+            return tYes;
+        }
+        _mutxPfe.Leave();
+    }
+
+    ClearPb(&pfe, size(PFE));
+    if (!blck.FGetFlo(&pfe.flo, fTrue))
+        return tMaybe;
+    pfe.pcrf = this;
+    pfe.ctg = ctg;
+    pfe.cno = cno;
+    pfe.pfnrpo = pfnrpo;
+    pfe.crep = crep;
+    pfe.fPacked = blck.FPacked();
+    pfe.pfs = pfsQueued;
+    pfe.hq = hqNil;
+
+    if (!_FQueuePfe(&pfe))
+    {
+        _ReleasePfe(&pfe);
+        return tMaybe;
+    }
+    return tYes;
+}
+
+/***************************************************************************
+    Static method to add an entry to the prefetch queue and make sure the
+    prefetch thread is running.  On failure, the caller still owns the
+    things the entry refers to.
+***************************************************************************/
+bool CRF::_FQueuePfe(PFE *ppfe)
+{
+    AssertVarMem(ppfe);
+    AssertPo(ppfe->pcrf, 0);
+    Assert(pfsQueued == ppfe->pfs, "bad pfs");
+
+    _mutxPfe.Enter();
+    if ((pvNil == _pglpfe && pvNil == (_pglpfe = GL::PglNew(size(PFE)))) || !_pglpfe->FAdd(ppfe))
+    {
+        _mutxPfe.Leave();
+        return fFalse;
+    }
+    ppfe->pcrf->_cpfe++;
+
+#ifdef WIN
+    if (!_fPrefetchThread)
+    {
+        HANDLE hth;
+        ulong luThread;
+
+        // if we can't start the thread, CompletePrefetches does the reading
+        if (hNil == _hevtPfe)
+            _hevtPfe = CreateEvent(pvNil, fFalse, fFalse, pvNil);
+        if (hNil != _hevtPfe && hNil != (hth = CreateThread(pvNil, 0, _LuPrefetchThread, pvNil, 0, &luThread)))
+        {
+            _fPrefetchThread = fTrue;
+            CloseHandle(hth);
+        }
+    }
+#endif // WIN
+
+    _mutxPfe.Leave();
+    return fTrue;
+}
+
+/***************************************************************************
+    Get a block for the chunk's data.  If a prefetch of it has finished,
+    this is the data it read, otherwise it's the chunk in the chunky file.
+    If the prefetch thread is reading it right now, we don't wait for it:
+    the entry is disowned (CompletePrefetches frees it when it's done) and
+    the data is read here.
+***************************************************************************/
+bool CRF::_FFindBlck(CTG ctg, CNO cno, PFNRPO pfnrpo, PBLCK pblck)
+{
+    AssertThis(0);
+    AssertPo(pblck, 0);
+    PFE pfe;
+    long ipfe;
+    bool fFound;
+
+    if (_cpfe > 0)
+    {
+        _mutxPfe.Enter();
+        if ((fFound = _FFindPfe(ctg, cno, pfnrpo, &ipfe)))
+        {
+            _pglpfe->Get(ipfe, &pfe);
+            if (pfsBusy == pfe.pfs)
+            {
+                ((PFE *)_pglpfe->QvGet(ipfe))->pcrf = pvNil;
+                fFound = fFalse;
+            }
+            else
+                _pglpfe->Delete(ipfe);
+            _cpfe--;
+        }
+        _mutxPfe.Leave();
+
+        if (fFound)
+        {
+            ReportDfr(&pfe.dfr);
+            fFound = pfsDone == pfe.pfs;
+            if (fFound)
+                pblck->SetHq(&pfe.hq);
+            _ReleasePfe(&pfe);
+            if (fFound)
+                return fTrue;
+        }
+    }
+
+    if (pvNil != _pggpke && _FUnstashData(ctg, cno, pblck))
+        return fTrue;
+
+    return _pcfl->FFind(ctg, cno, pblck);
+}
+
+/***************************************************************************
+    Find this CRF's prefetch entry for the object.  _mutxPfe must be held.
+***************************************************************************/
+bool CRF::_FFindPfe(CTG ctg, CNO cno, PFNRPO pfnrpo, long *pipfe)
+{
+    AssertThis(0);
+    AssertVarMem(pipfe);
+    long ipfe, cpfe;
+    PFE *qpfe;
+
+    if (0 == _cpfe)
+        return fFalse;
+
+    for (ipfe = 0, cpfe = _pglpfe->IvMac(); ipfe < cpfe; ipfe++)
+    {
+        qpfe = (PFE *)_pglpfe->QvGet(ipfe);
+        if (qpfe->pcrf == this && qpfe->ctg == ctg && qpfe->cno == cno && qpfe->pfnrpo == pfnrpo)
+        {
+            *pipfe = ipfe;
+            return fTrue;
+        }
+    }
+    return fFalse;
+}
+
+/***************************************************************************
+    Free the things a prefetch entry owns.  The entry must already be out
+    of the queue.
+***************************************************************************/
+void CRF::_ReleasePfe(PFE *ppfe)
+{
+    AssertVarMem(ppfe);
+
+    ReleasePpo(&ppfe->flo.pfil);
+    FreePhq(&ppfe->hq);
+}
+
+/***************************************************************************
+    Read and unpack the data for a prefetch entry.  Data for the second
+    tier is already in memory and is packed instead, with the fast codec,
+    since it never leaves the process.  This is called on the prefetch
+    thread, so it only touches the entry, the file and memory.
+***************************************************************************/
+bool CRF::_FReadPfe(PFE *ppfe)
+{
+    AssertVarMem(ppfe);
+    Assert(FPure(hqNil != ppfe->hq) == FPure(ppfe->fStash), "bad hq");
+
+    if (ppfe->fStash)
+    {
+        if (!ppfe->fPacked && vpcodmUtil->FCompressPhq(&ppfe->hq, kcfmtKauaiFast))
+            ppfe->fPacked = fTrue;
+        return fTrue;
+    }
+    if (!ppfe->flo.FReadHq(&ppfe->hq))
+        return fFalse;
+    if (ppfe->fPacked && !vpcodmUtil->FDecompressPhq(&ppfe->hq))
+    {
+        FreePhq(&ppfe->hq);
+        return fFalse;
+    }
+    return fTrue;
+}
+
+#ifdef WIN
+/***************************************************************************
+    The prefetch thread.  Reads queued entries until there are none left.
+    Failures are collected in the entry's DFR and reported on the main
+    thread when it takes the entry out of the queue.
+***************************************************************************/
+ulong __stdcall CRF::_LuPrefetchThread(void *pv)
+{
+    PFE pfe;
+    PFE *qpfe;
+    long ipfe, cpfe;
+    bool fRet;
+
+    // the main thread owns the objects we use, so don't validate them
+    Debug(vcactAV = 0;)
+
+    for (;;)
+    {
+        _mutxPfe.Enter();
+        for (ipfe = 0, cpfe = _pglpfe->IvMac(); ipfe < cpfe; ipfe++)
+        {
+            _pglpfe->Get(ipfe, &pfe);
+            if (pfsQueued == pfe.pfs)
+                break;
+        }
+        if (ipfe == cpfe)
+        {
+            _fPrefetchThread = fFalse;
+            _mutxPfe.Leave();
+            return 0;
+        }
+        ((PFE *)_pglpfe->QvGet(ipfe))->pfs = pfsBusy;
+        _mutxPfe.Leave();
+
+        vpdfrCur = &pfe.dfr;
+        fRet = _FReadPfe(&pfe);
+        vpdfrCur = pvNil;
+
+        // The entry may have moved, but the main thread doesn't remove busy
+        // entries and we're the only one that has them.
+        _mutxPfe.Enter();
+        for (ipfe = 0, cpfe = _pglpfe->IvMac(); ipfe < cpfe; ipfe++)
+        {
+            qpfe = (PFE *)_pglpfe->QvGet(ipfe);
+            if (pfsBusy == qpfe->pfs)
+            {
+                qpfe->hq = pfe.hq;
+                qpfe->fPacked = pfe.fPacked;
+                qpfe->dfr = pfe.dfr;
+                qpfe->pfs = fRet ? pfsDone : pfsFailed;
+                break;
+            }
+        }
+        Assert(ipfe < cpfe, "lost the busy prefetch entry");
+        _mutxPfe.Leave();
+        SetEvent(_hevtPfe);
+    }
+}
+#endif // WIN
+
+/***************************************************************************
+    Static method to build the objects for up to kcpfeIdle finished
+    prefetches and cache them (or put their data in the second tier).
+    Should be called at idle time.  If there's no prefetch thread, this
+    does the reading too.
+***************************************************************************/
+void CRF::CompletePrefetches(void)
+{
+    PFE pfe;
+    long ipfe, cpfe, cpfeDone, icre;
+    bool fRead;
+    BLCK blck;
+
+    for (cpfeDone = 0; cpfeDone < kcpfeIdle; cpfeDone++)
+    {
+        _mutxPfe.Enter();
+        if (pvNil == _pglpfe)
+        {
+            _mutxPfe.Leave();
+            return;
+        }
+
+        for (ipfe = 0, cpfe = _pglpfe->IvMac(); ipfe < cpfe; ipfe++)
+        {
+            _pglpfe->Get(ipfe, &pfe);
+            if (pfsDone == pfe.pfs || pfsFailed == pfe.pfs)
+                break;
+        }
+        fRead = fFalse;
+        if (ipfe == cpfe && !_fPrefetchThread)
+        {
+            for (ipfe = 0; ipfe < cpfe; ipfe++)
+            {
+                _pglpfe->Get(ipfe, &pfe);
+                if (pfsQueued == pfe.pfs)
+                    break;
+            }
+            fRead = fTrue;
+        }
+        if (ipfe == cpfe)
+        {
+            if (0 == cpfe && !_fPrefetchThread)
+                ReleasePpo(&_pglpfe);
+            _mutxPfe.Leave();
+            return;
+        }
+        _pglpfe->Delete(ipfe);
+        if (pvNil != pfe.pcrf)
+            pfe.pcrf->_cpfe--;
+        _mutxPfe.Leave();
+
+        if (fRead)
+            pfe.pfs = _FReadPfe(&pfe) ? pfsDone : pfsFailed;
+        ReportDfr(&pfe.dfr);
+
+        if (pvNil != pfe.pcrf && pfsDone == pfe.pfs)
+        {
+            if (pfe.fStash)
+                pfe.pcrf->_StashPfe(&pfe);
+            else if (!pfe.pcrf->_FFindCre(pfe.ctg, pfe.cno, pfe.pfnrpo, &icre))
+            {
+                blck.SetHq(&pfe.hq);
+                pfe.pcrf->_TLoadBlck(pfe.ctg, pfe.cno, pfe.pfnrpo, &blck, pfe.crep);
+                blck.Free();
+            }
+        }
+        _ReleasePfe(&pfe);
+    }
+}
+
+/***************************************************************************
+    Static method to return the number of entries in the prefetch queue,
+    including ones that are done but haven't been through
+    CompletePrefetches yet.
+***************************************************************************/
+long CRF::CpfePending(void)
+{
+    long cpfe;
+
+    _mutxPfe.Enter();
+    cpfe = pvNil == _pglpfe ? 0 : _pglpfe->IvMac();
+    _mutxPfe.Leave();
+    return cpfe;
+}
+
 /***************************************************************************
     Check the _fAttached flag.  If it's false, make sure the BACO is not
     in the CRF.
@@ -499,6 +984,7 @@ void CRF::BacoDetached(PBACO pbaco)
     _cbCur -= cre.cb;
     AssertIn(_cbCur, 0, kcbMax);
     _pglcre->Delete(icre);
+    _RemoveEvc(pbaco);
 }
 
 /***************************************************************************
@@ -526,10 +1012,14 @@ void CRF::BacoReleased(PBACO pbaco)
     _pglcre->Get(icre, &cre);
     cre.cactRelease = _cactRelease++;
     _pglcre->Put(icre, &cre);
+    _UpdateEvc(pbaco, &cre);
 
     if (pbaco->_crep <= crepToss || _cbCur > _cbMax)
     {
-        // toss it
+        // toss it - if it's only going because the cache is full, keep
+        // its data in the second tier (if it's still there)
+        if (pbaco->_crep > crepToss)
+            _StashData(pbaco->_ctg, pbaco->_cno);
         pbaco->Detach();
     }
 }
@@ -648,7 +1138,9 @@ bool CRF::_FFindBaco(PBACO pbaco, long *picre)
 
 /***************************************************************************
     Try to purge at least cbPurge bytes of space.  Doesn't free anything
-    with a crep > crepLast or that is locked.
+    with a crep > crepLast or that is locked.  The BACOs that can be
+    purged are kept in the _pglevc heap, so this just tosses from the top
+    of the heap until enough is free.
 ***************************************************************************/
 bool CRF::_FPurgeCb(long cbPurge, long crepLast)
 {
@@ -657,128 +1149,612 @@ bool CRF::_FPurgeCb(long cbPurge, long crepLast)
     if (crepLast <= crepToss)
         return fFalse;
 
-    CRE cre;
-    long icreMac;
-
-    while (0 < (icreMac = _pglcre->IvMac()))
-    {
-        // We want to find the "best" element to free.  This is determined by
-        // keeping a "best so far" element, which we compare each element to.
-        // If the cre has a larger crep, it is worse, so just continue.
-        // If the cre has a smaller crep, it is better.  When the crep values
-        // are the same, we score it based on when the cre was last released
-        // (how many releases have happened since the cre was last used) and
-        // how different the cb is from cbPurge.  Each release is worth
-        // kcbRelease bytes.  Bytes short of cbPurge are considered worse
-        // (by a factor of 3) than bytes beyond cbPurge, so we favor elements
-        // that are larger than cbPurge.
-        // REVIEW shonk: tune kcbRelease and the weighting factor...
-        const long kcbRelease = 256;
-        long icre, crep;
-        long lw, dcb;
-        long lwBest = klwMax;
-        long icreBest = ivNil;
-        long crepBest = crepLast;
-
-        for (icre = 0; icre < icreMac; icre++)
-        {
-            _pglcre->Get(icre, &cre);
-            AssertPo(cre.pbaco, 0);
-            if (cre.pbaco->CactRef() > 0 || (crep = cre.pbaco->_crep) > crepBest)
-            {
-                continue;
-            }
-            Assert(crep <= crepBest, 0);
-            AssertIn(cre.cactRelease, 0, _cactRelease);
-
-            dcb = cre.cb - cbPurge;
-            lw = -LwMul(kcbRelease, LwMin(kcbMax / kcbRelease, _cactRelease - cre.cactRelease)) + LwMul(2, LwAbs(dcb)) -
-                 dcb;
-            if (crep < crepBest || lw < lwBest)
-            {
-                icreBest = icre;
-                crepBest = crep;
-                lwBest = lw;
-            }
-        }
+    EVC evc;
 
-        if (ivNil == icreBest)
+    while (0 < _pglevc->IvMac())
+    {
+        _pglevc->Get(0, &evc);
+        AssertPo(evc.pbaco, 0);
+        if (evc.crep > crepLast)
             return fFalse;
+        if (evc.pbaco->CactRef() > 0)
+        {
+            // someone got a reference without going through us, it'll be
+            // put back when it's released
+            _RemoveEvc(evc.pbaco);
+            continue;
+        }
 
-        _pglcre->Get(icreBest, &cre);
-        Assert(cre.pbaco->_fAttached, "BACO not attached!");
-        cre.pbaco->Detach();
+        Assert(evc.pbaco->_fAttached, "BACO not attached!");
+        _StashData(evc.pbaco->_ctg, evc.pbaco->_cno);
+        evc.pbaco->Detach();
 
-        if (0 >= (cbPurge -= cre.cb))
+        if (0 >= (cbPurge -= evc.cb))
             return fTrue;
     }
 
     return fFalse;
 }
 
-#ifdef DEBUG
 /***************************************************************************
-    Assert the validity of a CRF (chunky resource file).
+    Return whether the BACO in pevc1 should be tossed before the one in
+    pevc2.  Lower creps go first.  Then the one released longest ago, but
+    releases within kcactReleaseGroup of each other count as the same age,
+    in which case the bigger one goes first.
 ***************************************************************************/
-void CRF::AssertValid(ulong grf)
+bool CRF::_FEvcLess(EVC *pevc1, EVC *pevc2)
 {
-    CRF_PAR::AssertValid(fobjAllocated);
-    AssertPo(_pglcre, 0);
-    AssertPo(_pcfl, 0);
-    AssertIn(_cbMax, 0, kcbMax);
-    AssertIn(_cbCur, 0, kcbMax);
-    AssertIn(_cactRelease, 0, kcbMax);
+    const long kcactReleaseGroup = 16;
+    long cact1, cact2;
+
+    if (pevc1->crep != pevc2->crep)
+        return pevc1->crep < pevc2->crep;
+    cact1 = pevc1->cactRelease / kcactReleaseGroup;
+    cact2 = pevc2->cactRelease / kcactReleaseGroup;
+    if (cact1 != cact2)
+        return cact1 < cact2;
+    return pevc1->cb > pevc2->cb;
 }
 
 /***************************************************************************
-    Mark memory used by a CRF.
+    Move the EVC at ievc up the heap to where it belongs.
 ***************************************************************************/
-void CRF::MarkMem(void)
+void CRF::_SiftUpEvc(long ievc)
 {
-    AssertThis(0);
-    long icre;
-    CRE cre;
-
-    CRF_PAR::MarkMem();
-    MarkMemObj(_pglcre);
-    MarkMemObj(_pcfl);
+    AssertIn(ievc, 0, _pglevc->IvMac());
+    EVC *qrgevc = (EVC *)_pglevc->QvGet(0);
+    EVC evc = qrgevc[ievc];
+    long ievcParent;
 
-    for (icre = _pglcre->IvMac(); icre-- > 0;)
+    for (; ievc > 0; ievc = ievcParent)
     {
-        _pglcre->Get(icre, &cre);
-        AssertPo(cre.pbaco, 0);
-        Assert(cre.pbaco->_fAttached, "baco claims to not be attached!");
-        cre.pbaco->_fAttached = fTrue; // safety to avoid infinite recursion
-        MarkMemObj(cre.pbaco);
+        ievcParent = (ievc - 1) / 2;
+        if (!_FEvcLess(&evc, &qrgevc[ievcParent]))
+            break;
+        qrgevc[ievc] = qrgevc[ievcParent];
+        qrgevc[ievc].pbaco->_ievc = ievc;
     }
+    qrgevc[ievc] = evc;
+    evc.pbaco->_ievc = ievc;
 }
-#endif // DEBUG
 
 /***************************************************************************
-    Destructor for Chunky resource manager.
+    Move the EVC at ievc down the heap to where it belongs.
 ***************************************************************************/
-CRM::~CRM(void)
+void CRF::_SiftDownEvc(long ievc)
 {
-    AssertBaseThis(fobjAllocated);
-    long ipcrf;
-    PCRF pcrf;
+    AssertIn(ievc, 0, _pglevc->IvMac());
+    EVC *qrgevc = (EVC *)_pglevc->QvGet(0);
+    EVC evc = qrgevc[ievc];
+    long ievcChild;
+    long ievcMac = _pglevc->IvMac();
 
-    if (pvNil != _pglpcrf)
+    for (;;)
     {
-        for (ipcrf = _pglpcrf->IvMac(); ipcrf-- > 0;)
-        {
-            _pglpcrf->Get(ipcrf, &pcrf);
-            AssertPo(pcrf, 0);
-            ReleasePpo(&pcrf);
-        }
-        ReleasePpo(&_pglpcrf);
+        ievcChild = 2 * ievc + 1;
+        if (ievcChild >= ievcMac)
+            break;
+        if (ievcChild + 1 < ievcMac && _FEvcLess(&qrgevc[ievcChild + 1], &qrgevc[ievcChild]))
+            ievcChild++;
+        if (!_FEvcLess(&qrgevc[ievcChild], &evc))
+            break;
+        qrgevc[ievc] = qrgevc[ievcChild];
+        qrgevc[ievc].pbaco->_ievc = ievc;
+        ievc = ievcChild;
     }
+    qrgevc[ievc] = evc;
+    evc.pbaco->_ievc = ievc;
 }
 
 /***************************************************************************
-    Static method to create a new CRM.
+    The BACO's crep, release time or reference count may have changed.
+    Put it in the eviction heap (or move it to the right place) if it's
+    unreferenced, otherwise take it out.
 ***************************************************************************/
-PCRM CRM::PcrmNew(long ccrfInit)
+void CRF::_UpdateEvc(PBACO pbaco, CRE *pcre)
+{
+    AssertPo(pbaco, 0);
+    AssertVarMem(pcre);
+    Assert(pcre->pbaco == pbaco, "wrong CRE");
+    EVC evc;
+    long ievc;
+
+    if (pbaco->CactRef() > 0 || !pbaco->_fAttached)
+    {
+        _RemoveEvc(pbaco);
+        return;
+    }
+
+    evc.pbaco = pbaco;
+    evc.crep = pbaco->_crep;
+    evc.cactRelease = pcre->cactRelease;
+    evc.cb = pcre->cb;
+    if (ivNil != (ievc = pbaco->_ievc))
+        _pglevc->Put(ievc, &evc);
+    else if (!_pglevc->FAdd(&evc, &ievc))
+    {
+        // TLoad and PbacoFetch make sure there's room
+        Bug("no room in the eviction heap");
+        return;
+    }
+    pbaco->_ievc = ievc;
+    _SiftUpEvc(ievc);
+    _SiftDownEvc(pbaco->_ievc);
+}
+
+/***************************************************************************
+    Take the BACO out of the eviction heap (if it's there).
+***************************************************************************/
+void CRF::_RemoveEvc(PBACO pbaco)
+{
+    AssertPo(pbaco, 0);
+    EVC evc;
+    long ievc, ievcLast;
+
+    if (ivNil == (ievc = pbaco->_ievc))
+        return;
+
+    AssertIn(ievc, 0, _pglevc->IvMac());
+    pbaco->_ievc = ivNil;
+    ievcLast = _pglevc->IvMac() - 1;
+    if (ievc < ievcLast)
+    {
+        // move the last one into the hole and fix the heap
+        _pglevc->Get(ievcLast, &evc);
+        _pglevc->Put(ievc, &evc);
+        _pglevc->Delete(ievcLast);
+        evc.pbaco->_ievc = ievc;
+        _SiftUpEvc(ievc);
+        _SiftDownEvc(evc.pbaco->_ievc);
+    }
+    else
+        _pglevc->Delete(ievcLast);
+}
+
+/***************************************************************************
+    Find the packed entry for the chunk, or where it would go.  Binary
+    searches _pggpke.
+***************************************************************************/
+bool CRF::_FFindPke(CTG ctg, CNO cno, long *pipke)
+{
+    AssertThis(0);
+    AssertVarMem(pipke);
+    long ipkeMin, ipkeLim, ipke;
+    PKE *qpke;
+
+    for (ipkeMin = 0, ipkeLim = pvNil == _pggpke ? 0 : _pggpke->IvMac(); ipkeMin < ipkeLim;)
+    {
+        ipke = (ipkeMin + ipkeLim) / 2;
+        qpke = (PKE *)_pggpke->QvFixedGet(ipke);
+        if (qpke->ctg < ctg)
+            ipkeMin = ipke + 1;
+        else if (qpke->ctg > ctg)
+            ipkeLim = ipke;
+        else if (qpke->cno < cno)
+            ipkeMin = ipke + 1;
+        else if (qpke->cno > cno)
+            ipkeLim = ipke;
+        else
+        {
+            *pipke = ipke;
+            return fTrue;
+        }
+    }
+
+    *pipke = ipkeMin;
+    return fFalse;
+}
+
+/***************************************************************************
+    Delete a packed entry.
+***************************************************************************/
+void CRF::_DeletePke(long ipke)
+{
+    AssertThis(0);
+    AssertIn(ipke, 0, _pggpke->IvMac());
+
+    _cbPacked -= _pggpke->Cb(ipke);
+    _pggpke->Delete(ipke);
+    if (0 == _pggpke->IvMac())
+    {
+        // every PKQ is stale now
+        ReleasePpo(&_pggpke);
+        ReleasePpo(&_pglpkq);
+    }
+}
+
+/***************************************************************************
+    If the given PKQ isn't stale, return true and fill *pipke with the
+    index of its PKE.
+***************************************************************************/
+bool CRF::_FLivePkq(long ipkq, long *pipke)
+{
+    AssertThis(0);
+    AssertIn(ipkq, 0, _pglpkq->IvMac());
+    AssertVarMem(pipke);
+    PKQ pkq;
+
+    _pglpkq->Get(ipkq, &pkq);
+    return _FFindPke(pkq.ctg, pkq.cno, pipke) && ((PKE *)_pggpke->QvFixedGet(*pipke))->cactStash == pkq.cactStash;
+}
+
+/***************************************************************************
+    Add a PKQ for a PKE that was just stashed.  The stale PKQs are only
+    squeezed out when they're more than half the queue.
+***************************************************************************/
+bool CRF::_FAddPkq(CTG ctg, CNO cno, long cactStash)
+{
+    AssertThis(0);
+    AssertPo(_pggpke, 0);
+    PKQ pkq;
+    long ipkq, ipkqNew, ipke;
+
+    if (pvNil == _pglpkq)
+    {
+        if (pvNil == (_pglpkq = GL::PglNew(size(PKQ))))
+            return fFalse;
+    }
+    else if (_pglpkq->IvMac() > 2 * _pggpke->IvMac())
+    {
+        for (ipkq = ipkqNew = 0; ipkq < _pglpkq->IvMac(); ipkq++)
+        {
+            if (!_FLivePkq(ipkq, &ipke))
+                continue;
+            _pglpkq->Get(ipkq, &pkq);
+            _pglpkq->Put(ipkqNew++, &pkq);
+        }
+        AssertDo(_pglpkq->FSetIvMac(ipkqNew), "shrinking failed");
+    }
+
+    pkq.ctg = ctg;
+    pkq.cno = cno;
+    pkq.cactStash = cactStash;
+    return _pglpkq->FAdd(&pkq);
+}
+
+/***************************************************************************
+    Toss the oldest packed entries until at least cbPurge bytes are free.
+***************************************************************************/
+void CRF::_PurgePackedCb(long cbPurge)
+{
+    AssertThis(0);
+    long ipkq, ipke;
+
+    for (ipkq = 0; cbPurge > 0 && pvNil != _pglpkq && ipkq < _pglpkq->IvMac(); ipkq++)
+    {
+        if (!_FLivePkq(ipkq, &ipke))
+            continue;
+        cbPurge -= _pggpke->Cb(ipke);
+        _DeletePke(ipke);
+    }
+
+    // _DeletePke frees the queue when the last PKE goes
+    if (pvNil != _pglpkq)
+        _pglpkq->Delete(0, ipkq);
+}
+
+/***************************************************************************
+    If the chunk's data is in the second tier and the chunk hasn't changed
+    since it was put there, make it the newest entry and return true.
+    Entries for chunks that have changed are deleted.
+***************************************************************************/
+bool CRF::_FFreshenPke(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+    PKE pke;
+    FLO flo;
+    BLCK blck;
+    long ipke;
+    bool fCurrent;
+
+    if (!_FFindPke(ctg, cno, &ipke))
+        return fFalse;
+
+    _pggpke->GetFixed(ipke, &pke);
+    fCurrent = _pcfl->FFind(ctg, cno, &blck) && blck.FGetFlo(&flo, fTrue);
+    if (fCurrent)
+    {
+        fCurrent = flo.fp == pke.fp && flo.cb == pke.cb;
+        ReleasePpo(&flo.pfil);
+    }
+    if (!fCurrent)
+    {
+        _DeletePke(ipke);
+        return fFalse;
+    }
+
+    if (_FAddPkq(ctg, cno, _cactStash))
+    {
+        pke.cactStash = _cactStash++;
+        _pggpke->PutFixed(ipke, &pke);
+    }
+    return fTrue;
+}
+
+/***************************************************************************
+    An object for the chunk is about to be built from *pblck.  If there's a
+    second tier and the chunk's data isn't in it, make sure the data is in
+    memory, so the object is built from that, and queue a copy of it to be
+    compressed in the background.  _StashPfe puts it in the second tier
+    when it's ready.  Copying the data now means tossing the object later
+    doesn't have to read it from the file again.
+***************************************************************************/
+void CRF::_CaptureData(CTG ctg, CNO cno, PBLCK pblck)
+{
+    AssertThis(0);
+    AssertPo(pblck, 0);
+    PFE pfe;
+    BLCK blck;
+    HQ hq;
+    long cb, ipfe;
+    bool fQueued;
+
+    if (_cbMaxPacked <= 0 || _FFreshenPke(ctg, cno))
+        return;
+
+    // don't let one chunk push out everything else
+    cb = pblck->Cb(fTrue);
+    if (cb <= 0 || cb > _cbMaxPacked / 4)
+        return;
+
+    if (_cpfe > 0)
+    {
+        // see if it's already on its way
+        _mutxPfe.Enter();
+        fQueued = _FFindPfe(ctg, cno, pvNil, &ipfe);
+        _mutxPfe.Leave();
+        if (fQueued)
+            return;
+    }
+
+    ClearPb(&pfe, size(PFE));
+    if (!_pcfl->FFind(ctg, cno, &blck) || !blck.FGetFlo(&pfe.flo, fTrue))
+        return;
+
+    // read the data into memory (if it's not there already), then copy it
+    pfe.fPacked = pblck->FPacked();
+    if (hqNil == (hq = pblck->HqFree(fTrue)))
+        goto LFail;
+    pblck->SetHq(&hq, pfe.fPacked);
+    if (!pblck->FReadHq(&pfe.hq, fTrue))
+        goto LFail;
+
+    pfe.pcrf = this;
+    pfe.ctg = ctg;
+    pfe.cno = cno;
+    pfe.pfnrpo = pvNil;
+    pfe.crep = crepNormal;
+    pfe.fStash = fTrue;
+    pfe.pfs = pfsQueued;
+    if (_FQueuePfe(&pfe))
+        return;
+
+LFail:
+    _ReleasePfe(&pfe);
+}
+
+/***************************************************************************
+    An object for the chunk is being tossed to make room.  Its data went
+    to the second tier when it was loaded, so just make it the newest
+    entry there.  If it's been pushed out since, it's not worth reading
+    the file to get it back.
+***************************************************************************/
+void CRF::_StashData(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+
+    _FFreshenPke(ctg, cno);
+}
+
+/***************************************************************************
+    The data _CaptureData queued has been compressed, so put it in the
+    second tier.
+    The PFE keeps ownership of its hq.
+***************************************************************************/
+void CRF::_StashPfe(PFE *ppfe)
+{
+    AssertThis(0);
+    AssertVarMem(ppfe);
+    Assert(ppfe->fStash && pfsDone == ppfe->pfs, "bad stash entry");
+    PKE pke;
+    long ipke, cb;
+
+    cb = CbOfHq(ppfe->hq);
+    if (_cbMaxPacked <= 0 || cb > _cbMaxPacked / 4)
+        return;
+
+    if (_FFindPke(ppfe->ctg, ppfe->cno, &ipke))
+        _DeletePke(ipke);
+    if (_cbPacked + cb > _cbMaxPacked)
+        _PurgePackedCb(_cbPacked + cb - _cbMaxPacked);
+
+    if (pvNil == _pggpke && pvNil == (_pggpke = GG::PggNew(size(PKE))))
+        return;
+
+    ClearPb(&pke, size(PKE));
+    pke.ctg = ppfe->ctg;
+    pke.cno = ppfe->cno;
+    pke.cactStash = _cactStash;
+    pke.fp = ppfe->flo.fp;
+    pke.cb = ppfe->flo.cb;
+    pke.fPacked = ppfe->fPacked;
+
+    // indexes may have changed, get the location to insert again
+    AssertDo(!_FFindPke(pke.ctg, pke.cno, &ipke), "how did this happen?");
+    if (!_pggpke->FInsert(ipke, cb, PvLockHq(ppfe->hq), &pke))
+    {
+        UnlockHq(ppfe->hq);
+        if (0 == _pggpke->IvMac())
+            ReleasePpo(&_pggpke);
+        return;
+    }
+    UnlockHq(ppfe->hq);
+    _cbPacked += cb;
+
+    if (!_FAddPkq(pke.ctg, pke.cno, pke.cactStash))
+    {
+        // it could never be purged
+        _DeletePke(ipke);
+        return;
+    }
+    _cactStash++;
+}
+
+/***************************************************************************
+    If the chunk's data is in the second tier (and the chunk hasn't
+    changed since it was put there), copy it to *pblck.  The data stays in
+    the second tier, for when the object is tossed again.
+***************************************************************************/
+bool CRF::_FUnstashData(CTG ctg, CNO cno, PBLCK pblck)
+{
+    AssertThis(0);
+    AssertPo(pblck, 0);
+    PKE pke;
+    HQ hq;
+    long ipke, cb;
+
+    if (!_FFreshenPke(ctg, cno))
+        return fFalse;
+
+    AssertDo(_FFindPke(ctg, cno, &ipke), 0);
+    _pggpke->GetFixed(ipke, &pke);
+    cb = _pggpke->Cb(ipke);
+    if (!FAllocHq(&hq, cb, fmemNil, mprNormal))
+        return fFalse;
+    CopyPb(_pggpke->QvGet(ipke), PvLockHq(hq), cb);
+    UnlockHq(hq);
+
+    _cactHitPacked++;
+    pblck->SetHq(&hq, pke.fPacked);
+    return fTrue;
+}
+
+#ifdef DEBUG
+/***************************************************************************
+    Assert the validity of a CRF (chunky resource file).
+***************************************************************************/
+void CRF::AssertValid(ulong grf)
+{
+    CRF_PAR::AssertValid(fobjAllocated);
+    AssertPo(_pglcre, 0);
+    AssertPo(_pglevc, 0);
+    AssertPo(_pcfl, 0);
+    AssertIn(_cbMax, 0, kcbMax);
+    AssertIn(_cbCur, 0, kcbMax);
+    AssertIn(_cactRelease, 0, kcbMax);
+    AssertIn(_cpfe, 0, kcbMax);
+    AssertIn(_cbMaxPacked, 0, kcbMax);
+    AssertIn(_cbPacked, 0, kcbMax);
+    AssertNilOrPo(_pggpke, 0);
+    AssertNilOrPo(_pglpkq, 0);
+    Assert(pvNil != _pggpke || pvNil == _pglpkq, "PKQs without PKEs");
+    AssertIn(_pglevc->IvMac(), 0, _pglcre->IvMac() + 1);
+
+    if (grf & fobjAssertFull)
+    {
+        EVC evc;
+        long ievc;
+
+        for (ievc = _pglevc->IvMac(); ievc-- > 0;)
+        {
+            _pglevc->Get(ievc, &evc);
+            Assert(evc.pbaco->_ievc == ievc, "bad eviction heap index");
+            Assert(evc.pbaco->_fAttached && evc.pbaco->_pcrf == this, "bad BACO in eviction heap");
+            Assert(ievc == 0 || !_FEvcLess(&evc, (EVC *)_pglevc->QvGet((ievc - 1) / 2)), "eviction heap out of order");
+        }
+    }
+}
+
+/***************************************************************************
+    Mark memory used by a CRF.
+***************************************************************************/
+void CRF::MarkMem(void)
+{
+    AssertThis(0);
+    long icre;
+    CRE cre;
+
+    CRF_PAR::MarkMem();
+    MarkMemObj(_pglcre);
+    MarkMemObj(_pglevc);
+    MarkMemObj(_pggpke);
+    MarkMemObj(_pglpkq);
+    MarkMemObj(_pcfl);
+
+    for (icre = _pglcre->IvMac(); icre-- > 0;)
+    {
+        _pglcre->Get(icre, &cre);
+        AssertPo(cre.pbaco, 0);
+        Assert(cre.pbaco->_fAttached, "baco claims to not be attached!");
+        cre.pbaco->_fAttached = fTrue; // safety to avoid infinite recursion
+        MarkMemObj(cre.pbaco);
+    }
+}
+
+/***************************************************************************
+    Static method to mark the memory used by the prefetch queue.  The
+    prefetch thread allocates memory for the entry it's reading before
+    that memory is in the queue, so this waits for the thread to finish
+    the busy entry.
+***************************************************************************/
+void CRF::MarkPrefetches(void)
+{
+    PFE pfe;
+    long ipfe, cpfe;
+
+    for (;;)
+    {
+        _mutxPfe.Enter();
+        if (pvNil == _pglpfe)
+            break;
+        for (ipfe = 0, cpfe = _pglpfe->IvMac(); ipfe < cpfe; ipfe++)
+        {
+            if (pfsBusy == ((PFE *)_pglpfe->QvGet(ipfe))->pfs)
+                break;
+        }
+        if (ipfe == cpfe)
+        {
+            MarkMemObj(_pglpfe);
+            for (ipfe = 0; ipfe < cpfe; ipfe++)
+            {
+                _pglpfe->Get(ipfe, &pfe);
+                MarkHq(pfe.hq);
+            }
+            break;
+        }
+        _mutxPfe.Leave();
+        Win(WaitForSingleObject(_hevtPfe, INFINITE);)
+    }
+    _mutxPfe.Leave();
+}
+#endif // DEBUG
+
+/***************************************************************************
+    Destructor for Chunky resource manager.
+***************************************************************************/
+CRM::~CRM(void)
+{
+    AssertBaseThis(fobjAllocated);
+    long ipcrf;
+    PCRF pcrf;
+
+    if (pvNil != _pglpcrf)
+    {
+        for (ipcrf = _pglpcrf->IvMac(); ipcrf-- > 0;)
+        {
+            _pglpcrf->Get(ipcrf, &pcrf);
+            AssertPo(pcrf, 0);
+            ReleasePpo(&pcrf);
+        }
+        ReleasePpo(&_pglpcrf);
+    }
+    _ReleaseIndex();
+}
+
+/***************************************************************************
+    Static method to create a new CRM.
+***************************************************************************/
+PCRM CRM::PcrmNew(long ccrfInit)
 {
     AssertIn(ccrfInit, 0, kcbMax);
     PCRM pcrm;
@@ -807,7 +1783,7 @@ tribool CRM::TLoad(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc, long crep)
     long ipcrf;
     long cpcrf = _pglpcrf->IvMac();
 
-    for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    for (ipcrf = _IpcrfMin(ctg, cno); ipcrf < cpcrf; ipcrf++)
     {
         _pglpcrf->Get(ipcrf, &pcrf);
         AssertPo(pcrf, 0);
@@ -818,6 +1794,30 @@ tribool CRM::TLoad(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc, long crep)
     return tNo;
 }
 
+/***************************************************************************
+    Start reading the object in the background (see CRF::TPrefetch), from
+    the first CRF that has it.
+***************************************************************************/
+tribool CRM::TPrefetch(CTG ctg, CNO cno, PFNRPO pfnrpo, long crep)
+{
+    AssertThis(0);
+    Assert(pvNil != pfnrpo, "nil object reader");
+    PCRF pcrf;
+    tribool t;
+    long ipcrf;
+    long cpcrf = _pglpcrf->IvMac();
+
+    for (ipcrf = _IpcrfMin(ctg, cno); ipcrf < cpcrf; ipcrf++)
+    {
+        _pglpcrf->Get(ipcrf, &pcrf);
+        AssertPo(pcrf, 0);
+        t = pcrf->TPrefetch(ctg, cno, pfnrpo, crep);
+        if (t != tNo)
+            return t;
+    }
+    return tNo;
+}
+
 /***************************************************************************
     Make sure the object is loaded and increment its reference count.  If
     successful, must be balanced with a call to ReleasePpo.  If this fails,
@@ -835,7 +1835,7 @@ PBACO CRM::PbacoFetch(CTG ctg, CNO cno, PFNRPO pfnrpo, bool *pfError, RSC rsc)
     PBACO pbaco = pvNil;
     long cpcrf = _pglpcrf->IvMac();
 
-    for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    for (ipcrf = _IpcrfMin(ctg, cno); ipcrf < cpcrf; ipcrf++)
     {
         _pglpcrf->Get(ipcrf, &pcrf);
         AssertPo(pcrf, 0);
@@ -878,7 +1878,7 @@ bool CRM::FSetCrep(long crep, CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc)
     long ipcrf;
     long cpcrf = _pglpcrf->IvMac();
 
-    for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    for (ipcrf = _IpcrfMin(ctg, cno); ipcrf < cpcrf; ipcrf++)
     {
         _pglpcrf->Get(ipcrf, &pcrf);
         AssertPo(pcrf, 0);
@@ -899,7 +1899,7 @@ PCRF CRM::PcrfFindChunk(CTG ctg, CNO cno, RSC rsc)
     long ipcrf;
     long cpcrf = _pglpcrf->IvMac();
 
-    for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    for (ipcrf = _IpcrfMin(ctg, cno); ipcrf < cpcrf; ipcrf++)
     {
         _pglpcrf->Get(ipcrf, &pcrf);
         AssertPo(pcrf, 0);
@@ -936,6 +1936,9 @@ bool CRM::FAddCfl(PCFL pcfl, long cbMax, long *piv)
         ReleasePpo(&pcrf);
         return fFalse;
     }
+
+    // the index doesn't know about the new file
+    _ReleaseIndex();
     return fTrue;
 }
 
@@ -956,6 +1959,155 @@ PCRF CRM::PcrfGet(long icrf)
     return pcrf;
 }
 
+// CRMs with fewer CRFs than this just ask each CRF
+const long kcpcrfMinIndex = 2;
+
+/***************************************************************************
+    Hash a (ctg, cno) for the CRM index.
+***************************************************************************/
+priv long _LwHashCtgCno(CTG ctg, CNO cno)
+{
+    ulong lu = (ulong)ctg * 0x9E3779B1 + (ulong)cno;
+
+    lu ^= lu >> 16;
+    lu *= 0x7FEB352D;
+    lu ^= lu >> 15;
+    return (long)(lu & klwMax);
+}
+
+/***************************************************************************
+    Make sure the index from (ctg, cno) to the first CRF that has the chunk
+    is built and up to date.  Returns false if there are too few CRFs to
+    bother with it or we couldn't allocate it, in which case the caller
+    should just ask each CRF.
+***************************************************************************/
+bool CRM::_FEnsureIndex(void)
+{
+    AssertThis(0);
+    long ipcrf, cpcrf, icki, ccki, cckiTot, cslot, islot, islotMask;
+    long cact;
+    PCRF pcrf;
+    PCFL pcfl;
+    CKI cki;
+    CRIE *qrgcrie, *qcrie;
+
+    cpcrf = _pglpcrf->IvMac();
+    if (pvNil != _pglcrie)
+    {
+        if (CFL::CactIndexAll() == _cactIndexAll)
+            return fTrue;
+
+        // some chunky file changed, see if it's one of ours
+        Assert(_pglcactCfl->IvMac() == cpcrf, "wrong number of CFL change counts");
+        for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+        {
+            _pglpcrf->Get(ipcrf, &pcrf);
+            _pglcactCfl->Get(ipcrf, &cact);
+            if (pcrf->Pcfl()->CactIndex() != cact)
+                break;
+        }
+        if (ipcrf == cpcrf)
+        {
+            _cactIndexAll = CFL::CactIndexAll();
+            return fTrue;
+        }
+        _ReleaseIndex();
+    }
+
+    if (cpcrf < kcpcrfMinIndex)
+        return fFalse;
+
+    for (cckiTot = ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    {
+        _pglpcrf->Get(ipcrf, &pcrf);
+        cckiTot += pcrf->Pcfl()->Ccki();
+    }
+
+    // keep the table at most half full
+    for (cslot = 64; cslot < 2 * cckiTot; cslot <<= 1)
+        ;
+
+    if (pvNil == (_pglcrie = GL::PglNew(size(CRIE), cslot)) || !_pglcrie->FSetIvMac(cslot) ||
+        pvNil == (_pglcactCfl = GL::PglNew(size(long), cpcrf)) || !_pglcactCfl->FSetIvMac(cpcrf))
+    {
+        _ReleaseIndex();
+        return fFalse;
+    }
+
+    qrgcrie = (CRIE *)_pglcrie->QvGet(0);
+    FillPb(qrgcrie, LwMul(cslot, size(CRIE)), 0xFF);
+    Assert(ivNil == qrgcrie[0].ipcrf, "FillPb didn't give ivNil");
+    islotMask = cslot - 1;
+    _cactIndexAll = CFL::CactIndexAll();
+
+    // Add the chunks of each file in order.  If an earlier file has the
+    // chunk, it wins, so the entry is left alone.
+    for (ipcrf = 0; ipcrf < cpcrf; ipcrf++)
+    {
+        _pglpcrf->Get(ipcrf, &pcrf);
+        pcfl = pcrf->Pcfl();
+        cact = pcfl->CactIndex();
+        _pglcactCfl->Put(ipcrf, &cact);
+
+        qrgcrie = (CRIE *)_pglcrie->QvGet(0);
+        for (icki = 0, ccki = pcfl->Ccki(); icki < ccki; icki++)
+        {
+            AssertDo(pcfl->FGetCki(icki, &cki), 0);
+            for (islot = _LwHashCtgCno(cki.ctg, cki.cno) & islotMask;; islot = (islot + 1) & islotMask)
+            {
+                qcrie = &qrgcrie[islot];
+                if (ivNil == qcrie->ipcrf)
+                {
+                    qcrie->ctg = cki.ctg;
+                    qcrie->cno = cki.cno;
+                    qcrie->ipcrf = ipcrf;
+                    break;
+                }
+                if (qcrie->ctg == cki.ctg && qcrie->cno == cki.cno)
+                    break;
+            }
+        }
+    }
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Free the index.  It gets rebuilt when it's next needed.
+***************************************************************************/
+void CRM::_ReleaseIndex(void)
+{
+    AssertBaseThis(0);
+    ReleasePpo(&_pglcrie);
+    ReleasePpo(&_pglcactCfl);
+}
+
+/***************************************************************************
+    Return the index of the first CRF that may have the chunk.  The CRFs
+    before it definitely don't.  If none of them has it, returns the number
+    of CRFs.
+***************************************************************************/
+long CRM::_IpcrfMin(CTG ctg, CNO cno)
+{
+    AssertThis(0);
+    long islot, islotMask;
+    CRIE *qrgcrie, *qcrie;
+
+    if (!_FEnsureIndex())
+        return 0;
+
+    qrgcrie = (CRIE *)_pglcrie->QvGet(0);
+    islotMask = _pglcrie->IvMac() - 1;
+    for (islot = _LwHashCtgCno(ctg, cno) & islotMask;; islot = (islot + 1) & islotMask)
+    {
+        qcrie = &qrgcrie[islot];
+        if (ivNil == qcrie->ipcrf)
+            return _pglpcrf->IvMac();
+        if (qcrie->ctg == ctg && qcrie->cno == cno)
+            return qcrie->ipcrf;
+    }
+}
+
 #ifdef DEBUG
 /***************************************************************************
     Check the sanity of the CRM
@@ -964,6 +2116,14 @@ void CRM::AssertValid(ulong grfobj)
 {
     CRM_PAR::AssertValid(grfobj | fobjAllocated);
     AssertPo(_pglpcrf, 0);
+    if (pvNil != _pglcrie)
+    {
+        AssertPo(_pglcrie, 0);
+        AssertPo(_pglcactCfl, 0);
+        Assert(_pglcactCfl->IvMac() == _pglpcrf->IvMac(), "wrong number of CFL change counts");
+    }
+    else
+        Assert(pvNil == _pglcactCfl, "change counts without an index");
 }
 
 /***************************************************************************
@@ -978,6 +2138,8 @@ void CRM::MarkMem(void)
 
     CRM_PAR::MarkMem();
     MarkMemObj(_pglpcrf);
+    MarkMemObj(_pglcrie);
+    MarkMemObj(_pglcactCfl);
 
     for (ipcrf = 0, cpcrf = _pglpcrf->IvMac(); ipcrf < cpcrf; ipcrf++)
     {
@@ -50,6 +50,7 @@ class BACO : public BACO_PAR
     CNO _cno;
     long _crep : 16;
     long _fAttached : 1;
+    long _ievc; // index in the CRF's eviction heap, ivNil if not there
 
     friend class CRF;
 
@@ -110,6 +111,12 @@ class RCA : public RCA_PAR
     virtual PBACO PbacoFind(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil) = 0;
     virtual bool FSetCrep(long crep, CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil) = 0;
     virtual PCRF PcrfFindChunk(CTG ctg, CNO cno, RSC rsc = rscNil) = 0;
+
+    // Background loading.  The chunk is read (and decompressed) on another
+    // thread and the object is built from it by CRF::CompletePrefetches
+    // (at idle time) or by the first TLoad or PbacoFetch of it.
+    virtual tribool TPrefetch(CTG ctg, CNO cno, PFNRPO pfnrpo, long crep = crepNormal) = 0;
+    tribool TPrefetchRgcki(CKI *prgcki, long ccki, PFNRPO pfnrpo, long crep = crepNormal);
 };
 
 /***************************************************************************
@@ -132,17 +139,115 @@ class CRF : public CRF_PAR
         long cb;          // size of data
     };
 
+    // eviction heap entry - an unreferenced BACO that _FPurgeCb may toss.
+    // The fields other than pbaco are copies, so comparisons don't have
+    // to look anything up.
+    struct EVC
+    {
+        BACO *pbaco;      // the object
+        long crep;        // its crep
+        long cactRelease; // when it was last released
+        long cb;          // size of data
+    };
+
+    // prefetch entry - a chunk being read in the background.  The prefetch
+    // queue is shared by all CRFs and protected by _mutxPfe.  Only the main
+    // thread adds or removes entries; the prefetch thread just does the
+    // reading for queued ones.  Data being compressed for the second tier
+    // (see _CaptureData) goes through here too, with fStash set, a nil
+    // pfnrpo and the hq already filled in.
+    struct PFE
+    {
+        PCRF pcrf; // nil if the CRF went away
+        CTG ctg;
+        CNO cno;
+        PFNRPO pfnrpo;
+        long crep;
+        FLO flo;      // where the data is (has a reference count on the pfil)
+        bool fPacked; // the data at flo (or in hq for fStash) is compressed
+        bool fStash;  // read the data for the second tier, not for an object
+        long pfs;     // state - see the pfs enum in crf.cpp
+        HQ hq;        // the data once it's been read, unpacked unless fStash
+        DFR dfr;      // failures on the prefetch thread, for the main thread
+    };
+
+    // packed entry - the chunk data of an object that was loaded, kept so
+    // fetching it again after it's tossed doesn't have to go to the file.
+    // The data is the variable part of the entry in _pggpke.
+    struct PKE
+    {
+        CTG ctg;
+        CNO cno;
+        long cactStash; // when it was stashed, matches its newest PKQ
+        FP fp;          // where the chunk was in the file when it was stashed
+        long cb;
+        bool fPacked;   // the data is compressed
+    };
+
+    // packed entry queue entry - the PKEs in the order they were stashed,
+    // so the oldest can be tossed first.  Entries whose PKE has since been
+    // deleted or stashed again (so its cactStash doesn't match) are stale
+    // and just skipped.
+    struct PKQ
+    {
+        CTG ctg;
+        CNO cno;
+        long cactStash;
+    };
+
+    static PGL _pglpfe;
+    static MUTX _mutxPfe;
+    static bool _fPrefetchThread; // whether the prefetch thread is running
+#ifdef WIN
+    static HANDLE _hevtPfe; // set by the prefetch thread when it finishes one
+#endif // WIN
+
     PCFL _pcfl;
     PGL _pglcre; // sorted by (cki, pfnrpo)
+    PGL _pglevc; // heap of EVCs, the one to toss first is at the top
     long _cbMax;
     long _cbCur;
     long _cactRelease;
+    long _cpfe; // number of entries this CRF has in the prefetch queue
+
+    PGG _pggpke; // PKEs sorted by (ctg, cno), nil if there aren't any
+    PGL _pglpkq; // PKQs, oldest first, nil if there aren't any PKEs
+    long _cbMaxPacked;
+    long _cbPacked;
+    long _cactStash;
+    long _cactHitPacked; // fetches served from the second tier
 
     CRF(PCFL pcfl, long cbMax);
+    tribool _TLoadBlck(CTG ctg, CNO cno, PFNRPO pfnrpo, PBLCK pblck, long crep);
+    bool _FFindBlck(CTG ctg, CNO cno, PFNRPO pfnrpo, PBLCK pblck);
+    bool _FFindPfe(CTG ctg, CNO cno, PFNRPO pfnrpo, long *pipfe);
+    static bool _FQueuePfe(PFE *ppfe);
+    static void _ReleasePfe(PFE *ppfe);
+    static bool _FReadPfe(PFE *ppfe);
+
+    bool _FFindPke(CTG ctg, CNO cno, long *pipke);
+    void _DeletePke(long ipke);
+    bool _FLivePkq(long ipkq, long *pipke);
+    bool _FAddPkq(CTG ctg, CNO cno, long cactStash);
+    bool _FFreshenPke(CTG ctg, CNO cno);
+    void _CaptureData(CTG ctg, CNO cno, PBLCK pblck);
+    void _StashData(CTG ctg, CNO cno);
+    void _StashPfe(PFE *ppfe);
+    bool _FUnstashData(CTG ctg, CNO cno, PBLCK pblck);
+    void _PurgePackedCb(long cbPurge);
+#ifdef WIN
+    static ulong __stdcall _LuPrefetchThread(void *pv);
+#endif // WIN
     bool _FFindCre(CTG ctg, CNO cno, PFNRPO pfnrpo, long *picre);
     bool _FFindBaco(PBACO pbaco, long *picre);
     bool _FPurgeCb(long cbPurge, long crepLast);
 
+    bool _FEvcLess(EVC *pevc1, EVC *pevc2);
+    void _SiftUpEvc(long ievc);
+    void _SiftDownEvc(long ievc);
+    void _UpdateEvc(PBACO pbaco, CRE *pcre);
+    void _RemoveEvc(PBACO pbaco);
+
   public:
     ~CRF(void);
     static PCRF PcrfNew(PCFL pcfl, long cbMax);
@@ -152,6 +257,13 @@ class CRF : public CRF_PAR
     virtual PBACO PbacoFind(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil);
     virtual bool FSetCrep(long crep, CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil);
     virtual PCRF PcrfFindChunk(CTG ctg, CNO cno, RSC rsc = rscNil);
+    virtual tribool TPrefetch(CTG ctg, CNO cno, PFNRPO pfnrpo, long crep = crepNormal);
+
+    static void CompletePrefetches(void);
+    static long CpfePending(void);
+#ifdef DEBUG
+    static void MarkPrefetches(void);
+#endif // DEBUG
 
     long CbMax(void)
     {
@@ -159,6 +271,17 @@ class CRF : public CRF_PAR
     }
     void SetCbMax(long cbMax);
 
+    // second tier cache of the data of tossed objects
+    long CbMaxPacked(void)
+    {
+        return _cbMaxPacked;
+    }
+    void SetCbMaxPacked(long cbMax);
+    long CactHitPacked(void)
+    {
+        return _cactHitPacked;
+    }
+
     PCFL Pcfl(void)
     {
         return _pcfl;
@@ -182,12 +305,27 @@ class CRM : public CRM_PAR
     MARKMEM
 
   protected:
+    // index entry - the first CRF that has the chunk
+    struct CRIE
+    {
+        CTG ctg;
+        CNO cno;
+        long ipcrf; // ivNil for an empty slot
+    };
+
     PGL _pglpcrf;
+    PGL _pglcrie;      // open addressing hash table of CRIEs, built lazily
+    PGL _pglcactCfl;   // CactIndex() of each CRF's CFL when _pglcrie was built
+    long _cactIndexAll; // CFL::CactIndexAll() when _pglcrie was last checked
 
     CRM(void)
     {
     }
 
+    bool _FEnsureIndex(void);
+    void _ReleaseIndex(void);
+    long _IpcrfMin(CTG ctg, CNO cno);
+
   public:
     ~CRM(void);
     static PCRM PcrmNew(long ccrfInit);
@@ -197,6 +335,7 @@ class CRM : public CRM_PAR
     virtual PBACO PbacoFind(CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil);
     virtual bool FSetCrep(long crep, CTG ctg, CNO cno, PFNRPO pfnrpo, RSC rsc = rscNil);
     virtual PCRF PcrfFindChunk(CTG ctg, CNO cno, RSC rsc = rscNil);
+    virtual tribool TPrefetch(CTG ctg, CNO cno, PFNRPO pfnrpo, long crep = crepNormal);
 
     bool FAddCfl(PCFL pcfl, long cbMax, long *piv = pvNil);
     long Ccrf(void)
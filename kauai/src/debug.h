@@ -26,15 +26,20 @@ inline void Debugger(void)
 #ifdef DEBUG
 bool FAssertProc(schar *pszsFile, long lwLine, schar *pszsMsg, void *pv, long cb);
 void WarnProc(schar *pszsFile, long lwLine, schar *pszsMsg);
+
+// These call FAssertProc and WarnProc, unless the current thread is
+// collecting its failures for another thread (see DFR in utilerro.h).
+bool FAssertProcCur(schar *pszsFile, long lwLine, schar *pszsMsg, void *pv, long cb);
+void WarnProcCur(schar *pszsFile, long lwLine, schar *pszsMsg);
 #define ASSERTNAME static schar __szsFile[] = __FILE__;
 
 #define AssertCore(f, szs, pv, cb)                                                                                     \
-    if (!(f) && FAssertProc(__szsFile, __LINE__, (schar *)szs, pv, cb))                                                \
+    if (!(f) && FAssertProcCur(__szsFile, __LINE__, (schar *)szs, pv, cb))                                             \
         Debugger();                                                                                                    \
     else                                                                                                               \
         (void)(0)
 
-#define Warn(szs) WarnProc(__szsFile, __LINE__, (schar *)szs)
+#define Warn(szs) WarnProcCur(__szsFile, __LINE__, (schar *)szs)
 #define Bug(szs) AssertCore(fFalse, szs, 0, 0)
 #define Assert(f, szs) AssertCore(f, szs, 0, 0)
 #define AssertVar(f, szs, pvar) AssertCore(f, szs, pvar, size(*(pvar)))
@@ -47,7 +52,7 @@ void WarnProc(schar *pszsFile, long lwLine, schar *pszsMsg);
 
 // these Asserts are for use in a header file
 #define AssertH(f)                                                                                                     \
-    if (!(f) && FAssertProc(pvNil, __LINE__, pvNil, pvNil, 0))                                                         \
+    if (!(f) && FAssertProcCur(pvNil, __LINE__, pvNil, pvNil, 0))                                                      \
         Debugger();                                                                                                    \
     else                                                                                                               \
         (void)(0)
@@ -43,6 +43,7 @@ FIL::~FIL(void)
 {
     // make sure the file is closed.
     _Close(fTrue);
+    Assert(0 == _cactMapRef && pvNil == _prgbMapOld, "PvMapRef pointers still in use");
 
     _mutxList.Enter();
     _Attach(pvNil);
@@ -221,6 +222,121 @@ void FIL::Release(void)
         delete this;
 }
 
+/***************************************************************************
+    Map the entire file into memory for reading.  Once mapped, FReadRgb
+    is satisfied directly from the view and PvMap can be used to get at
+    the file's bytes without copying them.  Only files that are open read
+    only and deny write can be mapped, since the view is a snapshot of the
+    file's contents and length.  The mapping is dropped if the file
+    becomes write enabled or is closed.  This fails if the platform can't
+    map the file or the views of all the mapped files would take too much
+    of the address space - callers should simply fall back to normal
+    reads.
+***************************************************************************/
+bool FIL::FMap(void)
+{
+    AssertThis(0);
+    bool fRet = fFalse;
+
+    _mutx.Enter();
+
+    if (pvNil != _prgbMap)
+        fRet = fTrue;
+    else if ((_grffil & (ffilWriteEnable | ffilDenyWrite)) == ffilDenyWrite && _el < kelRead)
+    {
+        if (!_fOpen)
+            _FOpen(fFalse, _grffil);
+        if (_fOpen)
+            fRet = _FMap();
+    }
+
+    _mutx.Leave();
+
+    return fRet;
+}
+
+/***************************************************************************
+    Release the memory mapping (if there is one).  Reads go back to the
+    file.
+***************************************************************************/
+void FIL::Unmap(void)
+{
+    AssertThis(0);
+
+    _mutx.Enter();
+    _Unmap();
+    _mutx.Leave();
+}
+
+/***************************************************************************
+    If the file is mapped, return a pointer to the bytes [fp, fp + cb) in
+    the view.  Returns pvNil if the file isn't mapped or the range isn't
+    in the view.  The pointer is valid until the file is unmapped, which
+    can't happen while the file stays read only and open.
+***************************************************************************/
+void *FIL::PvMap(FP fp, long cb)
+{
+    AssertThis(0);
+    AssertIn(cb, 0, kcbMax);
+    void *pv = pvNil;
+
+    _mutx.Enter();
+
+    if (pvNil != _prgbMap && FInFp(fp, 0, _cbMap + 1) && FInFp(cb, 0, _cbMap - fp + 1))
+        pv = _prgbMap + fp;
+
+    _mutx.Leave();
+
+    return pv;
+}
+
+/***************************************************************************
+    Like PvMap, but the caller may hold on to the pointer indefinitely:
+    the view isn't released until the caller calls UnmapRef, even if the
+    file is unmapped or closed first.  The file is AddRef'ed until then.
+    Use this for data that lives longer than the read that produced it.
+***************************************************************************/
+void *FIL::PvMapRef(FP fp, long cb)
+{
+    AssertThis(0);
+    AssertIn(cb, 0, kcbMax);
+    void *pv = pvNil;
+
+    _mutx.Enter();
+
+    if (pvNil != _prgbMap && FInFp(fp, 0, _cbMap + 1) && FInFp(cb, 0, _cbMap - fp + 1))
+    {
+        pv = _prgbMap + fp;
+        _cactMapRef++;
+    }
+
+    _mutx.Leave();
+
+    if (pvNil != pv)
+        AddRef();
+    return pv;
+}
+
+/***************************************************************************
+    Release a pointer returned by PvMapRef.  If the file was unmapped
+    while there were such pointers, this frees the view after the last one
+    is released.
+***************************************************************************/
+void FIL::UnmapRef(void)
+{
+    AssertThis(0);
+
+    _mutx.Enter();
+
+    AssertIn(_cactMapRef, 1, kcbMax);
+    if (0 == --_cactMapRef)
+        _UnmapOld();
+
+    _mutx.Leave();
+
+    Release();
+}
+
 /***************************************************************************
     Get a string representing the path of the file.
 ***************************************************************************/
@@ -357,9 +473,9 @@ void FIL::AssertValid(ulong grf)
 /***************************************************************************
     Determine if the given range is within cbTot.
 ***************************************************************************/
-priv bool _FRangeIn(long cbTot, long cb, long ib)
+priv bool _FRangeIn(long cbTot, long cb, FP ib)
 {
-    return FIn(ib, 0, cbTot + 1) && FIn(cb, 0, cbTot - ib + 1);
+    return FInFp(ib, 0, cbTot + 1) && FIn(cb, 0, cbTot - (long)ib + 1);
 }
 
 /***************************************************************************
@@ -416,6 +532,10 @@ bool FLO::FCopy(PFLO pfloDst)
         return fFalse;
     }
 
+    // if the source is mapped, write straight from the view
+    if (pvNil != (pv = PvMap()))
+        return pfloDst->FWrite(pv);
+
     if (this->cb <= size(rgb) || !FAllocPv(&pv, cbBlock = this->cb, fmemNil, mprForSpeed))
     {
         pv = (void *)rgb;
@@ -469,7 +589,7 @@ bool FLO::FReadHq(HQ *phq, long cbRead, FP dfp)
 /***************************************************************************
     Write the contents of an hq to the flo.
 ***************************************************************************/
-bool FLO::FWriteHq(HQ hq, long dfp)
+bool FLO::FWriteHq(HQ hq, FP dfp)
 {
     AssertThis(0);
     AssertHq(hq);
@@ -614,15 +734,15 @@ LFail:
 void FLO::AssertValid(ulong grfflo)
 {
     AssertPo(pfil, 0);
-    AssertIn(fp, 0, kcbMax);
+    Assert(fp >= 0, "bad fp");
     AssertIn(cb, 0, kcbMax);
     FP fpMac = pfil->FpMac();
 
     if (pfil->ElError() < kelSeek)
     {
-        AssertIn(fp, 0, fpMac + 1);
+        Assert(FInFp(fp, 0, fpMac + 1), "fp past the end of the file");
         if (grfflo & ffloReadable)
-            AssertIn(fp + cb, cb, fpMac + 1);
+            Assert(fp + cb <= fpMac, "flo extends past the end of the file");
     }
 }
 #endif // DEBUG
@@ -860,7 +980,7 @@ bool BLCK::FMoveMin(long dib)
 
     if (pvNil != _flo.pfil)
     {
-        if (!FIn(dib, -_flo.fp, _flo.cb + 1))
+        if (dib > _flo.cb || _flo.fp + dib < 0)
             return fFalse;
         _flo.fp += dib;
         _flo.cb -= dib;
@@ -889,7 +1009,7 @@ bool BLCK::FMoveLim(long dib)
 
     if (pvNil != _flo.pfil)
     {
-        if (!FIn(dib, -_flo.cb, kcbMax - _flo.fp))
+        if (!FIn(dib, -_flo.cb, kcbMax - _flo.cb))
             return fFalse;
         _flo.cb += dib;
         return fTrue;
@@ -1157,6 +1277,50 @@ bool BLCK::FGetFlo(PFLO pflo, bool fPackedOk)
     return fTrue;
 }
 
+/***************************************************************************
+    If the block refers to a range of a memory mapped file, return a
+    pointer to the data in the view.  Otherwise return pvNil and the caller
+    should use FReadRgb, etc.  The pointer is only valid while the block
+    continues to refer to the file.
+***************************************************************************/
+void *BLCK::PvMap(bool fPackedOk)
+{
+    AssertThis(0);
+
+    if (!fPackedOk && _fPacked)
+    {
+        Bug("accessing packed data");
+        return pvNil;
+    }
+
+    if (pvNil == _flo.pfil)
+        return pvNil;
+
+    return _flo.PvMap();
+}
+
+/***************************************************************************
+    If the block is unpacked data on a mapped file, return a pointer to
+    the block's bytes in the file's view and put the file in *ppfil.  The
+    pointer stays valid until the caller calls (*ppfil)->UnmapRef, even if
+    the file is unmapped or closed in the meantime.  Returns pvNil (and
+    sets *ppfil to nil) otherwise.
+***************************************************************************/
+void *BLCK::PvMapRef(PFIL *ppfil)
+{
+    AssertThis(0);
+    AssertVarMem(ppfil);
+    void *pv;
+
+    *ppfil = pvNil;
+    if (_fPacked || pvNil == _flo.pfil)
+        return pvNil;
+
+    if (pvNil != (pv = _flo.pfil->PvMapRef(_flo.fp, _flo.cb)))
+        *ppfil = _flo.pfil;
+    return pv;
+}
+
 /***************************************************************************
     Return whether the block is packed. If the block is compressed, but
     determining the compression type failed, *pcfmt is set to cfmtNil and
@@ -1178,9 +1342,10 @@ bool BLCK::FPacked(long *pcfmt)
 /***************************************************************************
     If the block is unpacked, pack it. If cfmt is cfmtNil, use the default
     packing format, otherwise use the one specified. If the block is
-    already packed, this doesn't change the packing format.
+    already packed, this doesn't change the packing format. luDict is the
+    dictionary to use for kcfmtKauai2Dict.
 ***************************************************************************/
-bool BLCK::FPackData(long cfmt)
+bool BLCK::FPackData(long cfmt, ulong luDict)
 {
     AssertThis(0);
     HQ hq;
@@ -1192,7 +1357,7 @@ bool BLCK::FPackData(long cfmt)
     {
         if (!_flo.FReadHq(&hq))
             return fFalse;
-        if (!vpcodmUtil->FCompressPhq(&hq, cfmt))
+        if (!vpcodmUtil->FCompressPhq(&hq, cfmt, luDict))
         {
             FreePhq(&hq);
             AssertThis(fblckUnpacked | fblckFile);
@@ -1211,7 +1376,7 @@ bool BLCK::FPackData(long cfmt)
             SetHq(&hq, fFalse);
         }
         Assert(_ibMin == 0 && _ibLim == CbOfHq(_hq), 0);
-        if (!vpcodmUtil->FCompressPhq(&_hq, cfmt))
+        if (!vpcodmUtil->FCompressPhq(&_hq, cfmt, luDict))
         {
             AssertThis(fblckUnpacked | fblckMemory);
             return fFalse;
@@ -1232,11 +1397,31 @@ bool BLCK::FUnpackData(void)
 {
     AssertThis(0);
     HQ hq;
+    void *pvSrc;
+    long cb;
+    bool fRet;
 
     if (!_fPacked)
         return fTrue;
 
-    if (pvNil != _flo.pfil)
+    if (pvNil != _flo.pfil && pvNil != (pvSrc = _flo.PvMap()))
+    {
+        // decompress straight out of the mapped file
+        if (!vpcodmUtil->FDecompress(pvSrc, _flo.cb, pvNil, 0, &cb))
+            return fFalse;
+        if (!FAllocHq(&hq, cb, fmemNil, mprNormal))
+            return fFalse;
+        fRet = vpcodmUtil->FDecompress(pvSrc, _flo.cb, PvLockHq(hq), cb, &cb);
+        UnlockHq(hq);
+        if (!fRet)
+        {
+            FreePhq(&hq);
+            AssertThis(fblckPacked | fblckFile);
+            return fFalse;
+        }
+        SetHq(&hq, fFalse);
+    }
+    else if (pvNil != _flo.pfil)
     {
         if (!_flo.FReadHq(&hq))
             return fFalse;
@@ -1273,6 +1458,21 @@ bool BLCK::FUnpackData(void)
     return fTrue;
 }
 
+/***************************************************************************
+    Read a range of the unpacked data. If the block isn't packed, this is
+    the same as FReadRgb. If it is, the block is left packed and only the
+    data needed for the range gets decompressed (for kcfmtBlocked data).
+***************************************************************************/
+bool BLCK::FUnpackRgb(void *pv, long cb, long ib)
+{
+    AssertThis(0);
+    AssertPvCb(pv, cb);
+
+    if (!_fPacked)
+        return FReadRgb(pv, cb, ib);
+    return vpcodmUtil->FDecompressRgbFromBlck(this, pv, cb, ib);
+}
+
 /***************************************************************************
     Return the amount of memory the block is using (roughly).
 ***************************************************************************/
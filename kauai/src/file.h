@@ -27,7 +27,13 @@ const short kboOther = 0x0100;
     Basic types
 ****************************************/
 
-typedef long FP;
+// file positions are 64 bits, so files can be bigger than 2GB
+typedef long long FP;
+
+inline bool FInFp(FP fp, FP fpMin, FP fpLim)
+{
+    return fp >= fpMin && fp < fpLim;
+}
 
 enum
 {
@@ -81,8 +87,16 @@ class FIL : public FIL_PAR
     short _fref;
 #elif defined(WIN)
     HANDLE _hfile;
+    HANDLE _hmap;
 #endif // WIN
 
+    // read-only view of the entire file (see FMap)
+    byte *_prgbMap;
+    FP _cbMap;
+    long _cactMapRef;  // PvMapRef pointers into the view still in use
+    byte *_prgbMapOld; // view unmapped while PvMapRef pointers were in use
+    long _cbMapOld;    // its size
+
     // private methods
     FIL(FNI *pfni, ulong grffil);
     ~FIL(void);
@@ -90,6 +104,9 @@ class FIL : public FIL_PAR
     bool _FOpen(bool fCreate, ulong grffil);
     void _Close(bool fFinal = fFalse);
     void _SetFpPos(FP fp);
+    bool _FMap(void);
+    void _Unmap(void);
+    void _UnmapOld(void);
 
   public:
     // public static members
@@ -141,6 +158,17 @@ class FIL : public FIL_PAR
     }
     void GetStnPath(PSTN pstn);
 
+    // memory mapping of read-only files
+    bool FMap(void);
+    void Unmap(void);
+    bool FMapped(void)
+    {
+        return pvNil != _prgbMap;
+    }
+    void *PvMap(FP fp, long cb);
+    void *PvMapRef(FP fp, long cb);
+    void UnmapRef(void);
+
     bool FSetFpMac(FP fp);
     FP FpMac(void);
     bool FReadRgb(void *pv, long cb, FP fp);
@@ -201,6 +229,10 @@ struct FLO
     {
         return FReadHq(phq, cb, 0);
     }
+    void *PvMap(void)
+    {
+        return pfil->PvMap(fp, cb);
+    }
     bool FTranslate(short osk);
 
     ASSERT
@@ -284,11 +316,18 @@ class BLCK : public BLCK_PAR
     bool FWriteToBlck(PBLCK pblckDst, bool fPackedOk = fFalse);
     bool FGetFlo(PFLO pflo, bool fPackedOk = fFalse);
 
+    // direct access to the data of a block on a mapped file
+    void *PvMap(bool fPackedOk = fFalse);
+    void *PvMapRef(PFIL *ppfil);
+
     // packing and unpacking
     bool FPacked(long *pcfmt = pvNil);
-    bool FPackData(long cfmt = cfmtNil);
+    bool FPackData(long cfmt = cfmtNil, ulong luDict = 0);
     bool FUnpackData(void);
 
+    // reading part of the unpacked data without unpacking the whole block
+    bool FUnpackRgb(void *pv, long cb, long ib);
+
     // Amount of memory being used
     long CbMem(void);
 };
@@ -96,6 +96,33 @@ void FIL::_Close(void)
     _el = elNil;
 }
 
+/***************************************************************************
+    Memory mapping isn't supported on the Mac - FIL::FMap will fail and
+    reads go through the file.
+***************************************************************************/
+bool FIL::_FMap(void)
+{
+    AssertThis(0);
+    return fFalse;
+}
+
+/***************************************************************************
+    Nothing to release on the Mac.
+***************************************************************************/
+void FIL::_Unmap(void)
+{
+    AssertBaseThis(0);
+}
+
+/***************************************************************************
+    Nothing to release on the Mac.
+***************************************************************************/
+void FIL::_UnmapOld(void)
+{
+    AssertBaseThis(0);
+    Assert(pvNil == _prgbMapOld, "Mac doesn't map files");
+}
+
 /***************************************************************************
     Flush the file (and its volume?).
 ***************************************************************************/
@@ -124,7 +151,8 @@ void FIL::_SetFpPos(FP fp)
 bool FIL::FSetFpMac(FP fp)
 {
     AssertThis(0);
-    AssertIn(fp, 0, kcbMax);
+    // Mac file lengths are longs
+    Assert(FInFp(fp, 0, klwMax), "bad fp");
     if (_el >= kelWrite)
         return fFalse;
 
@@ -145,14 +173,14 @@ bool FIL::FSetFpMac(FP fp)
 FP FIL::FpMac(void)
 {
     AssertThis(0);
-    FP fp;
+    long lwEof;
 
-    if (_el < kelSeek && GetEOF(_fref, &fp) != noErr)
+    if (_el < kelSeek && GetEOF(_fref, &lwEof) != noErr)
     {
         _el = kelSeek;
         PushErc(ercFileGeneral);
     }
-    return _el < kelSeek ? fp : 0;
+    return _el < kelSeek ? lwEof : 0;
 }
 
 /***************************************************************************
@@ -162,7 +190,7 @@ bool FIL::FReadRgb(void *pv, long cb, FP fp)
 {
     AssertThis(0);
     AssertIn(cb, 0, kcbMax);
-    AssertIn(fp, 0, klwMax);
+    Assert(FInFp(fp, 0, klwMax), "bad fp");
     AssertPvCb(pv, cb);
 
     Debug(FP dfp = FpMac() - fp;)
@@ -188,7 +216,7 @@ bool FIL::FWriteRgb(void *pv, long cb, FP fp)
 {
     AssertThis(0);
     AssertIn(cb, 0, kcbMax);
-    AssertIn(fp, 0, klwMax);
+    Assert(FInFp(fp, 0, klwMax), "bad fp");
     AssertPvCb(pv, cb);
 
     _SetFpPos(fp);
@@ -13,9 +13,17 @@
 #include "util.h"
 ASSERTNAME
 
-const ulong kfpError = 0xFFFFFFFF;
 priv HANDLE _HfileOpen(PSZ pszFile, bool fCreate, ulong grffil);
 
+// The most address space the views of all the mapped files may use, so
+// mapping every content file can't starve FAllocHq in a 32 bit process.
+// Files that don't fit are just read.
+const long kcbMapTotalMax = 0x10000000; // 256 Megabytes
+
+// the size of all the views (including old ones) - only changed with
+// InterlockedExchangeAdd, since each file maps under its own mutx
+priv long _cbMapTotal;
+
 /***************************************************************************
     Open or create the file by calling CreateFile.  Returns hBadWin on
     failure.
@@ -60,6 +68,8 @@ bool FIL::_FOpen(bool fCreate, ulong grffil)
             fRet = fTrue;
             goto LRet;
         }
+        // a view is only valid while the file is read only
+        _Unmap();
         CloseHandle(_hfile);
         _hfile = hBadWin;
 
@@ -105,6 +115,7 @@ void FIL::_Close(bool fFinal)
 
     if (_fOpen)
     {
+        _Unmap();
         Flush();
         CloseHandle(_hfile);
         _fOpen = fFalse;
@@ -120,6 +131,112 @@ void FIL::_Close(bool fFinal)
     _mutx.Leave();
 }
 
+/***************************************************************************
+    Map the file into memory - assumes the mutx is already entered and the
+    file is open read only.  We only map files on fixed (or RAM) drives.
+    Touching a view of a file on a CD or network share after the media goes
+    away raises an exception instead of failing the read.
+***************************************************************************/
+bool FIL::_FMap(void)
+{
+    AssertThis(0);
+    Assert(_fOpen && !(_grffil & ffilWriteEnable), "mapping a writable file");
+    STN stn;
+    LARGE_INTEGER li;
+    HANDLE hmap;
+    void *pv;
+    long cb;
+
+    // don't map again until the old view is released (see UnmapRef)
+    if (pvNil != _prgbMapOld)
+        return fFalse;
+
+    // find the root of the volume
+    _fni.GetStnPath(&stn);
+    if (stn.Cch() < 3 || stn.Psz()[1] != ChLit(':') || stn.Psz()[2] != ChLit('\\'))
+        return fFalse;
+    stn.Delete(3);
+    switch (GetDriveType(stn.Psz()))
+    {
+    case DRIVE_FIXED:
+    case DRIVE_RAMDISK:
+        break;
+    default:
+        return fFalse;
+    }
+
+    // reserve room for the view in the budget
+    if (!GetFileSizeEx(_hfile, &li) || li.QuadPart <= 0 || li.QuadPart > kcbMapTotalMax)
+        return fFalse;
+    cb = (long)li.QuadPart;
+    if (InterlockedExchangeAdd(&_cbMapTotal, cb) + cb > kcbMapTotalMax)
+        goto LFail;
+
+    if (pvNil == (hmap = CreateFileMapping(_hfile, pvNil, PAGE_READONLY, 0, 0, pvNil)))
+        goto LFail;
+    if (pvNil == (pv = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0)))
+    {
+        CloseHandle(hmap);
+        goto LFail;
+    }
+
+    _hmap = hmap;
+    _prgbMap = (byte *)pv;
+    _cbMap = cb;
+    return fTrue;
+
+LFail:
+    InterlockedExchangeAdd(&_cbMapTotal, -cb);
+    return fFalse;
+}
+
+/***************************************************************************
+    Release the view of the file - assumes the mutx is already entered.
+    If there are PvMapRef pointers into the view, it stays mapped until the
+    last of them is released (see UnmapRef).
+***************************************************************************/
+void FIL::_Unmap(void)
+{
+    AssertBaseThis(0);
+
+    if (pvNil == _prgbMap)
+        return;
+
+    if (_cactMapRef > 0)
+    {
+        Assert(pvNil == _prgbMapOld, "already have an old view");
+        _prgbMapOld = _prgbMap;
+        _cbMapOld = (long)_cbMap;
+    }
+    else
+    {
+        UnmapViewOfFile(_prgbMap);
+        InterlockedExchangeAdd(&_cbMapTotal, -(long)_cbMap);
+    }
+    CloseHandle(_hmap);
+    _hmap = pvNil;
+    _prgbMap = pvNil;
+    _cbMap = 0;
+}
+
+/***************************************************************************
+    Free a view that was kept for PvMapRef pointers after the file was
+    unmapped (see _Unmap), once the last of them is released - assumes
+    the mutx is already entered.
+***************************************************************************/
+void FIL::_UnmapOld(void)
+{
+    AssertBaseThis(0);
+
+    if (pvNil != _prgbMapOld)
+    {
+        UnmapViewOfFile(_prgbMapOld);
+        InterlockedExchangeAdd(&_cbMapTotal, -_cbMapOld);
+        _prgbMapOld = pvNil;
+        _cbMapOld = 0;
+    }
+}
+
 /***************************************************************************
     Flush the file (and its volume?).
 ***************************************************************************/
@@ -145,7 +262,10 @@ void FIL::_SetFpPos(FP fp)
     if (!_fOpen)
         _FOpen(fFalse, _grffil);
 
-    if (_el < kelSeek && SetFilePointer(_hfile, fp, pvNil, FILE_BEGIN) == kfpError)
+    LARGE_INTEGER li;
+
+    li.QuadPart = fp;
+    if (_el < kelSeek && !SetFilePointerEx(_hfile, li, pvNil, FILE_BEGIN))
     {
         PushErc(ercFileGeneral);
         _el = kelSeek;
@@ -158,7 +278,7 @@ void FIL::_SetFpPos(FP fp)
 bool FIL::FSetFpMac(FP fp)
 {
     AssertThis(0);
-    AssertIn(fp, 0, kcbMax);
+    Assert(fp >= 0, "bad fp");
     bool fRet;
 
     _mutx.Enter();
@@ -189,17 +309,23 @@ FP FIL::FpMac(void)
 {
     AssertThis(0);
     FP fp;
+    LARGE_INTEGER li;
 
     _mutx.Enter();
 
     if (!_fOpen)
         _FOpen(fFalse, _grffil);
 
-    if (_el < kelSeek && (fp = SetFilePointer(_hfile, 0, pvNil, FILE_END)) == kfpError)
+    li.QuadPart = 0;
+    if (pvNil != _prgbMap)
+        fp = _cbMap;
+    else if (_el < kelSeek && !SetFilePointerEx(_hfile, li, &li, FILE_END))
     {
         PushErc(ercFileGeneral);
         _el = kelSeek;
     }
+    else
+        fp = li.QuadPart;
 
     if (_el >= kelSeek)
         fp = 0;
@@ -216,7 +342,7 @@ bool FIL::FReadRgb(void *pv, long cb, FP fp)
 {
     AssertThis(0);
     AssertIn(cb, 0, kcbMax);
-    AssertIn(fp, 0, klwMax);
+    Assert(fp >= 0, "bad fp");
     AssertPvCb(pv, cb);
 
     long cbT;
@@ -230,6 +356,24 @@ bool FIL::FReadRgb(void *pv, long cb, FP fp)
     if (!_fOpen)
         _FOpen(fFalse, _grffil);
 
+    if (pvNil != _prgbMap && _el < kelRead)
+    {
+        // satisfy the read from the view
+        if (FInFp(fp, 0, _cbMap) && FInFp(cb, 1, _cbMap - fp + 1))
+        {
+            CopyPb(_prgbMap + fp, pv, cb);
+            fRet = fTrue;
+        }
+        else
+        {
+            Bug("read past EOF");
+            PushErc(ercFileGeneral);
+            _el = kelRead;
+        }
+        _mutx.Leave();
+        return fRet;
+    }
+
     Debug(FP dfp = FpMac() - fp;)
 
         _SetFpPos(fp);
@@ -258,7 +402,7 @@ bool FIL::FWriteRgb(void *pv, long cb, FP fp)
 {
     AssertThis(0);
     AssertIn(cb, 0, kcbMax);
-    AssertIn(fp, 0, klwMax);
+    Assert(fp >= 0, "bad fp");
     AssertPvCb(pv, cb);
 
     long cbT;
@@ -44,6 +44,9 @@
 #define cfmtNil 0
 #define kcfmtKauai 'KCDC'
 #define kcfmtKauai2 'KCD2'
+#define kcfmtKauaiFast 'KCDF'
+#define kcfmtBlocked 'KCBK'    // independently packed blocks - see codec.cpp
+#define kcfmtKauai2Dict 'KCDD' // KCD2 primed with a shared dictionary - see codec.cpp
 
 /***************************************************************************
     For flushing events.
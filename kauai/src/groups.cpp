@@ -46,6 +46,7 @@ RTCLASS(AG)
 GRPB::~GRPB(void)
 {
     AssertThis(0);
+    _ReleaseView();
     FreePhq(&_hqData1);
     FreePhq(&_hqData2);
 }
@@ -59,6 +60,10 @@ bool GRPB::_FEnsureSizes(long cbMin1, long cbMin2, ulong grfgrp)
     AssertThis(0);
     Assert(cbMin1 >= 0 && cbMin2 >= 0, "negative sizes");
 
+    // a view can't be resized, so get our own copy of the data first
+    if (pvNil != _pbView && !_FCopyView())
+        return fFalse;
+
     if (grfgrp & fgrpShrink)
     {
         // shrink anything that's too big
@@ -199,6 +204,11 @@ bool GRPB::_FWrite(PBLCK pblck, void *pv, long cb, long cb1, long cb2)
     if (!pblck->FWriteRgb(pv, cb, 0))
         return fFalse;
 
+    if (pvNil != _pbView)
+    {
+        // a view doesn't move, so there's nothing to lock
+        return (cb1 == 0 || pblck->FWriteRgb(_Qb1(0), cb1, cb)) && (cb2 == 0 || pblck->FWriteRgb(_Qb2(0), cb2, cb + cb1));
+    }
     if (cb1 > 0)
     {
         fRet = pblck->FWriteRgb(PvLockHq(_hqData1), cb1, cb);
@@ -231,6 +241,8 @@ bool GRPB::_FReadData(PBLCK pblck, long cb1, long cb2, long ib)
 
     if (cb1 == 0 && cb2 == 0)
         return fTrue;
+    if (_fReadView && _FReadView(pblck, cb1, cb2, ib))
+        return fTrue;
     if (!_FEnsureSizes(cb1, cb2, fgrpNil))
         return fFalse;
 
@@ -252,6 +264,136 @@ bool GRPB::_FReadData(PBLCK pblck, long cb1, long cb2, long ib)
     return fTrue;
 }
 
+// groups smaller than this are copied rather than viewed in a mapped file
+const long kcbMinMapView = 0x00010000;
+
+/***************************************************************************
+    Make the group a view of the two sections of data at the given
+    location in the block, rather than copying them into our own hq's.
+    If the block is on a mapped file and the data is at least
+    kcbMinMapView bytes, the view points into the file's (read only)
+    mapping, which stays around until the view is released (see
+    FIL::PvMapRef).  Otherwise we take the block's (unpacked) data, so the
+    block is empty afterwards - for a block on a file, this reads the data
+    into an hq.  A view of the file gets its own copy of the data when it's
+    first written to (see _FEnsureWritable), and any view does when it
+    first needs to change size (see _FCopyView).  Returns false if we
+    can't make a view, in which case the block is untouched.
+***************************************************************************/
+bool GRPB::_FReadView(PBLCK pblck, long cb1, long cb2, long ib)
+{
+    AssertPo(pblck, fblckUnpacked);
+    AssertIn(cb1, 0, kcbMax);
+    AssertIn(cb2, 0, kcbMax);
+    Assert(cb1 + cb2 > 0, "empty view");
+    Assert(pvNil == _pbView && hqNil == _hqData1 && hqNil == _hqData2, "group already has data");
+    HQ hq;
+    void *pv;
+    long lwAlign = cb2 > 0 ? cb1 : 0;
+
+    // the sections must be long aligned, since section 2 holds the LOC's
+    // (or bst's) of a GG (or GST)
+    if (cb1 + cb2 >= kcbMinMapView && pvNil != (pv = pblck->PvMapRef(&_pfilView)))
+    {
+        _pbView = (byte *)pv + ib;
+        if ((((long)(size_t)_pbView | lwAlign) & (size(long) - 1)) != 0)
+        {
+            _ReleaseView();
+            return fFalse;
+        }
+    }
+    else
+    {
+        if (((ib | lwAlign) & (size(long) - 1)) != 0 || hqNil == (hq = pblck->HqFree()))
+            return fFalse;
+        if (CbOfHq(hq) < ib + cb1 + cb2)
+        {
+            Bug("block got smaller");
+            pblck->SetHq(&hq);
+            return fFalse;
+        }
+        _hqView = hq;
+        _pbView = (byte *)PvLockHq(hq) + ib;
+    }
+
+    _cb1 = cb1;
+    _cb2 = cb2;
+    return fTrue;
+}
+
+/***************************************************************************
+    Copy the data out of the view into our own hq's, so the group can be
+    resized like any other.
+***************************************************************************/
+bool GRPB::_FCopyView(void)
+{
+    AssertPvCb(_pbView, _cb1 + _cb2);
+    HQ hq1 = hqNil;
+    HQ hq2 = hqNil;
+    long ib;
+
+    if (hqNil != _hqView && _cb2 == 0)
+    {
+        // just keep the block's hq (this is the common case of a GL)
+        ib = _pbView - (byte *)QvFromHq(_hqView);
+        if (ib > 0)
+            BltPb(_pbView, _pbView - ib, _cb1);
+        UnlockHq(_hqView);
+        if (CbOfHq(_hqView) > _cb1)
+            AssertDo(FResizePhq(&_hqView, _cb1, fmemNil, mprNormal), 0);
+        _hqData1 = _hqView;
+        _hqView = hqNil;
+        _pbView = pvNil;
+        return fTrue;
+    }
+
+    if (_cb1 > 0 && !FAllocHq(&hq1, _cb1, fmemNil, mprNormal) || _cb2 > 0 && !FAllocHq(&hq2, _cb2, fmemNil, mprNormal))
+    {
+        FreePhq(&hq1);
+        FreePhq(&hq2);
+        return fFalse;
+    }
+    if (_cb1 > 0)
+        CopyPb(_pbView, QvFromHq(hq1), _cb1);
+    if (_cb2 > 0)
+        CopyPb(_pbView + _cb1, QvFromHq(hq2), _cb2);
+
+    _ReleaseView();
+    _hqData1 = hq1;
+    _hqData2 = hq2;
+    return fTrue;
+}
+
+/***************************************************************************
+    A view of a mapped file is read only, so copy the data into our own
+    hq's before writing to it.  Other groups can be written in place.
+    Returns false if the copy fails, in which case the group is unchanged.
+***************************************************************************/
+bool GRPB::_FEnsureWritable(void)
+{
+    if (pvNil == _pfilView)
+        return fTrue;
+    return _FCopyView();
+}
+
+/***************************************************************************
+    Free the view (if there is one).  This doesn't touch _cb1 or _cb2.
+***************************************************************************/
+void GRPB::_ReleaseView(void)
+{
+    if (hqNil != _hqView)
+    {
+        UnlockHq(_hqView);
+        FreePhq(&_hqView);
+    }
+    if (pvNil != _pfilView)
+    {
+        _pfilView->UnmapRef();
+        _pfilView = pvNil;
+    }
+    _pbView = pvNil;
+}
+
 #ifdef DEBUG
 /***************************************************************************
     Assert the validity of the grpb stuff.
@@ -261,6 +403,16 @@ void GRPB::AssertValid(ulong grfobj)
     GRPB_PAR::AssertValid(grfobj | fobjAllocated);
     AssertIn(_cb1, 0, kcbMax);
     AssertIn(_cb2, 0, kcbMax);
+    if (pvNil != _pbView)
+    {
+        Assert(_hqData1 == hqNil && _hqData2 == hqNil, "view has data hq's");
+        Assert((hqNil == _hqView) != (pvNil == _pfilView), "bad view");
+        Assert(_cb1 + _cb2 > 0, "empty view");
+        Assert(hqNil == _hqView || _pbView + _cb1 + _cb2 <= (byte *)QvFromHq(_hqView) + CbOfHq(_hqView),
+               "view past end of hq");
+        return;
+    }
+    Assert(hqNil == _hqView && pvNil == _pfilView, "view data but no view");
     Assert((_cb1 == 0) == (_hqData1 == hqNil), "cb's don't match _hqData1");
     Assert((_cb2 == 0) == (_hqData2 == hqNil), "cb's don't match _hqData2");
     Assert(_hqData1 == hqNil || CbOfHq(_hqData1) == _cb1, "_hqData1 wrong size");
@@ -276,6 +428,7 @@ void GRPB::MarkMem(void)
     GRPB_PAR::MarkMem();
     MarkHq(_hqData1);
     MarkHq(_hqData2);
+    MarkHq(_hqView);
 }
 #endif // DEBUG
 
@@ -331,6 +484,10 @@ void GLB::Put(long iv, void *pv)
     AssertThis(0);
     AssertIn(iv, 0, _ivMac);
     AssertPvCb(pv, _cbEntry);
+
+    if (!_FEnsureWritable())
+        return;
+
     CopyPb(pv, QvGet(iv), _cbEntry);
     AssertThis(0);
 }
@@ -423,6 +580,36 @@ PGL GL::PglRead(PFIL pfil, FP fp, long cb, short *pbo, short *posk)
     return PglRead(&blck, pbo, posk);
 }
 
+/***************************************************************************
+    Like PglRead, but the list may be a view of the block's data rather
+    than a copy of it (see GRPB::_FReadView).  The block's data may be
+    taken, so the block shouldn't be used afterwards.  A view may be read
+    only memory, so only change the list through its methods, not through
+    QvGet or PvLock pointers.
+***************************************************************************/
+PGL GL::PglReadView(PBLCK pblck, short *pbo, short *posk)
+{
+    AssertPo(pblck, 0);
+    AssertNilOrVarMem(pbo);
+    AssertNilOrVarMem(posk);
+    PGL pgl;
+
+    if ((pgl = NewObj GL(4)) == pvNil)
+        goto LFail;
+    pgl->_fReadView = fTrue;
+    if (!pgl->_FRead(pblck, pbo, posk))
+    {
+        ReleasePpo(&pgl);
+    LFail:
+        TrashVar(pbo);
+        TrashVar(posk);
+        return pvNil;
+    }
+    pgl->_fReadView = fFalse;
+    AssertPo(pgl, 0);
+    return pgl;
+}
+
 /***************************************************************************
     Constructor for GL.
 ***************************************************************************/
@@ -514,6 +701,7 @@ bool GL::_FRead(PBLCK pblck, short *pbo, short *posk)
     AssertNilOrVarMem(posk);
 
     GLF glf;
+    short bo;
     long cb;
     bool fRet = fFalse;
 
@@ -532,7 +720,7 @@ bool GL::_FRead(PBLCK pblck, short *pbo, short *posk)
     if (posk != pvNil)
         *posk = glf.osk;
 
-    if (glf.bo == kboOther)
+    if ((bo = glf.bo) == kboOther)
         SwapBytesBom(&glf, kbomGlf);
 
     cb -= size(glf);
@@ -547,6 +735,10 @@ bool GL::_FRead(PBLCK pblck, short *pbo, short *posk)
     _ivMac = glf.ivMac;
     fRet = _FReadData(pblck, cb, 0, size(glf));
 
+    // the caller swaps the entries in place
+    if (bo == kboOther && fRet)
+        fRet = _FEnsureWritable();
+
 LFail:
     TrashVarIf(!fRet, pbo);
     TrashVarIf(!fRet, posk);
@@ -566,6 +758,9 @@ bool GL::FInsert(long iv, void *pv, long cv)
     byte *qb;
     long cbTot, cbIns, ibIns;
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     cbTot = LwMul(_ivMac + cv, _cbEntry);
     cbIns = LwMul(cv, _cbEntry);
     ibIns = LwMul(iv, _cbEntry);
@@ -603,6 +798,9 @@ void GL::Delete(long ivMin, long cv)
     AssertIn(ivMin, 0, _ivMac);
     AssertIn(cv, 1, _ivMac - ivMin + 1);
 
+    if (!_FEnsureWritable())
+        return;
+
     if (ivMin < (_ivMac -= cv))
     {
         byte *qb = _Qb1(LwMul(ivMin, _cbEntry));
@@ -626,6 +824,9 @@ void GL::Move(long ivSrc, long ivTarget)
     AssertIn(ivSrc, 0, _ivMac);
     AssertIn(ivTarget, 0, _ivMac + 1);
 
+    if (!_FEnsureWritable())
+        return;
+
     MoveElement(_Qb1(0), _cbEntry, ivSrc, ivTarget);
     AssertThis(0);
 }
@@ -662,6 +863,9 @@ bool GL::FPop(void *pv)
         TrashPvCb(pv, _cbEntry);
         return fFalse;
     }
+    if (!_FEnsureWritable())
+        return fFalse;
+
     if (pv != pvNil)
         Get(_ivMac - 1, pv);
     _ivMac--;
@@ -679,6 +883,9 @@ bool GL::FSetIvMac(long ivMacNew)
     AssertIn(ivMacNew, 0, kcbMax);
     long cb;
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     if (ivMacNew > _ivMac)
     {
         if (ivMacNew > kcbMax / _cbEntry)
@@ -1097,12 +1304,14 @@ bool GGB::_FDup(PGGB pggbDst)
     AssertPo(pggbDst, fobjAssertFull);
     Assert(_cbFixed == pggbDst->_cbFixed, "why do these have different sized fixed portions?");
 
+    _CloseGaps();
     if (!GGB_PAR::_FDup(pggbDst, _bvMac, LwMul(_ivMac, size(LOC))))
         return fFalse;
 
     pggbDst->_bvMac = _bvMac;
     pggbDst->_clocFree = _clocFree;
     pggbDst->_cbFixed = _cbFixed;
+    pggbDst->_fGapped = _fGapped;
     AssertPo(pggbDst, fobjAssertFull);
 
     return fTrue;
@@ -1126,7 +1335,7 @@ const BOM kbomGgf = 0x5FF00000L;
 long GGB::CbOnFile(void)
 {
     AssertThis(fobjAssertFull);
-    return size(GGF) + LwMul(_ivMac, size(LOC)) + _bvMac;
+    return size(GGF) + LwMul(_ivMac, size(LOC)) + _bvMac - _cbHole;
 }
 
 /***************************************************************************
@@ -1143,6 +1352,11 @@ bool GGB::FWrite(PBLCK pblck, short bo, short osk)
     GGF ggf;
     bool fRet;
 
+    // the loc's are swapped in place
+    if (kboOther == bo && !_FEnsureWritable())
+        return fFalse;
+
+    _CloseGaps();
     ggf.bo = kboCur;
     ggf.osk = osk;
     ggf.ilocMac = _ivMac;
@@ -1218,6 +1432,9 @@ bool GGB::_FRead(PBLCK pblck, short *pbo, short *posk)
     _cbFixed = ggf.cbFixed;
     fRet = _FReadData(pblck, cb - cbT, cbT, size(ggf));
     AssertBomRglw(kbomLoc, size(LOC));
+    // the loc's are swapped here and the data by the caller
+    if (bo == kboOther && fRet)
+        fRet = _FEnsureWritable();
     if (bo == kboOther && fRet)
     {
         // adjust the byte order on the loc's.
@@ -1268,15 +1485,15 @@ bool GGB::FEnsureSpace(long cvAdd, long cbAdd, ulong grfgrp)
         clocAdd = LwMax(0, cvAdd - _clocFree);
 
     // we waste at most (size(long) - 1) bytes per element
-    if (clocAdd > kcbMax / size(LOC) - _ivMac || cvAdd > (kcbMax / (_cbFixed + size(long) - 1)) - _bvMac ||
+    if (clocAdd > kcbMax / size(LOC) - _ivMac - _clocGap || cvAdd > (kcbMax / (_cbFixed + size(long) - 1)) - _bvMac ||
         cbAdd > kcbMax - _bvMac - cvAdd * (_cbFixed + size(long) - 1))
     {
         Bug("why is this group growing so large?");
         return fFalse;
     }
 
-    return _FEnsureSizes(_bvMac + cbAdd + LwMul(cvAdd, _cbFixed + size(long) - 1), LwMul(_ivMac + clocAdd, size(LOC)),
-                         grfgrp);
+    return _FEnsureSizes(_bvMac + cbAdd + LwMul(cvAdd, _cbFixed + size(long) - 1),
+                         LwMul(_ivMac + _clocGap + clocAdd, size(LOC)), grfgrp);
 }
 
 /***************************************************************************
@@ -1303,6 +1520,17 @@ void GGB::_RemoveRgb(long bv, long cb)
     Assert(cb == CbRoundToLong(cb), "cb not divisible by size(long)");
     byte *qb;
 
+    if (_fGapped && (bv = CbRoundToLong(bv)) + cb < _bvMac)
+    {
+        // leave a hole tagged with its size - see _SqueezeHoles
+        qb = _Qb1(bv);
+        TrashPvCb(qb, cb);
+        *(long *)qb = cb;
+        if (2 * (_cbHole += cb) > _bvMac)
+            _SqueezeHoles();
+        return;
+    }
+
     if (bv + cb < _bvMac)
     {
         qb = _Qb1(bv);
@@ -1324,13 +1552,15 @@ void GGB::_AdjustLocs(long bvMin, long bvLim, long dcb)
     AssertIn(bvLim, bvMin, _bvMac + 2);
     AssertIn(dcb, -_bvMac, kcbMax);
     Assert((dcb % size(long)) == 0, "dcb not divisible by size(long)");
-    long cloc;
+    long iloc;
     LOC *qloc;
 
     if (FIn(_bvMac, bvMin, bvLim))
         _bvMac += dcb;
-    for (qloc = _Qloc(0), cloc = _ivMac; cloc > 0; cloc--, qloc++)
+    for (qloc = (LOC *)_Qb2(0), iloc = 0; iloc < _ivMac; iloc++, qloc++)
     {
+        if (iloc == _ilocGap)
+            qloc += _clocGap;
         if (bvNil == qloc->bv)
             continue;
         if (FIn(qloc->bv, bvMin, bvLim))
@@ -1339,6 +1569,97 @@ void GGB::_AdjustLocs(long bvMin, long bvLim, long dcb)
     }
 }
 
+/***************************************************************************
+    Move the gap in the rgloc so it starts at iloc.  A gap at the end is
+    just spare room, so it's dropped.
+***************************************************************************/
+void GGB::_MoveLocGap(long iloc)
+{
+    AssertBaseThis(0);
+    AssertIn(iloc, 0, _ivMac + 1);
+    byte *qb;
+
+    if (_clocGap > 0 && iloc != _ilocGap)
+    {
+        qb = _Qb2(0);
+        if (iloc < _ilocGap)
+        {
+            BltPb(qb + LwMul(iloc, size(LOC)), qb + LwMul(iloc + _clocGap, size(LOC)),
+                  LwMul(_ilocGap - iloc, size(LOC)));
+        }
+        else
+        {
+            BltPb(qb + LwMul(_ilocGap + _clocGap, size(LOC)), qb + LwMul(_ilocGap, size(LOC)),
+                  LwMul(iloc - _ilocGap, size(LOC)));
+        }
+    }
+    _ilocGap = iloc;
+    if (iloc == _ivMac)
+        _clocGap = 0;
+}
+
+/***************************************************************************
+    Slide the data of a gapped group down over its holes.  Each hole starts
+    with its size.  The first long of each element is swapped with the
+    element's loc.bv and replaced by ~iloc (which is negative), so one pass
+    over the data can tell elements from holes without any extra memory.
+***************************************************************************/
+void GGB::_SqueezeHoles(void)
+{
+    AssertBaseThis(0);
+    long iloc, bvSrc, bvDst, cb, lw;
+    LOC *qloc;
+    byte *qb;
+
+    qb = _Qb1(0);
+    for (iloc = 0; iloc < _ivMac; iloc++)
+    {
+        qloc = _Qloc(iloc);
+        if (bvNil == qloc->bv || 0 == qloc->cb)
+            continue;
+        lw = *(long *)(qb + qloc->bv);
+        *(long *)(qb + qloc->bv) = ~iloc;
+        qloc->bv = lw;
+    }
+
+    for (bvSrc = bvDst = 0; bvSrc < _bvMac; bvSrc += cb)
+    {
+        lw = *(long *)(qb + bvSrc);
+        if (lw >= 0)
+        {
+            // a hole
+            AssertIn(lw, size(long), _bvMac - bvSrc + 1);
+            cb = lw;
+            continue;
+        }
+
+        qloc = _Qloc(~lw);
+        cb = CbRoundToLong(qloc->cb);
+        *(long *)(qb + bvSrc) = qloc->bv;
+        qloc->bv = bvDst;
+        if (bvDst < bvSrc)
+            BltPb(qb + bvSrc, qb + bvDst, cb);
+        bvDst += cb;
+    }
+    Assert(_bvMac - bvDst == _cbHole, "holes don't add up");
+    TrashPvCb(qb + bvDst, _bvMac - bvDst);
+    _bvMac = bvDst;
+    _cbHole = 0;
+}
+
+/***************************************************************************
+    Remove the gap in the rgloc and the holes in the data, so the group
+    is laid out the way an ungapped one is.
+***************************************************************************/
+void GGB::_CloseGaps(void)
+{
+    AssertBaseThis(0);
+
+    _MoveLocGap(_ivMac);
+    if (_cbHole > 0)
+        _SqueezeHoles();
+}
+
 /***************************************************************************
     Returns a volative pointer the the fixed sized data in the element.
     If pcbVar is not nil, fills *pcbVar with the size of the variable part.
@@ -1401,6 +1722,9 @@ void GGB::PutFixed(long iv, void *pv)
 
     LOC loc;
 
+    if (!_FEnsureWritable())
+        return;
+
     loc = *_Qloc(iv);
     AssertIn(loc.cb, _cbFixed, _bvMac - loc.bv + 1);
     CopyPb(pv, _Qb1(loc.bv), _cbFixed);
@@ -1479,6 +1803,9 @@ void GGB::Put(long iv, void *pv)
 
     LOC loc;
 
+    if (!_FEnsureWritable())
+        return;
+
     loc = *_Qloc(iv);
     AssertPvCb(pv, loc.cb - _cbFixed);
     CopyPb(pv, _Qb1(loc.bv + _cbFixed), loc.cb - _cbFixed);
@@ -1497,6 +1824,9 @@ bool GGB::FPut(long iv, long cb, void *pv)
 
     long cbCur = Cb(iv);
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     if (cb > cbCur)
     {
         if (!FInsertRgb(iv, cbCur, cb - cbCur, pvNil))
@@ -1547,6 +1877,9 @@ void GGB::PutRgb(long iv, long bv, long cb, void *pv)
 
     LOC loc;
 
+    if (!_FEnsureWritable())
+        return;
+
     bv += _cbFixed;
     loc = *_Qloc(iv);
     AssertIn(bv, _cbFixed, loc.cb);
@@ -1570,6 +1903,9 @@ void GGB::DeleteRgb(long iv, long bv, long cb)
     long cbDel;
     byte *qb;
 
+    if (!_FEnsureWritable())
+        return;
+
     bv += _cbFixed;
     loc = *_Qloc(iv);
     AssertIn(bv, _cbFixed, loc.cb);
@@ -1582,17 +1918,18 @@ void GGB::DeleteRgb(long iv, long bv, long cb)
         BltPb(qb + cb, qb, loc.cb - bv - cb);
     }
 
-    // determine the number of bytes to nuke
-    cbDel = CbRoundToLong(loc.cb) - CbRoundToLong(loc.cb - cb);
-    if (cbDel > 0)
-        _RemoveRgb(loc.bv + loc.cb - cb, cbDel);
-
     qloc = _Qloc(iv);
     if (0 == (qloc->cb -= cb))
     {
         Assert(_cbFixed == 0, "oops!");
         qloc->bv = 0; // empty element
     }
+
+    // determine the number of bytes to nuke - the loc has to be updated
+    // first since this can squeeze a gapped group
+    cbDel = CbRoundToLong(loc.cb) - CbRoundToLong(loc.cb - cb);
+    if (cbDel > 0)
+        _RemoveRgb(loc.bv + loc.cb - cb, cbDel);
     AssertThis(0);
 }
 
@@ -1611,6 +1948,9 @@ bool GGB::FInsertRgb(long iv, long bv, long cb, void *pv)
     long cbAdd;
     byte *qb;
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     bv += _cbFixed;
     loc = *_Qloc(iv);
     AssertIn(bv, _cbFixed, loc.cb + 1);
@@ -1621,15 +1961,28 @@ bool GGB::FInsertRgb(long iv, long bv, long cb, void *pv)
     cbAdd = CbRoundToLong(loc.cb + cb) - CbRoundToLong(loc.cb);
     if (cbAdd > 0)
     {
-        long bvT;
+        long bvT, cbOld;
 
         if (!_FEnsureSizes(_bvMac + cbAdd, LwMul(_ivMac, size(LOC)), fgrpNil))
             return fFalse;
 
-        // move later entries back
-        bvT = loc.bv + CbRoundToLong(loc.cb);
-        if (bvT < _bvMac)
+        bvT = loc.bv + (cbOld = CbRoundToLong(loc.cb));
+        if (_fGapped && bvT < _bvMac && cbOld < _bvMac - bvT &&
+            _FEnsureSizes(_bvMac + cbOld + cbAdd, LwMul(_ivMac, size(LOC)), fgrpNil))
+        {
+            // it's cheaper to move this element to the end than to move
+            // everything after it, so leave a hole behind
+            qb = _Qb1(loc.bv);
+            CopyPb(qb, _Qb1(_bvMac), cbOld);
+            TrashPvCb(qb, cbOld);
+            *(long *)qb = cbOld;
+            _cbHole += cbOld;
+            loc.bv = _bvMac;
+            _bvMac += cbOld + cbAdd;
+        }
+        else if (bvT < _bvMac)
         {
+            // move later entries back
             qb = _Qb1(bvT);
             BltPb(qb, qb + cbAdd, _bvMac - bvT);
             _AdjustLocs(loc.bv + 1, _bvMac + 1, cbAdd);
@@ -1653,9 +2006,12 @@ bool GGB::FInsertRgb(long iv, long bv, long cb, void *pv)
     else
         TrashPvCb(_Qb1(loc.bv + bv), cb);
 
-    // copy the entire loc in case loc.bv got set to _bvMac (if the item was empty)
+    // copy the entire loc in case loc.bv got set to _bvMac (if the item was
+    // empty or got moved)
     loc.cb += cb;
     *_Qloc(iv) = loc;
+    if (2 * _cbHole > _bvMac)
+        _SqueezeHoles();
     AssertThis(0);
     return fTrue;
 }
@@ -1680,6 +2036,9 @@ bool GGB::FMoveRgb(long ivSrc, long bvSrc, long ivDst, long bvDst, long cb)
     LOC locSrc, locDst;
     long cbMove, cbT;
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     locSrc = *_Qloc(ivSrc);
     locDst = *_Qloc(ivDst);
 
@@ -1759,6 +2118,9 @@ void GGB::Merge(long ivSrc, long ivDst)
     long cb, cbMove, bv;
     byte rgb[size(long)];
 
+    if (!_FEnsureWritable())
+        return;
+
     cb = Cb(ivSrc);
     cbMove = LwRoundToward(cb, size(long));
     if (cb > cbMove)
@@ -1799,9 +2161,12 @@ void GGB::AssertValid(ulong grfobj)
     AssertIn(_ivMac, 0, kcbMax);
     AssertIn(_bvMac, 0, kcbMax);
     Assert(_Cb1() >= _bvMac, "group area too small");
-    Assert(_Cb2() >= LwMul(_ivMac, size(LOC)), "rgloc area too small");
+    Assert(_Cb2() >= LwMul(_ivMac + _clocGap, size(LOC)), "rgloc area too small");
     Assert(_clocFree == cvNil || _clocFree == 0 || _clocFree > 0 && _clocFree < _ivMac, "_clocFree is wrong");
     AssertIn(_cbFixed, 0, kcbMax);
+    Assert(_fGapped || 0 == _clocGap && 0 == _cbHole, "ungapped group has gaps");
+    Assert(0 == _clocGap || FIn(_ilocGap, 0, _ivMac), "bad rgloc gap");
+    AssertIn(_cbHole, 0, _bvMac + 1);
 
     if (grfobj & fobjAssertFull)
     {
@@ -1822,7 +2187,7 @@ void GGB::AssertValid(ulong grfobj)
             Assert(loc.bv + loc.cb <= _bvMac, "loc extends past _bvMac");
             cbTot += loc.cb;
         }
-        Assert(cbTot == _bvMac, "group wrong size");
+        Assert(cbTot + _cbHole == _bvMac, "group wrong size");
         Assert(clocFree == _clocFree || _clocFree == cvNil && clocFree == 0, "bad _clocFree");
     }
 }
@@ -1885,6 +2250,36 @@ PGG GG::PggRead(PFIL pfil, FP fp, long cb, short *pbo, short *posk)
     return PggRead(&blck, pbo, posk);
 }
 
+/***************************************************************************
+    Like PggRead, but the group may be a view of the block's data rather
+    than a copy of it (see GRPB::_FReadView).  The block's data may be
+    taken, so the block shouldn't be used afterwards.  As with
+    PglReadView, only change the group through its methods.
+***************************************************************************/
+PGG GG::PggReadView(PBLCK pblck, short *pbo, short *posk)
+{
+    AssertPo(pblck, 0);
+    AssertNilOrVarMem(pbo);
+    AssertNilOrVarMem(posk);
+
+    PGG pgg;
+
+    if ((pgg = NewObj GG(0)) == pvNil)
+        goto LFail;
+    pgg->_fReadView = fTrue;
+    if (!pgg->_FRead(pblck, pbo, posk))
+    {
+        ReleasePpo(&pgg);
+    LFail:
+        TrashVar(pbo);
+        TrashVar(posk);
+        return pvNil;
+    }
+    pgg->_fReadView = fFalse;
+    AssertPo(pgg, fobjAssertFull);
+    return pgg;
+}
+
 /***************************************************************************
     Duplicate this GG.
 ***************************************************************************/
@@ -1903,6 +2298,25 @@ PGG GG::PggDup(void)
     return pgg;
 }
 
+/***************************************************************************
+    Turn gapped editing on or off.  A gapped group keeps a gap in its
+    rgloc at the last place an element was inserted or deleted, and leaves
+    holes in the data instead of moving everything after a deleted or
+    shrunk element.  The holes get squeezed out once they're half the
+    data.  So editing near the last edit is O(1) amortized rather than
+    O(n).  Writing or duplicating the group closes the gaps, so the file
+    format is the same either way.
+***************************************************************************/
+void GG::SetGapped(bool fGapped)
+{
+    AssertThis(0);
+
+    if (!fGapped)
+        _CloseGaps();
+    _fGapped = FPure(fGapped);
+    AssertThis(fobjAssertFull);
+}
+
 /***************************************************************************
     Insert an element into the group.
 ***************************************************************************/
@@ -1921,13 +2335,41 @@ bool GG::FInsert(long iv, long cb, void *pv, void *pvFixed)
     loc.bv = cb == 0 ? 0 : _bvMac;
     cb = CbRoundToLong(cb);
 
-    if (!_FEnsureSizes(_bvMac + cb, LwMul(_ivMac + 1, size(LOC)), fgrpNil))
-        return fFalse;
+    if (!_fGapped || iv == _ivMac)
+    {
+        if (!_FEnsureSizes(_bvMac + cb, LwMul(_ivMac + _clocGap + 1, size(LOC)), fgrpNil))
+            return fFalse;
 
-    // make room for the entry
-    qloc = _Qloc(iv);
-    if (iv < _ivMac)
-        BltPb(qloc, qloc + 1, LwMul(_ivMac - iv, size(LOC)));
+        // make room for the entry
+        qloc = _Qloc(iv);
+        if (iv < _ivMac)
+            BltPb(qloc, qloc + 1, LwMul(_ivMac - iv, size(LOC)));
+    }
+    else
+    {
+        if (!_FEnsureSizes(_bvMac + cb, LwMul(_ivMac + _clocGap, size(LOC)), fgrpNil))
+            return fFalse;
+
+        if (0 == _clocGap)
+        {
+            // open a new gap with the spare room at the end of the rgloc,
+            // growing it by a fraction of its size so moving the gap
+            // around amortizes
+            if (!_FEnsureSizes(_bvMac + cb, LwMul(_ivMac + LwMax(16, _ivMac >> 3), size(LOC)), fgrpNil) &&
+                !_FEnsureSizes(_bvMac + cb, LwMul(_ivMac + 1, size(LOC)), fgrpNil))
+            {
+                return fFalse;
+            }
+            _ilocGap = _ivMac;
+            _clocGap = _Cb2() / size(LOC) - _ivMac;
+        }
+
+        // use the first loc in the gap
+        _MoveLocGap(iv);
+        _ilocGap++;
+        _clocGap--;
+        qloc = _Qloc(iv);
+    }
     *qloc = loc;
 
     if (pvNil != pv && cb > 0)
@@ -2030,11 +2472,26 @@ void GG::Delete(long iv)
     LOC *qloc;
     LOC loc;
 
+    if (!_FEnsureWritable())
+        return;
+
     qloc = _Qloc(iv);
     loc = *qloc;
-    if (iv < --_ivMac)
-        BltPb(qloc + 1, qloc, LwMul(_ivMac - iv, size(LOC)));
-    TrashPvCb(_Qloc(_ivMac), size(LOC));
+    if (_fGapped && iv < _ivMac - 1)
+    {
+        // widen the gap over the loc rather than moving the ones after it
+        _MoveLocGap(iv);
+        _clocGap++;
+        _ivMac--;
+    }
+    else
+    {
+        if (iv < --_ivMac)
+            BltPb(qloc + 1, qloc, LwMul(_ivMac - iv, size(LOC)));
+        TrashPvCb(_Qloc(_ivMac), size(LOC));
+        if (_ilocGap >= _ivMac)
+            _clocGap = 0;
+    }
     if (loc.cb > 0)
         _RemoveRgb(loc.bv, CbRoundToLong(loc.cb));
     AssertThis(fobjAssertFull);
@@ -2053,8 +2510,16 @@ void GG::Move(long ivSrc, long ivTarget)
     AssertThis(0);
     AssertIn(ivSrc, 0, _ivMac);
     AssertIn(ivTarget, 0, _ivMac + 1);
+    long ivMin = LwMin(ivSrc, ivTarget);
+    long ivLim = LwMax(ivSrc + 1, ivTarget);
 
-    MoveElement(_Qloc(0), size(LOC), ivSrc, ivTarget);
+    if (!_FEnsureWritable())
+        return;
+
+    // the locs in [ivMin, ivLim) need to be contiguous
+    if (_clocGap > 0 && FIn(_ilocGap, ivMin + 1, ivLim))
+        _MoveLocGap(ivLim - _ilocGap < _ilocGap - ivMin ? ivLim : ivMin);
+    MoveElement(_Qloc(ivMin), size(LOC), ivSrc - ivMin, ivTarget - ivMin);
     AssertThis(0);
 }
 
@@ -2067,6 +2532,9 @@ void GG::Swap(long iv1, long iv2)
     AssertIn(iv1, 0, _ivMac);
     AssertIn(iv2, 0, _ivMac);
 
+    if (!_FEnsureWritable())
+        return;
+
     SwapPb(_Qloc(iv1), _Qloc(iv2), size(LOC));
     AssertThis(0);
 }
@@ -52,20 +52,29 @@ class GRPB : public GRPB_PAR
     HQ _hqData1;
     HQ _hqData2;
 
+    // views of data we didn't copy (see GRPB::_FReadView)
+    byte *_pbView;    // section 1 followed by section 2, pvNil if not a view
+    HQ _hqView;       // the (locked) block data _pbView points into
+    PFIL _pfilView;   // or the mapped file it points into (see FIL::PvMapRef)
+
     bool _FEnsureHqCb(HQ *phq, long cb, long cbMinGrow, long *pcb);
+    bool _FReadView(PBLCK pblck, long cb1, long cb2, long ib);
+    bool _FCopyView(void);
+    void _ReleaseView(void);
 
   protected:
     long _cbMinGrow1;
     long _cbMinGrow2;
     long _ivMac;
+    bool _fReadView; // _FReadData may make a view (see the *ReadView methods)
 
     byte *_Qb1(long ib)
     {
-        return (byte *)QvFromHq(_hqData1) + ib;
+        return (pvNil != _pbView ? _pbView : (byte *)QvFromHq(_hqData1)) + ib;
     }
     byte *_Qb2(long ib)
     {
-        return (byte *)QvFromHq(_hqData2) + ib;
+        return (pvNil != _pbView ? _pbView + _cb1 : (byte *)QvFromHq(_hqData2)) + ib;
     }
     long _Cb1(void)
     {
@@ -76,6 +85,7 @@ class GRPB : public GRPB_PAR
         return _cb2;
     }
     bool _FEnsureSizes(long cbMin1, long cbMin2, ulong grfgrp);
+    bool _FEnsureWritable(void);
     bool _FWrite(PBLCK pblck, void *pv, long cb, long cb1, long cb2);
     bool _FReadData(PBLCK pblck, long ib, long cb1, long cb2);
     bool _FDup(PGRPB pgrpbDst, long cb1, long cb2);
@@ -101,6 +111,10 @@ class GRPB : public GRPB_PAR
     {
         return _ivMac;
     }
+    bool FView(void)
+    {
+        return pvNil != _pbView;
+    }
     virtual bool FFree(long iv) = 0;
     virtual void Delete(long iv) = 0;
 
@@ -158,6 +172,7 @@ class GL : public GL_PAR
     static PGL PglNew(long cb, long cvInit = 0);
     static PGL PglRead(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
     static PGL PglRead(PFIL pfil, FP fp, long cb, short *pbo = pvNil, short *posk = pvNil);
+    static PGL PglReadView(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
 
     // duplication
     PGL PglDup(void);
@@ -258,6 +273,12 @@ class GGB : public GGB_PAR
     long _clocFree;
     long _cbFixed;
 
+    // gapped groups (see GG::SetGapped)
+    bool _fGapped;
+    long _ilocGap; // where the gap in the rgloc is
+    long _clocGap; // number of free locs in the gap
+    long _cbHole;  // total size of the holes in the data
+
   protected:
     GGB(long cbFixed, bool fAllowFree);
 
@@ -265,8 +286,13 @@ class GGB : public GGB_PAR
     void _AdjustLocs(long bvMin, long bvLim, long dcb);
     LOC *_Qloc(long iloc)
     {
+        if (iloc >= _ilocGap)
+            iloc += _clocGap;
         return (LOC *)_Qb2(LwMul(iloc, size(LOC)));
     }
+    void _MoveLocGap(long iloc);
+    void _SqueezeHoles(void);
+    void _CloseGaps(void);
     bool _FRead(PBLCK pblck, short *pbo, short *posk);
 
     bool _FDup(PGGB pggbDst);
@@ -327,6 +353,7 @@ class GG : public GG_PAR
     static PGG PggNew(long cbFixed = 0, long cvInit = 0, long cbInit = 0);
     static PGG PggRead(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
     static PGG PggRead(PFIL pfil, FP fp, long cb, short *pbo = pvNil, short *posk = pvNil);
+    static PGG PggReadView(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
 
     // duplication
     PGG PggDup(void);
@@ -336,6 +363,7 @@ class GG : public GG_PAR
     virtual void Delete(long iv);
 
     // new methods
+    void SetGapped(bool fGapped);
     bool FInsert(long iv, long cb, void *pv = pvNil, void *pvFixed = pvNil);
     bool FCopyEntries(PGG pggSrc, long ivSrc, long ivDst, long cv);
     void Move(long ivSrc, long ivTarget);
@@ -394,14 +422,21 @@ class GSTB : public GSTB_PAR
 {
     RTCLASS_DEC
     ASSERT
+    MARKMEM
 
   protected:
     long _cbEntry;
     long _bstMac;
     long _cbstFree; // this is cvNil for non-allocated GSTBs
 
+    // hashed lookup (see GSTB::SetHashed)
+    bool _fHashed;
+    ulong _grfgstHash; // fgstUserSorted if the hash ignores case
+    PGL _pglistnHash;  // open addressing hash table of istns, ivNil is empty
+
   protected:
     GSTB(long cbExtra, ulong grfgst);
+    ~GSTB(void);
 
     long _Bst(long ibst)
     {
@@ -421,6 +456,13 @@ class GSTB : public GSTB_PAR
 
     bool _FDup(PGSTB pgstbDst);
 
+    bool _FHashMatches(ulong grfgst);
+    bool _FEnsureHash(void);
+    bool _FFindHash(achar *prgch, long cch, long *pistn);
+    void _ReleaseHash(void);
+    void _AddToHash(long istn, bool fInserted);
+    void _RemoveFromHash(long istn, bool fDeleting);
+
   public:
     // methods required by parent class
     virtual bool FWrite(PBLCK pblck, short bo = kboCur, short osk = koskCur);
@@ -429,6 +471,7 @@ class GSTB : public GSTB_PAR
 
     bool FEnsureSpace(long cstnAdd, long cchAdd, ulong grfgrp = fgrpNil);
     void SetMinGrow(long cstnAdd, long cchAdd);
+    void SetHashed(bool fHashed, ulong grfgst = fgstNil);
 
     virtual bool FAddRgch(achar *prgch, long cch, void *pvExtra = pvNil, long *pistn = pvNil) = 0;
     virtual bool FFindRgch(achar *prgch, long cch, long *pistn, ulong grfgst = fgstNil);
@@ -474,6 +517,7 @@ class GST : public GST_PAR
     static PGST PgstNew(long cbExtra = 0, long cstnInit = 0, long cchInit = 0);
     static PGST PgstRead(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
     static PGST PgstRead(PFIL pfil, FP fp, long cb, short *pbo = pvNil, short *posk = pvNil);
+    static PGST PgstReadView(PBLCK pblck, short *pbo = pvNil, short *posk = pvNil);
 
     // duplication
     PGST PgstDup(void);
@@ -47,6 +47,15 @@ GSTB::GSTB(long cbExtra, ulong grfgst)
     AssertThis(fobjAssertFull);
 }
 
+/***************************************************************************
+    Destructor for a base string table.  Frees the hash table.
+***************************************************************************/
+GSTB::~GSTB(void)
+{
+    AssertThis(0);
+    ReleasePpo(&_pglistnHash);
+}
+
 /***************************************************************************
     Duplicate the string table.
 ***************************************************************************/
@@ -62,6 +71,7 @@ bool GSTB::_FDup(PGSTB pgstbDst)
     pgstbDst->_cbEntry = _cbEntry;
     pgstbDst->_bstMac = _bstMac;
     pgstbDst->_cbstFree = _cbstFree;
+    pgstbDst->SetHashed(_fHashed, _grfgstHash);
     AssertPo(pgstbDst, fobjAssertFull);
 
     return fTrue;
@@ -125,6 +135,10 @@ bool GSTB::FWrite(PBLCK pblck, short bo, short osk)
         }
     }
 
+    // the bst's and strings are swapped and translated in place
+    if ((kboOther == bo || koskCur != osk) && !_FEnsureWritable())
+        return fFalse;
+
     gstf.bo = kboCur;
     gstf.osk = osk;
     gstf.cbEntry = _cbEntry;
@@ -199,7 +213,10 @@ bool GSTB::_FRead(PBLCK pblck, short *pbo, short *posk)
     _ivMac = gstf.ibstMac;
     _bstMac = gstf.bstMac;
     _cbstFree = gstf.cbstFree;
+    _ReleaseHash();
     fRet = _FReadData(pblck, cb - cbT, cbT, size(gstf));
+    if (fRet && (bo == kboOther || koskCur != gstf.osk))
+        fRet = _FEnsureWritable();
     if (fRet)
     {
         if (bo == kboOther)
@@ -253,6 +270,30 @@ void GSTB::SetMinGrow(long cstnAdd, long cchAdd)
     _cbMinGrow2 = LwMul(cstnAdd, _cbEntry);
 }
 
+/***************************************************************************
+    Turn hashed lookup on or off.  While it's on, FFindRgch finds strings
+    through a hash table rather than by searching, so lookups stay constant
+    time as the table grows.  The hash table isn't saved with the string
+    table; it's built the first time it's needed (eg, after PgstRead) and
+    kept up to date as strings are added, replaced and deleted.
+
+    If fgstUserSorted is passed in grfgst, the hash ignores case and is
+    used by lookups that pass fgstUserSorted.  Otherwise it's used by
+    lookups that don't.
+***************************************************************************/
+void GSTB::SetHashed(bool fHashed, ulong grfgst)
+{
+    AssertThis(0);
+
+    grfgst = fHashed ? (grfgst & fgstUserSorted) : fgstNil;
+    if (FPure(fHashed) == _fHashed && grfgst == _grfgstHash)
+        return;
+
+    _ReleaseHash();
+    _fHashed = FPure(fHashed);
+    _grfgstHash = grfgst;
+}
+
 /***************************************************************************
     Append an stn to string table.
 ***************************************************************************/
@@ -279,9 +320,13 @@ bool GSTB::FPutRgch(long istn, achar *prgch, long cch)
     long bstOld;
     achar *qst;
 
+    if (!_FEnsureWritable())
+        return fFalse;
+
     qst = _Qst(istn);
     if ((cchOld = CchSt(qst)) == cch)
     {
+        _RemoveFromHash(istn, fFalse);
         CopyPb(prgch, PrgchSt(qst), cch * size(achar));
         goto LDone;
     }
@@ -289,6 +334,7 @@ bool GSTB::FPutRgch(long istn, achar *prgch, long cch)
     {
         return fFalse;
     }
+    _RemoveFromHash(istn, fFalse);
 
     // remove the old one
     bstOld = _Bst(istn);
@@ -299,6 +345,7 @@ bool GSTB::FPutRgch(long istn, achar *prgch, long cch)
     _AppendRgch(prgch, cch);
 
 LDone:
+    _AddToHash(istn, fFalse);
     AssertThis(fobjAssertFull);
     return fTrue;
 }
@@ -357,8 +404,8 @@ bool GSTB::FFindStn(PSTN pstn, long *pistn, ulong grfgst)
 
 /***************************************************************************
     Search for the string in the string table.  This version does a linear
-    search.  GST overrides this to do a binary search if fgstSorted is
-    passed in grfgst.
+    search (or uses the hash table, see SetHashed).  GST overrides this to
+    do a binary search if fgstSorted is passed in grfgst.
 ***************************************************************************/
 bool GSTB::FFindRgch(achar *prgch, long cch, long *pistn, ulong grfgst)
 {
@@ -369,6 +416,14 @@ bool GSTB::FFindRgch(achar *prgch, long cch, long *pistn, ulong grfgst)
     long istn, bst;
     PST qst;
 
+    if (_FHashMatches(grfgst) && _FEnsureHash())
+    {
+        if (_FFindHash(prgch, cch, pistn))
+            return fTrue;
+        *pistn = _ivMac;
+        return fFalse;
+    }
+
     for (istn = 0; istn < _ivMac; istn++)
     {
         bst = _Bst(istn);
@@ -461,6 +516,9 @@ void GSTB::PutExtra(long istn, void *pv)
 
     byte *qb;
 
+    if (!_FEnsureWritable())
+        return;
+
     qb = (byte *)_Qbst(istn) + size(long);
     CopyPb(pv, qb, _cbEntry - size(long));
     AssertThis(0);
@@ -645,6 +703,253 @@ LFail:
     return fRet;
 }
 
+// string tables with fewer strings than this are just searched
+const long kcstnMinHash = 16;
+
+/***************************************************************************
+    Hash a string for the lookup hash table (FNV-1a).  If fIgnoreCase is
+    set, the string is upper cased first, so strings that FEqualUserRgch
+    considers equal hash the same.
+***************************************************************************/
+priv long _LwHashRgch(achar *prgch, long cch, bool fIgnoreCase)
+{
+    AssertIn(cch, 0, kcchMaxGst + 1);
+    AssertPvCb(prgch, cch * size(achar));
+    achar rgch[kcchMaxGst];
+    ulong luHash;
+    byte *pb;
+    long cb;
+
+    if (fIgnoreCase)
+    {
+        CopyPb(prgch, rgch, cch * size(achar));
+        UpperRgch(rgch, cch);
+        prgch = rgch;
+    }
+
+    luHash = 0x811C9DC5;
+    for (pb = (byte *)prgch, cb = cch * size(achar); cb-- > 0; pb++)
+        luHash = (luHash ^ *pb) * 0x01000193;
+
+    // fold the high bits in, since the caller only uses the low ones
+    return (long)(luHash ^ (luHash >> 16));
+}
+
+/***************************************************************************
+    Return whether a lookup with the given grfgst can use the hash table.
+***************************************************************************/
+bool GSTB::_FHashMatches(ulong grfgst)
+{
+    AssertThis(0);
+    return _fHashed && (grfgst & fgstUserSorted) == _grfgstHash;
+}
+
+/***************************************************************************
+    Make sure the hash table exists and is big enough.  Returns false if
+    the string table is too small to bother with it or we couldn't
+    allocate it, in which case the caller should just search the strings.
+***************************************************************************/
+bool GSTB::_FEnsureHash(void)
+{
+    AssertThis(0);
+    Assert(_fHashed, "not hashed");
+    long cstn, cslot, istn, islot, islotMask;
+    long *qrgistn;
+    PST qst;
+    bool fIgnoreCase = FPure(_grfgstHash & fgstUserSorted);
+
+    cstn = _ivMac - LwMax(0, _cbstFree);
+    if (pvNil != _pglistnHash)
+    {
+        if (2 * cstn <= _pglistnHash->IvMac())
+            return fTrue;
+
+        // too full, build a bigger one
+        _ReleaseHash();
+    }
+
+    if (cstn < kcstnMinHash)
+        return fFalse;
+
+    // keep the table at most a quarter full when we build it, so it can
+    // grow for a while before we have to rebuild it
+    for (cslot = 2 * kcstnMinHash; cslot < 4 * cstn; cslot <<= 1)
+        ;
+
+    if (pvNil == (_pglistnHash = GL::PglNew(size(long), cslot)) || !_pglistnHash->FSetIvMac(cslot))
+    {
+        _ReleaseHash();
+        return fFalse;
+    }
+
+    qrgistn = (long *)_pglistnHash->QvGet(0);
+    FillPb(qrgistn, LwMul(cslot, size(long)), 0xFF);
+    Assert(ivNil == qrgistn[0], "FillPb didn't give ivNil");
+    islotMask = cslot - 1;
+    for (istn = 0; istn < _ivMac; istn++)
+    {
+        if (bvNil == _Bst(istn))
+            continue;
+        qst = _Qst(istn);
+        for (islot = _LwHashRgch(PrgchSt(qst), CchSt(qst), fIgnoreCase) & islotMask; ivNil != qrgistn[islot];
+             islot = (islot + 1) & islotMask)
+        {
+        }
+        qrgistn[islot] = istn;
+    }
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Look up the string in the hash table.  If there are several matching
+    strings, this finds the first one, just like a linear search would.
+***************************************************************************/
+bool GSTB::_FFindHash(achar *prgch, long cch, long *pistn)
+{
+    AssertThis(0);
+    AssertIn(cch, 0, kcchMaxGst + 1);
+    AssertPvCb(prgch, cch * size(achar));
+    AssertVarMem(pistn);
+    AssertPo(_pglistnHash, 0);
+    long islot, islotMask, istn, istnFound;
+    long *qrgistn;
+    PST qst;
+    bool fIgnoreCase = FPure(_grfgstHash & fgstUserSorted);
+
+    istnFound = ivNil;
+    qrgistn = (long *)_pglistnHash->QvGet(0);
+    islotMask = _pglistnHash->IvMac() - 1;
+    for (islot = _LwHashRgch(prgch, cch, fIgnoreCase) & islotMask; ivNil != (istn = qrgistn[islot]);
+         islot = (islot + 1) & islotMask)
+    {
+        if (ivNil != istnFound && istn > istnFound)
+            continue;
+        qst = _Qst(istn);
+        if (fIgnoreCase ? FEqualUserRgch(PrgchSt(qst), CchSt(qst), prgch, cch)
+                        : CchSt(qst) == cch && FEqualRgb(PrgchSt(qst), prgch, cch * size(achar)))
+        {
+            istnFound = istn;
+        }
+    }
+
+    *pistn = istnFound;
+    return ivNil != istnFound;
+}
+
+/***************************************************************************
+    Free the hash table.  It'll get rebuilt when it's next needed.
+***************************************************************************/
+void GSTB::_ReleaseHash(void)
+{
+    AssertBaseThis(0);
+    ReleasePpo(&_pglistnHash);
+}
+
+/***************************************************************************
+    String istn was just added or replaced. Update the hash table (if we
+    have one). If fShift is set, the string was inserted, so the strings
+    that were at or after istn all moved up one.
+***************************************************************************/
+void GSTB::_AddToHash(long istn, bool fShift)
+{
+    AssertIn(istn, 0, _ivMac);
+    Assert(!FFree(istn), "string entry is free!");
+    long islot, cslot, islotMask;
+    long *qrgistn;
+    PST qst;
+
+    if (pvNil == _pglistnHash)
+        return;
+
+    cslot = _pglistnHash->IvMac();
+    if (2 * (_ivMac - LwMax(0, _cbstFree)) > cslot)
+    {
+        // too full, rebuild it later
+        _ReleaseHash();
+        return;
+    }
+
+    qrgistn = (long *)_pglistnHash->QvGet(0);
+    if (fShift)
+    {
+        for (islot = 0; islot < cslot; islot++)
+        {
+            if (qrgistn[islot] >= istn)
+                qrgistn[islot]++;
+        }
+    }
+
+    islotMask = cslot - 1;
+    qst = _Qst(istn);
+    for (islot = _LwHashRgch(PrgchSt(qst), CchSt(qst), FPure(_grfgstHash & fgstUserSorted)) & islotMask;
+         ivNil != qrgistn[islot]; islot = (islot + 1) & islotMask)
+    {
+    }
+    qrgistn[islot] = istn;
+}
+
+/***************************************************************************
+    String istn is about to be deleted or replaced. Update the hash table
+    (if we have one). If fShift is set, the string is being deleted and
+    the strings after it will all move down one.
+***************************************************************************/
+void GSTB::_RemoveFromHash(long istn, bool fShift)
+{
+    AssertIn(istn, 0, _ivMac);
+    Assert(!FFree(istn), "string entry is free!");
+    long islot, islotNext, islotHome, cslot, islotMask;
+    long *qrgistn;
+    PST qst;
+    bool fIgnoreCase = FPure(_grfgstHash & fgstUserSorted);
+
+    if (pvNil == _pglistnHash)
+        return;
+
+    cslot = _pglistnHash->IvMac();
+    islotMask = cslot - 1;
+    qrgistn = (long *)_pglistnHash->QvGet(0);
+
+    qst = _Qst(istn);
+    for (islot = _LwHashRgch(PrgchSt(qst), CchSt(qst), fIgnoreCase) & islotMask; istn != qrgistn[islot];
+         islot = (islot + 1) & islotMask)
+    {
+        if (ivNil == qrgistn[islot])
+        {
+            Bug("istn not in hash table");
+            _ReleaseHash();
+            return;
+        }
+    }
+
+    // Remove it and move later entries in the cluster back so they can
+    // still be found.
+    qrgistn[islot] = ivNil;
+    for (islotNext = (islot + 1) & islotMask; ivNil != qrgistn[islotNext]; islotNext = (islotNext + 1) & islotMask)
+    {
+        qst = _Qst(qrgistn[islotNext]);
+        islotHome = _LwHashRgch(PrgchSt(qst), CchSt(qst), fIgnoreCase) & islotMask;
+        if (islot <= islotNext ? (islot < islotHome && islotHome <= islotNext)
+                               : (islot < islotHome || islotHome <= islotNext))
+        {
+            // this one can stay where it is
+            continue;
+        }
+        qrgistn[islot] = qrgistn[islotNext];
+        qrgistn[islotNext] = ivNil;
+        islot = islotNext;
+    }
+
+    if (fShift)
+    {
+        for (islot = 0; islot < cslot; islot++)
+        {
+            if (qrgistn[islot] > istn)
+                qrgistn[islot]--;
+        }
+    }
+}
+
 /***************************************************************************
     Returns true iff ibst is out of range or the corresponding bst is
     bvNil.
@@ -700,6 +1005,39 @@ void GSTB::AssertValid(ulong grfobj)
         Assert(cchTot * size(achar) == _bstMac, "grst wrong size");
         Assert(cbstFree == _cbstFree || _cbstFree == cvNil && cbstFree == 0, "bad _cbstFree");
     }
+
+    Assert(_fHashed || pvNil == _pglistnHash, "hash table but not hashed");
+    Assert(!(_grfgstHash & ~fgstUserSorted), "bad _grfgstHash");
+    if (pvNil != _pglistnHash)
+    {
+        long cslot, islot, istn, cstn;
+
+        AssertPo(_pglistnHash, 0);
+        cslot = _pglistnHash->IvMac();
+        Assert(cslot >= 2 * kcstnMinHash && (cslot & (cslot - 1)) == 0, "bad hash table size");
+        if (grfobj & fobjAssertFull)
+        {
+            for (cstn = islot = 0; islot < cslot; islot++)
+            {
+                _pglistnHash->Get(islot, &istn);
+                if (ivNil == istn)
+                    continue;
+                Assert(!FFree(istn), "bad istn in hash table");
+                cstn++;
+            }
+            Assert(cstn == _ivMac - LwMax(0, _cbstFree), "wrong number of strings in hash table");
+        }
+    }
+}
+
+/***************************************************************************
+    Mark the hash table.
+***************************************************************************/
+void GSTB::MarkMem(void)
+{
+    AssertThis(0);
+    GSTB_PAR::MarkMem();
+    MarkMemObj(_pglistnHash);
 }
 #endif // DEBUG
 
@@ -760,6 +1098,36 @@ PGST GST::PgstRead(PFIL pfil, FP fp, long cb, short *pbo, short *posk)
     return PgstRead(&blck, pbo, posk);
 }
 
+/***************************************************************************
+    Like PgstRead, but the string table may be a view of the block's data
+    rather than a copy of it (see GRPB::_FReadView).  The block's data may
+    be taken, so the block shouldn't be used afterwards.  As with
+    GL::PglReadView, only change the string table through its methods.
+***************************************************************************/
+PGST GST::PgstReadView(PBLCK pblck, short *pbo, short *posk)
+{
+    AssertPo(pblck, 0);
+    AssertNilOrVarMem(pbo);
+    AssertNilOrVarMem(posk);
+
+    PGST pgst;
+
+    if ((pgst = NewObj GST(0)) == pvNil)
+        goto LFail;
+    pgst->_fReadView = fTrue;
+    if (!pgst->_FRead(pblck, pbo, posk))
+    {
+        ReleasePpo(&pgst);
+    LFail:
+        TrashVar(pbo);
+        TrashVar(posk);
+        return pvNil;
+    }
+    pgst->_fReadView = fFalse;
+    AssertPo(pgst, 0);
+    return pgst;
+}
+
 /***************************************************************************
     Duplicate this GST.
 ***************************************************************************/
@@ -803,7 +1171,8 @@ bool GST::FAddRgch(achar *prgch, long cch, void *pvExtra, long *pistn)
     Find the given string and put its location in *pistn.  If it's not
     there, fill *pistn with where it would be.  If fgstSorted or fgstUserSorted
     is passed in, this does a binary search for the string; otherwise it
-    does a linear search.
+    does a linear search.  Either way, the hash table is used instead when
+    there is one (see SetHashed).
 ***************************************************************************/
 bool GST::FFindRgch(achar *prgch, long cch, long *pistn, ulong grfgst)
 {
@@ -815,6 +1184,11 @@ bool GST::FFindRgch(achar *prgch, long cch, long *pistn, ulong grfgst)
     if (!(grfgst & (fgstSorted | fgstUserSorted)))
         return GSTB::FFindRgch(prgch, cch, pistn, grfgst);
 
+    // if it's there, the hash table will find it. If it's not, we need the
+    // binary search to tell where it would go.
+    if (_FHashMatches(grfgst) && _FEnsureHash() && _FFindHash(prgch, cch, pistn))
+        return fTrue;
+
     // the table should be sorted, so do a binary search
     long ivMin, ivLim, iv;
     ulong fcmp;
@@ -882,6 +1256,7 @@ bool GST::FInsertRgch(long istn, achar *prgch, long cch, void *pvExtra)
     _ivMac++;
     // put the string in
     _AppendRgch(prgch, cch);
+    _AddToHash(istn, fTrue);
 
     AssertThis(fobjAssertFull);
     return fTrue;
@@ -911,6 +1286,10 @@ void GST::Delete(long istn)
     byte *qb;
     long bst;
 
+    if (!_FEnsureWritable())
+        return;
+
+    _RemoveFromHash(istn, fTrue);
     qb = (byte *)_Qbst(istn);
     bst = *(long *)qb;
     if (istn < --_ivMac)
@@ -934,6 +1313,11 @@ void GST::Move(long ivSrc, long ivTarget)
     AssertIn(ivSrc, 0, _ivMac);
     AssertIn(ivTarget, 0, _ivMac + 1);
 
+    if (!_FEnsureWritable())
+        return;
+
+    // the istns in the hash table are out of date; rebuild it when needed
+    _ReleaseHash();
     MoveElement(_Qbst(0), _cbEntry, ivSrc, ivTarget);
     AssertThis(0);
 }
@@ -1079,6 +1463,7 @@ bool AST::FAddRgch(achar *prgch, long cch, void *pvExtra, long *pistn)
 
     // put the string in
     _AppendRgch(prgch, cch);
+    _AddToHash(ibst, fFalse);
 
     if (pvNil != pistn)
         *pistn = ibst;
@@ -1098,6 +1483,7 @@ void AST::Delete(long istn)
     byte *qb;
     long bst;
 
+    _RemoveFromHash(istn, fFalse);
     qb = (byte *)_Qbst(istn);
     bst = *(long *)qb;
 
@@ -587,7 +587,7 @@ bool GOK::_FSetGmsCore(long gms, ulong grfact, bool *pfStable)
 bool GOK::_FSetRep(CHID chid, ulong grfgok, CTG ctg, long dxp, long dyp, bool *pfSet)
 {
     AssertThis(0);
-    long ikid;
+    KDE kde;
     KID kid;
     PGORP pgorp;
     bool fSet = fFalse;
@@ -640,8 +640,8 @@ bool GOK::_FSetRep(CHID chid, ulong grfgok, CTG ctg, long dxp, long dyp, bool *p
     if (kctgAnimation == ctg)
         goto LAdjust;
 
-    for (pcfl->FGetIkid(_pgokd->Ctg(), _pgokd->Cno(), 0, 0, chid, &ikid);
-         pcfl->FGetKid(_pgokd->Ctg(), _pgokd->Cno(), ikid, &kid) && kid.chid == chid; ikid++)
+    pcfl->InitKdeChid(_pgokd->Ctg(), _pgokd->Cno(), chid, &kde);
+    while (pcfl->FNextKid(&kde, &kid))
     {
         if (ctgNil != ctg && ctg != kid.cki.ctg || kctgAnimation == kid.cki.ctg)
         {
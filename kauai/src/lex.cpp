@@ -364,8 +364,8 @@ void LEXB::AssertValid(ulong grf)
     AssertPo(&_stnFile, 0);
     AssertIn(_lwLine, 0, kcbMax);
     AssertIn(_ichLine, 0, kcbMax);
-    AssertIn(_fpCur, 0, _fpMac + 1);
-    AssertIn(_fpMac, 0, kcbMax);
+    Assert(FInFp(_fpCur, 0, _fpMac + 1), "bad _fpCur");
+    Assert(_fpMac >= 0, "bad _fpMac");
     AssertIn(_ichCur, 0, _ichLim + 1);
     AssertIn(_ichLim, 0, size(_rgch) + 1);
 }
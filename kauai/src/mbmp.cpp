@@ -22,6 +22,8 @@ MBMP::~MBMP(void)
 {
     AssertBaseThis(0);
     FreePhq(&_hqrgb);
+    if (pvNil != _pfilMap)
+        _pfilMap->UnmapRef();
 }
 
 /***************************************************************************
@@ -270,15 +272,29 @@ PMBMP MBMP::PmbmpRead(PBLCK pblck)
     bool fSwap;
     RC rc;
     HQ hqrgb = hqNil;
+    PFIL pfilMap = pvNil;
 
     if (!pblck->FUnpackData())
         return pvNil;
     cbTot = pblck->Cb();
-
-    if (cbTot < size(MBMPH) || hqNil == (hqrgb = pblck->HqFree()))
+    if (cbTot < size(MBMPH))
         return pvNil;
 
-    qmbmph = (MBMPH *)QvFromHq(hqrgb);
+    // If the chunk is on a mapped file and doesn't need fixing up, use the
+    // bytes in the view instead of copying them.
+    qmbmph = (MBMPH *)pblck->PvMapRef(&pfilMap);
+    if (pvNil != pfilMap && (kboCur != qmbmph->bo || qmbmph->rc.FEmpty()))
+    {
+        pfilMap->UnmapRef();
+        pfilMap = pvNil;
+    }
+    if (pvNil == pfilMap)
+    {
+        if (hqNil == (hqrgb = pblck->HqFree()))
+            return pvNil;
+        qmbmph = (MBMPH *)QvFromHq(hqrgb);
+    }
+
     fSwap = (kboOther == qmbmph->bo);
     if (fSwap)
         SwapBytesBom(qmbmph, kbomMbmph);
@@ -305,11 +321,19 @@ PMBMP MBMP::PmbmpRead(PBLCK pblck)
     {
     LFail:
         FreePhq(&hqrgb);
+        if (pvNil != pfilMap)
+            pfilMap->UnmapRef();
         return pvNil;
     }
 
     pmbmp->_cbRgcb = cbRgcb;
     pmbmp->_hqrgb = hqrgb;
+    if (pvNil != pfilMap)
+    {
+        pmbmp->_pfilMap = pfilMap;
+        pmbmp->_prgbMap = (byte *)qmbmph;
+        pmbmp->_cbMap = cbTot;
+    }
 
     if (fSwap)
     {
@@ -367,7 +391,31 @@ PMBMP MBMP::PmbmpRead(PBLCK pblck)
 long MBMP::CbOnFile(void)
 {
     AssertThis(0);
-    return CbOfHq(_hqrgb);
+    return _Cb();
+}
+
+/***************************************************************************
+    If the data is still in a file's view, copy it to _hqrgb so it can be
+    changed.
+***************************************************************************/
+bool MBMP::_FEnsureHq(void)
+{
+    AssertThis(0);
+
+    if (pvNil == _pfilMap)
+        return fTrue;
+
+    if (!FAllocHq(&_hqrgb, _cbMap, fmemNil, mprNormal))
+        return fFalse;
+    CopyPb(_prgbMap, QvFromHq(_hqrgb), _cbMap);
+
+    _pfilMap->UnmapRef();
+    _pfilMap = pvNil;
+    _prgbMap = pvNil;
+    _cbMap = 0;
+
+    AssertThis(0);
+    return fTrue;
 }
 
 /***************************************************************************
@@ -379,6 +427,9 @@ bool MBMP::FWrite(PBLCK pblck)
     AssertPo(pblck, 0);
     MBMPH *qmbmph;
 
+    if (!_FEnsureHq())
+        return fFalse;
+
     qmbmph = _Qmbmph();
     qmbmph->bo = kboCur;
     qmbmph->osk = koskCur;
@@ -454,7 +505,14 @@ void MBMP::AssertValid(ulong grf)
     RC rc;
 
     MBMP_PAR::AssertValid(0);
-    AssertHq(_hqrgb);
+    if (pvNil != _pfilMap)
+    {
+        AssertPo(_pfilMap, 0);
+        Assert(hqNil == _hqrgb, "both mapped and in memory");
+        AssertPvCb(_prgbMap, _cbMap);
+    }
+    else
+        AssertHq(_hqrgb);
 
     rc = _Qmbmph()->rc;
     ccb = rc.Dyp();
@@ -466,7 +524,7 @@ void MBMP::AssertValid(ulong grf)
         AssertIn(*qcb, 0, kcbMax);
         cbTot += *qcb++;
     }
-    Assert(cbTot + _cbRgcb + size(MBMPH) == CbOfHq(_hqrgb), "_hqrgb wrong size");
+    Assert(cbTot + _cbRgcb + size(MBMPH) == _Cb(), "_hqrgb wrong size");
 }
 
 /***************************************************************************
@@ -57,6 +57,13 @@ class MBMP : public MBMP_PAR
     long _cbRgcb; // size of the rgcb portion of _hqrgb
     HQ _hqrgb;    // MBMPH, short rgcb[_rc.Dyp()] followed by the pixel data
 
+    // When read from a mapped file, the data stays in the file's view
+    // (see FIL::PvMapRef) and _hqrgb is nil until something needs to
+    // change the data (see _FEnsureHq).
+    PFIL _pfilMap;
+    byte *_prgbMap;
+    long _cbMap;
+
     // MBMP header on file
     struct MBMPH
     {
@@ -77,12 +84,17 @@ class MBMP : public MBMP_PAR
 
     short *_Qrgcb(void)
     {
-        return (short *)PvAddBv(QvFromHq(_hqrgb), size(MBMPH));
+        return (short *)PvAddBv(_Qmbmph(), size(MBMPH));
     }
     MBMPH *_Qmbmph(void)
     {
-        return (MBMPH *)QvFromHq(_hqrgb);
+        return (MBMPH *)(pvNil != _pfilMap ? _prgbMap : QvFromHq(_hqrgb));
+    }
+    long _Cb(void)
+    {
+        return pvNil != _pfilMap ? _cbMap : CbOfHq(_hqrgb);
     }
+    bool _FEnsureHq(void);
 
   public:
     ~MBMP(void);
@@ -2283,11 +2283,16 @@ void SCCB::_AddNameRef(PSTN pstn, long *pistn)
     AssertPo(pstn, 0);
     AssertVarMem(pistn);
 
-    if (pvNil == _pgstNames && pvNil == (_pgstNames = GST::PgstNew(0, 5, 100)))
+    if (pvNil == _pgstNames)
     {
-        *pistn = 0;
-        _ReportError(_pszOom);
-        return;
+        if (pvNil == (_pgstNames = GST::PgstNew(0, 5, 100)))
+        {
+            *pistn = 0;
+            _ReportError(_pszOom);
+            return;
+        }
+        // names are looked up every time they're referenced
+        _pgstNames->SetHashed(fTrue);
     }
     // can't sort, because then indices can change
     if (_pgstNames->FFindStn(pstn, pistn, fgstNil))
@@ -1017,7 +1017,7 @@ bool _FReadStringReg(PCRF pcrf, CTG ctg, CNO cno, PBLCK pblck, PBACO *ppbaco, lo
         return fFalse;
     *pcb = pblck->Cb();
 
-    if (pvNil == (pgst = GST::PgstRead(pblck, &bo)) || pgst->CbExtra() != size(long))
+    if (pvNil == (pgst = GST::PgstReadView(pblck, &bo)) || pgst->CbExtra() != size(long))
     {
         goto LFail;
     }
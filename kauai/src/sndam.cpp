@@ -48,6 +48,10 @@ STBL::STBL(void)
     // based on BASE. So fields are not automatically initialized to 0.
     _cactRef = 1;
     _ib = 0;
+    _cb = 0;
+    _hqBlock = hqNil;
+    _ibBlock = 0;
+    _cbBlock = 0;
 }
 
 /***************************************************************************
@@ -56,6 +60,7 @@ STBL::STBL(void)
 STBL::~STBL(void)
 {
     AssertThisMem();
+    FreePhq(&_hqBlock);
 }
 
 /***************************************************************************
@@ -107,8 +112,8 @@ STDMETHODIMP STBL::Read(void *pv, ULONG cb, ULONG *pcb)
     AssertPvCb(pv, cb);
     AssertNilOrVarMem(pcb);
 
-    cb = LwMin(_blck.Cb() - _ib, cb);
-    if (_blck.FReadRgb(pv, cb, _ib))
+    cb = LwMin(_cb - _ib, cb);
+    if (_blck.FPacked() ? _FReadPacked(pv, cb) : _blck.FReadRgb(pv, cb, _ib))
     {
         _ib += cb;
         if (pvNil != pcb)
@@ -121,6 +126,44 @@ STDMETHODIMP STBL::Read(void *pv, ULONG cb, ULONG *pcb)
     return ResultFromScode(STG_E_READFAULT);
 }
 
+/***************************************************************************
+    Read from a stream that was left packed, unpacking a piece of it at a
+    time.
+***************************************************************************/
+bool STBL::_FReadPacked(void *pv, long cb)
+{
+    AssertThis(0);
+    AssertIn(cb, 0, _cb - _ib + 1);
+    AssertPvCb(pv, cb);
+    long ib, cbT;
+    bool fRet;
+
+    for (ib = _ib; cb > 0; ib += cbT, cb -= cbT)
+    {
+        if (!FIn(ib, _ibBlock, _ibBlock + _cbBlock))
+        {
+            // unpack the piece containing ib
+            if (hqNil == _hqBlock && !FAllocHq(&_hqBlock, kcbCodecBlock, fmemNil, mprNormal))
+                return fFalse;
+            _ibBlock = ib - ib % kcbCodecBlock;
+            _cbBlock = LwMin(kcbCodecBlock, _cb - _ibBlock);
+            fRet = _blck.FUnpackRgb(PvLockHq(_hqBlock), _cbBlock, _ibBlock);
+            UnlockHq(_hqBlock);
+            if (!fRet)
+            {
+                _cbBlock = 0;
+                return fFalse;
+            }
+        }
+
+        cbT = LwMin(cb, _ibBlock + _cbBlock - ib);
+        CopyPb((byte *)QvFromHq(_hqBlock) + ib - _ibBlock, pv, cbT);
+        pv = PvAddBv(pv, cbT);
+    }
+
+    return fTrue;
+}
+
 /***************************************************************************
     Seek to a place.
 ***************************************************************************/
@@ -139,11 +182,11 @@ STDMETHODIMP STBL::Seek(LARGE_INTEGER dlibMove, DWORD dwOrigin, ULARGE_INTEGER *
         break;
 
     case STREAM_SEEK_END:
-        dlibMove.QuadPart += _blck.Cb();
+        dlibMove.QuadPart += _cb;
         break;
     }
 
-    if (dlibMove.QuadPart < 0 || dlibMove.QuadPart > _blck.Cb())
+    if (dlibMove.QuadPart < 0 || dlibMove.QuadPart > _cb)
     {
         if (pvNil != plibNewPosition)
             plibNewPosition->QuadPart = _ib;
@@ -172,8 +215,19 @@ PSTBL STBL::PstblNew(FLO *pflo, bool fPacked)
     pblck = &pstbl->_blck;
     if (fPacked)
     {
-        // unpack the block
+        long cfmt;
+
+        // if the sound is big and in pieces that can be unpacked one at a
+        // time, leave it packed and unpack it as it's read
         pblck->Set(pflo, fPacked);
+        if (pblck->FPacked(&cfmt) && kcfmtBlocked == cfmt && vpcodmUtil->FGetCbFromBlck(pblck, &pstbl->_cb) &&
+            pstbl->_cb > SDAM::vcbMaxMemWave)
+        {
+            AssertPo(pstbl, 0);
+            return pstbl;
+        }
+
+        // unpack the block
         if (!pblck->FUnpackData())
         {
             delete pstbl;
@@ -215,6 +269,7 @@ PSTBL STBL::PstblNew(FLO *pflo, bool fPacked)
         else
             pblck->Set(pflo);
     }
+    pstbl->_cb = pblck->Cb();
 
     AssertPo(pstbl, 0);
     return pstbl;
@@ -228,7 +283,10 @@ void STBL::AssertValid(ulong grf)
 {
     AssertThisMem();
     AssertPo(&_blck, 0);
-    AssertIn(_ib, 0, _blck.Cb() + 1);
+    AssertIn(_ib, 0, _cb + 1);
+    if (hqNil != _hqBlock)
+        AssertHq(_hqBlock);
+    AssertIn(_cbBlock, 0, kcbCodecBlock + 1);
 }
 
 /***************************************************************************
@@ -238,6 +296,7 @@ void STBL::MarkMem(void)
 {
     AssertValid(0);
     MarkMemObj(&_blck);
+    MarkHq(_hqBlock);
 }
 #endif // DEBUG
 
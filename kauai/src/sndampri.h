@@ -29,11 +29,19 @@ class STBL : public STBL_PAR
   protected:
     long _cactRef;
     long _ib;
+    long _cb; // the unpacked size of the stream
     BLCK _blck;
 
+    // if _blck is packed, the last piece of it we unpacked
+    HQ _hqBlock;
+    long _ibBlock;
+    long _cbBlock;
+
     STBL(void);
     ~STBL(void);
 
+    bool _FReadPacked(void *pv, long cb);
+
   public:
     // IUnknown methods
     STDMETHODIMP QueryInterface(REFIID riid, void **ppv);
@@ -90,7 +98,7 @@ class STBL : public STBL_PAR
     static PSTBL PstblNew(FLO *pflo, bool fPacked);
     long CbMem(void)
     {
-        return size(STBL) + _blck.CbMem();
+        return size(STBL) + _blck.CbMem() + (hqNil == _hqBlock ? 0 : CbOfHq(_hqBlock));
     }
     bool FInMemory(void)
     {
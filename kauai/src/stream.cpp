@@ -919,7 +919,7 @@ void BSF::AssertValid(ulong grfobj)
         {
             AssertPo(flo.pfil, 0);
             Assert(cbT == 0, "wrong sized file entry");
-            AssertIn(flo.fp, 0, kcbMax);
+            Assert(flo.fp >= 0, "bad fp");
             AssertIn(flo.cb, 0, kcbMax);
             cbT = flo.cb;
         }
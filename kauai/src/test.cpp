@@ -25,9 +25,13 @@ void TestGl(void);
 void TestFni(void);
 void TestFil(void);
 void TestGg(void);
+void TestGgGap(void);
+void TestGst(void);
 void TestCfl(void);
+void TestCflIndex(void);
 void TestErs(void);
 void TestCrf(void);
+void TestCodec(void);
 
 /******************************************************************************
     Test util code.
@@ -43,9 +47,13 @@ void TestUtil(void)
     TestErs();
     TestGl();
     TestGg();
+    TestGgGap();
+    TestGst();
+    TestCodec();
     // TestFni();
     // TestFil();
     // TestCfl();
+    TestCflIndex();
     TestCrf();
 }
 
@@ -54,6 +62,11 @@ void TestUtil(void)
 ***************************************************************************/
 void TestInt(void)
 {
+    const BOM rgbom[] = {0xFFFFFFFF, 0xFFD50000, 0x555C15C0};
+    byte rgb1[7 * 32], rgb2[7 * 32];
+    long ib, ibom;
+    SWPL swpl;
+
     AssertDo(SwHigh(0x12345678) == (short)0x1234, 0);
     AssertDo(SwHigh(0xABCDEF01) == (short)0xABCD, 0);
     AssertDo(SwLow(0x12345678) == (short)0x5678, 0);
@@ -125,6 +138,18 @@ void TestInt(void)
     AssertDo(FcmpCompareFracs(50000, 30000, -300000, 200000) == fcmpGt, 0);
     AssertDo(FcmpCompareFracs(50000, 30000, 500000, 300000) == fcmpEq, 0);
     AssertDo(FcmpCompareFracs(0x1FFF0000, 0x10, 0x11000000, 0x10) == fcmpGt, 0);
+
+    // swap plans must do the same thing as SwapBytesBom on each struct
+    for (ibom = 0; ibom < CvFromRgv(rgbom); ibom++)
+    {
+        for (ib = 0; ib < size(rgb1); ib++)
+            rgb1[ib] = rgb2[ib] = (byte)(ib * 7);
+        CompileBom(rgbom[ibom], 32, &swpl);
+        SwapBytesRgvSwpl(rgb1, size(rgb1) / 32, &swpl);
+        for (ib = 0; ib < size(rgb2); ib += 32)
+            SwapBytesBom(rgb2 + ib, rgbom[ibom]);
+        AssertDo(fcmpEq == FcmpCompareRgb(rgb1, rgb2, size(rgb1)), 0);
+    }
 }
 
 /***************************************************************************
@@ -135,7 +160,8 @@ void TestMem(void)
 #define kchq 18
     static HQ rghq[kchq]; // static so it's initially zeros
     HQ hqT, hq;
-    long cb, ihq;
+    long cb, ihq, ipcl, cactHit;
+    MPST mpst;
 
     for (ihq = 0; ihq < kchq; ihq++)
     {
@@ -204,6 +230,25 @@ void TestMem(void)
         }
         FreePhq(&rghq[ihq]);
     }
+
+#ifdef WIN
+    // a small block that's just been freed should come back from the pools
+    for (cactHit = 0, ipcl = 0; ipcl < kcpclMem; ipcl++)
+    {
+        GetMpst(ipcl, &mpst);
+        cactHit -= mpst.cactHit;
+    }
+    AssertDo(FAllocHq(&hq, 10, fmemNil, mprDebug), 0);
+    FreePhq(&hq);
+    AssertDo(FAllocHq(&hq, 10, fmemNil, mprDebug), 0);
+    FreePhq(&hq);
+    for (ipcl = 0; ipcl < kcpclMem; ipcl++)
+    {
+        GetMpst(ipcl, &mpst);
+        cactHit += mpst.cactHit;
+    }
+    AssertDo(cactHit > 0, 0);
+#endif // WIN
 }
 
 /***************************************************************************
@@ -215,6 +260,8 @@ void TestGl(void)
     long isw;
     short *qsw;
     PGL pglsw;
+    BLCK blck;
+    HQ hq;
 
     pglsw = GL::PglNew(size(short));
     if (pvNil == pglsw)
@@ -270,6 +317,25 @@ void TestGl(void)
         AssertDo(sw == isw / 2, 0);
     }
 
+    // read it back as a view of the block's data, then force a copy
+    AssertDo(FAllocHq(&hq, pglsw->CbOnFile(), fmemNil, mprNormal), 0);
+    blck.SetHq(&hq);
+    AssertDo(pglsw->FWrite(&blck), 0);
+    ReleasePpo(&pglsw);
+    AssertDo(pvNil != (pglsw = GL::PglReadView(&blck)), 0);
+    AssertDo(pglsw->FView() && pglsw->IvMac() == 10, 0);
+    sw = 100;
+    pglsw->Put(0, &sw);
+    AssertDo(pglsw->FAdd(&sw), 0);
+    AssertDo(!pglsw->FView() && pglsw->IvMac() == 11, 0);
+    for (isw = 10; isw-- > 1;)
+    {
+        pglsw->Get(isw, &sw);
+        AssertDo(sw == isw / 2, 0);
+    }
+    pglsw->Get(0, &sw);
+    AssertDo(sw == 100, 0);
+
     ReleasePpo(&pglsw);
 }
 
@@ -407,6 +473,118 @@ void TestGg(void)
     ReleasePpo(&pgg);
 }
 
+/***************************************************************************
+    Test a gapped group. Elements are inserted and deleted over and over
+    at one spot, and grown and shrunk so holes are left in the data and
+    squeezed out again. A duplicate of the group has its gaps closed, so
+    it has to match.
+***************************************************************************/
+void TestGgGap(void)
+{
+    PGG pgg, pggDup;
+    long cb, iv, iact;
+    byte *qb;
+    PSZ psz = PszLit("0123456789ABCDEFG");
+    achar rgch[100];
+
+    AssertDo((pgg = GG::PggNew(0)) != pvNil, 0);
+    pgg->SetGapped(fTrue);
+    for (iv = 0; iv < 64; iv++)
+        AssertDo(pgg->FAdd((iv & 15) + 1, pvNil, psz), 0);
+
+    for (iact = 0; iact < 100; iact++)
+    {
+        AssertDo(pgg->FInsert(32, 5, psz), 0);
+        pgg->Delete(32);
+    }
+
+    for (iv = 0; iv < 64; iv++)
+    {
+        cb = pgg->Cb(iv);
+        AssertDo(cb == (iv & 15) + 1, 0);
+        CopyPb(psz, rgch, cb);
+        CopyPb(psz, rgch + cb, cb);
+        AssertDo(pgg->FPut(iv, cb + cb, rgch), 0);
+        pgg->DeleteRgb(iv, 0, cb);
+        qb = (byte *)pgg->QvGet(iv);
+        AssertDo(FEqualRgb(psz, qb, cb), 0);
+    }
+
+    for (iv = 63; iv > 0; iv -= 2)
+        pgg->Delete(iv);
+    AssertDo(pgg->IvMac() == 32, 0);
+
+    AssertDo((pggDup = pgg->PggDup()) != pvNil, 0);
+    AssertDo(pggDup->IvMac() == 32, 0);
+    for (iv = 0; iv < 32; iv++)
+    {
+        cb = pgg->Cb(iv);
+        AssertDo(cb == ((2 * iv) & 15) + 1, 0);
+        AssertDo(pggDup->Cb(iv) == cb, 0);
+        AssertDo(FEqualRgb(pggDup->QvGet(iv), pgg->QvGet(iv), cb), 0);
+        AssertDo(FEqualRgb(psz, pgg->QvGet(iv), cb), 0);
+    }
+    ReleasePpo(&pggDup);
+    ReleasePpo(&pgg);
+}
+
+/***************************************************************************
+    Test the string tables, with hashed lookup.
+***************************************************************************/
+void TestGst(void)
+{
+    PGST pgst;
+    PAST past;
+    long istn, iv;
+    STN stn;
+
+    AssertDo((past = AST::PastNew(0)) != pvNil, 0);
+    past->SetHashed(fTrue);
+    for (iv = 0; iv < 100; iv++)
+    {
+        stn.FFormatSz(PszLit("Str %d"), iv);
+        AssertDo(past->FAddStn(&stn, pvNil, &istn), 0);
+        AssertDo(istn == iv, 0);
+    }
+    for (iv = 0; iv < 100; iv += 2)
+        past->Delete(iv);
+    for (iv = 0; iv < 100; iv++)
+    {
+        stn.FFormatSz(PszLit("Str %d"), iv);
+        if (iv & 1)
+            AssertDo(past->FFindStn(&stn, &istn) && istn == iv, 0);
+        else
+            AssertDo(!past->FFindStn(&stn, &istn), 0);
+    }
+    stn = PszLit("Changed");
+    AssertDo(past->FPutStn(1, &stn), 0);
+    AssertDo(past->FFindStn(&stn, &istn) && istn == 1, 0);
+    stn = PszLit("Str 1");
+    AssertDo(!past->FFindStn(&stn, &istn), 0);
+    ReleasePpo(&past);
+
+    // case insensitive lookup, with the istns shifting under the hash
+    AssertDo((pgst = GST::PgstNew(0)) != pvNil, 0);
+    pgst->SetHashed(fTrue, fgstUserSorted);
+    for (iv = 0; iv < 100; iv++)
+    {
+        stn.FFormatSz(PszLit("Str %d"), iv);
+        AssertDo(pgst->FAddStn(&stn), 0);
+    }
+    stn = PszLit("STR 42");
+    AssertDo(pgst->FFindStn(&stn, &istn, fgstUserSorted) && istn == 42, 0);
+    AssertDo(!pgst->FFindStn(&stn, &istn), 0);
+    pgst->Delete(0);
+    AssertDo(pgst->FFindStn(&stn, &istn, fgstUserSorted) && istn == 41, 0);
+    stn = PszLit("Str 0");
+    AssertDo(pgst->FInsertStn(10, &stn), 0);
+    stn = PszLit("str 0");
+    AssertDo(pgst->FFindStn(&stn, &istn, fgstUserSorted) && istn == 10, 0);
+    stn = PszLit("str 42");
+    AssertDo(pgst->FFindStn(&stn, &istn, fgstUserSorted) && istn == 42, 0);
+    ReleasePpo(&pgst);
+}
+
 /***************************************************************************
     Test the chunky file stuff.
 ***************************************************************************/
@@ -555,6 +733,20 @@ void TestCfl(void)
 
         AssertDo(pcfl->FSave(BigLittle('JUNK', 'KNUJ'), pvNil), 0);
         ReleasePpo(&pcfl);
+
+        // reopen it mapped and make sure the views match what we read
+        AssertDo((pcfl = CFL::PcflOpen(&fni, fcflMapped)) != pvNil, 0);
+        for (icki = 0; pcfl->FGetCki(icki, &cki, pvNil, &blck); icki++)
+        {
+            void *pv;
+            long cb;
+
+            AssertDo(blck.FRead(rgch), 0);
+            if (pvNil != (pv = pcfl->PvFindMap(cki.ctg, cki.cno, &cb)))
+                AssertDo(cb == blck.Cb() && FEqualRgb(pv, rgch, cb), 0);
+        }
+        blck.Free();
+        ReleasePpo(&pcfl);
     }
 
     while (FGetFniOpenMacro(&fni, pvNil, 0, PszLit("All files\0*.*\0"), NULL))
@@ -581,6 +773,192 @@ void TestCfl(void)
     CFL::CloseUnmarked();
 }
 
+/***************************************************************************
+    Test the chunky file index, free space, journal and sharing code.
+    Unlike TestCfl, this doesn't need any input.
+***************************************************************************/
+void TestCflIndex(void)
+{
+    const CTG kctgLan = 0x41414141;
+    const CTG kctgKatz = 0x42424242;
+    FNI fni;
+    PCFL pcfl;
+    BLCK blck;
+    long icki;
+    CNO cno;
+    CKI cki;
+    ALST alst;
+    CKI rgcki[3];
+    KDE kde;
+    KID kid, kidT, kidPrev;
+    long ikid, cfmt;
+    HQ rghq[3];
+    BLCK rgblck[3];
+    byte rgb[1024];
+
+    // enough chunks to use the index hash table, with some deleted
+    AssertDo((pcfl = CFL::PcflCreateTemp()) != pvNil, 0);
+    for (icki = 0; icki < 600; icki++)
+    {
+        cno = icki / 3;
+        AssertDo(pcfl->FPutPv(&icki, size(long), kctgLan + icki % 3, cno), 0);
+    }
+    for (cno = 0; cno < 200; cno += 3)
+        pcfl->Delete(kctgLan + 1, cno);
+    AssertPo(pcfl, fcflFull);
+    AssertDo(pcfl->CckiCtg(kctgLan) == 200 && pcfl->CckiCtg(kctgLan + 1) == 133, 0);
+    AssertDo(pcfl->CckiCtg(kctgLan + 2) == 200 && pcfl->CckiCtg(kctgLan + 3) == 0, 0);
+    for (icki = 0; pcfl->FGetCkiCtg(kctgLan + 1, icki, &cki); icki++)
+    {
+        AssertDo(cki.ctg == kctgLan + 1 && cki.cno % 3 != 0, 0);
+        AssertDo(pcfl->FFind(cki.ctg, cki.cno) && !pcfl->FFind(cki.ctg, cki.cno / 3 * 3), 0);
+    }
+    AssertDo(icki == 133, 0);
+
+    // the deleted chunks should be reused by chunks of the same size
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cfsm == 67 && alst.cbFree == 67 * size(long) && alst.callocReuse == 0, 0);
+    for (cno = 0; cno < 200; cno += 3)
+        AssertDo(pcfl->FPutPv(&cno, size(long), kctgLan + 1, cno), 0);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cfsm == 0 && alst.callocReuse == 67 && alst.calloc == 667, 0);
+    AssertPo(pcfl, fcflFull);
+
+    // batch reads come back in request order and unpacked
+    FillPb(rgb, size(rgb), 0x55);
+    AssertDo(pcfl->FPutPv(rgb, size(rgb), kctgLan + 3, 0), 0);
+    AssertDo(pcfl->FPackData(kctgLan + 3, 0) && pcfl->FPacked(kctgLan + 3, 0), 0);
+    rgcki[0].ctg = kctgLan + 2;
+    rgcki[0].cno = 199;
+    rgcki[1].ctg = kctgLan + 3;
+    rgcki[1].cno = 0;
+    rgcki[2].ctg = kctgLan;
+    rgcki[2].cno = 0;
+    AssertDo(pcfl->FReadRghq(rgcki, 3, rghq), 0);
+    AssertDo(CbOfHq(rghq[0]) == size(long) && *(long *)PvLockHq(rghq[0]) == 599, 0);
+    AssertDo(CbOfHq(rghq[1]) == size(rgb) && FEqualRgb(PvLockHq(rghq[1]), rgb, size(rgb)), 0);
+    AssertDo(CbOfHq(rghq[2]) == size(long) && *(long *)PvLockHq(rghq[2]) == 0, 0);
+    for (icki = 0; icki < 3; icki++)
+    {
+        UnlockHq(rghq[icki]);
+        FreePhq(&rghq[icki]);
+    }
+    AssertDo(pcfl->FFindRgblck(rgcki, 3, rgblck), 0);
+    AssertDo(!rgblck[1].FPacked() && rgblck[1].Cb() == size(rgb), 0);
+    AssertDo(rgblck[0].Cb() == size(long) && rgblck[2].Cb() == size(long), 0);
+    rgcki[2].cno = 1000;
+    AssertDo(!pcfl->FReadRghq(rgcki, 3, rghq), 0);
+    AssertDo(rghq[0] == hqNil && rghq[1] == hqNil && rghq[2] == hqNil, 0);
+    AssertDo(!pcfl->FFindRgblck(rgcki, 3, rgblck) && rgblck[0].Cb(fTrue) == 0, 0);
+
+    // batch packing skips packed and incompressible chunks
+    AssertDo(pcfl->FPutPv(rgb, size(rgb), kctgLan + 3, 3), 0);
+    rgcki[2].ctg = kctgLan + 3;
+    rgcki[2].cno = 3;
+    AssertDo(pcfl->FPackDataRgcki(rgcki, 3), 0);
+    AssertDo(!pcfl->FPacked(kctgLan + 2, 199) && pcfl->FPacked(kctgLan + 3, 3), 0);
+    AssertDo(pcfl->FReadRghq(&rgcki[2], 1, rghq), 0);
+    AssertDo(CbOfHq(rghq[0]) == size(rgb) && FEqualRgb(PvLockHq(rghq[0]), rgb, size(rgb)), 0);
+    UnlockHq(rghq[0]);
+    FreePhq(&rghq[0]);
+    pcfl->Delete(kctgLan + 3, 3);
+
+    // identical data is only stored once
+    FillPb(rgb, size(rgb), 0x66);
+    AssertDo(pcfl->FPutPv(rgb, size(rgb), kctgLan + 3, 1) && pcfl->FPutPv(rgb, size(rgb), kctgLan + 3, 2), 0);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cbShared == size(rgb), 0);
+    AssertPo(pcfl, fcflFull);
+    pcfl->Delete(kctgLan + 3, 1);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cbShared == 0, 0);
+
+    // temp files pack with the fast codec and saving to a real file repacks
+    if (vpcodmUtil->FCanDo(kcfmtKauaiFast, fTrue))
+    {
+        AssertDo(pcfl->FPackData(kctgLan + 3, 2) && pcfl->FFind(kctgLan + 3, 2, &blck), 0);
+        AssertDo(blck.FPacked(&cfmt) && cfmt == kcfmtKauaiFast, 0);
+        AssertDo(fni.FGetTemp() && pcfl->FSave(kctgLan, &fni), 0);
+        AssertDo(pcfl->FFind(kctgLan + 3, 2, &blck) && blck.FPacked(&cfmt) && cfmt != kcfmtKauaiFast, 0);
+    }
+    AssertDo(pcfl->FReadHq(kctgLan + 3, 2, &rghq[0]), 0);
+    AssertDo(CbOfHq(rghq[0]) == size(rgb) && FEqualRgb(PvLockHq(rghq[0]), rgb, size(rgb)), 0);
+    UnlockHq(rghq[0]);
+    FreePhq(&rghq[0]);
+    ReleasePpo(&pcfl);
+
+    // small saves go in the index journal - make sure it reads back
+    AssertDo(fni.FGetTemp(), 0);
+    AssertDo((pcfl = CFL::PcflCreate(&fni, fcflWriteEnable)) != pvNil, 0);
+    for (icki = 0; icki < 600; icki++)
+        AssertDo(pcfl->FPutPv(&icki, size(long), kctgLan, icki), 0);
+    AssertDo(pcfl->FPutPv(rgb, size(rgb), kctgLan + 2, 0) && pcfl->FPutPv(rgb, size(rgb), kctgLan + 2, 1), 0);
+    AssertDo(pcfl->FSave(kctgLan), 0);
+    for (icki = 0; icki < 600; icki += 100)
+    {
+        pcfl->Delete(kctgLan, icki);
+        AssertDo(pcfl->FPutPv(&icki, size(long), kctgLan + 1, icki), 0);
+        AssertDo(pcfl->FSave(kctgLan), 0);
+    }
+    ReleasePpo(&pcfl);
+    AssertDo((pcfl = CFL::PcflOpen(&fni, fcflNil)) != pvNil, 0);
+    AssertDo(pcfl->CckiCtg(kctgLan) == 594 && pcfl->CckiCtg(kctgLan + 1) == 6, 0);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cbShared == size(rgb) && !alst.fValidated, 0);
+    for (icki = 0; pcfl->FGetCkiCtg(kctgLan + 1, icki, &cki); icki++)
+    {
+        AssertDo(pcfl->FFind(cki.ctg, cki.cno, &blck) && blck.FReadRgb(&cno, size(long), 0), 0);
+        AssertDo(cno == cki.cno && cno == icki * 100, 0);
+    }
+    ReleasePpo(&pcfl);
+    AssertDo((pcfl = CFL::PcflOpen(&fni, fcflValidate)) != pvNil, 0);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.fValidated, 0);
+    ReleasePpo(&pcfl);
+
+    // switch to the large format (the first save rewrites the index, the
+    // next one goes in the journal) and make sure it reads back
+    AssertDo((pcfl = CFL::PcflOpen(&fni, fcflWriteEnable | fcflLarge)) != pvNil, 0);
+    AssertDo(pcfl->FSave(kctgLan), 0);
+    icki = 1000;
+    AssertDo(pcfl->FPutPv(&icki, size(long), kctgLan + 1, icki) && pcfl->FSave(kctgLan), 0);
+    ReleasePpo(&pcfl);
+    AssertDo((pcfl = CFL::PcflOpen(&fni, fcflValidate)) != pvNil, 0);
+    AssertDo(pcfl->CckiCtg(kctgLan) == 594 && pcfl->CckiCtg(kctgLan + 1) == 7, 0);
+    pcfl->GetAlst(&alst);
+    AssertDo(alst.cbShared == size(rgb), 0);
+    AssertDo(pcfl->FFind(kctgLan + 1, 1000, &blck) && blck.FReadRgb(&cno, size(long), 0) && cno == 1000, 0);
+    pcfl->SetTemp(fTrue);
+    ReleasePpo(&pcfl);
+
+    // kids come back sorted by (chid, ctg, cno) and can be enumerated by chid
+    AssertDo((pcfl = CFL::PcflCreateTemp()) != pvNil, 0);
+    AssertDo(pcfl->FPutPv(pvNil, 0, kctgLan, 0), 0);
+    for (icki = 0; icki < 300; icki++)
+    {
+        AssertDo(pcfl->FPutPv(pvNil, 0, kctgKatz + icki % 2, icki), 0);
+        AssertDo(pcfl->FAdoptChild(kctgLan, 0, kctgKatz + icki % 2, icki, icki * 7 % 10), 0);
+    }
+    pcfl->InitKde(kctgLan, 0, &kde);
+    for (icki = 0; pcfl->FNextKid(&kde, &kid, &ikid); icki++)
+    {
+        AssertDo(ikid == icki && pcfl->FGetKid(kctgLan, 0, icki, &kidT), 0);
+        AssertDo(FEqualRgb(&kid, &kidT, size(KID)), 0);
+        AssertDo(icki == 0 || kid.chid > kidPrev.chid || kid.chid == kidPrev.chid && kid.cki.ctg >= kidPrev.cki.ctg,
+                 0);
+        kidPrev = kid;
+    }
+    AssertDo(icki == 300, 0);
+    pcfl->InitKdeChid(kctgLan, 0, 3, &kde);
+    for (icki = 0; pcfl->FNextKid(&kde, &kid); icki++)
+        AssertDo(kid.chid == 3 && kid.cki.cno * 7 % 10 == 3, 0);
+    AssertDo(icki == 30, 0);
+    pcfl->InitKdeChid(kctgLan, 0, 10, &kde);
+    AssertDo(!pcfl->FNextKid(&kde, &kid), 0);
+    AssertPo(pcfl, fcflFull);
+    ReleasePpo(&pcfl);
+}
+
 /******************************************************************************
     Test the error registration code.
 ******************************************************************************/
@@ -622,6 +1000,96 @@ void TestErs(void)
     Assert(vpers->Cerc() == 0, "bad count of error codes on stack");
 }
 
+/***************************************************************************
+    Round trip patterned data through each Kauai compression format at
+    each compression level. The data mixes short overlapping runs, literal
+    stretches and far matches so every decoder path gets exercised. The
+    tail doesn't compress, so the last kcfmtBlocked piece is stored raw.
+    Also checks a kcfmtKauai2Dict round trip.
+***************************************************************************/
+void TestCodec(void)
+{
+    const long cbSrc = 2 * kcbCodecBlock + 0x1234;
+    const long rgcfmt[] = {kcfmtKauai, kcfmtKauai2, kcfmtKauaiFast, kcfmtBlocked};
+    KCDC kcdc;
+    KCDF kcdf;
+    PCODM pcodm;
+    BLCK blck;
+    HQ hq;
+    byte *prgbSrc, *prgbCmp, *prgbDst;
+    long ib, icfmt, cml, cbCmp, cbDst;
+    ulong luDict;
+
+    if (pvNil == (pcodm = NewObj CODM(&kcdc, kcfmtKauai)) || !pcodm->FRegisterCodec(&kcdf))
+    {
+        Bug("creating codm failed");
+        ReleasePpo(&pcodm);
+        return;
+    }
+    if (!FAllocPv((void **)&prgbSrc, 3 * cbSrc, fmemClear, mprNormal))
+    {
+        Bug("allocating codec buffers failed");
+        ReleasePpo(&pcodm);
+        return;
+    }
+    prgbCmp = prgbSrc + cbSrc;
+    prgbDst = prgbCmp + cbSrc;
+
+    for (ib = 0; ib < cbSrc; ib++)
+    {
+        switch (ib >= 2 * kcbCodecBlock ? 1 : (ib >> 9) & 3)
+        {
+        case 0:
+            prgbSrc[ib] = (byte)(ib % ((ib >> 11) + 1));
+            break;
+        case 1:
+            prgbSrc[ib] = (byte)(ib * 0x9E3779B1 >> 13);
+            break;
+        default:
+            prgbSrc[ib] = prgbSrc[ib - 0x400 + (ib & 0x0F)];
+            break;
+        }
+    }
+
+    for (cml = 0; cml < kcmlLim; cml++)
+    {
+        pcodm->SetCmlDefault(cml);
+        for (icfmt = 0; icfmt < CvFromRgv(rgcfmt); icfmt++)
+        {
+            AssertDo(pcodm->FCompress(prgbSrc, cbSrc, prgbCmp, cbSrc, &cbCmp, rgcfmt[icfmt]), 0);
+            AssertDo(pcodm->FDecompress(prgbCmp, cbCmp, prgbDst, cbSrc, &cbDst), 0);
+            Assert(cbDst == cbSrc, "wrong decompressed size");
+            Assert(fcmpEq == FcmpCompareRgb(prgbSrc, prgbDst, cbSrc), "round trip mismatch");
+        }
+    }
+
+    // unpack ranges of blocked data - one spanning all three pieces and
+    // one inside the raw piece
+    AssertDo(pcodm->FCompress(prgbSrc, cbSrc, prgbCmp, cbSrc, &cbCmp, kcfmtBlocked), 0);
+    AssertDo(FAllocHq(&hq, cbCmp, fmemNil, mprNormal), 0);
+    CopyPb(prgbCmp, QvFromHq(hq), cbCmp);
+    blck.SetHq(&hq, fTrue);
+    ClearPb(prgbDst, cbSrc);
+    ib = kcbCodecBlock - 0x100;
+    AssertDo(pcodm->FDecompressRgbFromBlck(&blck, prgbDst, cbSrc - ib, ib), 0);
+    Assert(fcmpEq == FcmpCompareRgb(prgbSrc + ib, prgbDst, cbSrc - ib), "blocked range mismatch");
+    ib = 2 * kcbCodecBlock + 0x10;
+    AssertDo(pcodm->FDecompressRgbFromBlck(&blck, prgbDst, 0x100, ib), 0);
+    Assert(fcmpEq == FcmpCompareRgb(prgbSrc + ib, prgbDst, 0x100), "blocked range mismatch");
+
+    // a small piece primed with a dictionary taken from the data before it
+    AssertDo(pcodm->FAddDict(prgbSrc, 0x1000, &luDict), 0);
+    AssertDo(pcodm->FCompress(prgbSrc + 0x1000, 0x300, prgbCmp, cbSrc, &cbCmp, kcfmtKauai2Dict, luDict), 0);
+    AssertDo(pcodm->FDecompress(prgbCmp, cbCmp, prgbDst, cbSrc, &cbDst), 0);
+    Assert(cbDst == 0x300, "wrong decompressed size");
+    Assert(fcmpEq == FcmpCompareRgb(prgbSrc + 0x1000, prgbDst, 0x300), "dictionary round trip mismatch");
+    pcodm->ReleaseDict(luDict);
+    Assert(!pcodm->FHasDict(luDict), "dictionary not released");
+
+    FreePpv((void **)&prgbSrc);
+    ReleasePpo(&pcodm);
+}
+
 /******************************************************************************
     Test chunky resource file
 ******************************************************************************/
@@ -634,6 +1102,9 @@ void TestCrf(void)
     PGHQ rgpghq[cnoLim];
     PCFL pcfl;
     PCRF pcrf;
+    PCRM pcrm;
+    PCFL rgpcfl[2];
+    long icrf, cact;
     HQ hq;
     PGHQ pghq;
 
@@ -692,5 +1163,105 @@ void TestCrf(void)
         ReleasePpo(&rgpghq[cno]);
     }
 
+    // prefetched objects are the same as ones read directly
+    pcrf->SetCbMax(0);
+    pcrf->SetCbMax(50);
+    for (cno = 0; cno < cnoLim; cno++)
+        AssertDo(tYes == pcrf->TPrefetch(ctg, cno, GHQ::FReadGhq, 20), 0);
+    Assert(tNo == pcrf->TPrefetch(ctg, cnoLim, GHQ::FReadGhq, 20), "prefetched a missing chunk");
+    CRF::CompletePrefetches();
+    for (cno = 0; cno < cnoLim; cno++)
+    {
+        pghq = (PGHQ)pcrf->PbacoFetch(ctg, cno, GHQ::FReadGhq);
+        AssertPo(pghq, 0);
+        hq = pghq->hq;
+        Assert(CbOfHq(hq) == 11, "wrong length");
+        Assert(FEqualRgb(QvFromHq(hq), "Test string", 11), "bad bytes");
+        ReleasePpo(&pghq);
+    }
+
+    // objects pushed out of a small cache come back from the second tier
+    pcrf->SetCbMax(0);
+    pcrf->SetCbMax(22);
+    pcrf->SetCbMaxPacked(1000);
+    for (cact = 0; cact < 2; cact++)
+    {
+        for (cno = 0; cno < cnoLim; cno++)
+        {
+            pghq = (PGHQ)pcrf->PbacoFetch(ctg, cno, GHQ::FReadGhq);
+            AssertPo(pghq, 0);
+            hq = pghq->hq;
+            Assert(CbOfHq(hq) == 11, "wrong length");
+            Assert(FEqualRgb(QvFromHq(hq), "Test string", 11), "bad bytes");
+            ReleasePpo(&pghq);
+        }
+
+        // the loaded chunks get into the second tier at idle time
+        while (CRF::CpfePending() > 0)
+            CRF::CompletePrefetches();
+    }
+
+    // only the last couple of objects fit in the cache, so the second pass
+    // should have gotten the rest from the second tier
+    Assert(pcrf->CactHitPacked() >= cnoLim - 2, "second tier not used");
+    pcrf->SetCbMaxPacked(0);
+
+    // when the cache is full, lower creps are tossed first, then the ones
+    // released longest ago
+    pcrf->SetCbMax(0);
+    pcrf->SetCbMax(33);
+    pcrf->TLoad(ctg, 0, GHQ::FReadGhq, rscNil, 10);
+    for (cact = 0; cact < 16; cact++)
+        pcrf->TLoad(ctg, 1, GHQ::FReadGhq, rscNil, 20);
+    pcrf->TLoad(ctg, 2, GHQ::FReadGhq, rscNil, 10);
+    AssertDo(tYes == pcrf->TLoad(ctg, 3, GHQ::FReadGhq, rscNil, 30), 0);
+    Assert(pvNil == pcrf->PbacoFind(ctg, 0, GHQ::FReadGhq), "older object not tossed first");
+    AssertDo(tYes == pcrf->TLoad(ctg, 4, GHQ::FReadGhq, rscNil, 30), 0);
+    Assert(pvNil == pcrf->PbacoFind(ctg, 2, GHQ::FReadGhq), "lower crep not tossed first");
+    AssertDo(tYes == pcrf->TLoad(ctg, 5, GHQ::FReadGhq, rscNil, 30), 0);
+    Assert(pvNil == pcrf->PbacoFind(ctg, 1, GHQ::FReadGhq), "lower crep not tossed first");
+    for (cno = 3; cno < 6; cno++)
+    {
+        pghq = (PGHQ)pcrf->PbacoFind(ctg, cno, GHQ::FReadGhq);
+        AssertPo(pghq, 0);
+        ReleasePpo(&pghq);
+    }
+
     ReleasePpo(&pcrf);
+
+    // a CRM looks chunks up in the first file that has them
+    if (pvNil == (pcrm = CRM::PcrmNew(2)))
+    {
+        Bug("creating CRM failed");
+        return;
+    }
+    for (icrf = 0; icrf < 2; icrf++)
+    {
+        if (!fni.FGetTemp() || pvNil == (rgpcfl[icrf] = CFL::PcflCreate(&fni, fcflWriteEnable | fcflTemp)))
+        {
+            Bug("creating chunky file failed");
+            ReleasePpo(&pcrm);
+            return;
+        }
+        for (cno = icrf * cnoLim / 2; cno < cnoLim + icrf * cnoLim / 2; cno++)
+            AssertDo(rgpcfl[icrf]->FPutPv("Test string", 11, ctg, cno), 0);
+        AssertDo(pcrm->FAddCfl(rgpcfl[icrf], 50), 0);
+        ReleasePpo(&rgpcfl[icrf]);
+    }
+
+    for (cno = 0; cno < cnoLim + cnoLim / 2; cno++)
+    {
+        Assert(pcrm->PcrfFindChunk(ctg, cno) == pcrm->PcrfGet(cno < cnoLim ? 0 : 1), "wrong CRF");
+    }
+    Assert(pvNil == pcrm->PcrfFindChunk(ctg, 2 * cnoLim), "found missing chunk");
+
+    // changing a file's chunks is noticed
+    AssertDo(pcrm->PcrfGet(1)->Pcfl()->FPutPv("Test string", 11, ctg, 2 * cnoLim), 0);
+    Assert(pcrm->PcrfFindChunk(ctg, 2 * cnoLim) == pcrm->PcrfGet(1), "didn't find new chunk");
+    pcrm->PcrfGet(0)->Pcfl()->Delete(ctg, 0);
+    Assert(pvNil == pcrm->PcrfFindChunk(ctg, 0), "found deleted chunk");
+    pcrm->PcrfGet(0)->Pcfl()->Delete(ctg, cnoLim / 2);
+    Assert(pcrm->PcrfFindChunk(ctg, cnoLim / 2) == pcrm->PcrfGet(1), "wrong CRF after delete");
+
+    ReleasePpo(&pcrm);
 }
@@ -33,5 +33,7 @@ void MarkUtilMem(void)
 
     for (pfil = FIL::PfilFirst(); pfil != pvNil; pfil = pfil->PfilNext())
         MarkMemObj(pfil);
+
+    CRF::MarkPrefetches();
 }
 #endif // DEBUG
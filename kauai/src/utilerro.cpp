@@ -17,6 +17,7 @@ ASSERTNAME
 
 ERS _ers;
 ERS *vpers = &_ers;
+thread_local DFR *vpdfrCur;
 
 RTCLASS(ERS)
 
@@ -40,6 +41,14 @@ void ERS::Push(long erc)
 {
     AssertThis(0);
 
+    if (pvNil != vpdfrCur)
+    {
+        // this thread is working for another one, which reports the error
+        if (0 == vpdfrCur->cerc++)
+            vpdfrCur->ercFirst = erc;
+        return;
+    }
+
 #ifdef DEBUG
     STN stn;
     SZS szs;
@@ -180,7 +189,74 @@ void ERS::Flush(long erc)
     _mutx.Leave();
 }
 
+/***************************************************************************
+    Report the failures a helper thread collected in *pdfr (see DFR) on
+    this thread, and clear *pdfr. Only the first error, and the first
+    failed assert or warning, is reported.
+***************************************************************************/
+void ReportDfr(DFR *pdfr)
+{
+    AssertVarMem(pdfr);
+    Assert(pdfr != vpdfrCur, "reporting failures to themselves");
+
+#ifdef DEBUG
+    if (pdfr->cbug > 0)
+    {
+        if (FAssertProcCur(pdfr->pszsFile, pdfr->lwLine, pdfr->pszsMsg, pvNil, 0))
+            Debugger();
+    }
+    else if (pdfr->cwarn > 0)
+        WarnProcCur(pdfr->pszsFile, pdfr->lwLine, pdfr->pszsMsg);
+#endif // DEBUG
+    if (pdfr->cerc > 0)
+        PushErc(pdfr->ercFirst);
+
+    ClearPb(pdfr, size(DFR));
+}
+
 #ifdef DEBUG
+/***************************************************************************
+    Report a failed assert, or collect it if this thread is working for
+    another one.
+***************************************************************************/
+bool FAssertProcCur(PSZS pszsFile, long lwLine, PSZS pszsMsg, void *pv, long cb)
+{
+    DFR *pdfr = vpdfrCur;
+
+    if (pvNil == pdfr)
+        return FAssertProc(pszsFile, lwLine, pszsMsg, pv, cb);
+
+    if (0 == pdfr->cbug++)
+    {
+        pdfr->pszsFile = pszsFile;
+        pdfr->lwLine = lwLine;
+        pdfr->pszsMsg = pszsMsg;
+    }
+    return fFalse;
+}
+
+/***************************************************************************
+    Report a warning, or collect it if this thread is working for another
+    one.
+***************************************************************************/
+void WarnProcCur(PSZS pszsFile, long lwLine, PSZS pszsMsg)
+{
+    DFR *pdfr = vpdfrCur;
+
+    if (pvNil == pdfr)
+    {
+        WarnProc(pszsFile, lwLine, pszsMsg);
+        return;
+    }
+
+    if (0 == pdfr->cwarn++ && 0 == pdfr->cbug)
+    {
+        pdfr->pszsFile = pszsFile;
+        pdfr->lwLine = lwLine;
+        pdfr->pszsMsg = pszsMsg;
+    }
+}
+
 /***************************************************************************
     Assert the error stack is valid.
 ***************************************************************************/
@@ -60,6 +60,30 @@ class ERS : public ERS_PAR
 
 extern ERS *vpers;
 
+/***************************************************************************
+    Deferred failures. A helper thread doing work for another thread (eg,
+    the CODM batch coders) doesn't report its own errors, failed asserts
+    or warnings, since the owning thread is the one that knows what the
+    work was for. While the helper's vpdfrCur is set, they're collected in
+    the DFR instead, and the owning thread calls ReportDfr when the work
+    is done.
+***************************************************************************/
+struct DFR
+{
+    long cerc;     // number of errors pushed
+    long ercFirst; // the first of them
+#ifdef DEBUG
+    long cbug;  // number of failed asserts
+    long cwarn; // number of warnings
+    PSZS pszsFile; // where the first failed assert (or warning) was
+    long lwLine;
+    PSZS pszsMsg;
+#endif // DEBUG
+};
+
+extern thread_local DFR *vpdfrCur;
+void ReportDfr(DFR *pdfr);
+
 #ifdef DEBUG
 #define PushErc(erc) vpers->Push(erc, __szsFile, __LINE__)
 #else //! DEBUG
@@ -41,6 +41,9 @@ RND vrndUtil;
 // Standard Kauai codec
 KCDC vkcdcUtil;
 
+// Fast Kauai codec - apps register this for their temporary data
+KCDF vkcdfUtil;
+
 // Standard compression manager - gets initialized with the standard
 // Kauai codec. Clients can add additional codecs or redirect vpcodmUtil
 // to a different compression manager with their own codecs
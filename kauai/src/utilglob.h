@@ -60,6 +60,10 @@ inline ulong TsCurrentSystem(void)
     // n.b. WIN: timeGetTime is more accurate than GetTickCount
     return MacWin(TickCount(), timeGetTime());
 }
+// high resolution system time in microseconds - for profiling
+const ulong kdtsPreciseSecond = 1000000;
+ulong TsCurrentPrecise(void);
+
 inline ulong DtsCaret(void)
 {
     return MacWin(GetCaretTime(), GetCaretBlinkTime());
@@ -84,8 +88,10 @@ extern RND vrndUtil;
     Global standard Kauai codec, compression manager, and pointer to
     a compression manager. The blck-level compression uses vpcodmUtil.
     Clients are free to redirect this to their own compression manager.
+    vkcdfUtil is the fast Kauai codec. APPB registers it with vpcodmUtil.
 ***************************************************************************/
 extern KCDC vkcdcUtil;
+extern KCDF vkcdfUtil;
 extern CODM vcodmUtil;
 extern PCODM vpcodmUtil;
 
@@ -17,6 +17,69 @@
 
 ASSERTNAME
 
+// vectors for bulk byte swapping
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#include <emmintrin.h>
+#define VECTOR_SWAP
+typedef __m128i VSWP;
+
+inline VSWP _VswpLoad(void *pv)
+{
+    return _mm_loadu_si128((__m128i *)pv);
+}
+inline void _StoreVswp(void *pv, VSWP vswp)
+{
+    _mm_storeu_si128((__m128i *)pv, vswp);
+}
+inline VSWP _VswpSwapSw(VSWP vswp)
+{
+    return _mm_or_si128(_mm_slli_epi16(vswp, 8), _mm_srli_epi16(vswp, 8));
+}
+inline VSWP _VswpSwapLw(VSWP vswp)
+{
+    vswp = _VswpSwapSw(vswp);
+    vswp = _mm_shufflelo_epi16(vswp, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(vswp, _MM_SHUFFLE(2, 3, 0, 1));
+}
+// take the bytes in vswpMaskLw from vswpLw, the bytes in vswpMaskSw from
+// vswpSw and the rest from vswp
+inline VSWP _VswpBlend(VSWP vswp, VSWP vswpLw, VSWP vswpSw, VSWP vswpMaskLw, VSWP vswpMaskSw)
+{
+    return _mm_or_si128(_mm_andnot_si128(_mm_or_si128(vswpMaskLw, vswpMaskSw), vswp),
+                        _mm_or_si128(_mm_and_si128(vswpMaskLw, vswpLw), _mm_and_si128(vswpMaskSw, vswpSw)));
+}
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VECTOR_SWAP
+typedef uint8x16_t VSWP;
+
+inline VSWP _VswpLoad(void *pv)
+{
+    return vld1q_u8((uint8_t *)pv);
+}
+inline void _StoreVswp(void *pv, VSWP vswp)
+{
+    vst1q_u8((uint8_t *)pv, vswp);
+}
+inline VSWP _VswpSwapSw(VSWP vswp)
+{
+    return vrev16q_u8(vswp);
+}
+inline VSWP _VswpSwapLw(VSWP vswp)
+{
+    return vrev32q_u8(vswp);
+}
+inline VSWP _VswpBlend(VSWP vswp, VSWP vswpLw, VSWP vswpSw, VSWP vswpMaskLw, VSWP vswpMaskSw)
+{
+    return vorrq_u8(vbicq_u8(vswp, vorrq_u8(vswpMaskLw, vswpMaskSw)),
+                    vorrq_u8(vandq_u8(vswpMaskLw, vswpLw), vandq_u8(vswpMaskSw, vswpSw)));
+}
+#endif
+
+#ifdef VECTOR_SWAP
+const long kcbVswp = 16;
+#endif // VECTOR_SWAP
+
 /***************************************************************************
     Calculates the GCD of two longs.
 ***************************************************************************/
@@ -450,6 +513,10 @@ void SwapBytesRgsw(void *psw, long csw)
     byte *pb = (byte *)psw;
 
     Assert(size(short) == 2, "code broken");
+#ifdef VECTOR_SWAP
+    for (; csw >= kcbVswp / 2; csw -= kcbVswp / 2, pb += kcbVswp)
+        _StoreVswp(pb, _VswpSwapSw(_VswpLoad(pb)));
+#endif // VECTOR_SWAP
     for (; csw > 0; csw--, pb += 2)
     {
         b = pb[1];
@@ -470,6 +537,10 @@ void SwapBytesRglw(void *plw, long clw)
     byte *pb = (byte *)plw;
 
     Assert(size(long) == 4, "code broken");
+#ifdef VECTOR_SWAP
+    for (; clw >= kcbVswp / 4; clw -= kcbVswp / 4, pb += kcbVswp)
+        _StoreVswp(pb, _VswpSwapLw(_VswpLoad(pb)));
+#endif // VECTOR_SWAP
     for (; clw > 0; clw--, pb += 4)
     {
         b = pb[3];
@@ -481,6 +552,143 @@ void SwapBytesRglw(void *plw, long clw)
     }
 }
 
+/***************************************************************************
+    Compile bom into a swap plan for arrays of a struct of size cb.
+    Adjacent swapped fields of the same size are merged into runs, and
+    if the long fields are long aligned, masks are built so that whole
+    vectors can be swapped at once.
+***************************************************************************/
+void CompileBom(BOM bom, long cb, PSWPL pswpl)
+{
+    AssertIn(cb, 1, kcbMax);
+    AssertVarMem(pswpl);
+
+    long ib, cbFld;
+    byte *pbMask;
+    SWRN *pswrn = pvNil;
+
+    Assert(size(short) == 2 && size(long) == 4, "code broken");
+    ClearPb(pswpl, size(SWPL));
+    pswpl->cb = cb;
+    pswpl->fMask = cb <= kcbSwplMask && (cb % size(long)) == 0;
+    for (ib = 0; bom != 0; bom <<= 2, ib += cbFld)
+    {
+        cbFld = (bom & 0x80000000L) ? 4 : 2;
+        if (!(bom & 0x40000000L))
+            continue;
+
+        if (pvNil != pswrn && pswrn->cbFld == cbFld && pswrn->ib + pswrn->cfld * cbFld == ib)
+            pswrn->cfld++;
+        else
+        {
+            pswrn = &pswpl->rgswrn[pswpl->cswrn++];
+            pswrn->ib = (short)ib;
+            pswrn->cfld = 1;
+            pswrn->cbFld = (short)cbFld;
+        }
+
+        if (cbFld == 4 && (ib % 4) != 0 || ib + cbFld > cb)
+            pswpl->fMask = fFalse;
+        if (pswpl->fMask)
+        {
+            pbMask = (cbFld == 4) ? pswpl->rgbLong : pswpl->rgbShort;
+            FillPb(pbMask + ib, cbFld, 0xFF);
+        }
+    }
+    Assert(ib <= cb, "bom is bigger than the struct");
+
+    if (pswpl->fMask)
+    {
+        // repeat the masks so a vector starting anywhere in the struct
+        // can be read from them
+        for (ib = cb; ib < cb + 16; ib++)
+        {
+            pswpl->rgbLong[ib] = pswpl->rgbLong[ib - cb];
+            pswpl->rgbShort[ib] = pswpl->rgbShort[ib - cb];
+        }
+    }
+}
+
+/***************************************************************************
+    Swap bytes in an array of cv structs according to a swap plan (see
+    CompileBom).
+***************************************************************************/
+void SwapBytesRgvSwpl(void *pv, long cv, PSWPL pswpl)
+{
+    AssertVarMem(pswpl);
+    AssertIn(pswpl->cswrn, 0, kcswrnMax + 1);
+    AssertIn(cv, 0, kcbMax);
+    AssertPvCb(pv, LwMul(cv, pswpl->cb));
+
+    SWRN *pswrn, *pswrnLim;
+    byte *pb = (byte *)pv;
+
+    if (0 == cv || 0 == pswpl->cswrn)
+        return;
+
+    pswrn = pswpl->rgswrn;
+    if (1 == pswpl->cswrn && 0 == pswrn->ib && pswrn->cfld * pswrn->cbFld == pswpl->cb)
+    {
+        // the struct is nothing but swapped longs or shorts
+        if (4 == pswrn->cbFld)
+            SwapBytesRglw(pv, LwMul(cv, pswpl->cb) / 4);
+        else
+            SwapBytesRgsw(pv, LwMul(cv, pswpl->cb) / 2);
+        return;
+    }
+
+#ifdef VECTOR_SWAP
+    if (pswpl->fMask)
+    {
+        // keep these in locals, since the stores could alias pswpl
+        VSWP vswp;
+        long ib = 0; // offset in the struct
+        long cbStruct = pswpl->cb;
+        long cb = LwMul(cv, cbStruct);
+        byte *pbLong = pswpl->rgbLong;
+        byte *pbShort = pswpl->rgbShort;
+
+        for (; cb >= kcbVswp; cb -= kcbVswp, pb += kcbVswp)
+        {
+            vswp = _VswpLoad(pb);
+            _StoreVswp(pb, _VswpBlend(vswp, _VswpSwapLw(vswp), _VswpSwapSw(vswp), _VswpLoad(pbLong + ib),
+                                      _VswpLoad(pbShort + ib)));
+            for (ib += kcbVswp; ib >= cbStruct;)
+                ib -= cbStruct;
+        }
+
+        // the rest is whole longs
+        for (; cb > 0; cb -= 4, pb += 4)
+        {
+            if (pbLong[ib])
+                SwapBytesRglw(pb, 1);
+            else
+            {
+                if (pbShort[ib])
+                    SwapBytesRgsw(pb, 1);
+                if (pbShort[ib + 2])
+                    SwapBytesRgsw(pb + 2, 1);
+            }
+            if ((ib += 4) >= cbStruct)
+                ib = 0;
+        }
+        return;
+    }
+#endif // VECTOR_SWAP
+
+    pswrnLim = pswrn + pswpl->cswrn;
+    for (; cv > 0; cv--, pb += pswpl->cb)
+    {
+        for (pswrn = pswpl->rgswrn; pswrn < pswrnLim; pswrn++)
+        {
+            if (4 == pswrn->cbFld)
+                SwapBytesRglw(pb + pswrn->ib, pswrn->cfld);
+            else
+                SwapBytesRgsw(pb + pswrn->ib, pswrn->cfld);
+        }
+    }
+}
+
 #ifdef DEBUG
 /***************************************************************************
     Asserts that the given BOM indicates a struct having cb/size(long) longs
@@ -1104,6 +1312,30 @@ ulong USAC::TsCur(void)
     return _tsBaseApp + dtsSys;
 }
 
+/***************************************************************************
+    Return the current system time in microseconds, from the highest
+    resolution timer we have. This wraps around every 71 minutes or so,
+    so it's only good for timing things (differences).
+***************************************************************************/
+ulong TsCurrentPrecise(void)
+{
+#ifdef WIN
+    static LARGE_INTEGER _liFreq;
+    LARGE_INTEGER li;
+
+    if (0 == _liFreq.QuadPart && !QueryPerformanceFrequency(&_liFreq))
+        _liFreq.QuadPart = -1;
+    if (_liFreq.QuadPart <= 0 || !QueryPerformanceCounter(&li))
+        return timeGetTime() * (kdtsPreciseSecond / kdtsSecond);
+
+    // don't overflow the multiply on machines that have been up a while
+    return (ulong)((li.QuadPart / _liFreq.QuadPart) * kdtsPreciseSecond +
+                   (li.QuadPart % _liFreq.QuadPart) * kdtsPreciseSecond / _liFreq.QuadPart);
+#else  //! WIN
+    return TickCount() * (kdtsPreciseSecond / kdtsSecond);
+#endif //! WIN
+}
+
 /***************************************************************************
     Scale the time.
 ***************************************************************************/
@@ -334,6 +334,42 @@ void AssertBomRgsw(BOM bom, long cb);
 #define AssertBomRgsw(bom, cb)
 #endif //! DEBUG
 
+/****************************************
+    Swap plans - a BOM compiled for
+    swapping arrays of the struct it
+    describes
+****************************************/
+const long kcswrnMax = 16;  // a BOM has at most 16 fields
+const long kcbSwplMask = 64; // structs at most this big get masks
+
+// swap run - a run of adjacent fields of the same size to swap
+struct SWRN
+{
+    short ib;    // offset of the first field in the struct
+    short cfld;  // number of fields
+    short cbFld; // size(short) or size(long)
+};
+
+// swap plan
+struct SWPL
+{
+    long cb;    // size of the struct (the stride of the array)
+    long cswrn; // number of runs
+    SWRN rgswrn[kcswrnMax];
+
+    // If fMask is set, all long fields are long aligned and the struct is
+    // a multiple of size(long), so whole vectors can be swapped at once.
+    // rgbLong and rgbShort have 0xFF in the bytes of swapped longs and
+    // shorts, repeated to cover a vector starting anywhere in the struct.
+    bool fMask;
+    byte rgbLong[kcbSwplMask + 16];
+    byte rgbShort[kcbSwplMask + 16];
+};
+typedef SWPL *PSWPL;
+
+void CompileBom(BOM bom, long cb, PSWPL pswpl);
+void SwapBytesRgvSwpl(void *pv, long cv, PSWPL pswpl);
+
 /****************************************
     OS level rectangle and point
 ****************************************/
@@ -54,15 +54,370 @@ priv void _AssertMbh(MBH *pmbh);
 #define free(pv) delete (pv)
 #endif // MAC
 #ifdef WIN
-#define malloc(cb) (void *)GlobalAlloc(GMEM_FIXED, cb)
-#define free(pv) GlobalFree((HGLOBAL)pv)
-#define _msize(pv) GlobalSize((HGLOBAL)pv)
-#define realloc(pv, cb) (void *)GlobalReAlloc((HGLOBAL)pv, cb, GMEM_MOVEABLE)
+#define _PvAllocOs(cb) (void *)GlobalAlloc(GMEM_FIXED, cb)
+#define _FreeOs(pv) GlobalFree((HGLOBAL)pv)
+#define _PvReallocOs(pv, cb) (void *)GlobalReAlloc((HGLOBAL)pv, cb, GMEM_MOVEABLE)
+
+priv void *_PvAllocMem(long cb);
+priv void _FreeMem(void *pv);
+priv void *_PvReallocMem(void *pv, long cb);
+priv long _CbOfMem(void *pv);
+
+#define malloc(cb) _PvAllocMem(cb)
+#define free(pv) _FreeMem(pv)
+#define _msize(pv) _CbOfMem(pv)
+#define realloc(pv, cb) _PvReallocMem(pv, cb)
 #endif // WIN
 
 PFNLIB vpfnlib = pvNil;
 bool _fInLiberator = fFalse;
 
+#ifdef WIN
+/***************************************************************************
+    Size class pools.  Requests for up to kcbPoolMax bytes are rounded up
+    to one of kcpclMem size classes.  Freed blocks go on a per thread
+    cache for their class and overflow from there into a shared depot
+    (protected by vmutxMem), so churning small blocks rarely goes to the
+    OS.  Each block is still allocated from the OS on its own, so when
+    the OS runs out, the pools can be flushed back to it (before vpfnlib
+    is asked to free anything).  Every block starts with a PBH saying
+    which class it's in, or that it's too big to pool.
+***************************************************************************/
+const long kcbPoolMax = 1024;
+const long kcblkCacheMax = 64;  // max free blocks a thread caches per class
+const long kcblkBatch = 16;     // blocks moved from the depot to a cache at once
+const long kcblkDepotMax = 256; // max free blocks in the depot per class
+const long ipclNil = -1;
+
+// pooled block header
+struct PBH
+{
+    long ipcl; // size class, ipclNil if not pooled
+    long cb;   // size of the client area
+};
+
+// the client area keeps the alignment the OS gives us
+const long kcbPbh = 2 * size(void *);
+
+// a thread's cache of free pooled blocks (linked through the client area)
+struct MTC
+{
+    bool fDead;                 // the thread is exiting, don't cache any more
+    void *rgpvFree[kcpclMem];   // free lists
+    long rgcblk[kcpclMem];      // number of blocks on each free list
+    long rgcactAlloc[kcpclMem]; // statistics not yet added to _rgmpst
+    long rgcactHit[kcpclMem];
+
+    ~MTC(void);
+};
+
+thread_local MTC _mtc;
+void *_rgpvDepot[kcpclMem];
+MPST _rgmpst[kcpclMem];
+bool _fMemShutDown; // ShutDownMem has been called, nothing is pooled now
+
+/***************************************************************************
+    Return the size class for a request of cb bytes.  The classes are
+    every 16 bytes up to 128, then four per doubling up to kcbPoolMax.
+***************************************************************************/
+priv long _IpclFromCb(long cb)
+{
+    AssertIn(cb, 0, kcbPoolMax + 1);
+    long lg;
+
+    if (--cb < 128)
+        return LwMax(0, cb) >> 4;
+    for (lg = 7; (cb >> (lg + 1)) != 0; lg++)
+        ;
+    return 8 + 4 * (lg - 7) + ((cb - (1L << lg)) >> (lg - 2));
+}
+
+/***************************************************************************
+    Return the block size of the given size class.
+***************************************************************************/
+priv long _CbFromIpcl(long ipcl)
+{
+    AssertIn(ipcl, 0, kcpclMem);
+    long lg;
+
+    if (ipcl < 8)
+        return (ipcl + 1) << 4;
+    lg = 7 + (ipcl - 8) / 4;
+    return (1L << lg) + (((ipcl - 8) % 4 + 1) << (lg - 2));
+}
+
+/***************************************************************************
+    Add the cache's statistics for the class to _rgmpst.  vmutxMem must be
+    entered.
+***************************************************************************/
+priv void _FlushMtcStats(MTC *pmtc, long ipcl)
+{
+    _rgmpst[ipcl].cactAlloc += pmtc->rgcactAlloc[ipcl];
+    _rgmpst[ipcl].cactHit += pmtc->rgcactHit[ipcl];
+    pmtc->rgcactAlloc[ipcl] = 0;
+    pmtc->rgcactHit[ipcl] = 0;
+}
+
+/***************************************************************************
+    Move the first cblk free blocks of the class from the cache to the
+    depot.  Anything that doesn't fit in the depot is freed.
+***************************************************************************/
+priv void _PutDepot(MTC *pmtc, long ipcl, long cblk)
+{
+    AssertIn(cblk, 0, pmtc->rgcblk[ipcl] + 1);
+    void *pv, *pvNext;
+    void *pvFree = pvNil;
+
+    vmutxMem.Enter();
+    _FlushMtcStats(pmtc, ipcl);
+    for (; cblk > 0; cblk--)
+    {
+        pv = pmtc->rgpvFree[ipcl];
+        pmtc->rgpvFree[ipcl] = *(void **)pv;
+        pmtc->rgcblk[ipcl]--;
+        if (_rgmpst[ipcl].cblkDepot < kcblkDepotMax)
+        {
+            *(void **)pv = _rgpvDepot[ipcl];
+            _rgpvDepot[ipcl] = pv;
+            _rgmpst[ipcl].cblkDepot++;
+        }
+        else
+        {
+            *(void **)pv = pvFree;
+            pvFree = pv;
+            _rgmpst[ipcl].cblkOs--;
+        }
+    }
+    vmutxMem.Leave();
+
+    for (; pvNil != pvFree; pvFree = pvNext)
+    {
+        pvNext = *(void **)pvFree;
+        _FreeOs(PvSubBv(pvFree, kcbPbh));
+    }
+}
+
+/***************************************************************************
+    Move up to kcblkBatch free blocks of the class from the depot to the
+    cache.
+***************************************************************************/
+priv void _GetDepot(MTC *pmtc, long ipcl)
+{
+    void *pv;
+    long cblk;
+
+    vmutxMem.Enter();
+    _FlushMtcStats(pmtc, ipcl);
+    for (cblk = 0; cblk < kcblkBatch && pvNil != (pv = _rgpvDepot[ipcl]); cblk++)
+    {
+        _rgpvDepot[ipcl] = *(void **)pv;
+        *(void **)pv = pmtc->rgpvFree[ipcl];
+        pmtc->rgpvFree[ipcl] = pv;
+    }
+    _rgmpst[ipcl].cblkDepot -= cblk;
+    pmtc->rgcblk[ipcl] += cblk;
+    vmutxMem.Leave();
+}
+
+/***************************************************************************
+    Free this thread's cache and the depot back to the OS.  Returns true
+    if there was anything to free.
+***************************************************************************/
+priv bool _FFlushPools(void)
+{
+    MTC *pmtc = &_mtc;
+    long ipcl;
+    bool fRet = fFalse;
+    void *pv;
+
+    if (_fMemShutDown)
+        return fFalse;
+
+    for (ipcl = 0; ipcl < kcpclMem; ipcl++)
+    {
+        fRet |= pvNil != pmtc->rgpvFree[ipcl];
+        _PutDepot(pmtc, ipcl, pmtc->rgcblk[ipcl]);
+
+        vmutxMem.Enter();
+        fRet |= pvNil != _rgpvDepot[ipcl];
+        while (pvNil != (pv = _rgpvDepot[ipcl]))
+        {
+            _rgpvDepot[ipcl] = *(void **)pv;
+            _rgmpst[ipcl].cblkDepot--;
+            _rgmpst[ipcl].cblkOs--;
+            _FreeOs(PvSubBv(pv, kcbPbh));
+        }
+        vmutxMem.Leave();
+    }
+
+    return fRet;
+}
+
+/***************************************************************************
+    The thread is going away, so give its cached blocks to the depot.  Once
+    ShutDownMem has been called, vmutxMem may already be gone, so this
+    doesn't do anything.
+***************************************************************************/
+MTC::~MTC(void)
+{
+    long ipcl;
+
+    fDead = fTrue;
+    if (_fMemShutDown)
+        return;
+    for (ipcl = 0; ipcl < kcpclMem; ipcl++)
+        _PutDepot(this, ipcl, rgcblk[ipcl]);
+}
+
+/***************************************************************************
+    Allocate a block of at least cb bytes, from the pools if it's small
+    enough.  Returns pvNil if the OS is out of memory.
+***************************************************************************/
+priv void *_PvAllocMem(long cb)
+{
+    MTC *pmtc = &_mtc;
+    PBH *ppbh;
+    long ipcl, cbBlock;
+    void *pv;
+
+    if (cb > kcbPoolMax || _fMemShutDown)
+    {
+        ipcl = ipclNil;
+        cbBlock = cb;
+    }
+    else
+    {
+        ipcl = _IpclFromCb(cb);
+        cbBlock = _CbFromIpcl(ipcl);
+        if (!pmtc->fDead)
+        {
+            pmtc->rgcactAlloc[ipcl]++;
+            if (pvNil == pmtc->rgpvFree[ipcl])
+                _GetDepot(pmtc, ipcl);
+            if (pvNil != (pv = pmtc->rgpvFree[ipcl]))
+            {
+                pmtc->rgpvFree[ipcl] = *(void **)pv;
+                pmtc->rgcblk[ipcl]--;
+                pmtc->rgcactHit[ipcl]++;
+                return pv;
+            }
+        }
+    }
+
+    if (pvNil == (ppbh = (PBH *)_PvAllocOs(cbBlock + kcbPbh)) && _FFlushPools())
+        ppbh = (PBH *)_PvAllocOs(cbBlock + kcbPbh);
+    if (pvNil == ppbh)
+        return pvNil;
+
+    if (ipclNil != ipcl)
+    {
+        vmutxMem.Enter();
+        _rgmpst[ipcl].cblkOs++;
+        vmutxMem.Leave();
+    }
+    ppbh->ipcl = ipcl;
+    ppbh->cb = cbBlock;
+    return PvAddBv(ppbh, kcbPbh);
+}
+
+/***************************************************************************
+    Free a block allocated by _PvAllocMem.
+***************************************************************************/
+priv void _FreeMem(void *pv)
+{
+    MTC *pmtc = &_mtc;
+    PBH *ppbh = (PBH *)PvSubBv(pv, kcbPbh);
+    long ipcl = ppbh->ipcl;
+
+    if (ipclNil == ipcl || _fMemShutDown)
+    {
+        _FreeOs(ppbh);
+        return;
+    }
+
+    AssertIn(ipcl, 0, kcpclMem);
+    *(void **)pv = pmtc->rgpvFree[ipcl];
+    pmtc->rgpvFree[ipcl] = pv;
+    if (++pmtc->rgcblk[ipcl] > kcblkCacheMax || pmtc->fDead)
+        _PutDepot(pmtc, ipcl, pmtc->fDead ? pmtc->rgcblk[ipcl] : kcblkCacheMax / 2);
+}
+
+/***************************************************************************
+    Resize a block allocated by _PvAllocMem.  Stays in place if the new
+    size is in the same class.  Returns pvNil (and leaves the block alone)
+    if the OS is out of memory.
+***************************************************************************/
+priv void *_PvReallocMem(void *pv, long cb)
+{
+    PBH *ppbh = (PBH *)PvSubBv(pv, kcbPbh);
+    void *pvNew;
+
+    if (ipclNil == ppbh->ipcl)
+    {
+        if (cb > kcbPoolMax)
+        {
+            if (pvNil == (ppbh = (PBH *)_PvReallocOs(ppbh, cb + kcbPbh)) && _FFlushPools())
+                ppbh = (PBH *)_PvReallocOs(PvSubBv(pv, kcbPbh), cb + kcbPbh);
+            if (pvNil == ppbh)
+                return pvNil;
+            ppbh->cb = cb;
+            return PvAddBv(ppbh, kcbPbh);
+        }
+    }
+    else if (cb <= kcbPoolMax && _IpclFromCb(cb) == ppbh->ipcl)
+        return pv;
+
+    if (pvNil == (pvNew = _PvAllocMem(cb)))
+        return pvNil;
+    CopyPb(pv, pvNew, LwMin(cb, ppbh->cb));
+    _FreeMem(pv);
+    return pvNew;
+}
+
+/***************************************************************************
+    Return the usable size of a block allocated by _PvAllocMem.
+***************************************************************************/
+priv long _CbOfMem(void *pv)
+{
+    return ((PBH *)PvSubBv(pv, kcbPbh))->cb;
+}
+#endif // WIN
+
+/***************************************************************************
+    The app is shutting down.  Free this thread's cache and the depot back
+    to the OS and stop pooling, so that nothing needs vmutxMem once static
+    destruction starts.  Blocks freed after this go straight to the OS.
+    This is called on the main thread, whose cache would otherwise only
+    be flushed by its thread_local destructor during CRT teardown.
+***************************************************************************/
+void ShutDownMem(void)
+{
+#ifdef WIN
+    _FFlushPools();
+    _mtc.fDead = fTrue;
+    _fMemShutDown = fTrue;
+#endif // WIN
+}
+
+/***************************************************************************
+    Get the statistics for the given size class of the memory pools.  This
+    thread's latest allocations are included, other threads' may not be.
+***************************************************************************/
+void GetMpst(long ipcl, MPST *pmpst)
+{
+    AssertIn(ipcl, 0, kcpclMem);
+    AssertVarMem(pmpst);
+
+    ClearPb(pmpst, size(MPST));
+#ifdef WIN
+    vmutxMem.Enter();
+    _FlushMtcStats(&_mtc, ipcl);
+    *pmpst = _rgmpst[ipcl];
+    vmutxMem.Leave();
+    pmpst->cb = _CbFromIpcl(ipcl);
+#endif // WIN
+}
+
 #ifdef DEBUG
 /***************************************************************************
     Do simulated failure testing.
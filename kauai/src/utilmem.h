@@ -30,6 +30,25 @@ typedef long (*PFNLIB)(long cb, long mpr);
 extern PFNLIB vpfnlib;
 extern bool _fInAlloc;
 
+/***************************************************************************
+    Small blocks are pooled by size class (see utilmem.cpp).  These are
+    the statistics kept for each class.
+***************************************************************************/
+const long kcpclMem = 20; // number of size classes
+
+// memory pool statistics
+struct MPST
+{
+    long cb;        // size of the blocks in the class
+    long cactAlloc; // number of allocations
+    long cactHit;   // allocations served from a pool rather than the OS
+    long cblkOs;    // blocks currently allocated from the OS
+    long cblkDepot; // free blocks in the shared depot
+};
+
+void GetMpst(long ipcl, MPST *pmpst);
+void ShutDownMem(void);
+
 /****************************************
     OS memory handles and management
 ****************************************/
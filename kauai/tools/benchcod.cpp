@@ -0,0 +1,522 @@
+/* Copyright (c) Microsoft Corporation.
+   Licensed under the MIT License. */
+
+/***************************************************************************
+    Project: Kauai
+    Copyright (c) Microsoft Corporation
+
+    Codec and chunk load benchmark. Reads every chunk of one or more
+    chunky files and times reading the raw chunk data (CFL::FReadHq),
+    unpacking chunks that are stored packed, and packing and unpacking
+    each chunk in each Kauai format. The totals are reported per CTG as
+    a table, CSV or JSON, so runs can be compared by a script.
+
+***************************************************************************/
+#include <stdio.h>
+#include <time.h>
+#include "util.h"
+ASSERTNAME
+
+// the timed operations
+enum
+{
+    kbopRead,       // CFL::FReadHq
+    kbopUnpack,     // unpacking a chunk that is stored packed
+    kbopEncodeKcdc, // then packing and unpacking in each format
+    kbopDecodeKcdc,
+    kbopEncodeKcd2,
+    kbopDecodeKcd2,
+    kbopEncodeKcdf,
+    kbopDecodeKcdf,
+    kbopLim
+};
+
+static PSZS _rgpszsBop[kbopLim] = {"read", "unpack", "encode-kcdc", "decode-kcdc",
+                                   "encode-kcd2", "decode-kcd2", "encode-kcdf", "decode-kcdf"};
+static long _rgcfmtBench[] = {kcfmtKauai, kcfmtKauai2, kcfmtKauaiFast};
+
+// output formats
+enum
+{
+    kbofText,
+    kbofCsv,
+    kbofJson
+};
+
+// totals for one operation
+struct BTOT
+{
+    long cact;    // number of times the operation was done
+    double cbSrc; // bytes going in
+    double cbDst; // bytes coming out
+    double dsec;  // time taken
+};
+
+// totals for the chunks of one CTG
+struct CTGB
+{
+    CTG ctg;
+    BTOT rgbtot[kbopLim];
+};
+
+bool _FBenchCfl(PCFL pcfl, PGL pglctgb, long crep);
+bool _FBenchChunk(PCFL pcfl, CKI *pcki, CTGB *pctgb, long crep);
+void _AddTime(BTOT *pbtot, long cbSrc, long cbDst, double dsec);
+double _SecCur(void);
+void _Report(PGL pglctgb, long bof);
+void _ReportRow(PSZS pszsCtg, long bop, BTOT *pbtot, long bof, bool fFirst);
+
+/***************************************************************************
+    Main routine.  Returns non-zero iff there's an error.
+***************************************************************************/
+int __cdecl main(int cpszs, char *prgpszs[])
+{
+    schar chs;
+    STN stn;
+    FNI fni;
+    long ipszs;
+    long cfni = 0;
+    long crep = 3;
+    long bof = kbofText;
+    PCFL pcfl = pvNil;
+    PGL pglctgb = pvNil;
+
+#ifdef UNICODE
+    fprintf(stderr, "\nKauai Codec Benchmark (Unicode; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#else  //! UNICODE
+    fprintf(stderr, "\nKauai Codec Benchmark (Ansi; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#endif //! UNICODE
+
+    // the fast codec is normally only registered by apps
+    if (!vpcodmUtil->FRegisterCodec(&vkcdfUtil))
+        goto LFail;
+
+    for (ipszs = 1; ipszs < cpszs; ipszs++)
+    {
+        chs = prgpszs[ipszs][0];
+        if (chs != '/' && chs != '-')
+        {
+            cfni++;
+            continue;
+        }
+
+        switch (prgpszs[ipszs][1])
+        {
+        case 'c':
+        case 'C':
+            bof = kbofCsv;
+            break;
+
+        case 'j':
+        case 'J':
+            bof = kbofJson;
+            break;
+
+        case 'n':
+        case 'N':
+            stn.SetSzs(prgpszs[ipszs] + 2);
+            if (!stn.FGetLw(&crep) || !FIn(crep, 1, 1000))
+            {
+                fprintf(stderr, "Error: Bad repeat count\n\n");
+                goto LUsage;
+            }
+            break;
+
+        case 'l':
+        case 'L':
+            if (prgpszs[ipszs][2] < '0' || prgpszs[ipszs][2] >= '0' + kcmlLim || prgpszs[ipszs][3] != 0)
+            {
+                fprintf(stderr, "Error: Bad compression level\n\n");
+                goto LUsage;
+            }
+            vpcodmUtil->SetCmlDefault(prgpszs[ipszs][2] - '0');
+            break;
+
+        default:
+            goto LUsage;
+        }
+    }
+
+    if (cfni == 0)
+    {
+        fprintf(stderr, "Error: Need at least one chunky file\n\n");
+        goto LUsage;
+    }
+
+    if (pvNil == (pglctgb = GL::PglNew(size(CTGB))))
+        goto LFail;
+
+    for (ipszs = 1; ipszs < cpszs; ipszs++)
+    {
+        chs = prgpszs[ipszs][0];
+        if (chs == '/' || chs == '-')
+            continue;
+
+        stn.SetSzs(prgpszs[ipszs]);
+        if (!fni.FBuildFromPath(&stn))
+        {
+            fprintf(stderr, "Error: Bad file name: %s\n\n", prgpszs[ipszs]);
+            goto LUsage;
+        }
+        if (pvNil == (pcfl = CFL::PcflOpen(&fni, fcflNil)))
+        {
+            fprintf(stderr, "Error: Couldn't open %s\n\n", prgpszs[ipszs]);
+            goto LFail;
+        }
+        if (!_FBenchCfl(pcfl, pglctgb, crep))
+        {
+            fprintf(stderr, "Error: Reading %s failed\n\n", prgpszs[ipszs]);
+            goto LFail;
+        }
+        ReleasePpo(&pcfl);
+    }
+
+    _Report(pglctgb, bof);
+
+    ReleasePpo(&pglctgb);
+    FIL::ShutDown();
+    return 0;
+
+LUsage:
+    // print usage
+    fprintf(stderr, "%s",
+            "Usage:  bench-codec [-c | -j] [-n<repeat>] [-l<level>] <chunkyFile> ...\n"
+            "   -c: CSV output, -j: JSON output\n"
+            "   -n: times to repeat each operation (default 3)\n"
+            "   -l0: fast, -l1: normal (default), -l2: smallest\n\n");
+
+LFail:
+    ReleasePpo(&pcfl);
+    ReleasePpo(&pglctgb);
+    FIL::ShutDown();
+    fprintf(stderr, "Something failed\n");
+    return 1;
+}
+
+/***************************************************************************
+    Time all the chunks in the file, adding the totals to the CTGB for
+    their CTG.
+***************************************************************************/
+bool _FBenchCfl(PCFL pcfl, PGL pglctgb, long crep)
+{
+    AssertPo(pcfl, 0);
+    AssertPo(pglctgb, 0);
+    CKI cki;
+    CTGB ctgb;
+    long icki, ictgb;
+
+    for (icki = 0; pcfl->FGetCki(icki, &cki); icki++)
+    {
+        for (ictgb = 0; ictgb < pglctgb->IvMac(); ictgb++)
+        {
+            if (((CTGB *)pglctgb->QvGet(ictgb))->ctg == cki.ctg)
+                break;
+        }
+        if (ictgb == pglctgb->IvMac())
+        {
+            ClearPb(&ctgb, size(ctgb));
+            ctgb.ctg = cki.ctg;
+            if (!pglctgb->FAdd(&ctgb))
+                return fFalse;
+        }
+
+        pglctgb->Get(ictgb, &ctgb);
+        if (!_FBenchChunk(pcfl, &cki, &ctgb, crep))
+            return fFalse;
+        pglctgb->Put(ictgb, &ctgb);
+    }
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Time reading one chunk, unpacking it if it's packed, then packing and
+    unpacking it in each format. Each operation is done crep times.
+    Chunks that don't compress in a format only count towards that
+    format's encode time.
+***************************************************************************/
+bool _FBenchChunk(PCFL pcfl, CKI *pcki, CTGB *pctgb, long crep)
+{
+    AssertPo(pcfl, 0);
+    AssertVarMem(pcki);
+    AssertVarMem(pctgb);
+    long irep, icfmt, cbStored, cb, cbCmp, cbT;
+    double secStart;
+    HQ hq = hqNil;
+    byte *prgbSrc = pvNil;
+    byte *prgbCmp = pvNil;
+    byte *prgbDst = pvNil;
+    bool fOk;
+    bool fRet = fFalse;
+
+    for (irep = 0; irep < crep; irep++)
+    {
+        FreePhq(&hq);
+        secStart = _SecCur();
+        fOk = pcfl->FReadHq(pcki->ctg, pcki->cno, &hq);
+        if (!fOk)
+            goto LFail;
+        _AddTime(&pctgb->rgbtot[kbopRead], CbOfHq(hq), CbOfHq(hq), _SecCur() - secStart);
+    }
+    if (0 == (cbStored = CbOfHq(hq)))
+    {
+        FreePhq(&hq);
+        return fTrue;
+    }
+
+    // get the unpacked data
+    if (pcfl->FPacked(pcki->ctg, pcki->cno))
+    {
+        if (!vpcodmUtil->FDecompress(QvFromHq(hq), cbStored, pvNil, 0, &cb) ||
+            !FAllocPv((void **)&prgbSrc, cb, fmemNil, mprNormal))
+        {
+            goto LFail;
+        }
+        for (irep = 0; irep < crep; irep++)
+        {
+            secStart = _SecCur();
+            fOk = vpcodmUtil->FDecompress(QvFromHq(hq), cbStored, prgbSrc, cb, &cbT);
+            if (!fOk)
+                goto LFail;
+            _AddTime(&pctgb->rgbtot[kbopUnpack], cbStored, cb, _SecCur() - secStart);
+        }
+    }
+    else
+    {
+        cb = cbStored;
+        if (!FAllocPv((void **)&prgbSrc, cb, fmemNil, mprNormal))
+            goto LFail;
+        CopyPb(QvFromHq(hq), prgbSrc, cb);
+    }
+    FreePhq(&hq);
+
+    if (!FAllocPv((void **)&prgbCmp, cb, fmemNil, mprNormal) || !FAllocPv((void **)&prgbDst, cb, fmemNil, mprNormal))
+        goto LFail;
+
+    for (icfmt = 0; icfmt < CvFromRgv(_rgcfmtBench); icfmt++)
+    {
+        for (irep = 0; irep < crep; irep++)
+        {
+            secStart = _SecCur();
+            fOk = vpcodmUtil->FCompress(prgbSrc, cb, prgbCmp, cb, &cbCmp, _rgcfmtBench[icfmt]);
+            _AddTime(&pctgb->rgbtot[kbopEncodeKcdc + 2 * icfmt], cb, fOk ? cbCmp : cb, _SecCur() - secStart);
+        }
+        if (!fOk)
+            continue;
+
+        for (irep = 0; irep < crep; irep++)
+        {
+            secStart = _SecCur();
+            fOk = vpcodmUtil->FDecompress(prgbCmp, cbCmp, prgbDst, cb, &cbT);
+            if (!fOk)
+                goto LFail;
+            _AddTime(&pctgb->rgbtot[kbopDecodeKcdc + 2 * icfmt], cbCmp, cb, _SecCur() - secStart);
+        }
+        if (cbT != cb || fcmpEq != FcmpCompareRgb(prgbSrc, prgbDst, cb))
+        {
+            Bug("round trip failed");
+            goto LFail;
+        }
+    }
+    fRet = fTrue;
+
+LFail:
+    FreePhq(&hq);
+    FreePpv((void **)&prgbSrc);
+    FreePpv((void **)&prgbCmp);
+    FreePpv((void **)&prgbDst);
+    return fRet;
+}
+
+/***************************************************************************
+    Add one timing to the totals.
+***************************************************************************/
+void _AddTime(BTOT *pbtot, long cbSrc, long cbDst, double dsec)
+{
+    AssertVarMem(pbtot);
+
+    pbtot->cact++;
+    pbtot->cbSrc += cbSrc;
+    pbtot->cbDst += cbDst;
+    pbtot->dsec += dsec;
+}
+
+/***************************************************************************
+    Return the current time in seconds from a high resolution clock.
+***************************************************************************/
+double _SecCur(void)
+{
+#ifdef WIN
+    static LARGE_INTEGER _liFreq;
+    LARGE_INTEGER li;
+
+    if (0 == _liFreq.QuadPart)
+        QueryPerformanceFrequency(&_liFreq);
+    QueryPerformanceCounter(&li);
+    return (double)li.QuadPart / (double)_liFreq.QuadPart;
+#else  //! WIN
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif //! WIN
+}
+
+/***************************************************************************
+    Print the totals for each CTG, then the totals over all CTGs.
+***************************************************************************/
+void _Report(PGL pglctgb, long bof)
+{
+    AssertPo(pglctgb, 0);
+    CTGB ctgb;
+    BTOT rgbtotAll[kbopLim];
+    long ictgb, bop;
+    schar rgchsCtg[5];
+    bool fFirst = fTrue;
+
+    switch (bof)
+    {
+    case kbofCsv:
+        printf("ctg,op,decoder,chunks,bytes_in,bytes_out,seconds,mb_per_sec,ns_per_chunk\n");
+        break;
+    case kbofJson:
+        printf("[\n");
+        break;
+    default:
+        printf("CTG    Operation    Decoder    Chunks     Bytes in    Bytes out      MB/s   ns/chunk\n");
+        break;
+    }
+
+    ClearPb(rgbtotAll, size(rgbtotAll));
+    for (ictgb = 0; ictgb < pglctgb->IvMac(); ictgb++)
+    {
+        pglctgb->Get(ictgb, &ctgb);
+        rgchsCtg[0] = (schar)B3Lw(ctgb.ctg);
+        rgchsCtg[1] = (schar)B2Lw(ctgb.ctg);
+        rgchsCtg[2] = (schar)B1Lw(ctgb.ctg);
+        rgchsCtg[3] = (schar)B0Lw(ctgb.ctg);
+        rgchsCtg[4] = 0;
+        for (bop = 0; bop < kbopLim; bop++)
+        {
+            if (0 == ctgb.rgbtot[bop].cact)
+                continue;
+            _ReportRow(rgchsCtg, bop, &ctgb.rgbtot[bop], bof, fFirst);
+            fFirst = fFalse;
+            rgbtotAll[bop].cact += ctgb.rgbtot[bop].cact;
+            rgbtotAll[bop].cbSrc += ctgb.rgbtot[bop].cbSrc;
+            rgbtotAll[bop].cbDst += ctgb.rgbtot[bop].cbDst;
+            rgbtotAll[bop].dsec += ctgb.rgbtot[bop].dsec;
+        }
+    }
+
+    for (bop = 0; bop < kbopLim; bop++)
+    {
+        if (0 == rgbtotAll[bop].cact)
+            continue;
+        _ReportRow("*", bop, &rgbtotAll[bop], bof, fFirst);
+        fFirst = fFalse;
+    }
+
+    if (kbofJson == bof)
+        printf("\n]\n");
+}
+
+/***************************************************************************
+    Print the totals for one operation on one CTG. pszsCtg is "*" for the
+    totals over all CTGs.
+***************************************************************************/
+void _ReportRow(PSZS pszsCtg, long bop, BTOT *pbtot, long bof, bool fFirst)
+{
+    AssertIn(bop, 0, kbopLim);
+    AssertVarMem(pbtot);
+    double cbUnpacked, mbps, nsPerChunk;
+#ifdef IN_80386
+    PSZS pszsDecoder = "asm";
+#else  //! IN_80386
+    PSZS pszsDecoder = "c";
+#endif //! IN_80386
+
+    // MB/s is measured on the unpacked size, which is the larger one
+    cbUnpacked = pbtot->cbSrc > pbtot->cbDst ? pbtot->cbSrc : pbtot->cbDst;
+    mbps = pbtot->dsec > 0 ? cbUnpacked / pbtot->dsec / 1e6 : 0;
+    nsPerChunk = pbtot->dsec * 1e9 / pbtot->cact;
+
+    switch (bof)
+    {
+    case kbofCsv:
+        printf("%s,%s,%s,%ld,%.0f,%.0f,%.6f,%.2f,%.0f\n", pszsCtg, _rgpszsBop[bop], pszsDecoder, pbtot->cact,
+               pbtot->cbSrc, pbtot->cbDst, pbtot->dsec, mbps, nsPerChunk);
+        break;
+
+    case kbofJson:
+        printf("%s  {\"ctg\": \"%s\", \"op\": \"%s\", \"decoder\": \"%s\", \"chunks\": %ld, \"bytes_in\": %.0f, "
+               "\"bytes_out\": %.0f, \"seconds\": %.6f, \"mb_per_sec\": %.2f, \"ns_per_chunk\": %.0f}",
+               fFirst ? "" : ",\n", pszsCtg, _rgpszsBop[bop], pszsDecoder, pbtot->cact, pbtot->cbSrc, pbtot->cbDst,
+               pbtot->dsec, mbps, nsPerChunk);
+        break;
+
+    default:
+        printf("%-6s %-12s %-7s %9ld %12.0f %12.0f %9.2f %10.0f\n", pszsCtg, _rgpszsBop[bop], pszsDecoder, pbtot->cact,
+               pbtot->cbSrc, pbtot->cbDst, mbps, nsPerChunk);
+        break;
+    }
+}
+
+#ifdef DEBUG
+bool _fEnableWarnings = fTrue;
+
+/***************************************************************************
+    Warning proc called by Warn() macro
+***************************************************************************/
+void WarnProc(PSZS pszsFile, long lwLine, PSZS pszsMessage)
+{
+    if (_fEnableWarnings)
+    {
+        fprintf(stderr, "%s(%ld) : warning", pszsFile, lwLine);
+        if (pszsMessage != pvNil)
+        {
+            fprintf(stderr, ": %s", pszsMessage);
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+/***************************************************************************
+    Returning true breaks into the debugger.
+***************************************************************************/
+bool FAssertProc(PSZS pszsFile, long lwLine, PSZS pszsMessage, void *pv, long cb)
+{
+    fprintf(stderr, "An assert occurred: \n");
+    if (pszsMessage != pvNil)
+        fprintf(stderr, "   Message: %s\n", pszsMessage);
+    if (pv != pvNil)
+    {
+        fprintf(stderr, "   Address %x\n", pv);
+        if (cb != 0)
+        {
+            fprintf(stderr, "   Value: ");
+            switch (cb)
+            {
+            default: {
+                byte *pb;
+                byte *pbLim;
+
+                for (pb = (byte *)pv, pbLim = pb + cb; pb < pbLim; pb++)
+                    fprintf(stderr, "%02x", (int)*pb);
+            }
+            break;
+
+            case 2:
+                fprintf(stderr, "%04x", (int)*(short *)pv);
+                break;
+
+            case 4:
+                fprintf(stderr, "%08lx", *(long *)pv);
+                break;
+            }
+            printf("\n");
+        }
+    }
+    fprintf(stderr, "   File: %s\n", pszsFile);
+    fprintf(stderr, "   Line: %ld\n", lwLine);
+
+    return fFalse;
+}
+#endif // DEBUG
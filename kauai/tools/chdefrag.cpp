@@ -0,0 +1,391 @@
+/* Copyright (c) Microsoft Corporation.
+   Licensed under the MIT License. */
+
+/***************************************************************************
+    Project: Kauai
+    Copyright (c) Microsoft Corporation
+
+    Tool to defragment a chunky file.  The chunk data is rewritten so that
+    each loner's subgraph is contiguous on disk and in pre-order, which is
+    the order a subgraph is read when a template, scene or background is
+    loaded.  The resulting file has no free space.
+
+***************************************************************************/
+#include <stdio.h>
+#include "util.h"
+ASSERTNAME
+
+bool _FPlaceSubgraph(PCFL pcflSrc, CTG ctg, CNO cno, PCFL pcflDst);
+bool _FPlaceChunk(PCFL pcflSrc, CTG ctg, CNO cno, PCFL pcflDst);
+bool _FLinkChunks(PCFL pcflSrc, PCFL pcflDst);
+void _GetSeeks(PCFL pcfl, CTG ctg, CNO cno, long *pcseek, long *pckbSeek);
+
+/***************************************************************************
+    Main routine.  Returns non-zero iff there's an error.
+***************************************************************************/
+int __cdecl main(int cpszs, char *prgpszs[])
+{
+    schar chs;
+    STN stn;
+    FNI fniSrc, fniDst, fniT;
+    CKI cki;
+    long icki;
+    FLO floSrc, floDst;
+    long cseekSrc, ckbSrc, cseekDst, ckbDst;
+    long cseekSrcTot, ckbSrcTot, cseekDstTot, ckbDstTot;
+    long cfni = 0;
+    bool fReport = fFalse;
+    PCFL pcflSrc = pvNil;
+    PCFL pcflDst = pvNil;
+
+#ifdef UNICODE
+    fprintf(stderr, "\nChunky File Defrag Utility (Unicode; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#else  //! UNICODE
+    fprintf(stderr, "\nChunky File Defrag Utility (Ansi; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#endif //! UNICODE
+
+    for (prgpszs++; --cpszs > 0; prgpszs++)
+    {
+        chs = (*prgpszs)[0];
+        if (chs == '/' || chs == '-')
+        {
+            // -r or --report means print the seek distances for each loner
+            switch ((*prgpszs)[1])
+            {
+            case 'r':
+            case 'R':
+                fReport = fTrue;
+                break;
+
+            case '-':
+                stn.SetSzs(*prgpszs + 2);
+                if (!stn.FEqualUserSz(PszLit("report")))
+                    goto LUsage;
+                fReport = fTrue;
+                break;
+
+            default:
+                goto LUsage;
+            }
+        }
+        else
+        {
+            if (cfni >= 2)
+            {
+                fprintf(stderr, "Error: Too many file names\n\n");
+                goto LUsage;
+            }
+            stn.SetSzs(*prgpszs);
+            if (!(cfni == 0 ? &fniSrc : &fniDst)->FBuildFromPath(&stn))
+            {
+                fprintf(stderr, "Error: Bad file name: %s\n\n", *prgpszs);
+                goto LUsage;
+            }
+            cfni++;
+        }
+    }
+
+    if (cfni != 2)
+    {
+        fprintf(stderr, "Error: Need a source and destination file\n\n");
+        goto LUsage;
+    }
+    if (fniSrc.FEqual(&fniDst))
+    {
+        fprintf(stderr, "Error: Source and destination must be different\n\n");
+        goto LUsage;
+    }
+
+    if (pvNil == (pcflSrc = CFL::PcflOpen(&fniSrc, fcflNil)))
+    {
+        fprintf(stderr, "Error: Couldn't open source file\n\n");
+        goto LFail;
+    }
+    if (pvNil == (pcflDst = CFL::PcflCreateTemp()))
+        goto LFail;
+
+    // Lay down the data for each loner's subgraph.  Since the temp file
+    // has no free space, each chunk is appended to the end of the file.
+    for (icki = 0; pcflSrc->FGetCki(icki, &cki); icki++)
+    {
+        if (!pcflSrc->FLoner(cki.ctg, cki.cno))
+            continue;
+        if (!_FPlaceSubgraph(pcflSrc, cki.ctg, cki.cno, pcflDst))
+        {
+            fprintf(stderr, "Error: Copying chunk failed\n\n");
+            goto LFail;
+        }
+    }
+
+    // Anything not reachable from a loner (shouldn't happen) goes at the end
+    for (icki = 0; pcflSrc->FGetCki(icki, &cki); icki++)
+    {
+        if (!_FPlaceChunk(pcflSrc, cki.ctg, cki.cno, pcflDst))
+        {
+            fprintf(stderr, "Error: Copying chunk failed\n\n");
+            goto LFail;
+        }
+    }
+
+    if (!_FLinkChunks(pcflSrc, pcflDst))
+    {
+        fprintf(stderr, "Error: Linking chunks failed\n\n");
+        goto LFail;
+    }
+
+    // save the temp file in place so the data isn't reordered, then copy
+    // the bits to the destination
+    if (!pcflDst->FSave('CHDF'))
+        goto LFail;
+    pcflDst->GetFni(&fniT);
+    if (pvNil == (floSrc.pfil = FIL::PfilFromFni(&fniT)))
+    {
+        Bug("what happened?");
+        goto LFail;
+    }
+    floSrc.fp = 0;
+    floSrc.cb = floSrc.pfil->FpMac();
+
+    if (pvNil == (floDst.pfil = FIL::PfilCreate(&fniDst)))
+        goto LFail;
+    floDst.fp = 0;
+    floDst.cb = floSrc.cb;
+
+    if (!floSrc.FCopy(&floDst))
+    {
+        floDst.pfil->SetTemp(fTrue);
+        ReleasePpo(&floDst.pfil);
+        goto LFail;
+    }
+    ReleasePpo(&floDst.pfil);
+
+    if (fReport)
+    {
+        // the destination file is a byte copy of pcflDst, so offsets in
+        // pcflDst are offsets in the destination
+        cseekSrcTot = ckbSrcTot = cseekDstTot = ckbDstTot = 0;
+        printf("Root                    Seeks before  KB before  Seeks after  KB after\n");
+        for (icki = 0; pcflSrc->FGetCki(icki, &cki); icki++)
+        {
+            if (!pcflSrc->FLoner(cki.ctg, cki.cno))
+                continue;
+            _GetSeeks(pcflSrc, cki.ctg, cki.cno, &cseekSrc, &ckbSrc);
+            _GetSeeks(pcflDst, cki.ctg, cki.cno, &cseekDst, &ckbDst);
+            printf("'%c%c%c%c', 0x%08lX  %12ld %10ld %12ld %9ld\n", B3Lw(cki.ctg), B2Lw(cki.ctg), B1Lw(cki.ctg),
+                   B0Lw(cki.ctg), cki.cno, cseekSrc, ckbSrc, cseekDst, ckbDst);
+            cseekSrcTot += cseekSrc;
+            ckbSrcTot += ckbSrc;
+            cseekDstTot += cseekDst;
+            ckbDstTot += ckbDst;
+        }
+        printf("Total                   %12ld %10ld %12ld %9ld\n", cseekSrcTot, ckbSrcTot, cseekDstTot, ckbDstTot);
+    }
+
+    ReleasePpo(&pcflSrc);
+    ReleasePpo(&pcflDst);
+    FIL::ShutDown();
+    return 0;
+
+LUsage:
+    // print usage
+    fprintf(stderr, "%s", "Usage:  chdefrag [-r | --report] <srcFile> <dstFile>\n\n");
+
+LFail:
+    ReleasePpo(&pcflSrc);
+    ReleasePpo(&pcflDst);
+    FIL::ShutDown();
+    fprintf(stderr, "Something failed\n");
+    return 1;
+}
+
+/***************************************************************************
+    Copy the data for the subgraph rooted at (ctg, cno) to pcflDst in
+    pre-order.  Chunks already in pcflDst (shared with an earlier subgraph)
+    are skipped along with their descendents.  Doesn't create any parent
+    child links.
+***************************************************************************/
+bool _FPlaceSubgraph(PCFL pcflSrc, CTG ctg, CNO cno, PCFL pcflDst)
+{
+    AssertPo(pcflSrc, 0);
+    AssertPo(pcflDst, 0);
+
+    CGE cge;
+    KID kid;
+    CKI ckiPar;
+    ulong grfcge;
+    ulong grfcgeIn = fcgeNil;
+
+    cge.Init(pcflSrc, ctg, cno);
+    while (cge.FNextKid(&kid, &ckiPar, &grfcge, grfcgeIn))
+    {
+        grfcgeIn = fcgeNil;
+        if (grfcge & fcgeError)
+            return fFalse;
+        if (!(grfcge & fcgePre))
+            continue;
+
+        if (pcflDst->FFind(kid.cki.ctg, kid.cki.cno))
+        {
+            // already placed, so its subgraph is too
+            grfcgeIn = fcgeSkipToSib;
+            continue;
+        }
+        if (!_FPlaceChunk(pcflSrc, kid.cki.ctg, kid.cki.cno, pcflDst))
+            return fFalse;
+    }
+
+    return fTrue;
+}
+
+/***************************************************************************
+    If (ctg, cno) isn't in pcflDst yet, copy its data, packed state, forest
+    flag and name from pcflSrc.  The cno is preserved.
+***************************************************************************/
+bool _FPlaceChunk(PCFL pcflSrc, CTG ctg, CNO cno, PCFL pcflDst)
+{
+    AssertPo(pcflSrc, 0);
+    AssertPo(pcflDst, 0);
+
+    BLCK blck;
+    STN stn;
+
+    if (pcflDst->FFind(ctg, cno))
+        return fTrue;
+
+    if (!pcflSrc->FFind(ctg, cno, &blck) || !pcflDst->FPutBlck(&blck, ctg, cno))
+        return fFalse;
+    if (pcflSrc->FForest(ctg, cno))
+        pcflDst->SetForest(ctg, cno);
+    if (pcflSrc->FGetName(ctg, cno, &stn) && !pcflDst->FSetName(ctg, cno, &stn))
+        return fFalse;
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Recreate all the parent child links of pcflSrc in pcflDst and make the
+    loner flags match.  All the chunks must already be in pcflDst.
+***************************************************************************/
+bool _FLinkChunks(PCFL pcflSrc, PCFL pcflDst)
+{
+    AssertPo(pcflSrc, 0);
+    AssertPo(pcflDst, 0);
+
+    long icki, ikid, ckid;
+    CKI cki;
+    KID kid;
+
+    for (icki = 0; pcflSrc->FGetCki(icki, &cki, &ckid); icki++)
+    {
+        for (ikid = 0; ikid < ckid; ikid++)
+        {
+            AssertDo(pcflSrc->FGetKid(cki.ctg, cki.cno, ikid, &kid), 0);
+            if (!pcflDst->FAdoptChild(cki.ctg, cki.cno, kid.cki.ctg, kid.cki.cno, kid.chid, fFalse))
+                return fFalse;
+        }
+    }
+
+    for (icki = 0; pcflSrc->FGetCki(icki, &cki); icki++)
+        pcflDst->SetLoner(cki.ctg, cki.cno, pcflSrc->FLoner(cki.ctg, cki.cno));
+
+    return fTrue;
+}
+
+/***************************************************************************
+    Walk the subgraph rooted at (ctg, cno) in pre-order, as a loader would,
+    and count the number of times the next chunk's data doesn't start where
+    the previous chunk's data ended.  *pckbSeek gets the total distance of
+    those seeks in KB.
+***************************************************************************/
+void _GetSeeks(PCFL pcfl, CTG ctg, CNO cno, long *pcseek, long *pckbSeek)
+{
+    AssertPo(pcfl, 0);
+    AssertVarMem(pcseek);
+    AssertVarMem(pckbSeek);
+
+    CGE cge;
+    KID kid;
+    CKI ckiPar;
+    FLO flo;
+    ulong grfcge;
+    FP fpNext = -1;
+
+    *pcseek = *pckbSeek = 0;
+    cge.Init(pcfl, ctg, cno);
+    while (cge.FNextKid(&kid, &ckiPar, &grfcge, fcgeNil))
+    {
+        if ((grfcge & fcgeError) || !(grfcge & fcgePre))
+            continue;
+        if (!pcfl->FFindFlo(kid.cki.ctg, kid.cki.cno, &flo) || flo.cb <= 0)
+            continue;
+
+        if (fpNext >= 0 && flo.fp != fpNext)
+        {
+            (*pcseek)++;
+            *pckbSeek += (long)(((flo.fp > fpNext ? flo.fp - fpNext : fpNext - flo.fp) + 1023) / 1024);
+        }
+        fpNext = flo.fp + flo.cb;
+    }
+}
+
+#ifdef DEBUG
+bool _fEnableWarnings = fTrue;
+
+/***************************************************************************
+    Warning proc called by Warn() macro
+***************************************************************************/
+void WarnProc(PSZS pszsFile, long lwLine, PSZS pszsMessage)
+{
+    if (_fEnableWarnings)
+    {
+        fprintf(stderr, "%s(%ld) : warning", pszsFile, lwLine);
+        if (pszsMessage != pvNil)
+        {
+            fprintf(stderr, ": %s", pszsMessage);
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+/***************************************************************************
+    Returning true breaks into the debugger.
+***************************************************************************/
+bool FAssertProc(PSZS pszsFile, long lwLine, PSZS pszsMessage, void *pv, long cb)
+{
+    fprintf(stderr, "An assert occurred: \n");
+    if (pszsMessage != pvNil)
+        fprintf(stderr, "   Message: %s\n", pszsMessage);
+    if (pv != pvNil)
+    {
+        fprintf(stderr, "   Address %x\n", pv);
+        if (cb != 0)
+        {
+            fprintf(stderr, "   Value: ");
+            switch (cb)
+            {
+            default: {
+                byte *pb;
+                byte *pbLim;
+
+                for (pb = (byte *)pv, pbLim = pb + cb; pb < pbLim; pb++)
+                    fprintf(stderr, "%02x", (int)*pb);
+            }
+            break;
+
+            case 2:
+                fprintf(stderr, "%04x", (int)*(short *)pv);
+                break;
+
+            case 4:
+                fprintf(stderr, "%08lx", *(long *)pv);
+                break;
+            }
+            printf("\n");
+        }
+    }
+    fprintf(stderr, "   File: %s\n", pszsFile);
+    fprintf(stderr, "   Line: %ld\n", lwLine);
+
+    return fFalse;
+}
+#endif // DEBUG
@@ -0,0 +1,462 @@
+/* Copyright (c) Microsoft Corporation.
+   Licensed under the MIT License. */
+
+/***************************************************************************
+    Project: Kauai
+    Copyright (c) Microsoft Corporation
+
+    Tool to train compression dictionaries for a chunky file. For each
+    chunk type with lots of small packed chunks, a dictionary is built
+    from the byte strings that turn up in many of the chunks, and the
+    packed chunks of the type are repacked with it (see CFL::FSetDict).
+    A dictionary is only kept if it saves more than its own size.
+
+***************************************************************************/
+#include <stdio.h>
+#include "util.h"
+ASSERTNAME
+
+const long kcbDictDef = 0x2000;       // default dictionary size
+const long kcckiMinDict = 32;         // types with fewer packed chunks are skipped
+const long kcbAvgMaxDict = 0x4000;    // as are types with bigger chunks
+const long kcbSampleMax = 0x00100000; // most data to train a dictionary from
+
+// The dictionary is built from kcbSegDict byte pieces of the samples,
+// starting every kcbSegStep bytes. A piece is worth the number of samples
+// each of its kcbKmer byte strings turns up in.
+const long kcbSegDict = 64;
+const long kcbSegStep = 16;
+const long kcbKmer = 6;
+const long kcbitKmerHash = 16;
+
+// what training a dictionary for one chunk type came to
+struct DRES
+{
+    long ccki;         // number of packed chunks
+    long cbUnpacked;   // their unpacked size
+    long cbPacked;     // their size packed without a dictionary
+    long cbPackedDict; // their size packed with the dictionary
+    long cbDict;       // size of the dictionary (0 if none was trained)
+};
+
+bool _FTrainCtg(PCFL pcfl, CTG ctg, long cbDict, bool fApply, DRES *pdres);
+bool _FReadUnpacked(PCFL pcfl, CKI *pcki, HQ *phq);
+long _CbTrainDict(byte *prgbSample, long *prgibLim, long csample, byte *prgbDict, long cbDict);
+long _CbPacked(void *pv, long cb, long cfmt, ulong luDict);
+
+/***************************************************************************
+    Main routine.  Returns non-zero iff there's an error.
+***************************************************************************/
+int __cdecl main(int cpszs, char *prgpszs[])
+{
+    schar chs;
+    STN stn;
+    FNI fni;
+    CKI cki;
+    DRES dres;
+    long ipszs, icki;
+    CTG ctg, ctgPrev;
+    long cbDict = kcbDictDef;
+    bool fApply = fTrue;
+    bool fFile = fFalse;
+    bool fAnyCtg = fFalse;
+    PCFL pcfl = pvNil;
+
+#ifdef UNICODE
+    fprintf(stderr, "\nChunky File Dictionary Trainer (Unicode; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#else  //! UNICODE
+    fprintf(stderr, "\nChunky File Dictionary Trainer (Ansi; " Debug("Debug; ") __DATE__ "; " __TIME__ ")\n\n");
+#endif //! UNICODE
+
+    for (ipszs = 1; ipszs < cpszs; ipszs++)
+    {
+        chs = prgpszs[ipszs][0];
+        if (chs != '/' && chs != '-')
+        {
+            if (!fFile)
+                fFile = fTrue;
+            else
+                fAnyCtg = fTrue;
+            continue;
+        }
+
+        switch (prgpszs[ipszs][1])
+        {
+        case 'n':
+        case 'N':
+            // just report what the dictionaries would save
+            fApply = fFalse;
+            break;
+
+        case 's':
+        case 'S':
+            stn.SetSzs(prgpszs[ipszs] + 2);
+            if (!stn.FGetLw(&cbDict) || !FIn(cbDict, kcbSegDict, kcbDictMax + 1))
+            {
+                fprintf(stderr, "Error: Bad dictionary size\n\n");
+                goto LUsage;
+            }
+            break;
+
+        case 'l':
+        case 'L':
+            if (prgpszs[ipszs][2] < '0' || prgpszs[ipszs][2] >= '0' + kcmlLim || prgpszs[ipszs][3] != 0)
+            {
+                fprintf(stderr, "Error: Bad compression level\n\n");
+                goto LUsage;
+            }
+            vpcodmUtil->SetCmlDefault(prgpszs[ipszs][2] - '0');
+            break;
+
+        default:
+            goto LUsage;
+        }
+    }
+
+    if (!fFile)
+    {
+        fprintf(stderr, "Error: Need a chunky file\n\n");
+        goto LUsage;
+    }
+
+    fFile = fFalse;
+    printf("CTG    Chunks     Unpacked       Packed    With dict   Dict size\n");
+    for (ipszs = 1; ipszs < cpszs; ipszs++)
+    {
+        chs = prgpszs[ipszs][0];
+        if (chs == '/' || chs == '-')
+            continue;
+
+        if (!fFile)
+        {
+            // the chunky file
+            fFile = fTrue;
+            stn.SetSzs(prgpszs[ipszs]);
+            if (!fni.FBuildFromPath(&stn))
+            {
+                fprintf(stderr, "Error: Bad file name: %s\n\n", prgpszs[ipszs]);
+                goto LUsage;
+            }
+            if (pvNil == (pcfl = CFL::PcflOpen(&fni, fApply ? fcflWriteEnable : fcflNil)))
+            {
+                fprintf(stderr, "Error: Couldn't open %s\n\n", prgpszs[ipszs]);
+                goto LFail;
+            }
+            if (fAnyCtg)
+                continue;
+
+            // no types were given, so try all of them
+            for (icki = 0, ctgPrev = kctgDict; pcfl->FGetCki(icki, &cki); icki++)
+            {
+                if (cki.ctg == ctgPrev)
+                    continue;
+                ctgPrev = cki.ctg;
+                if (!_FTrainCtg(pcfl, cki.ctg, cbDict, fApply, &dres))
+                    goto LFail;
+            }
+            continue;
+        }
+
+        // a chunk type - pad it with spaces
+        stn.SetSzs(prgpszs[ipszs]);
+        if (!FIn(stn.Cch(), 1, 5))
+        {
+            fprintf(stderr, "Error: Bad chunk type: %s\n\n", prgpszs[ipszs]);
+            goto LUsage;
+        }
+        for (ctg = 0, icki = 0; icki < 4; icki++)
+            ctg = (ctg << 8) | (icki < stn.Cch() ? (byte)prgpszs[ipszs][icki] : ' ');
+        if (!_FTrainCtg(pcfl, ctg, cbDict, fApply, &dres))
+            goto LFail;
+    }
+
+    if (fApply && !pcfl->FSave('CHDC'))
+    {
+        fprintf(stderr, "Error: Couldn't save the file\n\n");
+        goto LFail;
+    }
+
+    ReleasePpo(&pcfl);
+    FIL::ShutDown();
+    return 0;
+
+LUsage:
+    // print usage
+    fprintf(stderr, "%s",
+            "Usage:  chdict [-n] [-s<size>] [-l<level>] <chunkyFile> [<ctg> ...]\n"
+            "   -n: report only - don't change the file\n"
+            "   -s: dictionary size (default 8192)\n"
+            "   -l0: fast, -l1: normal (default), -l2: smallest\n"
+            "   With no ctg's, every type with enough small packed chunks is tried.\n\n");
+
+LFail:
+    ReleasePpo(&pcfl);
+    FIL::ShutDown();
+    fprintf(stderr, "Something failed\n");
+    return 1;
+}
+
+/***************************************************************************
+    Train a dictionary for the packed chunks of type ctg and, if it saves
+    more than its own size and fApply is set, repack the chunks with it.
+    Fills in *pdres and prints a line for the type. Types that don't have
+    enough small packed chunks are skipped.
+***************************************************************************/
+bool _FTrainCtg(PCFL pcfl, CTG ctg, long cbDict, bool fApply, DRES *pdres)
+{
+    AssertPo(pcfl, 0);
+    AssertIn(cbDict, kcbSegDict, kcbDictMax + 1);
+    AssertVarMem(pdres);
+
+    long icki, ccki, cb, cbSample, csample, dickiSample;
+    CKI cki;
+    BLCK blck;
+    schar rgchsCtg[5];
+    ulong luDict = 0;
+    HQ hq = hqNil;
+    byte *prgbSample = pvNil;
+    long *prgibLim = pvNil;
+    byte *prgbDict = pvNil;
+    CKI *prgcki = pvNil;
+    bool fRet = fFalse;
+
+    ClearPb(pdres, size(DRES));
+    if (kctgDict == ctg || 0 == (ccki = pcfl->CckiCtg(ctg)))
+        return fTrue;
+
+    // see how much packed data there is
+    for (icki = 0; icki < ccki; icki++)
+    {
+        AssertDo(pcfl->FGetCkiCtg(ctg, icki, &cki, pvNil, &blck), 0);
+        if (!blck.FPacked() || !vpcodmUtil->FGetCbFromBlck(&blck, &cb))
+            continue;
+        pdres->ccki++;
+        pdres->cbUnpacked += cb;
+    }
+    if (pdres->ccki < kcckiMinDict || pdres->cbUnpacked / pdres->ccki > kcbAvgMaxDict)
+        return fTrue;
+
+    cbSample = LwMin(pdres->cbUnpacked, kcbSampleMax);
+    if (!FAllocPv((void **)&prgbSample, cbSample, fmemNil, mprNormal) ||
+        !FAllocPv((void **)&prgibLim, LwMul(pdres->ccki, size(long)), fmemNil, mprNormal) ||
+        !FAllocPv((void **)&prgbDict, cbDict, fmemNil, mprNormal) ||
+        !FAllocPv((void **)&prgcki, LwMul(pdres->ccki, size(CKI)), fmemNil, mprNormal))
+    {
+        goto LFail;
+    }
+    for (icki = cb = 0; icki < ccki; icki++)
+    {
+        AssertDo(pcfl->FGetCkiCtg(ctg, icki, &cki, pvNil, &blck), 0);
+        if (blck.FPacked())
+            prgcki[cb++] = cki;
+    }
+    Assert(cb == pdres->ccki, 0);
+
+    // Gather the samples. If there's too much data, use every
+    // dickiSample'th chunk, so the samples are spread over the whole type.
+    dickiSample = pdres->cbUnpacked / kcbSampleMax + 1;
+    for (icki = csample = cb = 0; icki < pdres->ccki && cb < cbSample; icki += dickiSample)
+    {
+        if (!_FReadUnpacked(pcfl, &prgcki[icki], &hq))
+            goto LFail;
+        CopyPb(QvFromHq(hq), prgbSample + cb, LwMin(CbOfHq(hq), cbSample - cb));
+        cb += LwMin(CbOfHq(hq), cbSample - cb);
+        prgibLim[csample++] = cb;
+        FreePhq(&hq);
+    }
+
+    if (0 == (pdres->cbDict = _CbTrainDict(prgbSample, prgibLim, csample, prgbDict, cbDict)) ||
+        !vpcodmUtil->FAddDict(prgbDict, pdres->cbDict, &luDict))
+    {
+        pdres->cbDict = 0;
+        fRet = fTrue;
+        goto LFail;
+    }
+
+    // see what the dictionary saves
+    for (icki = 0; icki < pdres->ccki; icki++)
+    {
+        if (!_FReadUnpacked(pcfl, &prgcki[icki], &hq))
+            goto LFail;
+        pdres->cbPacked += _CbPacked(QvFromHq(hq), CbOfHq(hq), kcfmtKauai2, 0);
+        pdres->cbPackedDict += _CbPacked(QvFromHq(hq), CbOfHq(hq), kcfmtKauai2Dict, luDict);
+        FreePhq(&hq);
+    }
+
+    rgchsCtg[0] = (schar)B3Lw(ctg);
+    rgchsCtg[1] = (schar)B2Lw(ctg);
+    rgchsCtg[2] = (schar)B1Lw(ctg);
+    rgchsCtg[3] = (schar)B0Lw(ctg);
+    rgchsCtg[4] = 0;
+    printf("%-6s %6ld %12ld %12ld %12ld %11ld%s\n", rgchsCtg, pdres->ccki, pdres->cbUnpacked, pdres->cbPacked,
+           pdres->cbPackedDict, pdres->cbDict, pdres->cbPacked - pdres->cbPackedDict > pdres->cbDict ? "" : "  (not used)");
+    if (pdres->cbPacked - pdres->cbPackedDict <= pdres->cbDict || !fApply)
+    {
+        fRet = fTrue;
+        goto LFail;
+    }
+
+    // set the dictionary and repack the chunks with it
+    if (!pcfl->FSetDict(ctg, prgbDict, pdres->cbDict))
+        goto LFail;
+    for (icki = 0; icki < pdres->ccki; icki++)
+    {
+        if (!pcfl->FUnpackData(prgcki[icki].ctg, prgcki[icki].cno))
+            goto LFail;
+    }
+    fRet = pcfl->FPackDataRgcki(prgcki, pdres->ccki, kcfmtKauai2);
+
+LFail:
+    if (0 != luDict)
+        vpcodmUtil->ReleaseDict(luDict);
+    FreePhq(&hq);
+    FreePpv((void **)&prgbSample);
+    FreePpv((void **)&prgibLim);
+    FreePpv((void **)&prgbDict);
+    FreePpv((void **)&prgcki);
+    return fRet;
+}
+
+/***************************************************************************
+    Read the unpacked data of *pcki into *phq.
+***************************************************************************/
+bool _FReadUnpacked(PCFL pcfl, CKI *pcki, HQ *phq)
+{
+    AssertPo(pcfl, 0);
+    AssertVarMem(pcki);
+    AssertVarMem(phq);
+    BLCK blck;
+
+    *phq = hqNil;
+    if (!pcfl->FFind(pcki->ctg, pcki->cno, &blck))
+    {
+        Bug("chunk not there");
+        return fFalse;
+    }
+    return blck.FUnpackData() && blck.FReadHq(phq);
+}
+
+/***************************************************************************
+    Return the hash of the kcbKmer bytes at pb.
+***************************************************************************/
+inline long _IhashKmer(byte *pb)
+{
+    ulong lu = (ulong)LwFromBytes(pb[0], pb[1], pb[2], pb[3]) * 0x9E3779B1 ^ ((ulong)pb[4] << 8 | pb[5]) * 0x85EBCA6B;
+
+    return (long)((lu & 0xFFFFFFFF) >> (32 - kcbitKmerHash));
+}
+
+/***************************************************************************
+    Build a dictionary of up to cbDict bytes from the samples in
+    prgbSample. prgibLim gives where each sample ends. The pieces of the
+    samples whose strings turn up in the most samples are picked one at a
+    time, and the strings of each piece picked stop counting, so the same
+    strings don't get picked twice. The most useful pieces go at the end
+    of the dictionary, where they're closest to the data and cheapest to
+    refer to. Returns the size of the dictionary, or 0 if the samples have
+    nothing in common.
+***************************************************************************/
+long _CbTrainDict(byte *prgbSample, long *prgibLim, long csample, byte *prgbDict, long cbDict)
+{
+    AssertIn(csample, 0, kcbMax);
+    AssertPvCb(prgibLim, LwMul(csample, size(long)));
+    AssertPvCb(prgbSample, csample > 0 ? prgibLim[csample - 1] : 0);
+    AssertIn(cbDict, kcbSegDict, kcbDictMax + 1);
+    AssertPvCb(prgbDict, cbDict);
+
+    long isample, ib, ibMin, ibLim, ibSeg, cbSeg, lwScore, lwScoreBest;
+    long ibSegBest = 0;
+    long cbSegBest = 0;
+    long cbSample = csample > 0 ? prgibLim[csample - 1] : 0;
+    long cbUsed = 0;
+    long *prgcsample = pvNil;    // number of samples each string hash turns up in
+    long *prgisampleLast = pvNil; // the last sample each string hash turned up in
+    long *prgihash = pvNil;       // the string hash at each sample position
+
+    if (cbSample < kcbKmer)
+        return 0;
+    if (!FAllocPv((void **)&prgcsample, LwMul(1 << kcbitKmerHash, size(long)), fmemClear, mprNormal) ||
+        !FAllocPv((void **)&prgisampleLast, LwMul(1 << kcbitKmerHash, size(long)), fmemNil, mprNormal) ||
+        !FAllocPv((void **)&prgihash, LwMul(cbSample, size(long)), fmemNil, mprNormal))
+    {
+        goto LFail;
+    }
+    FillPb(prgisampleLast, LwMul(1 << kcbitKmerHash, size(long)), 0xFF);
+
+    // count the samples each string is in
+    for (isample = 0, ibMin = 0; isample < csample; ibMin = prgibLim[isample++])
+    {
+        for (ib = ibMin; ib + kcbKmer <= prgibLim[isample]; ib++)
+        {
+            prgihash[ib] = _IhashKmer(prgbSample + ib);
+            if (prgisampleLast[prgihash[ib]] != isample)
+            {
+                prgisampleLast[prgihash[ib]] = isample;
+                prgcsample[prgihash[ib]]++;
+            }
+        }
+    }
+
+    while (cbDict - cbUsed >= kcbSegDict)
+    {
+        // find the most valuable piece - strings that are only in one
+        // sample don't count
+        lwScoreBest = 0;
+        for (isample = 0, ibMin = 0; isample < csample; ibMin = prgibLim[isample++])
+        {
+            ibLim = prgibLim[isample];
+            for (ibSeg = ibMin; ibSeg + kcbKmer <= ibLim; ibSeg += kcbSegStep)
+            {
+                cbSeg = LwMin(kcbSegDict, ibLim - ibSeg);
+                for (lwScore = 0, ib = ibSeg; ib + kcbKmer <= ibSeg + cbSeg; ib++)
+                {
+                    if (prgcsample[prgihash[ib]] > 1)
+                        lwScore += prgcsample[prgihash[ib]];
+                }
+                if (lwScore > lwScoreBest)
+                {
+                    lwScoreBest = lwScore;
+                    ibSegBest = ibSeg;
+                    cbSegBest = cbSeg;
+                }
+            }
+        }
+        if (0 == lwScoreBest)
+            break;
+
+        // add it in front of the pieces already picked
+        cbUsed += cbSegBest;
+        CopyPb(prgbSample + ibSegBest, prgbDict + cbDict - cbUsed, cbSegBest);
+        for (ib = ibSegBest; ib + kcbKmer <= ibSegBest + cbSegBest; ib++)
+            prgcsample[prgihash[ib]] = 0;
+    }
+
+    // move the dictionary to the front of the buffer
+    if (cbUsed < cbDict)
+        BltPb(prgbDict + cbDict - cbUsed, prgbDict, cbUsed);
+
+LFail:
+    FreePpv((void **)&prgcsample);
+    FreePpv((void **)&prgisampleLast);
+    FreePpv((void **)&prgihash);
+    return cbUsed;
+}
+
+/***************************************************************************
+    Return the size of the data packed in the given format, or its
+    unpacked size if it doesn't compress.
+***************************************************************************/
+long _CbPacked(void *pv, long cb, long cfmt, ulong luDict)
+{
+    AssertIn(cb, 0, kcbMax);
+    AssertPvCb(pv, cb);
+    long cbPacked;
+    byte *prgb;
+
+    if (cb <= 1 || !FAllocPv((void **)&prgb, cb, fmemNil, mprNormal))
+        return cb;
+    if (!vpcodmUtil->FCompress(pv, cb, prgb, cb, &cbPacked, cfmt, luDict))
+        cbPacked = cb;
+    FreePpv((void **)&prgb);
+    return cbPacked;
+}
@@ -26,6 +26,7 @@ int __cdecl main(int cpszs, char *prgpszs[])
     CNO cnoDst;
     PCFL pcflSrc;
     bool fPreOrder = fFalse;
+    bool fLarge = fFalse;
     PCFL pcflMerge = pvNil;
 
 #ifdef UNICODE
@@ -57,6 +58,13 @@ int __cdecl main(int cpszs, char *prgpszs[])
                     goto LFail;
                 break;
 
+            // -l means the result should use 64-bit file positions even if
+            // it's smaller than 2GB
+            case 'l':
+            case 'L':
+                fLarge = fTrue;
+                break;
+
             default:
                 goto LUsage;
             }
@@ -125,9 +133,13 @@ int __cdecl main(int cpszs, char *prgpszs[])
         goto LUsage;
     }
 
+    if (fLarge)
+        AssertDo(pcflMerge->FSetGrfcfl(fcflLarge, fcflLarge), 0);
+
     if (fPreOrder)
     {
         FLO floSrc, floDst;
+        FP fpMac;
 
         if (!pcflMerge->FSave('CHMR'))
             goto LFail;
@@ -137,18 +149,21 @@ int __cdecl main(int cpszs, char *prgpszs[])
             Bug("what happened?");
             goto LFail;
         }
-        floSrc.fp = 0;
-        floSrc.cb = floSrc.pfil->FpMac();
-
         if (pvNil == (floDst.pfil = FIL::PfilCreate(&fniSrc)))
             goto LFail;
-        floDst.fp = 0;
-        floDst.cb = floSrc.cb;
 
-        if (!floSrc.FCopy(&floDst))
+        // the file may be bigger than a flo can be, so copy it in pieces
+        fpMac = floSrc.pfil->FpMac();
+        for (floSrc.fp = 0; floSrc.fp < fpMac; floSrc.fp += floSrc.cb)
         {
-            floDst.pfil->SetTemp(fTrue);
-            goto LFail;
+            floSrc.cb = fpMac - floSrc.fp < kcbMax ? (long)(fpMac - floSrc.fp) : kcbMax;
+            floDst.fp = floSrc.fp;
+            floDst.cb = floSrc.cb;
+            if (!floSrc.FCopy(&floDst))
+            {
+                floDst.pfil->SetTemp(fTrue);
+                goto LFail;
+            }
         }
     }
     else
@@ -163,7 +178,7 @@ int __cdecl main(int cpszs, char *prgpszs[])
 
 LUsage:
     // print usage
-    fprintf(stderr, "%s", "Usage:  chmerge [-r] <srcFile0> [<srcFile1> ...] <dstFile>\n\n");
+    fprintf(stderr, "%s", "Usage:  chmerge [-r] [-l] <srcFile0> [<srcFile1> ...] <dstFile>\n\n");
 
 LFail:
     FIL::ShutDown();
@@ -48,6 +48,17 @@ int __cdecl main(int cpszs, char *prgpszs[])
                 fCompile = fFalse;
                 break;
 
+            case 'l':
+            case 'L':
+                // compression level for packed chunks
+                if (pszs[2] < '0' || pszs[2] >= '0' + kcmlLim || pszs[3] != 0)
+                {
+                    fprintf(stderr, "Bad compression level\n\n");
+                    goto LUsage;
+                }
+                vpcodmUtil->SetCmlDefault(pszs[2] - '0');
+                continue;
+
             default:
                 fprintf(stderr, "Bad command line option\n\n");
                 goto LUsage;
@@ -134,7 +145,8 @@ int __cdecl main(int cpszs, char *prgpszs[])
 LUsage:
     fprintf(stderr, "%s",
             "Usage:\n"
-            "   chomp [/c] <srcTextFile> <dstChunkFile>  - compile chunky file\n"
+            "   chomp [/c] [/l<level>] <srcTextFile> <dstChunkFile>  - compile chunky file\n"
+            "       level is 0 (fast), 1 (normal, the default) or 2 (smallest)\n"
             "   chomp /d <srcChunkFile> [<dstTextFile>]  - decompile chunky file\n\n");
 
     FIL::ShutDown();
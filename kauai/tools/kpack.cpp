@@ -75,6 +75,16 @@ int __cdecl main(int cpszs, char *prgpszs[])
                 }
                 break;
 
+            case 'l':
+            case 'L':
+                if ((*prgpszs)[2] < '0' || (*prgpszs)[2] >= '0' + kcmlLim || (*prgpszs)[3] != 0)
+                {
+                    fprintf(stderr, "Bad compression level\n\n");
+                    goto LUsage;
+                }
+                vpcodmUtil->SetCmlDefault((*prgpszs)[2] - '0');
+                break;
+
             case 'p':
             case 'P':
                 fCompress = fTrue;
@@ -127,8 +137,14 @@ int __cdecl main(int cpszs, char *prgpszs[])
         fprintf(stderr, "Can't open source file\n\n");
         goto LFail;
     }
+    // packing works on a single block, so the source has to fit in one
+    if (floSrc.pfil->FpMac() > kcbMax)
+    {
+        fprintf(stderr, "Source file is too big\n\n");
+        goto LFail;
+    }
     floSrc.fp = 0;
-    floSrc.cb = floSrc.pfil->FpMac();
+    floSrc.cb = (long)floSrc.pfil->FpMac();
 
     if (fniDst.FEqual(&fniSrc) || pvNil == (floDst.pfil = FIL::PfilCreate(&fniDst)))
     {
@@ -206,7 +222,9 @@ int __cdecl main(int cpszs, char *prgpszs[])
 
 LUsage:
     // print usage
-    fprintf(stderr, "%s", "Usage:  kpack [-d] [-c[0|1|2]] [-p <format>] <srcFile> <dstFile>\n\n");
+    fprintf(stderr, "%s",
+            "Usage:  kpack [-d] [-c[0|1|2]] [-p <format>] [-l<level>] <srcFile> <dstFile>\n"
+            "   -l0: fast, -l1: normal (default), -l2: smallest\n\n");
 
 LFail:
     if (pvNil != floDst.pfil)
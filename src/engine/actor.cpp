@@ -249,6 +249,8 @@ bool ACTR::_FCreateGroups(void)
 
     if (pvNil == (_pggaev = GG::PggNew(size(AEV), kcaevInit, kcbVarAdd)))
         return fFalse;
+    // events get inserted and deleted around the current frame
+    _pggaev->SetGapped(fTrue);
 
     if (pvNil == (_pglrpt = GL::PglNew(size(RPT), kcrptGrow)))
         return fFalse;
@@ -351,6 +351,7 @@ bool ACTR::_FReadEvents(PCFL pcfl, CNO cno)
     _pggaev = GG::PggRead(&blck, &bo);
     if (pvNil == _pggaev)
         return fFalse;
+    _pggaev->SetGapped(fTrue);
     if (kboOther == bo)
         _SwapBytesPggaev(_pggaev);
     return fTrue;
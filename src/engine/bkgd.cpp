@@ -200,7 +200,7 @@ bool BKGD::_FInit(PCFL pcfl, CTG ctg, CNO cno)
     {
         if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
             goto LFail;
-        _pglclr = GL::PglRead(&blck, &bo);
+        _pglclr = GL::PglReadView(&blck, &bo);
         if (_pglclr != pvNil)
         {
             if (kboOther == bo)
@@ -216,7 +216,7 @@ bool BKGD::_FInit(PCFL pcfl, CTG ctg, CNO cno)
         goto LFail;
     if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
         goto LFail;
-    pgllite = GL::PglRead(&blck, &bo);
+    pgllite = GL::PglReadView(&blck, &bo);
     if (pvNil == pgllite)
         goto LFail;
     Assert(pgllite->CbEntry() == size(LITE), "bad pgllite...you may need to update bkgds.chk");
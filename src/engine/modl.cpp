@@ -126,10 +126,7 @@ bool MODL::_FInit(PBLCK pblck)
     MODLF modlf;
     long cbrgbrv;
     long cbrgbrf;
-    long ibrv;
-    BRV *pbrv;
-    long ibrf;
-    BRF *pbrf;
+    SWPL swpl;
     MODL *pmodlThis = this;
     char szIdentifier[size(PMODL) + 1];
 
@@ -202,10 +199,8 @@ bool MODL::_FInit(PBLCK pblck)
         }
         if (kboOther == modlf.bo)
         {
-            for (ibrv = 0, pbrv = _pbmdl->prepared_vertices; ibrv < modlf.cver; ibrv++, pbrv++)
-            {
-                SwapBytesBom(pbrv, kbomBrv);
-            }
+            CompileBom(kbomBrv, size(BRV), &swpl);
+            SwapBytesRgvSwpl(_pbmdl->prepared_vertices, modlf.cver, &swpl);
         }
         BRF_IO* prepared_faces_io = new BRF_IO[modlf.cfac];
         if (!pblck->FReadRgb(prepared_faces_io, cbrgbrf, size(MODLF) + cbrgbrv))
@@ -215,11 +210,8 @@ bool MODL::_FInit(PBLCK pblck)
         }
         if (kboOther == modlf.bo)
         {
-            BRF_IO* pbrf;
-            for (ibrf = 0, pbrf = prepared_faces_io; ibrf < modlf.cfac; ibrf++, pbrf++)
-            {
-                SwapBytesBom(pbrf, kbomBrf);
-            }
+            CompileBom(kbomBrf, size(BRF_IO), &swpl);
+            SwapBytesRgvSwpl(prepared_faces_io, modlf.cfac, &swpl);
         }
 
         BRF_IoToNative(_pbmdl->prepared_faces, prepared_faces_io, modlf.cfac);
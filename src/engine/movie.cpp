@@ -2451,7 +2451,7 @@ bool MVIE::FAutoSave(PFNI pfni, bool fCleanRollCall)
     CNO cnoScen;
     CNO cnoSource;
     MFP mfp;
-    KID kidScen, kidGstRollCall, kidGstSource;
+    KID kidScen, kidGstRollCall, kidGstSource, kidEvents;
     PCFL pcfl;
     PGST pgstSource = pvNil;
 
@@ -2528,6 +2528,20 @@ LRetry:
             pcfl->Delete(kctgScen, cnoScen);
             goto LFail0;
         }
+
+        //
+        // Pack the scene's events.  The autosave file is a temp file, so
+        // this uses the fast codec, and the CFL repacks them when the movie
+        // is saved to a real file.  If packing fails, they just stay unpacked.
+        //
+        if (pcfl->FGetKidChidCtg(kctgScen, cnoScen, 0, kctgFrmGg, &kidEvents))
+        {
+            pcfl->FPackData(kidEvents.cki.ctg, kidEvents.cki.cno);
+        }
+        if (pcfl->FGetKidChidCtg(kctgScen, cnoScen, 1, kctgStartGg, &kidEvents))
+        {
+            pcfl->FPackData(kidEvents.cki.ctg, kidEvents.cki.cno);
+        }
     }
 
     //
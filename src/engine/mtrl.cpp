@@ -568,14 +568,12 @@ bool CMTL::_FInit(PCRF pcrf, CTG ctg, CNO cno)
     Assert(kboCur == cmtlf.bo, "bad CMTLF");
     _ibset = cmtlf.ibset;
 
-    // Highest chid is number of body part sets - 1
+    // Highest chid is number of body part sets - 1.  Kids are sorted by
+    // chid, so the last kid has the highest one.
     _cbprt = 0;
-    // note: there might be a faster way to compute _cbprt
-    for (ikid = 0; pcfl->FGetKid(ctg, cno, ikid, &kid); ikid++)
-    {
-        if ((long)kid.chid > (_cbprt - 1))
-            _cbprt = kid.chid + 1;
-    }
+    ikid = pcfl->Ckid(ctg, cno);
+    if (ikid > 0 && pcfl->FGetKid(ctg, cno, ikid - 1, &kid))
+        _cbprt = kid.chid + 1;
     if (!FAllocPv((void **)&_prgpmtrl, LwMul(_cbprt, size(PMTRL)), fmemClear, mprNormal))
     {
         return fFalse;
@@ -519,6 +519,7 @@ PSCEN SCEN::PscenNew(PMVIE pmvie)
     {
         goto LFail;
     }
+    pscen->_pggsevFrm->SetGapped(fTrue);
     pscen->_isevFrmLim = 0;
 
     pscen->_pggsevStart = GG::PggNew(size(SEV));
@@ -526,6 +527,7 @@ PSCEN SCEN::PscenNew(PMVIE pmvie)
     {
         goto LFail;
     }
+    pscen->_pggsevStart->SetGapped(fTrue);
 
     pscen->_pglpactr = GL::PglNew(size(PACTR), 0);
     if (pscen->_pglpactr == pvNil)
@@ -3858,6 +3860,7 @@ SCEN *SCEN::PscenRead(PMVIE pmvie, PCRF pcrf, CNO cno)
     {
         goto LFail0;
     }
+    pscen->_pggsevFrm->SetGapped(fTrue);
 
     Assert(pscen->_pggsevFrm->CbFixed() == size(SEV), "Bad GG read for event");
 
@@ -3939,6 +3942,7 @@ SCEN *SCEN::PscenRead(PMVIE pmvie, PCRF pcrf, CNO cno)
     {
         goto LFail1;
     }
+    pscen->_pggsevStart->SetGapped(fTrue);
 
     Assert(pscen->_pggsevStart->CbFixed() == size(SEV), "Bad GG read for event");
 
@@ -543,7 +543,8 @@ PCRM TAGM::_PcrmSourceNew(long sid, PFNI pfniDir)
         goto LFail;
     while (fne.FNextFni(&fni))
     {
-        pcfl = CFL::PcflOpen(&fni, fcflNil);
+        // content files are only ever read, so map them if we can
+        pcfl = CFL::PcflOpen(&fni, fcflMapped);
         if (pvNil == pcfl)
             goto LFail;
         if (!pcrmSource->FAddCfl(pcfl, _cbCache))
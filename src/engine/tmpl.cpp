@@ -144,30 +144,52 @@ bool ACTN::_FInit(PCFL pcfl, CTG ctg, CNO cno)
 {
     AssertPo(pcfl, 0);
 
+    // the chunks we read, in the order they're in rgcki and rgblck
+    enum
+    {
+        iblckActn,
+        iblckGgcl,
+        iblckGlxf,
+        iblckGlms,
+        iblckLim
+    };
+
     KID kid;
-    BLCK blck;
+    CKI rgcki[iblckLim];
+    BLCK rgblck[iblckLim];
     ACTNF actnf;
     short bo;
-    long icel;
-
-    if (!pcfl->FFind(ctg, cno, &blck) || !blck.FUnpackData())
+    long icel, ccki;
+
+    // find the ACTN and its GG of cels (chid 0, ctg kctgGgcl), GL of
+    // transforms (chid 0, ctg kctgGlxf) and (optional) GL of motion-match
+    // sounds (chid 0, ctg kctgGlms), then read them all in one batch so
+    // the packed ones are decompressed in parallel
+    rgcki[iblckActn].ctg = ctg;
+    rgcki[iblckActn].cno = cno;
+    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGgcl, &kid))
+        return fFalse;
+    rgcki[iblckGgcl] = kid.cki;
+    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlxf, &kid))
+        return fFalse;
+    rgcki[iblckGlxf] = kid.cki;
+    ccki = iblckGlms;
+    if (pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlms, &kid))
+        rgcki[ccki++] = kid.cki;
+    if (!pcfl->FFindRgblck(rgcki, ccki, rgblck))
         return fFalse;
 
-    if (blck.Cb() < size(ACTNF))
+    if (rgblck[iblckActn].Cb() < size(ACTNF))
         return fFalse;
-    if (!blck.FReadRgb(&actnf, size(ACTNF), 0))
+    if (!rgblck[iblckActn].FReadRgb(&actnf, size(ACTNF), 0))
         return fFalse;
     if (kboOther == actnf.bo)
         SwapBytesBom(&actnf, kbomActnf);
     Assert(kboCur == actnf.bo, "bad ACTNF");
     _grfactn = actnf.grfactn;
 
-    // read GG of cels (chid 0, ctg kctgGgcl):
-    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGgcl, &kid))
-        return fFalse;
-    if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
-        return fFalse;
-    _pggcel = GG::PggRead(&blck, &bo);
+    // GG of cels
+    _pggcel = GG::PggReadView(&rgblck[iblckGgcl], &bo);
     if (pvNil == _pggcel)
         return fFalse;
     AssertBomRglw(kbomCel, size(CEL));
@@ -181,12 +203,8 @@ bool ACTN::_FInit(PCFL pcfl, CTG ctg, CNO cno)
         }
     }
 
-    // read GL of transforms (chid 0, ctg kctgGlxf):
-    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlxf, &kid))
-        return fFalse;
-    if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
-        return fFalse;
-    _pglbmat34 = GL::PglRead(&blck, &bo);
+    // GL of transforms
+    _pglbmat34 = GL::PglReadView(&rgblck[iblckGlxf], &bo);
     if (pvNil == _pglbmat34)
         return fFalse;
     AssertBomRglw(kbomBmat34, size(BMAT34));
@@ -195,12 +213,10 @@ bool ACTN::_FInit(PCFL pcfl, CTG ctg, CNO cno)
         SwapBytesRglw(_pglbmat34->QvGet(0), LwMul(_pglbmat34->IvMac(), size(BMAT34) / size(long)));
     }
 
-    // read (optional) GL of motion-match sounds (chid 0, ctg kctgGlms):
-    if (pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlms, &kid))
+    // (optional) GL of motion-match sounds
+    if (ccki > iblckGlms)
     {
-        if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
-            return fFalse;
-        _pgltagSnd = GL::PglRead(&blck, &bo);
+        _pgltagSnd = GL::PglReadView(&rgblck[iblckGlms], &bo);
         if (pvNil == _pgltagSnd)
             return fFalse;
         AssertBomRglw(kbomTag, size(TAG));
@@ -418,33 +434,50 @@ bool TMPL::_FInit(PCFL pcfl, CTG ctg, CNO cno)
 {
     AssertPo(pcfl, 0);
 
+    // the chunks we read, in the order they're in rgcki and rgblck
+    enum
+    {
+        iblckGlpi,
+        iblckGlbs,
+        iblckGgcm,
+        iblckLim
+    };
+
     KID kid;
+    CKI rgcki[iblckLim];
+    BLCK rgblck[iblckLim];
     short bo;
-    BLCK blck;
-    long ibact;
+    long ibact, ccki;
     short ibset;
 
     if (!_FReadTmplf(pcfl, ctg, cno))
         return fFalse;
 
-    // read GLPI (parent tree)
+    // find the GLPI (parent tree), GLBS (body-part-set ID list) and GGCM
+    // (costume info), then read them in one batch so the packed ones are
+    // decompressed in parallel
     if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlpi, &kid))
         return fFalse;
-    if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
+    rgcki[iblckGlpi] = kid.cki;
+    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlbs, &kid))
+        return fFalse;
+    rgcki[iblckGlbs] = kid.cki;
+    ccki = iblckGgcm;
+    if (pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGgcm, &kid))
+        rgcki[ccki++] = kid.cki;
+    if (!pcfl->FFindRgblck(rgcki, ccki, rgblck))
         return fFalse;
-    _pglibactPar = GL::PglRead(&blck, &bo);
+
+    // GLPI
+    _pglibactPar = GL::PglReadView(&rgblck[iblckGlpi], &bo);
     if (pvNil == _pglibactPar)
         return fFalse;
     Assert(_pglibactPar->CbEntry() == size(short), "Bad _pglibactPar!");
     if (kboOther == bo)
         SwapBytesRgsw(_pglibactPar->QvGet(0), _pglibactPar->IvMac());
 
-    // read GLBS (body-part-set ID list)
-    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGlbs, &kid))
-        return fFalse;
-    if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
-        return fFalse;
-    _pglibset = GL::PglRead(&blck, &bo);
+    // GLBS
+    _pglibset = GL::PglReadView(&rgblck[iblckGlbs], &bo);
     if (pvNil == _pglibset)
         return fFalse;
     Assert(_pglibset->CbEntry() == size(short), "Bad TMPL _pglibset!");
@@ -477,16 +510,14 @@ bool TMPL::_FInit(PCFL pcfl, CTG ctg, CNO cno)
     while (pcfl->FGetKidChidCtg(ctg, cno, _cactn, kctgActn, &kid))
         _cactn++;
 
-    // read GGCM (costume info)
-    if (!pcfl->FGetKidChidCtg(ctg, cno, 0, kctgGgcm, &kid))
+    // GGCM
+    if (ccki <= iblckGgcm)
     {
         // REVIEW *****: temp until Pete updates sitobren
         goto LBuildGgcm;
         //		return fFalse;
     }
-    if (!pcfl->FFind(kid.cki.ctg, kid.cki.cno, &blck))
-        return fFalse;
-    _pggcmid = GG::PggRead(&blck, &bo);
+    _pggcmid = GG::PggReadView(&rgblck[iblckGgcm], &bo);
     if (pvNil == _pggcmid)
         return fFalse;
     Assert(_pggcmid->CbFixed() == size(long), "Bad TMPL _pggcmid");
@@ -502,7 +533,7 @@ bool TMPL::_FInit(PCFL pcfl, CTG ctg, CNO cno)
     return fTrue;
 // REVIEW *****: temp code until Pete converts our TMPL content
 LBuildGgcm:
-    long ikid;
+    KDE kde;
     PCMTL pcmtl;
     PCRF pcrf;
     long rgcmid[50];
@@ -522,10 +553,10 @@ LBuildGgcm:
     }
     for (ibset = 0; ibset < _cbset; ibset++)
     {
-        ikid = 0;
         ccmid = 0;
 
-        while (pcfl->FGetKid(ctg, cno, ikid++, &kid))
+        pcfl->InitKde(ctg, cno, &kde);
+        while (pcfl->FNextKid(&kde, &kid))
         {
             if (kid.cki.ctg != kctgCmtl)
                 continue;
@@ -1571,8 +1571,7 @@ bool BCL::_FAddFileToThd(PCFL pcfl, long sid)
     long cckiRoot;
     CKI ckiRoot;
     KID kidPar;
-    long ikidPar;
-    long ckidPar;
+    KDE kde;
 
     Assert(ctgNil != _ctgRoot, "Illegal call");
 
@@ -1609,13 +1608,9 @@ bool BCL::_FAddFileToThd(PCFL pcfl, long sid)
         if (!pcfl->FFind(ckiRoot.ctg, ckiRoot.cno))
             continue;
 
-        ckidPar = pcfl->Ckid(ckiRoot.ctg, ckiRoot.cno);
-
-        for (ikidPar = 0; ikidPar < ckidPar; ikidPar++)
+        pcfl->InitKde(ckiRoot.ctg, ckiRoot.cno, &kde);
+        while (pcfl->FNextKid(&kde, &kidPar))
         {
-            if (!pcfl->FGetKid(ckiRoot.ctg, ckiRoot.cno, ikidPar, &kidPar))
-                return fFalse;
-
             if (kidPar.cki.ctg != _ctgContent)
                 continue;
 